@@ -72,6 +72,8 @@ const std::unordered_map<string, PgExpr::Opcode> kOperatorNames = {
   { ">=", PgExpr::Opcode::PG_EXPR_GE },
   { "<", PgExpr::Opcode::PG_EXPR_LT },
   { "<=", PgExpr::Opcode::PG_EXPR_LE },
+  { "is_null", PgExpr::Opcode::PG_EXPR_IS_NULL },
+  { "starts_with", PgExpr::Opcode::PG_EXPR_STARTS_WITH },
 
   { "and", PgExpr::Opcode::PG_EXPR_AND },
   { "or", PgExpr::Opcode::PG_EXPR_OR },
@@ -83,7 +85,12 @@ const std::unordered_map<string, PgExpr::Opcode> kOperatorNames = {
   { "count", PgExpr::Opcode::PG_EXPR_COUNT },
   { "max", PgExpr::Opcode::PG_EXPR_MAX },
   { "min", PgExpr::Opcode::PG_EXPR_MIN },
-  { "eval_expr_call", PgExpr::Opcode::PG_EXPR_EVAL_EXPR_CALL }
+  { "eval_expr_call", PgExpr::Opcode::PG_EXPR_EVAL_EXPR_CALL },
+
+  { "+", PgExpr::Opcode::PG_EXPR_ADD },
+  { "-", PgExpr::Opcode::PG_EXPR_SUB },
+  { "*", PgExpr::Opcode::PG_EXPR_MUL },
+  { "||", PgExpr::Opcode::PG_EXPR_CONCAT }
 };
 
 PgExpr::PgExpr(Opcode opcode, const K2PgTypeEntity *type_entity)
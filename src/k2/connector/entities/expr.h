@@ -74,6 +74,10 @@ class PgExpr {
         PG_EXPR_LE,
         PG_EXPR_LT,
 
+        // Null test and prefix match of string columns, i.e. col IS NULL and col LIKE 'abc%'.
+        PG_EXPR_IS_NULL,
+        PG_EXPR_STARTS_WITH,
+
         // exists
         PG_EXPR_EXISTS,
 
@@ -92,6 +96,12 @@ class PgExpr {
 
         // built-in functions
         PG_EXPR_EVAL_EXPR_CALL,
+
+        // Arithmetic and string operators of the pushed down UPDATE assignments, e.g. SET col = col + 1
+        PG_EXPR_ADD,
+        PG_EXPR_SUB,
+        PG_EXPR_MUL,
+        PG_EXPR_CONCAT,
     };
 
     friend std::ostream& operator<<(std::ostream& os, const Opcode& opcode) {
@@ -105,6 +115,8 @@ class PgExpr {
             case Opcode::PG_EXPR_GT: return os << "PG_EXPR_GT";
             case Opcode::PG_EXPR_LE: return os << "PG_EXPR_LE";
             case Opcode::PG_EXPR_LT: return os << "PG_EXPR_LT";
+            case Opcode::PG_EXPR_IS_NULL: return os << "PG_EXPR_IS_NULL";
+            case Opcode::PG_EXPR_STARTS_WITH: return os << "PG_EXPR_STARTS_WITH";
             case Opcode::PG_EXPR_EXISTS: return os << "PG_EXPR_EXISTS";
             case Opcode::PG_EXPR_AND: return os << "PG_EXPR_AND";
             case Opcode::PG_EXPR_OR: return os << "PG_EXPR_OR";
@@ -116,6 +128,10 @@ class PgExpr {
             case Opcode::PG_EXPR_MAX: return os << "PG_EXPR_MAX";
             case Opcode::PG_EXPR_MIN: return os << "PG_EXPR_MIN";
             case Opcode::PG_EXPR_EVAL_EXPR_CALL: return os << "PG_EXPR_EVAL_EXPR_CALL";
+            case Opcode::PG_EXPR_ADD: return os << "PG_EXPR_ADD";
+            case Opcode::PG_EXPR_SUB: return os << "PG_EXPR_SUB";
+            case Opcode::PG_EXPR_MUL: return os << "PG_EXPR_MUL";
+            case Opcode::PG_EXPR_CONCAT: return os << "PG_EXPR_CONCAT";
             default: return os << "UNKNOWN";
         }
     }
@@ -160,6 +176,13 @@ class PgExpr {
                 opcode_ == Opcode::PG_EXPR_LT);
     }
 
+    bool is_assign_expr() const {
+        return (opcode_ == Opcode::PG_EXPR_ADD ||
+                opcode_ == Opcode::PG_EXPR_SUB ||
+                opcode_ == Opcode::PG_EXPR_MUL ||
+                opcode_ == Opcode::PG_EXPR_CONCAT);
+    }
+
     virtual bool is_k2pgbasetid() const {
         return false;
     }
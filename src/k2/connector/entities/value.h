@@ -23,6 +23,8 @@
 
 #include <assert.h>
 #include <cmath>
+#include <limits>
+#include <string>
 
 #include "common/type/slice.h"
 #include "pggate/pg_gate_typedefs.h"
@@ -100,33 +102,113 @@ public:
       return type_ == ValueType::INT;
   }
 
-  bool IsMaxInteger() {
-      if (!IsInteger()) {
-          return false;
+  // true if there is a value which sorts right after this one, i.e. UpperBound() can be called.
+  // Strings always have one (the same string with a trailing \0 byte)
+  bool HasUpperBound() const {
+      // null values are not handled here since SQL has its own way to handle nulls
+      assert(!IsNull());
+      switch (type_) {
+          case ValueType::BOOL:
+              return !data_.bool_val_;
+          case ValueType::INT:
+              return data_.int_val_ != std::numeric_limits<int64_t>::max();
+          case ValueType::FLOAT:
+              return !std::isnan(data_.float_val_) && data_.float_val_ != std::numeric_limits<float>::infinity();
+          case ValueType::DOUBLE:
+              return !std::isnan(data_.double_val_) && data_.double_val_ != std::numeric_limits<double>::infinity();
+          case ValueType::SLICE:
+              return true;
+          default:
+              return false;
       }
+  }
 
-      // null values are not handled here since SQL has its own way to handle nulls
+  // true if there is a value which sorts right before this one, i.e. LowerBound() can be called.
+  // Strings never have one since the predecessor of "b" is "a" followed by an infinite number of 0xff bytes
+  bool HasLowerBound() const {
       assert(!IsNull());
-      return data_.int_val_ == std::numeric_limits<int64_t>::max();
+      switch (type_) {
+          case ValueType::BOOL:
+              return data_.bool_val_;
+          case ValueType::INT:
+              return data_.int_val_ != std::numeric_limits<int64_t>::min();
+          case ValueType::FLOAT:
+              return !std::isnan(data_.float_val_) && data_.float_val_ != -std::numeric_limits<float>::infinity();
+          case ValueType::DOUBLE:
+              return !std::isnan(data_.double_val_) && data_.double_val_ != -std::numeric_limits<double>::infinity();
+          default:
+              return false;
+      }
   }
 
-  // get a value that is higher than the current one
-  SqlValue UpperBound() {
+  // get the smallest value that is higher than the current one
+  SqlValue UpperBound() const {
     // null values are not handled here since SQL has its own way to handle nulls
     assert(!IsNull());
     switch (type_) {
+        case ValueType::BOOL: {
+            return SqlValue(true);
+        } break;
         case ValueType::INT: {
             return SqlValue(data_.int_val_ + 1);
         } break;
+        case ValueType::FLOAT: {
+            // -0.0 and 0.0 are equal, so step over both of them
+            if (data_.float_val_ == 0) {
+                return SqlValue(std::numeric_limits<float>::denorm_min());
+            }
+            return SqlValue(std::nextafter(data_.float_val_, std::numeric_limits<float>::infinity()));
+        } break;
+        case ValueType::DOUBLE: {
+            if (data_.double_val_ == 0) {
+                return SqlValue(std::numeric_limits<double>::denorm_min());
+            }
+            return SqlValue(std::nextafter(data_.double_val_, std::numeric_limits<double>::infinity()));
+        } break;
+        case ValueType::SLICE: {
+            std::string next(data_.slice_val_);
+            next.push_back('\0');
+            return SqlValue(std::move(next));
+        } break;
+        default: {
+            throw std::invalid_argument("Unsupported data type: " + std::to_string(type_));
+        } break;
+    }
+
+    throw std::invalid_argument("Unsupported data type: " + std::to_string(type_));
+  }
+
+  // get the largest value that is lower than the current one
+  SqlValue LowerBound() const {
+    assert(!IsNull());
+    switch (type_) {
+        case ValueType::BOOL: {
+            return SqlValue(false);
+        } break;
+        case ValueType::INT: {
+            return SqlValue(data_.int_val_ - 1);
+        } break;
+        case ValueType::FLOAT: {
+            if (data_.float_val_ == 0) {
+                return SqlValue(-std::numeric_limits<float>::denorm_min());
+            }
+            return SqlValue(std::nextafter(data_.float_val_, -std::numeric_limits<float>::infinity()));
+        } break;
+        case ValueType::DOUBLE: {
+            if (data_.double_val_ == 0) {
+                return SqlValue(-std::numeric_limits<double>::denorm_min());
+            }
+            return SqlValue(std::nextafter(data_.double_val_, -std::numeric_limits<double>::infinity()));
+        } break;
         default: {
-            throw std::invalid_argument("Unsupported data type: " + type_);
+            throw std::invalid_argument("Unsupported data type: " + std::to_string(type_));
         } break;
     }
 
-    throw std::invalid_argument("Unsupported data type: " + type_);
+    throw std::invalid_argument("Unsupported data type: " + std::to_string(type_));
   }
 
-  int Compare(const SqlValue& val) {
+  int Compare(const SqlValue& val) const {
     // null values are not considered here since their comparison is based on column sorting type
     assert((!IsNull()) && (!val.IsNull()));
     // types must be the same for comparison
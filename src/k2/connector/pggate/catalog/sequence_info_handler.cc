@@ -0,0 +1,236 @@
+/*
+MIT License
+
+Copyright(c) 2020 Futurewei Cloud
+
+    Permission is hereby granted,
+    free of charge, to any person obtaining a copy of this software and associated documentation files(the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and / or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions :
+
+    The above copyright notice and this permission notice shall be included in all copies
+    or
+    substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS",
+    WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+    DAMAGES OR OTHER
+    LIABILITY,
+    WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include "pggate/catalog/sequence_info_handler.h"
+
+#include <glog/logging.h>
+
+namespace k2pg {
+namespace sql {
+namespace catalog {
+
+SequenceInfoHandler::SequenceInfoHandler(std::shared_ptr<K2Adapter> k2_adapter)
+    : collection_name_(CatalogConsts::skv_collection_name_primary_cluster),
+      schema_name_(CatalogConsts::skv_schema_name_sequence_meta) {
+    schema_ptr_ = std::make_shared<k2::dto::Schema>(schema_);
+    k2_adapter_ = k2_adapter;
+}
+
+SequenceInfoHandler::~SequenceInfoHandler() {
+}
+
+InitSequenceTableResult SequenceInfoHandler::InitSequenceTable() {
+    InitSequenceTableResult response;
+    auto result = k2_adapter_->CreateSchema(collection_name_, schema_ptr_).get();
+    if (!result.status.is2xxOK()) {
+        K2LOG_E(log::catalog, "Failed to create schema for {} in {}, due to {}", schema_ptr_->name, collection_name_, result.status);
+        response.status = K2Adapter::K2StatusToK2PgStatus(result.status);
+        return response;
+    }
+
+    K2LOG_I(log::catalog, "InitSequenceTable succeeded schema as {} in {}", schema_ptr_->name, collection_name_);
+    response.status = Status();  // OK
+    return response;
+}
+
+InitSequenceTableResult SequenceInfoHandler::EnsureSequenceTable() {
+    InitSequenceTableResult response;
+    auto schema_result = k2_adapter_->GetSchema(collection_name_, schema_name_, schema_ptr_->version).get();
+    if (schema_result.status.is2xxOK()) {
+        response.status = Status();  // OK
+        return response;
+    }
+
+    response.status = K2Adapter::K2StatusToK2PgStatus(schema_result.status);
+    if (!response.status.IsNotFound()) {
+        K2LOG_E(log::catalog, "Failed to get schema {} in {}, due to {}", schema_name_, collection_name_, schema_result.status);
+        return response;
+    }
+
+    K2LOG_I(log::catalog, "Creating missing schema {} in {}", schema_name_, collection_name_);
+    response = InitSequenceTable();
+    if (!response.status.ok()) {
+        // another process may have created it at the same time
+        schema_result = k2_adapter_->GetSchema(collection_name_, schema_name_, schema_ptr_->version).get();
+        if (schema_result.status.is2xxOK()) {
+            response.status = Status();  // OK
+        }
+    }
+    return response;
+}
+
+// The records are made within the tasks, i.e. on the seastar thread which sends them
+k2::dto::SKVRecord SequenceInfoHandler::MakeSequenceRecord(int64_t db_oid, int64_t seq_oid, std::optional<int64_t> last_val,
+                                                           std::optional<bool> is_called) {
+    k2::dto::SKVRecord record(collection_name_, schema_ptr_);
+    // use int64_t to represent uint32_t since since SKV does not support them
+    record.serializeNext<int64_t>(db_oid);
+    record.serializeNext<int64_t>(seq_oid);
+    if (last_val) {
+        record.serializeNext<int64_t>(*last_val);
+    } else {
+        record.serializeNull();
+    }
+    if (is_called) {
+        record.serializeNext<bool>(*is_called);
+    } else {
+        record.serializeNull();
+    }
+    return record;
+}
+
+Status SequenceInfoHandler::InsertSequence(int64_t db_oid, int64_t seq_oid, int64_t last_val, bool is_called) {
+    OpTask task = [this, db_oid, seq_oid, last_val, is_called] (k2::K23SIClient&, k2::K2TxnHandle& txn) {
+        k2::dto::SKVRecord record = MakeSequenceRecord(db_oid, seq_oid, last_val, is_called);
+        return txn.write(record)
+            .then([] (k2::WriteResult&& result) { return K2Adapter::K2StatusToK2PgStatus(result.status); });
+    };
+    Status status = k2_adapter_->RunOneShot(std::move(task), OpCounts{.writes = 1}).get();
+    if (!status.ok()) {
+        K2LOG_E(log::catalog, "Failed to insert sequence {} in database {} due to {}", seq_oid, db_oid, status);
+    }
+    return status;
+}
+
+Status SequenceInfoHandler::UpdateSequence(int64_t db_oid, int64_t seq_oid, int64_t last_val, bool is_called,
+                                           std::optional<int64_t> expected_last_val, std::optional<bool> expected_is_called,
+                                           bool* skipped) {
+    bool conditional = expected_last_val || expected_is_called;
+    auto mismatch = std::make_shared<bool>(false);
+    OpTask task = [this, db_oid, seq_oid, last_val, is_called, expected_last_val, expected_is_called, conditional, mismatch]
+                  (k2::K23SIClient&, k2::K2TxnHandle& txn) {
+        // the sequence must exist, so that a concurrently dropped sequence is not brought back
+        auto write = [this, db_oid, seq_oid, last_val, is_called, &txn] {
+            k2::dto::SKVRecord record = MakeSequenceRecord(db_oid, seq_oid, last_val, is_called);
+            return txn.write(record, false, k2::dto::ExistencePrecondition::Exists)
+                .then([] (k2::WriteResult&& result) { return K2Adapter::K2StatusToK2PgStatus(result.status); });
+        };
+        if (!conditional) {
+            return write();
+        }
+
+        // a concurrent update of the sequence makes either this transaction or the other one fail with a conflict
+        return txn.read(MakeSequenceRecord(db_oid, seq_oid, std::nullopt, std::nullopt))
+            .then([expected_last_val, expected_is_called, mismatch, write=std::move(write)] (k2::ReadResult<k2::dto::SKVRecord>&& current) {
+                if (!current.status.is2xxOK()) {
+                    return seastar::make_ready_future<Status>(K2Adapter::K2StatusToK2PgStatus(current.status));
+                }
+                std::optional<int64_t> current_last_val = current.value.deserializeField<int64_t>("LastValue");
+                std::optional<bool> current_is_called = current.value.deserializeField<bool>("IsCalled");
+                if ((expected_last_val && current_last_val != expected_last_val) ||
+                    (expected_is_called && current_is_called != expected_is_called)) {
+                    *mismatch = true;
+                    return seastar::make_ready_future<Status>(Status::OK());
+                }
+                return write();
+            });
+    };
+
+    Status status = k2_adapter_->RunOneShot(std::move(task), OpCounts{.reads = conditional ? 1u : 0u, .writes = 1}).get();
+    if (conditional && status.IsAborted()) {
+        K2LOG_D(log::catalog, "Conditional update of sequence {} in database {} conflicted: {}", seq_oid, db_oid, status);
+        *mismatch = true;
+        status = Status::OK();
+    }
+    if (!status.ok()) {
+        K2LOG_E(log::catalog, "Failed to update sequence {} in database {} due to {}", seq_oid, db_oid, status);
+        return status;
+    }
+    if (skipped != nullptr) {
+        *skipped = *mismatch;
+    }
+    return status;
+}
+
+Status SequenceInfoHandler::ReadSequence(int64_t db_oid, int64_t seq_oid, int64_t* last_val, bool* is_called) {
+    auto values = std::make_shared<std::pair<int64_t, bool>>(0, false);
+    OpTask task = [this, db_oid, seq_oid, values] (k2::K23SIClient&, k2::K2TxnHandle& txn) {
+        return txn.read(MakeSequenceRecord(db_oid, seq_oid, std::nullopt, std::nullopt))
+            .then([values] (k2::ReadResult<k2::dto::SKVRecord>&& current) {
+                if (current.status.is2xxOK()) {
+                    values->first = current.value.deserializeField<int64_t>("LastValue").value();
+                    values->second = current.value.deserializeField<bool>("IsCalled").value();
+                }
+                return K2Adapter::K2StatusToK2PgStatus(current.status);
+            });
+    };
+    Status status = k2_adapter_->RunOneShot(std::move(task), OpCounts{.reads = 1}).get();
+    if (!status.ok()) {
+        K2LOG_E(log::catalog, "Failed to read sequence {} in database {} due to {}", seq_oid, db_oid, status);
+        return status;
+    }
+    *last_val = values->first;
+    *is_called = values->second;
+    return status;
+}
+
+Status SequenceInfoHandler::DeleteSequence(int64_t db_oid, int64_t seq_oid) {
+    OpTask task = [this, db_oid, seq_oid] (k2::K23SIClient&, k2::K2TxnHandle& txn) {
+        k2::dto::SKVRecord record = MakeSequenceRecord(db_oid, seq_oid, std::nullopt, std::nullopt);
+        return txn.write(record, true /*erase*/)
+            .then([] (k2::WriteResult&& result) { return K2Adapter::K2StatusToK2PgStatus(result.status); });
+    };
+    Status status = k2_adapter_->RunOneShot(std::move(task), OpCounts{.writes = 1}).get();
+    if (!status.ok()) {
+        K2LOG_E(log::catalog, "Failed to delete sequence {} in database {} due to {}", seq_oid, db_oid, status);
+    }
+    return status;
+}
+
+Status SequenceInfoHandler::DeleteDatabaseSequences(int64_t db_oid) {
+    auto create_result = k2_adapter_->CreateScanRead(collection_name_, schema_name_).get();
+    if (!create_result.status.is2xxOK()) {
+        K2LOG_E(log::catalog, "Failed to create scan read for sequences of database {} due to {}", db_oid, create_result.status);
+        return K2Adapter::K2StatusToK2PgStatus(create_result.status);
+    }
+
+    auto txnHandler = std::make_shared<PgTxnHandler>(k2_adapter_);
+    std::shared_ptr<k2::Query> query = create_result.query;
+    // all the sequences of the database, i.e. the records with the database oid as the key prefix
+    query->startScanRecord.serializeNext<int64_t>(db_oid);
+    query->endScanRecord.serializeNext<int64_t>(db_oid);
+    do {
+        auto query_result = k2_adapter_->ScanRead(txnHandler->GetTxn(), query).get();
+        if (!query_result.status.is2xxOK()) {
+            K2LOG_E(log::catalog, "Failed to run scan read for sequences of database {} due to {}", db_oid, query_result.status);
+            txnHandler->AbortTransaction();
+            return K2Adapter::K2StatusToK2PgStatus(query_result.status);
+        }
+
+        for (k2::dto::SKVRecord& record : query_result.records) {
+            auto delete_result = k2_adapter_->DeleteRecord(txnHandler->GetTxn(), record).get();
+            if (!delete_result.status.is2xxOK()) {
+                K2LOG_E(log::catalog, "Failed to delete a sequence of database {} due to {}", db_oid, delete_result.status);
+                txnHandler->AbortTransaction();
+                return K2Adapter::K2StatusToK2PgStatus(delete_result.status);
+            }
+        }
+        // if the query is not done, the query itself is updated with the pagination token for the next call
+    } while (!query->isDone());
+
+    return txnHandler->CommitTransaction();
+}
+
+} // namespace catalog
+} // namespace sql
+} // namespace k2pg
@@ -0,0 +1,103 @@
+/*
+MIT License
+
+Copyright(c) 2020 Futurewei Cloud
+
+    Permission is hereby granted,
+    free of charge, to any person obtaining a copy of this software and associated documentation files(the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and / or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions :
+
+    The above copyright notice and this permission notice shall be included in all copies
+    or
+    substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS",
+    WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+    DAMAGES OR OTHER
+    LIABILITY,
+    WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+#pragma once
+
+#include <optional>
+#include <string>
+
+#include "pggate/catalog/sql_catalog_defaults.h"
+#include "pggate/k2_adapter.h"
+#include "pggate/pg_txn_handler.h"
+#include "catalog_log.h"
+
+namespace k2pg {
+namespace sql {
+namespace catalog {
+
+using k2pg::gate::K2Adapter;
+using k2pg::gate::PgTxnHandler;
+using k2pg::Status;
+
+struct InitSequenceTableResult {
+    Status status;
+};
+
+// Keeps the data of the sequences, i.e. the last value handed out, in the primary cluster's SKV collection.
+// A sequence is not transactional: each of its operations runs and commits in a transaction of its own, regardless
+// of the transaction of the session. PG reserves a range of values with a single conditional update of the last
+// value, so that a session only goes to SKV once per range.
+class SequenceInfoHandler {
+    public:
+    typedef std::shared_ptr<SequenceInfoHandler> SharedPtr;
+
+    k2::dto::Schema schema_ {
+        .name = CatalogConsts::skv_schema_name_sequence_meta,
+        .version = 1,
+        .fields = std::vector<k2::dto::SchemaField> {
+                {k2::dto::FieldType::INT64T, "DatabaseOid", false, false},
+                {k2::dto::FieldType::INT64T, "SequenceOid", false, false},
+                {k2::dto::FieldType::INT64T, "LastValue", false, false},
+                {k2::dto::FieldType::BOOL, "IsCalled", false, false}},
+        .partitionKeyFields = std::vector<uint32_t> { 0, 1 },
+        .rangeKeyFields = std::vector<uint32_t> {}
+    };
+
+    SequenceInfoHandler(std::shared_ptr<K2Adapter> k2_adapter);
+    ~SequenceInfoHandler();
+
+    // Called only once in sql_catalog_manager::InitPrimaryCluster()
+    InitSequenceTableResult InitSequenceTable();
+
+    // Called on every start of sql_catalog_manager, creates the SKV schema of the sequences on clusters which were
+    // initialized before the sequences were stored in SKV
+    InitSequenceTableResult EnsureSequenceTable();
+
+    // Creates the sequence, or resets it if it exists, e.g. for TRUNCATE ... RESTART IDENTITY
+    Status InsertSequence(int64_t db_oid, int64_t seq_oid, int64_t last_val, bool is_called);
+
+    // Sets the last value of the sequence. If expected values are given, the sequence is only updated if it still
+    // has them, otherwise skipped is set, e.g. when another session reserved a range of values concurrently
+    Status UpdateSequence(int64_t db_oid, int64_t seq_oid, int64_t last_val, bool is_called,
+                          std::optional<int64_t> expected_last_val, std::optional<bool> expected_is_called,
+                          bool* skipped);
+
+    Status ReadSequence(int64_t db_oid, int64_t seq_oid, int64_t* last_val, bool* is_called);
+
+    Status DeleteSequence(int64_t db_oid, int64_t seq_oid);
+
+    // Deletes the sequences of a dropped database
+    Status DeleteDatabaseSequences(int64_t db_oid);
+
+    private:
+    k2::dto::SKVRecord MakeSequenceRecord(int64_t db_oid, int64_t seq_oid, std::optional<int64_t> last_val,
+                                          std::optional<bool> is_called);
+
+    std::string collection_name_;
+    std::string schema_name_;
+    std::shared_ptr<k2::dto::Schema> schema_ptr_;
+    std::shared_ptr<K2Adapter> k2_adapter_;
+};
+
+} // namespace catalog
+} // namespace sql
+} // namespace k2pg
@@ -162,6 +162,15 @@ Status SqlCatalogClient::DeleteIndexTable(const PgOid database_oid, const PgOid
   return response.status;
 }
 
+Status SqlCatalogClient::PurgeIndexData(const std::string& database_id, const IndexInfo& index_info) {
+  PurgeIndexDataRequest request {
+    .databaseId = database_id,
+    .indexInfo = index_info
+  };
+  PurgeIndexDataResponse response = catalog_manager_->PurgeIndexData(request);
+  return response.status;
+}
+
 Status SqlCatalogClient::OpenTable(const PgOid database_oid, const PgOid table_oid, std::shared_ptr<TableInfo>* table) {
   GetTableSchemaRequest request {
     .databaseOid = database_oid,
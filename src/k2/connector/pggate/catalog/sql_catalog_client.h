@@ -92,6 +92,8 @@ class SqlCatalogClient {
 
     CHECKED_STATUS DeleteIndexTable(const PgOid database_oid, const PgOid table_oid, PgOid *base_table_oid, bool wait = true);
 
+    CHECKED_STATUS PurgeIndexData(const std::string& database_id, const IndexInfo& index_info);
+
     CHECKED_STATUS OpenTable(const PgOid database_oid, const PgOid table_oid, std::shared_ptr<TableInfo>* table);
 
     Result<std::shared_ptr<TableInfo>> OpenTable(const PgOid database_oid, const PgOid table_oid) {
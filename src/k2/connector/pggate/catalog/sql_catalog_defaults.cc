@@ -31,9 +31,12 @@ namespace catalog {
 const std::string CatalogConsts::primary_cluster_id = "PG_DEFAULT_CLUSTER";
 const std::string CatalogConsts::skv_collection_name_primary_cluster =  "K2RESVD_COLLECTION_SQL_PRIMARY_CLUSTER";
 
-// two meta tables/SKVSchema in singleton SKV collection (sql primary cluster).
+// meta tables/SKVSchema in singleton SKV collection (sql primary cluster).
 const std::string CatalogConsts::skv_schema_name_cluster_meta =         "K2RESVD_SCHEMA_SQL_CLUSTER_META";
 const std::string CatalogConsts::skv_schema_name_database_meta =        "K2RESVD_SCHEMA_SQL_DATABASE_META";
+// the data of all sequences, i.e. their last value, keyed by database oid and sequence oid
+const std::string CatalogConsts::skv_schema_name_sequence_meta =        "K2RESVD_SCHEMA_SQL_SEQUENCE_META";
+const std::string CatalogConsts::skv_schema_name_purge_meta =           "K2RESVD_SCHEMA_SQL_PURGE_META";
 
 // Names of three system meta tables holding definition of tables, table columns, index columns (as using Postgre provided sys catalog pg_class, pg_index, etc is too complex)
 // All database/SKV collection, except "sql primary cluster", contains a set of them.
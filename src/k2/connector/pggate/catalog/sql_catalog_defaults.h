@@ -36,9 +36,11 @@ struct CatalogConsts {
     static const std::string primary_cluster_id;
     static const std::string skv_collection_name_primary_cluster;
 
-    // two meta tables/SKVSchemas in PG primary cluster(corresponding SKV collection)
+    // meta tables/SKVSchemas in PG primary cluster(corresponding SKV collection)
     static const std::string skv_schema_name_cluster_meta;
     static const std::string skv_schema_name_database_meta;
+    static const std::string skv_schema_name_sequence_meta;
+    static const std::string skv_schema_name_purge_meta;
 
     // table/index and their column meta tables - exist in every
     static const std::string skv_schema_name_table_meta;
@@ -59,6 +61,19 @@ struct CatalogConsts {
 
     static inline int catalog_manager_background_task_thread_pool_size = 2;
 
+    // number of tables/indexes whose records are copied concurrently when creating a database from a template
+    static inline const size_t default_catalog_copy_parallelism = 8;
+
+    // number of dropped tables/indexes whose records are purged concurrently in the background
+    static inline int catalog_manager_purge_thread_pool_size = 2;
+
+    // pause between two batches of deletes when purging the records of a dropped table/index
+    static inline const int default_catalog_purge_batch_interval_ms = 10;
+
+    // time for which a process owns the purge of a dropped table/index, renewed while the purge runs. Once it is over,
+    // e.g. because the process exited, the purge is resumed by the next process which looks for pending purges
+    static inline const int default_catalog_purge_claim_ms = 60000;
+
     static const std::string& physical_collection(const std::string& database_id, bool is_shared);
 
     static bool is_on_physical_collection(const std::string& database_id, bool is_shared);
@@ -40,13 +40,19 @@ namespace catalog {
 
     SqlCatalogManager::SqlCatalogManager(std::shared_ptr<K2Adapter> k2_adapter) :
         cluster_id_(CatalogConsts::primary_cluster_id), k2_adapter_(k2_adapter),
-        thread_pool_(CatalogConsts::catalog_manager_background_task_thread_pool_size) {
+        thread_pool_(CatalogConsts::catalog_manager_background_task_thread_pool_size),
+        purge_thread_pool_(CatalogConsts::catalog_manager_purge_thread_pool_size) {
         cluster_info_handler_ = std::make_shared<ClusterInfoHandler>(k2_adapter);
         database_info_handler_ = std::make_shared<DatabaseInfoHandler>(k2_adapter);
+        sequence_info_handler_ = std::make_shared<SequenceInfoHandler>(k2_adapter);
         table_info_handler_ = std::make_shared<TableInfoHandler>(k2_adapter);
     }
 
     SqlCatalogManager::~SqlCatalogManager() {
+        // don't hold the exit until the running purges are done
+        table_info_handler_->CancelPurges();
+        // the background task may queue purges, stop it before purge_thread_pool_
+        catalog_version_task_.reset(nullptr);
     }
 
     Status SqlCatalogManager::Start() {
@@ -74,6 +80,19 @@ namespace catalog {
         // end the current transaction so that we use a different one for later operations
         ci_txnHandler->CommitTransaction();
 
+        // clusters initialized before the sequences were stored in SKV don't have their schema yet
+        InitSequenceTableResult seqresp = sequence_info_handler_->EnsureSequenceTable();
+        if (!seqresp.status.ok()) {
+            K2LOG_E(log::catalog, "Failed to check the sequence table due to {}", seqresp.status);
+            return seqresp.status;
+        }
+
+        CreateSKVSchemaResult purgeresp = table_info_handler_->EnsurePurgeMetaTable();
+        if (!purgeresp.status.ok()) {
+            K2LOG_E(log::catalog, "Failed to check the pending purge table due to {}", purgeresp.status);
+            return purgeresp.status;
+        }
+
         // load databases
         std::shared_ptr<PgTxnHandler> ns_txnHandler = NewTransaction();
         ListDatabaseResult nsresp = database_info_handler_->ListDatabases(ns_txnHandler);
@@ -100,11 +119,13 @@ namespace catalog {
         if (init_db_done_) {
             std::function<void()> catalog_version_task([this]{
                 CheckCatalogVersion();
+                ResumePendingPurges();
             });
             catalog_version_task_ = std::make_unique<SingleThreadedPeriodicTask>(catalog_version_task, "catalog-version-task",
                 CatalogConsts::catalog_manager_background_task_initial_wait,
                 CatalogConsts::catalog_manager_background_task_sleep_interval);
             catalog_version_task_->Start();
+            ResumePendingPurges();
         }
 
         initted_.store(true, std::memory_order_release);
@@ -161,6 +182,13 @@ namespace catalog {
             return initCIRes.status;
         }
 
+        // also create the SKVSchema in the primary cluster's SKVcollection for the data of all sequences
+        InitSequenceTableResult initSeqRes = sequence_info_handler_->InitSequenceTable();
+        if (!initSeqRes.status.ok()) {
+            K2LOG_E(log::catalog, "Failed to initialize creating sequence table due to {}", initSeqRes.status.code());
+            return initSeqRes.status;
+        }
+
         init_txnHandler->CommitTransaction();
 
         // step 4/4 re-start this catalog manager so it can execute other APIs
@@ -235,6 +263,7 @@ namespace catalog {
             }
             if (result.clusterInfo->GetCatalogVersion() > catalog_version_) {
                 catalog_version_.store(result.clusterInfo->GetCatalogVersion(), std::memory_order_relaxed);
+                k2_adapter_->OnCatalogVersionChange(catalog_version_);
             }
 
         }
@@ -258,9 +287,39 @@ namespace catalog {
         if (result.clusterInfo->GetCatalogVersion() > catalog_version_) {
             catalog_version_ = result.clusterInfo->GetCatalogVersion();
             K2LOG_D(log::catalog, "Updated catalog version to {}", catalog_version_);
+            k2_adapter_->OnCatalogVersionChange(catalog_version_);
         }
     }
 
+    void SqlCatalogManager::ResumePendingPurges() {
+        bool expected = false;
+        if (!purge_resume_pending_.compare_exchange_strong(expected, true)) {
+            return;
+        }
+        purge_thread_pool_.enqueue([this] () {
+            purge_resume_pending_ = false;
+            ClaimPendingPurgesResult result = table_info_handler_->ClaimPendingPurges([this] { return NewTransaction(); });
+            if (!result.status.ok()) {
+                K2LOG_W(log::catalog, "Failed to look for pending purges due to {}", result.status);
+                return;
+            }
+            // one purge per SKV table so that they run concurrently
+            for (PendingPurge& purge : result.purges) {
+                EnqueuePurges({std::move(purge)});
+            }
+        });
+    }
+
+    void SqlCatalogManager::EnqueuePurges(std::vector<PendingPurge> purges) {
+        purge_thread_pool_.enqueue([this, purges=std::move(purges)] () {
+            Status status = table_info_handler_->PurgeData(purges, [this] { return NewTransaction(); });
+            if (!status.ok()) {
+                K2LOG_W(log::catalog, "Failed to purge the data of table {} in {} due to {}", purges.front().schema_name,
+                    purges.front().collection_name, status);
+            }
+        });
+    }
+
     GetCatalogVersionResponse SqlCatalogManager::GetCatalogVersion(const GetCatalogVersionRequest& request) {
         GetCatalogVersionResponse response;
         response.catalogVersion = catalog_version_;
@@ -296,6 +355,7 @@ namespace catalog {
             return response;
         }
         txnHandler->CommitTransaction();
+        k2_adapter_->OnCatalogVersionChange(catalog_version_);
         response.version = catalog_version_;
         response.status = Status(); // OK;
         K2LOG_D(log::catalog, "Increase catalog version to {}", catalog_version_);
@@ -398,32 +458,27 @@ namespace catalog {
                 return response;
             }
             K2LOG_D(log::catalog, "Found {} table ids from source database {}", list_table_result.tableIds.size(), request.sourceDatabaseId);
-            int num_index = 0;
-            for (auto& source_table_id : list_table_result.tableIds) {
-                // copy the source table metadata to the target table
-                K2LOG_D(log::catalog, "Copying from source table {}", source_table_id);
-                CopyTableResult copy_result = table_info_handler_->CopyTable(
-                    target_txnHandler,
-                    new_ns->GetDatabaseId(),
-                    new_ns->GetDatabaseName(),
-                    new_ns->GetDatabaseOid(),
-                    source_txnHandler,
-                    source_database_info->GetDatabaseId(),
-                    source_database_info->GetDatabaseName(),
-                    source_table_id);
-                if (!copy_result.status.ok()) {
-                    K2LOG_E(log::catalog, "Failed to copy from source table {} due to {}", source_table_id, copy_result.status.code());
-                    source_txnHandler->AbortTransaction();
-                    target_txnHandler->AbortTransaction();
-                    ns_txnHandler->AbortTransaction();
-                    response.status = std::move(copy_result.status);
-                    return response;
-                }
-                num_index += copy_result.num_index;
+            // copy the source tables metadata and data to the target tables
+            CopyTablesResult copy_result = table_info_handler_->CopyTables(
+                target_txnHandler,
+                new_ns->GetDatabaseId(),
+                new_ns->GetDatabaseName(),
+                new_ns->GetDatabaseOid(),
+                source_txnHandler,
+                source_database_info->GetDatabaseId(),
+                source_database_info->GetDatabaseName(),
+                list_table_result.tableIds);
+            if (!copy_result.status.ok()) {
+                K2LOG_E(log::catalog, "Failed to copy tables from source database {} due to {}", request.sourceDatabaseId, copy_result.status.code());
+                source_txnHandler->AbortTransaction();
+                target_txnHandler->AbortTransaction();
+                ns_txnHandler->AbortTransaction();
+                response.status = std::move(copy_result.status);
+                return response;
             }
             source_txnHandler->CommitTransaction();
             K2LOG_D(log::catalog, "Finished copying {} tables and {} indexes from source database {} to {}",
-                list_table_result.tableIds.size(), num_index, source_database_info->GetDatabaseId(), new_ns->GetDatabaseId());
+                list_table_result.tableIds.size(), copy_result.num_index, source_database_info->GetDatabaseId(), new_ns->GetDatabaseId());
         }
 
         target_txnHandler->CommitTransaction();
@@ -502,7 +557,12 @@ namespace catalog {
         }
         std::shared_ptr<DatabaseInfo> database_info = result.databaseInfo;
 
-        // No need to delete table data or metadata, it will be dropped with the SKV collection
+        // No need to delete table data or metadata, it will be dropped with the SKV collection. The sequences are
+        // kept in the primary cluster's collection instead, so they are deleted separately
+        Status seq_status = sequence_info_handler_->DeleteDatabaseSequences(database_info->GetDatabaseOid());
+        if (!seq_status.ok()) {
+            K2LOG_W(log::catalog, "Failed to delete the sequences of database {} due to {}", request.databaseId, seq_status);
+        }
 
         std::shared_ptr<PgTxnHandler> ns_txnHandler = NewTransaction();
         DeleteDataseResult del_result = database_info_handler_->DeleteDatabase(ns_txnHandler, database_info);
@@ -819,26 +879,29 @@ namespace catalog {
             table_info = table_result.tableInfo;
         }
 
-        // delete indexes and the table itself
-        // delete table data
-         DeleteTableResult delete_data_result = table_info_handler_->DeleteTableData(txnHandler, database_id, table_info);
-        if (!delete_data_result.status.ok()) {
+        // delete table schema metadata, including the indexes
+        DeleteTableResult delete_metadata_result = table_info_handler_->DeleteTableMetadata(txnHandler, database_id, table_info);
+        if (!delete_metadata_result.status.ok()) {
             txnHandler->AbortTransaction();
-            response.status = std::move(delete_data_result.status);
+            response.status = std::move(delete_metadata_result.status);
             return response;
         }
 
-        // delete table schema metadata
-        DeleteTableResult delete_metadata_result = table_info_handler_->DeleteTableMetadata(txnHandler, database_id, table_info);
-        if (!delete_metadata_result.status.ok()) {
+        // the table and index records can't be reached anymore, record their purge along with the drop so that it
+        // is resumed if this process exits before its end
+        std::vector<PendingPurge> purges = table_info_handler_->GetTablePurges(database_id, table_info);
+        Status purge_status = table_info_handler_->PersistPendingPurges(txnHandler, purges);
+        if (!purge_status.ok()) {
             txnHandler->AbortTransaction();
-            response.status = std::move(delete_metadata_result.status);
+            response.status = std::move(purge_status);
             return response;
         }
 
         txnHandler->CommitTransaction();
         // clear table cache after table deletion
         ClearTableCache(table_info);
+
+        EnqueuePurges(std::move(purges));
         response.status = Status(); // OK;
         return response;
     }
@@ -892,14 +955,6 @@ namespace catalog {
             base_table_info = table_result.tableInfo;
         }
 
-        // delete index data
-        DeleteIndexResult delete_data_result = table_info_handler_->DeleteIndexData(txnHandler, database_id, table_id);
-        if (!delete_data_result.status.ok()) {
-            txnHandler->AbortTransaction();
-            response.status = std::move(delete_data_result.status);
-            return response;
-        }
-
         // delete index metadata
         DeleteIndexResult delete_metadata_result = table_info_handler_->DeleteIndexMetadata(txnHandler, database_id, table_id);
         if (!delete_metadata_result.status.ok()) {
@@ -908,7 +963,28 @@ namespace catalog {
             return response;
         }
 
+        // the index records can't be reached anymore, record their purge along with the drop so that it is resumed
+        // if this process exits before its end
+        std::vector<PendingPurge> purges;
+        const auto itr = base_table_info->secondary_indexes().find(table_id);
+        if (itr != base_table_info->secondary_indexes().end()) {
+            purges.push_back(table_info_handler_->GetIndexPurge(database_id, itr->second));
+            Status purge_status = table_info_handler_->PersistPendingPurges(txnHandler, purges);
+            if (!purge_status.ok()) {
+                txnHandler->AbortTransaction();
+                response.status = std::move(purge_status);
+                return response;
+            }
+        } else {
+            K2LOG_W(log::catalog, "Cannot find index {} in base table {}, skipping the purge of its data", table_id, base_table_info->table_id());
+        }
+
         txnHandler->CommitTransaction();
+
+        if (!purges.empty()) {
+            EnqueuePurges(std::move(purges));
+        }
+
         // remove index from the table_info object
         base_table_info->drop_index(table_id);
         // update table cache with the index removed, index cache is updated accordingly
@@ -918,6 +994,24 @@ namespace catalog {
         return response;
     }
 
+    PurgeIndexDataResponse SqlCatalogManager::PurgeIndexData(const PurgeIndexDataRequest& request) {
+        K2LOG_D(log::catalog, "Purging the data of index {} in ns {}", request.indexInfo.table_id(), request.databaseId);
+        PurgeIndexDataResponse response;
+        std::vector<PendingPurge> purges{table_info_handler_->GetIndexPurge(request.databaseId, request.indexInfo)};
+        std::shared_ptr<PgTxnHandler> txnHandler = NewTransaction();
+        Status purge_status = table_info_handler_->PersistPendingPurges(txnHandler, purges);
+        if (!purge_status.ok()) {
+            txnHandler->AbortTransaction();
+            response.status = std::move(purge_status);
+            return response;
+        }
+        response.status = txnHandler->CommitTransaction();
+        if (response.status.ok()) {
+            EnqueuePurges(std::move(purges));
+        }
+        return response;
+    }
+
     ReservePgOidsResponse SqlCatalogManager::ReservePgOid(const ReservePgOidsRequest& request) {
         ReservePgOidsResponse response;
         K2LOG_D(log::catalog, "Reserving PgOid with nextOid: {}, count: {}, for ns: {}",
@@ -92,6 +92,7 @@ and task state checking APIs later by using thread pools.
 #include "pggate/k2_thread_pool.h"
 #include "pggate/catalog/sql_catalog_defaults.h"
 #include "pggate/catalog/cluster_info_handler.h"
+#include "pggate/catalog/sequence_info_handler.h"
 #include "pggate/catalog/database_info_handler.h"
 #include "pggate/catalog/table_info_handler.h"
 #include "pggate/catalog/background_task.h"
@@ -240,6 +241,15 @@ namespace catalog {
         uint32_t baseIndexTableOid;
     };
 
+    struct PurgeIndexDataRequest {
+        std::string databaseId;
+        IndexInfo indexInfo;
+    };
+
+    struct PurgeIndexDataResponse {
+        Status status;
+    };
+
     struct ReservePgOidsRequest {
         std::string databaseId;
         uint32_t nextOid;
@@ -309,6 +319,10 @@ namespace catalog {
 
         DeleteIndexResponse DeleteIndex(const DeleteIndexRequest& request);
 
+        // Purges the records of an index while keeping its metadata, e.g. the rows backfilled by a CREATE INDEX whose
+        // transaction is aborted. The purge is persisted first, so it is resumed if this process exits before its end
+        PurgeIndexDataResponse PurgeIndexData(const PurgeIndexDataRequest& request);
+
         ReservePgOidsResponse ReservePgOid(const ReservePgOidsRequest& request);
 
     protected:
@@ -351,6 +365,13 @@ namespace catalog {
 
         void CheckCatalogVersion();
 
+        // Claims the pending purges of dropped tables/indexes which no process is running, e.g. because the process
+        // which dropped them exited before their end, and runs them in purge_thread_pool_
+        void ResumePendingPurges();
+
+        // Purges the records of the given SKV tables in purge_thread_pool_
+        void EnqueuePurges(std::vector<PendingPurge> purges);
+
     private:
         // cluster identifier
         std::string cluster_id_;
@@ -373,6 +394,9 @@ namespace catalog {
         // and it is a shared table across all databases
         std::shared_ptr<DatabaseInfoHandler> database_info_handler_;
 
+        // handler to access the sequence data, which is a shared table across all databases
+        std::shared_ptr<SequenceInfoHandler> sequence_info_handler_;
+
         // handler to access table and index information
         std::shared_ptr<TableInfoHandler> table_info_handler_;
 
@@ -394,6 +418,14 @@ namespace catalog {
 
         // background task
         std::unique_ptr<SingleThreadedPeriodicTask> catalog_version_task_ = nullptr;
+
+        // set while a ResumePendingPurges() is queued, so that the background task doesn't pile them up
+        std::atomic<bool> purge_resume_pending_{false};
+
+        // thread pool to purge the records of dropped tables and indexes, declared last so that it is stopped first.
+        // A purge that is cancelled or still queued when the process exits is resumed by another process once its
+        // claim is over, see TableInfoHandler::ClaimPendingPurges()
+        ThreadPool purge_thread_pool_;
     };
 
 } // namespace catalog
@@ -23,7 +23,11 @@ Copyright(c) 2020 Futurewei Cloud
 
 #include "pggate/catalog/table_info_handler.h"
 
+#include <algorithm>
+#include <chrono>
+#include <list>
 #include <stdexcept>
+#include <thread>
 
 namespace k2pg {
 namespace sql {
@@ -34,7 +38,12 @@ TableInfoHandler::TableInfoHandler(std::shared_ptr<K2Adapter> k2_adapter)
     table_meta_SKVSchema_ = std::make_shared<k2::dto::Schema>(skv_schema_table_meta);
     tablecolumn_meta_SKVSchema_ = std::make_shared<k2::dto::Schema>(skv_schema_tablecolumn_meta);
     indexcolumn_meta_SKVSchema_ = std::make_shared<k2::dto::Schema>(skv_schema_indexcolumn_meta);
+    purge_meta_SKVSchema_ = std::make_shared<k2::dto::Schema>(skv_schema_purge_meta);
     k2_adapter_ = k2_adapter;
+    k2pg::gate::Config conf;
+    copy_parallelism_ = std::max<size_t>(1, conf.get("catalog_copy_parallelism", CatalogConsts::default_catalog_copy_parallelism));
+    purge_batch_interval_ = std::chrono::milliseconds(conf.get("catalog_purge_batch_interval_ms", CatalogConsts::default_catalog_purge_batch_interval_ms));
+    purge_claim_duration_ = std::chrono::milliseconds(conf.get("catalog_purge_claim_ms", CatalogConsts::default_catalog_purge_claim_ms));
 }
 
 TableInfoHandler::~TableInfoHandler() {
@@ -241,6 +250,57 @@ CopyTableResult TableInfoHandler::CopyTable(std::shared_ptr<PgTxnHandler> target
             const std::string& source_coll_name,
             const std::string& source_database_name,
             const std::string& source_table_id) {
+    std::vector<CopySKVTableRequest> copy_requests;
+    CopyTableResult response = CopyTableMeta(target_txnHandler, target_coll_name, target_database_name, target_database_oid,
+            source_txnHandler, source_coll_name, source_database_name, source_table_id, copy_requests);
+    if (!response.status.ok()) {
+        return response;
+    }
+
+    CopySKVTableResult copy_skv_result = CopySKVTables(target_txnHandler, target_coll_name, source_txnHandler, source_coll_name, copy_requests);
+    if (!copy_skv_result.status.ok()) {
+        response.status = std::move(copy_skv_result.status);
+        response.tableInfo = nullptr;
+    }
+    return response;
+}
+
+CopyTablesResult TableInfoHandler::CopyTables(std::shared_ptr<PgTxnHandler> target_txnHandler,
+            const std::string& target_coll_name,
+            const std::string& target_database_name,
+            uint32_t target_database_oid,
+            std::shared_ptr<PgTxnHandler> source_txnHandler,
+            const std::string& source_coll_name,
+            const std::string& source_database_name,
+            const std::vector<std::string>& source_table_ids) {
+    CopyTablesResult response;
+    std::vector<CopySKVTableRequest> copy_requests;
+    for (auto& source_table_id : source_table_ids) {
+        K2LOG_D(log::catalog, "Copying from source table {}", source_table_id);
+        CopyTableResult copy_result = CopyTableMeta(target_txnHandler, target_coll_name, target_database_name, target_database_oid,
+                source_txnHandler, source_coll_name, source_database_name, source_table_id, copy_requests);
+        if (!copy_result.status.ok()) {
+            K2LOG_E(log::catalog, "Failed to copy from source table {} due to {}", source_table_id, copy_result.status.code());
+            response.status = std::move(copy_result.status);
+            return response;
+        }
+        response.num_index += copy_result.num_index;
+    }
+
+    CopySKVTableResult copy_skv_result = CopySKVTables(target_txnHandler, target_coll_name, source_txnHandler, source_coll_name, copy_requests);
+    response.status = std::move(copy_skv_result.status);
+    return response;
+}
+
+CopyTableResult TableInfoHandler::CopyTableMeta(std::shared_ptr<PgTxnHandler> target_txnHandler,
+            const std::string& target_coll_name,
+            const std::string& target_database_name,
+            uint32_t target_database_oid,
+            std::shared_ptr<PgTxnHandler> source_txnHandler,
+            const std::string& source_coll_name,
+            const std::string& source_database_name,
+            const std::string& source_table_id,
+            std::vector<CopySKVTableRequest>& copy_requests) {
     CopyTableResult response;
     try {
         GetTableResult table_result = GetTable(source_txnHandler, source_coll_name, source_database_name, source_table_id);
@@ -262,7 +322,7 @@ CopyTableResult TableInfoHandler::CopyTable(std::shared_ptr<PgTxnHandler> target
             return response;
         }
 
-        // step 2/2 copy all data rows (when the table is not a shared table across databases)
+        // step 2/2 schedule the copy of all data rows (when the table is not a shared table across databases)
         if(source_table->is_shared()) {  // skip data copy if it is shared
             K2LOG_D(log::catalog, "Skip copying shared table {} in {}", source_table_id, source_coll_name);
             if(source_table->has_secondary_indexes()) {
@@ -273,19 +333,20 @@ CopyTableResult TableInfoHandler::CopyTable(std::shared_ptr<PgTxnHandler> target
                 }
             }
         } else {  // copy all base table and index rows(SKV record in K2)
-            CopySKVTableResult copy_skv_table_result = CopySKVTable(target_txnHandler, target_coll_name, target_table->table_id(), target_table->schema().version(),
-                source_txnHandler, source_coll_name, source_table_id, source_table->schema().version(), source_table_oid, 0 /*index_oid*/);
-            if (!copy_skv_table_result.status.ok()) {
-                response.status = std::move(copy_skv_table_result.status);
-                return response;
-            }
+            copy_requests.push_back(CopySKVTableRequest{
+                .target_schema_name = target_table->table_id(),
+                .target_schema_version = target_table->schema().version(),
+                .source_schema_name = source_table_id,
+                .source_schema_version = source_table->schema().version(),
+                .source_table_oid = source_table_oid,
+                .source_index_oid = 0});
 
             if(source_table->has_secondary_indexes()) {
-                std::unordered_map<std::string, IndexInfo*> target_index_name_map;
-                for (std::pair<TableId, IndexInfo> secondary_index : target_table->secondary_indexes()) {
+                std::unordered_map<std::string, const IndexInfo*> target_index_name_map;
+                for (const auto& secondary_index : target_table->secondary_indexes()) {
                     target_index_name_map[secondary_index.second.table_name()] = &secondary_index.second;
                 }
-                for (std::pair<TableId, IndexInfo> secondary_index : source_table->secondary_indexes()) {
+                for (const auto& secondary_index : source_table->secondary_indexes()) {
                     K2ASSERT(log::catalog, !secondary_index.second.is_shared(), "Index for a non-shared table must not be shared");
                     // search for target index by name
                     auto found = target_index_name_map.find(secondary_index.second.table_name());
@@ -293,19 +354,20 @@ CopyTableResult TableInfoHandler::CopyTable(std::shared_ptr<PgTxnHandler> target
                         response.status = STATUS_FORMAT(NotFound, "Cannot find target index {}", secondary_index.second.table_name());
                         return response;
                     }
-                    IndexInfo* target_index = found->second;
-                    CopySKVTableResult copy_skv_index_result = CopySKVTable(target_txnHandler, target_coll_name, secondary_index.first, secondary_index.second.version(),
-                        source_txnHandler, source_coll_name, target_index->table_id(), target_index->version(), source_table_oid/*baseTableId*/, target_index->table_oid()/*index_oid, should be source, but same as target index oid*/);
-                    if (!copy_skv_index_result.status.ok()) {
-                        response.status = std::move(copy_skv_index_result.status);
-                        return response;
-                    }
+                    const IndexInfo* target_index = found->second;
+                    copy_requests.push_back(CopySKVTableRequest{
+                        .target_schema_name = target_index->table_id(),
+                        .target_schema_version = target_index->version(),
+                        .source_schema_name = secondary_index.first,
+                        .source_schema_version = secondary_index.second.version(),
+                        .source_table_oid = source_table_oid, /*baseTableId*/
+                        .source_index_oid = secondary_index.second.table_oid()});
                     response.num_index++;
                 }
             }
         }
 
-        K2LOG_D(log::catalog, "Copied table from {} in {} to {} in {}", source_table_id, source_coll_name, target_table->table_id(), target_coll_name);
+        K2LOG_D(log::catalog, "Copied table meta from {} in {} to {} in {}", source_table_id, source_coll_name, target_table->table_id(), target_coll_name);
         response.tableInfo = target_table;
         response.status = Status(); // OK
     } catch (const std::exception& e) {
@@ -314,72 +376,135 @@ CopyTableResult TableInfoHandler::CopyTable(std::shared_ptr<PgTxnHandler> target
     return response;
 }
 
-CopySKVTableResult TableInfoHandler::CopySKVTable(std::shared_ptr<PgTxnHandler> target_txnHandler,
+CopySKVTableResult TableInfoHandler::CopySKVTables(std::shared_ptr<PgTxnHandler> target_txnHandler,
             const std::string& target_coll_name,
-            const std::string& target_schema_name,
-            uint32_t target_version,
             std::shared_ptr<PgTxnHandler> source_txnHandler,
             const std::string& source_coll_name,
-            const std::string& source_schema_name,
-            uint32_t source_version,
-            PgOid source_table_oid,
-            PgOid source_index_oid) {
+            const std::vector<CopySKVTableRequest>& requests) {
+    // an SKV table being copied, with the scan for its next page in flight
+    struct CopyState {
+        const CopySKVTableRequest* request;
+        std::shared_ptr<k2::dto::Schema> target_schema;
+        std::shared_ptr<k2::Query> query;
+        k2pg::gate::CBFuture<k2::QueryResult> scan;
+        int count = 0;
+    };
+
     CopySKVTableResult response;
-    // check target SKV schema
-    auto target_result = k2_adapter_->GetSchema(target_coll_name, target_schema_name, target_version).get();
-    if (!target_result.status.is2xxOK()) {
-        K2LOG_E(log::catalog, "Failed to get SKV schema for table {} in {} with version {} due to {}",
-            target_schema_name, target_coll_name, target_version,target_result.status);
-        response.status = K2Adapter::K2StatusToK2PgStatus(target_result.status);
+    std::list<CopyState> active;
+
+    // wait for all the outstanding scans before returning an error so that nothing is left running against the txns
+    auto fail = [&active, &response](Status&& status) {
+        for (CopyState& state : active) {
+            try {
+                state.scan.get();
+            } catch (const std::exception& e) {
+                K2LOG_W(log::catalog, "Ignoring scan failure for {} after copy failure: {}", state.request->source_schema_name, e.what());
+            }
+        }
+        response.status = std::move(status);
         return response;
-    }
+    };
 
-    // check the source SKV schema
-    auto source_result = k2_adapter_->GetSchema(source_coll_name, source_schema_name, source_version).get();
-    if (!source_result.status.is2xxOK()) {
-        K2LOG_E(log::catalog, "Failed to get SKV schema for table {} in {} with version {} due to {}",
-            source_schema_name, source_coll_name, source_version, source_result.status);
-        response.status = K2Adapter::K2StatusToK2PgStatus(source_result.status);
-        return response;
-    }
+    size_t next = 0;
+    try {
+        while (next < requests.size() || !active.empty()) {
+            // start copying more tables until we have enough in flight
+            while (active.size() < copy_parallelism_ && next < requests.size()) {
+                const CopySKVTableRequest& request = requests[next++];
+                // check target SKV schema
+                auto target_result = k2_adapter_->GetSchema(target_coll_name, request.target_schema_name, request.target_schema_version).get();
+                if (!target_result.status.is2xxOK()) {
+                    K2LOG_E(log::catalog, "Failed to get SKV schema for table {} in {} with version {} due to {}",
+                        request.target_schema_name, target_coll_name, request.target_schema_version, target_result.status);
+                    return fail(K2Adapter::K2StatusToK2PgStatus(target_result.status));
+                }
 
-    // create scan for source table
-    CreateScanReadResult create_source_scan_result = k2_adapter_->CreateScanRead(source_coll_name, source_result.schema->name).get();
-    if (!create_source_scan_result.status.is2xxOK()) {
-        K2LOG_E(log::catalog, "Failed to create scan read for {} in {} due to {}", source_schema_name, source_coll_name, create_source_scan_result.status.message);
-        response.status = K2Adapter::K2StatusToK2PgStatus(create_source_scan_result.status);
-        return response;
-    }
+                // check the source SKV schema
+                auto source_result = k2_adapter_->GetSchema(source_coll_name, request.source_schema_name, request.source_schema_version).get();
+                if (!source_result.status.is2xxOK()) {
+                    K2LOG_E(log::catalog, "Failed to get SKV schema for table {} in {} with version {} due to {}",
+                        request.source_schema_name, source_coll_name, request.source_schema_version, source_result.status);
+                    return fail(K2Adapter::K2StatusToK2PgStatus(source_result.status));
+                }
 
-    // scan the source table
-    std::shared_ptr<k2::Query> query = create_source_scan_result.query;
-    query->startScanRecord = buildRangeRecord(source_coll_name, source_result.schema, source_table_oid, source_index_oid, std::nullopt);
-    query->endScanRecord = buildRangeRecord(source_coll_name, source_result.schema, source_table_oid, source_index_oid, std::nullopt);
-    int count = 0;
-    do {
-        auto query_result = k2_adapter_->ScanRead(source_txnHandler->GetTxn(), query).get();
-        if (!query_result.status.is2xxOK()) {
-            K2LOG_E(log::catalog, "Failed to run scan read for table {} in {} due to {}",
-                source_schema_name, source_coll_name, query_result.status);
-            response.status = K2Adapter::K2StatusToK2PgStatus(query_result.status);
-            return response;
-        }
+                // create scan for source table
+                CreateScanReadResult create_source_scan_result = k2_adapter_->CreateScanRead(source_coll_name, source_result.schema->name).get();
+                if (!create_source_scan_result.status.is2xxOK()) {
+                    K2LOG_E(log::catalog, "Failed to create scan read for {} in {} due to {}", request.source_schema_name, source_coll_name, create_source_scan_result.status.message);
+                    return fail(K2Adapter::K2StatusToK2PgStatus(create_source_scan_result.status));
+                }
 
-        for (k2::dto::SKVRecord& record : query_result.records) {
-            // clone and persist SKV record to target table
-            k2::dto::SKVRecord target_record = record.cloneToOtherSchema(target_coll_name, target_result.schema);
-            auto upsertRes = k2_adapter_->UpsertRecord(target_txnHandler->GetTxn(), target_record).get();
-            if (!upsertRes.status.is2xxOK())
-            {
-                K2LOG_E(log::catalog, "Failed to upsert target_record due to {}", upsertRes.status);
-                response.status = K2Adapter::K2StatusToK2PgStatus(upsertRes.status);
-                return response;
+                // scan the source table
+                std::shared_ptr<k2::Query> query = create_source_scan_result.query;
+                query->startScanRecord = buildRangeRecord(source_coll_name, source_result.schema, request.source_table_oid, request.source_index_oid, std::nullopt);
+                query->endScanRecord = buildRangeRecord(source_coll_name, source_result.schema, request.source_table_oid, request.source_index_oid, std::nullopt);
+                active.push_back(CopyState{.request = &request, .target_schema = target_result.schema, .query = query,
+                    .scan = k2_adapter_->ScanRead(source_txnHandler->GetTxn(), query)});
+            }
+
+            // move every table in flight forward by one page
+            for (auto it = active.begin(); it != active.end();) {
+                CopyState& state = *it;
+                auto query_result = state.scan.get();
+                if (!query_result.status.is2xxOK()) {
+                    K2LOG_E(log::catalog, "Failed to run scan read for table {} in {} due to {}",
+                        state.request->source_schema_name, source_coll_name, query_result.status);
+                    active.erase(it);
+                    return fail(K2Adapter::K2StatusToK2PgStatus(query_result.status));
+                }
+
+                // clone and persist all SKV records of the page to target table without waiting for each write
+                std::vector<k2pg::gate::CBFuture<k2::WriteResult>> writes;
+                writes.reserve(query_result.records.size());
+                for (k2::dto::SKVRecord& record : query_result.records) {
+                    k2::dto::SKVRecord target_record = record.cloneToOtherSchema(target_coll_name, state.target_schema);
+                    writes.push_back(k2_adapter_->UpsertRecord(target_txnHandler->GetTxn(), target_record));
+                }
+                state.count += query_result.records.size();
+
+                // if the query is not done, the query itself is updated with the pagination token for the next call,
+                // which we issue right away so that the next page is read while the writes are in flight
+                bool done = state.query->isDone();
+                if (!done) {
+                    state.scan = k2_adapter_->ScanRead(source_txnHandler->GetTxn(), state.query);
+                }
+
+                Status write_status;
+                for (auto& write : writes) {
+                    // keep waiting for all the writes even after a failure
+                    try {
+                        auto upsertRes = write.get();
+                        if (!upsertRes.status.is2xxOK() && write_status.ok()) {
+                            K2LOG_E(log::catalog, "Failed to upsert target_record due to {}", upsertRes.status);
+                            write_status = K2Adapter::K2StatusToK2PgStatus(upsertRes.status);
+                        }
+                    } catch (const std::exception& e) {
+                        if (write_status.ok()) {
+                            write_status = STATUS_FORMAT(RuntimeError, "{}", e.what());
+                        }
+                    }
+                }
+                if (!write_status.ok()) {
+                    if (done) {
+                        active.erase(it);
+                    }
+                    return fail(std::move(write_status));
+                }
+
+                if (done) {
+                    K2LOG_I(log::catalog, "Finished copying {} in {} to {} in {} with {} records", state.request->source_schema_name, source_coll_name,
+                        state.request->target_schema_name, target_coll_name, state.count);
+                    it = active.erase(it);
+                } else {
+                    ++it;
+                }
             }
-            count++;
         }
-        // if the query is not done, the query itself is updated with the pagination token for the next call
-    } while (!query->isDone());
-    K2LOG_I(log::catalog, "Finished copying {} in {} to {} in {} with {} records", source_schema_name, source_coll_name, target_schema_name, target_coll_name, count);
+    } catch (const std::exception& e) {
+        return fail(STATUS_FORMAT(RuntimeError, "{}", e.what()));
+    }
+
     response.status = Status(); // OK
     return response;
 }
@@ -600,18 +725,19 @@ DeleteTableResult TableInfoHandler::DeleteTableMetadata(std::shared_ptr<PgTxnHan
     return response;
 }
 
-// Delete the actual table records from SKV that are stored with the SKV schema name to be table_id as in table_info
-DeleteTableResult TableInfoHandler::DeleteTableData(std::shared_ptr<PgTxnHandler> txnHandler, const std::string& collection_name, std::shared_ptr<TableInfo> table) {
-    DeleteTableResult response;
-    try {
-        // TODO: add a task to delete the actual data from SKV
-
-        response.status = Status(); // OK
-    }
-    catch (const std::exception& e) {
-		response.status = STATUS_FORMAT(RuntimeError, "{}", e.what());
+std::vector<PendingPurge> TableInfoHandler::GetTablePurges(const std::string& collection_name, std::shared_ptr<TableInfo> table) {
+    const std::string& data_coll_name = CatalogConsts::physical_collection(collection_name, table->is_shared());
+    std::vector<PendingPurge> purges;
+    purges.push_back(PendingPurge{data_coll_name, table->table_id(), table->schema().version(), table->table_oid(), 0 /*index_oid*/});
+    for (const auto& pair : table->secondary_indexes()) {
+        purges.push_back(GetIndexPurge(collection_name, pair.second));
     }
-    return response;
+    return purges;
+}
+
+PendingPurge TableInfoHandler::GetIndexPurge(const std::string& collection_name, const IndexInfo& index_info) {
+    const std::string& data_coll_name = CatalogConsts::physical_collection(collection_name, index_info.is_shared());
+    return PendingPurge{data_coll_name, index_info.table_id(), index_info.version(), index_info.base_table_oid(), index_info.table_oid()};
 }
 
 // Delete index_info from tablemeta and indexcolumnmeta tables
@@ -653,20 +779,186 @@ DeleteIndexResult TableInfoHandler::DeleteIndexMetadata(std::shared_ptr<PgTxnHan
     return response;
 }
 
-// Delete the actual index records from SKV that are stored with the SKV schema name to be table_id as in index_info
-DeleteIndexResult TableInfoHandler::DeleteIndexData(std::shared_ptr<PgTxnHandler> txnHandler, const std::string& collection_name, const std::string& index_id) {
-    DeleteIndexResult response;
-    try {
-        // TODO: add a task to delete the actual data from SKV
+CreateSKVSchemaResult TableInfoHandler::EnsurePurgeMetaTable() {
+    CreateSKVSchemaResult response;
+    const std::string& collection_name = CatalogConsts::skv_collection_name_primary_cluster;
+    auto schema_result = k2_adapter_->GetSchema(collection_name, purge_meta_SKVSchema_->name, purge_meta_SKVSchema_->version).get();
+    if (schema_result.status.is2xxOK()) {
+        response.status = Status(); // OK
+        return response;
+    }
+
+    response.status = K2Adapter::K2StatusToK2PgStatus(schema_result.status);
+    if (!response.status.IsNotFound()) {
+        K2LOG_E(log::catalog, "Failed to get schema {} in {}, due to {}", purge_meta_SKVSchema_->name, collection_name, schema_result.status);
+        return response;
+    }
 
+    K2LOG_I(log::catalog, "Creating missing schema {} in {}", purge_meta_SKVSchema_->name, collection_name);
+    auto create_result = k2_adapter_->CreateSchema(collection_name, purge_meta_SKVSchema_).get();
+    if (create_result.status.is2xxOK()) {
         response.status = Status(); // OK
+        return response;
     }
-    catch (const std::exception& e) {
-		response.status = STATUS_FORMAT(RuntimeError, "{}", e.what());
+
+    // another process may have created it at the same time
+    schema_result = k2_adapter_->GetSchema(collection_name, purge_meta_SKVSchema_->name, purge_meta_SKVSchema_->version).get();
+    if (schema_result.status.is2xxOK()) {
+        response.status = Status(); // OK
+    } else {
+        K2LOG_E(log::catalog, "Failed to create schema {} in {}, due to {}", purge_meta_SKVSchema_->name, collection_name, create_result.status);
+        response.status = K2Adapter::K2StatusToK2PgStatus(create_result.status);
+    }
+    return response;
+}
+
+Status TableInfoHandler::PersistPendingPurges(std::shared_ptr<PgTxnHandler> txnHandler, const std::vector<PendingPurge>& purges) {
+    for (const PendingPurge& purge : purges) {
+        k2::dto::SKVRecord record = MakePurgeRecord(purge, PurgeClaimDeadline());
+        auto upsert_result = k2_adapter_->UpsertRecord(txnHandler->GetTxn(), record).get();
+        if (!upsert_result.status.is2xxOK()) {
+            K2LOG_E(log::catalog, "Failed to persist the purge of table {} in {} due to {}", purge.schema_name, purge.collection_name, upsert_result.status);
+            return K2Adapter::K2StatusToK2PgStatus(upsert_result.status);
+        }
+    }
+    return Status::OK();
+}
+
+ClaimPendingPurgesResult TableInfoHandler::ClaimPendingPurges(std::function<std::shared_ptr<PgTxnHandler>()> fnc_tx) {
+    ClaimPendingPurgesResult response;
+    const std::string& collection_name = CatalogConsts::skv_collection_name_primary_cluster;
+    CreateScanReadResult create_scan_result = k2_adapter_->CreateScanRead(collection_name, purge_meta_SKVSchema_->name).get();
+    if (!create_scan_result.status.is2xxOK()) {
+        K2LOG_E(log::catalog, "Failed to create scan read for {} in {} due to {}", purge_meta_SKVSchema_->name, collection_name, create_scan_result.status);
+        response.status = K2Adapter::K2StatusToK2PgStatus(create_scan_result.status);
+        return response;
+    }
+
+    // pending purges are few and short lived, read them all before claiming any
+    std::vector<PendingPurge> expired;
+    std::shared_ptr<PgTxnHandler> scan_txnHandler = fnc_tx();
+    std::shared_ptr<k2::Query> query = create_scan_result.query;
+    int64_t now = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+    do {
+        auto query_result = k2_adapter_->ScanRead(scan_txnHandler->GetTxn(), query).get();
+        if (!query_result.status.is2xxOK()) {
+            K2LOG_E(log::catalog, "Failed to run scan read for {} in {} due to {}", purge_meta_SKVSchema_->name, collection_name, query_result.status);
+            scan_txnHandler->AbortTransaction();
+            response.status = K2Adapter::K2StatusToK2PgStatus(query_result.status);
+            return response;
+        }
+
+        for (k2::dto::SKVRecord& record : query_result.records) {
+            if (record.deserializeField<int64_t>("ClaimedUntil").value_or(0) > now) {
+                continue;
+            }
+            expired.push_back(PendingPurge{
+                record.deserializeField<k2::String>("CollectionName").value(),
+                record.deserializeField<k2::String>("SchemaName").value(),
+                static_cast<uint32_t>(record.deserializeField<int64_t>("SchemaVersion").value()),
+                static_cast<PgOid>(record.deserializeField<int64_t>("TableOid").value()),
+                static_cast<PgOid>(record.deserializeField<int64_t>("IndexOid").value())});
+        }
+        // if the query is not done, the query itself is updated with the pagination token for the next call
+    } while (!query->isDone());
+    scan_txnHandler->CommitTransaction();
+
+    for (const PendingPurge& purge : expired) {
+        std::shared_ptr<PgTxnHandler> txnHandler = fnc_tx();
+        // read it again, it may have been claimed or done by another process since the scan
+        k2::dto::SKVRecord key = MakePurgeRecord(purge, std::nullopt);
+        auto read_result = k2_adapter_->ReadRecord(txnHandler->GetTxn(), key).get();
+        if (!read_result.status.is2xxOK() || read_result.value.deserializeField<int64_t>("ClaimedUntil").value_or(0) > now) {
+            txnHandler->AbortTransaction();
+            continue;
+        }
+
+        k2::dto::SKVRecord record = MakePurgeRecord(purge, PurgeClaimDeadline());
+        auto upsert_result = k2_adapter_->UpsertRecord(txnHandler->GetTxn(), record).get();
+        if (!upsert_result.status.is2xxOK()) {
+            // e.g. a conflict with a process which claimed it at the same time
+            K2LOG_D(log::catalog, "Failed to claim the purge of table {} in {} due to {}", purge.schema_name, purge.collection_name, upsert_result.status);
+            txnHandler->AbortTransaction();
+            continue;
+        }
+        if (txnHandler->CommitTransaction().ok()) {
+            K2LOG_I(log::catalog, "Resuming the purge of table {} in {}", purge.schema_name, purge.collection_name);
+            response.purges.push_back(purge);
+        }
     }
+
+    response.status = Status(); // OK
     return response;
 }
 
+Status TableInfoHandler::PurgeData(const std::vector<PendingPurge>& purges, std::function<std::shared_ptr<PgTxnHandler>()> fnc_tx) {
+    for (const PendingPurge& purge : purges) {
+        Status status;
+        try {
+            status = PurgeSKVTable(purge, fnc_tx);
+        }
+        catch (const std::exception& e) {
+            status = STATUS_FORMAT(RuntimeError, "{}", e.what());
+        }
+        if (!status.ok()) {
+            return status;
+        }
+
+        std::shared_ptr<PgTxnHandler> txnHandler = fnc_tx();
+        k2::dto::SKVRecord record = MakePurgeRecord(purge, std::nullopt);
+        auto delete_result = k2_adapter_->DeleteRecord(txnHandler->GetTxn(), record).get();
+        if (!delete_result.status.is2xxOK()) {
+            // the purge is done again once its claim is over, which finds nothing left to delete
+            K2LOG_W(log::catalog, "Failed to delete the pending purge of table {} in {} due to {}", purge.schema_name, purge.collection_name, delete_result.status);
+            txnHandler->AbortTransaction();
+            continue;
+        }
+        txnHandler->CommitTransaction();
+    }
+    return Status::OK();
+}
+
+Status TableInfoHandler::RenewPurgeClaim(const PendingPurge& purge, std::function<std::shared_ptr<PgTxnHandler>()> fnc_tx) {
+    std::shared_ptr<PgTxnHandler> txnHandler = fnc_tx();
+    k2::dto::SKVRecord key = MakePurgeRecord(purge, std::nullopt);
+    auto read_result = k2_adapter_->ReadRecord(txnHandler->GetTxn(), key).get();
+    if (!read_result.status.is2xxOK()) {
+        txnHandler->AbortTransaction();
+        Status status = K2Adapter::K2StatusToK2PgStatus(read_result.status);
+        // the record of a purge which was resumed and finished by another process is gone
+        return status.IsNotFound() ? Status::OK() : status;
+    }
+
+    k2::dto::SKVRecord record = MakePurgeRecord(purge, PurgeClaimDeadline());
+    auto upsert_result = k2_adapter_->UpsertRecord(txnHandler->GetTxn(), record).get();
+    if (!upsert_result.status.is2xxOK()) {
+        txnHandler->AbortTransaction();
+        return K2Adapter::K2StatusToK2PgStatus(upsert_result.status);
+    }
+    return txnHandler->CommitTransaction();
+}
+
+k2::dto::SKVRecord TableInfoHandler::MakePurgeRecord(const PendingPurge& purge, std::optional<int64_t> claimed_until) {
+    k2::dto::SKVRecord record(CatalogConsts::skv_collection_name_primary_cluster, purge_meta_SKVSchema_);
+    record.serializeNext<k2::String>(purge.collection_name);
+    record.serializeNext<k2::String>(purge.schema_name);
+    // use int64_t to represent uint32_t since since SKV does not support them
+    record.serializeNext<int64_t>(purge.schema_version);
+    record.serializeNext<int64_t>(purge.table_oid);
+    record.serializeNext<int64_t>(purge.index_oid);
+    if (claimed_until) {
+        record.serializeNext<int64_t>(*claimed_until);
+    } else {
+        record.serializeNull();
+    }
+    return record;
+}
+
+int64_t TableInfoHandler::PurgeClaimDeadline() {
+    auto deadline = std::chrono::system_clock::now() + purge_claim_duration_;
+    return std::chrono::duration_cast<std::chrono::milliseconds>(deadline.time_since_epoch()).count();
+}
+
 GetBaseTableIdResult TableInfoHandler::GetBaseTableId(std::shared_ptr<PgTxnHandler> txnHandler, const std::string& collection_name, const std::string& index_id) {
     GetBaseTableIdResult response;
     try {
@@ -805,10 +1097,8 @@ CreateIndexTableResult TableInfoHandler::CreateIndexTable(std::shared_ptr<PgTxnH
         // update the base table with the new index
         base_table_info->add_secondary_index(new_index_info.table_id(), new_index_info);
 
-        if (!index_params.skip_index_backfill) {
-            // TODO: add logic to backfill the index
-            K2LOG_W(log::catalog, "Index backfill is not supported yet");
-        }
+        // the index is filled by PG when it builds the index, in the same transaction as the rest of the CREATE INDEX,
+        // see PgSession::BackfillIndex()
 
         result.status = Status();
         result.indexInfo = std::make_shared<IndexInfo>(new_index_info);
@@ -1549,6 +1839,100 @@ IndexInfo TableInfoHandler::BuildIndexInfo(std::shared_ptr<PgTxnHandler> txnHand
     return index_info;
 }
 
+Status TableInfoHandler::PurgeSKVTable(const PendingPurge& purge, std::function<std::shared_ptr<PgTxnHandler>()> fnc_tx) {
+    const std::string& collection_name = purge.collection_name;
+    const std::string& schema_name = purge.schema_name;
+    auto schema_result = k2_adapter_->GetSchema(collection_name, schema_name, purge.schema_version).get();
+    if (!schema_result.status.is2xxOK()) {
+        Status status = K2Adapter::K2StatusToK2PgStatus(schema_result.status);
+        if (status.IsNotFound()) {
+            // the SKV table was never created, so there is nothing to purge
+            return Status::OK();
+        }
+        K2LOG_E(log::catalog, "Failed to get SKV schema for table {} in {} with version {} due to {}",
+            schema_name, collection_name, purge.schema_version, schema_result.status);
+        return status;
+    }
+
+    CreateScanReadResult create_scan_result = k2_adapter_->CreateScanRead(collection_name, schema_name).get();
+    if (!create_scan_result.status.is2xxOK()) {
+        K2LOG_E(log::catalog, "Failed to create scan read for {} in {} due to {}", schema_name, collection_name, create_scan_result.status.message);
+        return K2Adapter::K2StatusToK2PgStatus(create_scan_result.status);
+    }
+
+    std::shared_ptr<PgTxnHandler> scan_txnHandler = fnc_tx();
+    std::shared_ptr<k2::Query> query = create_scan_result.query;
+    query->startScanRecord = buildRangeRecord(collection_name, schema_result.schema, purge.table_oid, purge.index_oid, std::nullopt);
+    query->endScanRecord = buildRangeRecord(collection_name, schema_result.schema, purge.table_oid, purge.index_oid, std::nullopt);
+    auto scan = k2_adapter_->ScanRead(scan_txnHandler->GetTxn(), query);
+    bool scan_pending = true;
+    uint64_t count = 0;
+    auto claim_renewed = k2::Clock::now();
+    Status status;
+    while (status.ok() && scan_pending) {
+        if (purge_cancelled_) {
+            // the rest is purged by the process which resumes it once the claim of this one is over
+            status = STATUS(Aborted, "purge cancelled");
+            break;
+        }
+        auto query_result = scan.get();
+        scan_pending = false;
+        if (!query_result.status.is2xxOK()) {
+            K2LOG_E(log::catalog, "Failed to run scan read for table {} in {} due to {}", schema_name, collection_name, query_result.status);
+            status = K2Adapter::K2StatusToK2PgStatus(query_result.status);
+            break;
+        }
+
+        // read the next page while the records of this one are deleted
+        if (!query->isDone()) {
+            scan = k2_adapter_->ScanRead(scan_txnHandler->GetTxn(), query);
+            scan_pending = true;
+        }
+
+        std::shared_ptr<PgTxnHandler> txnHandler = fnc_tx();
+        std::vector<k2pg::gate::CBFuture<k2::WriteResult>> deletes;
+        deletes.reserve(query_result.records.size());
+        for (k2::dto::SKVRecord& record : query_result.records) {
+            deletes.push_back(k2_adapter_->DeleteRecord(txnHandler->GetTxn(), record));
+        }
+        for (auto& del : deletes) {
+            // keep waiting for all the deletes even after a failure
+            auto delete_result = del.get();
+            if (!delete_result.status.is2xxOK() && status.ok()) {
+                K2LOG_E(log::catalog, "Failed to delete record of table {} in {} due to {}", schema_name, collection_name, delete_result.status);
+                status = K2Adapter::K2StatusToK2PgStatus(delete_result.status);
+            }
+        }
+        if (status.ok()) {
+            status = txnHandler->CommitTransaction();
+            count += query_result.records.size();
+        } else {
+            txnHandler->AbortTransaction();
+        }
+
+        if (status.ok() && k2::Clock::now() - claim_renewed > purge_claim_duration_ / 2) {
+            Status renew_status = RenewPurgeClaim(purge, fnc_tx);
+            if (!renew_status.ok()) {
+                // at worst, another process resumes the purge too
+                K2LOG_W(log::catalog, "Failed to renew the claim on the purge of table {} in {} due to {}", schema_name, collection_name, renew_status);
+            }
+            claim_renewed = k2::Clock::now();
+        }
+
+        if (status.ok() && scan_pending) {
+            std::this_thread::sleep_for(purge_batch_interval_);
+        }
+    }
+
+    if (scan_pending) {
+        // wait for the scan of the next page before ending its transaction
+        scan.get();
+    }
+    scan_txnHandler->CommitTransaction();
+    K2LOG_I(log::catalog, "Purged {} records of table {} in {}, status: {}", count, schema_name, collection_name, status);
+    return status;
+}
+
 k2::dto::SKVRecord TableInfoHandler::buildRangeRecord(const std::string& collection_name, std::shared_ptr<k2::dto::Schema> schema, PgOid table_oid, PgOid index_oid, std::optional<std::string> table_id) {
     k2::dto::SKVRecord record(collection_name, schema);
     // SchemaTableId
@@ -22,6 +22,8 @@ Copyright(c) 2020 Futurewei Cloud
 */
 #pragma once
 
+#include <atomic>
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -78,6 +80,21 @@ struct CopyTableResult {
     int num_index = 0;
 };
 
+struct CopyTablesResult {
+    Status status;
+    int num_index = 0;
+};
+
+// One SKV table (base table or secondary index) whose records are copied to another collection
+struct CopySKVTableRequest {
+    std::string target_schema_name;
+    uint32_t target_schema_version;
+    std::string source_schema_name;
+    uint32_t source_schema_version;
+    PgOid source_table_oid;
+    PgOid source_index_oid;
+};
+
 struct CreateSKVSchemaResult {
     Status status;
 };
@@ -125,6 +142,20 @@ struct CreateIndexTableParams {
     IndexPermissions index_permissions;
 };
 
+// A dropped SKV table (base table or secondary index) whose records are still to be purged
+struct PendingPurge {
+    std::string collection_name;
+    std::string schema_name;
+    uint32_t schema_version;
+    PgOid table_oid;
+    PgOid index_oid;
+};
+
+struct ClaimPendingPurgesResult {
+    Status status;
+    std::vector<PendingPurge> purges;
+};
+
 class TableInfoHandler {
     public:
     typedef std::shared_ptr<TableInfoHandler> SharedPtr;
@@ -207,6 +238,23 @@ class TableInfoHandler {
         .rangeKeyFields = std::vector<uint32_t> {3}
     };
 
+    // schema of the dropped tables/indexes whose records are still to be purged, in the primary cluster's collection.
+    // A record is written by the transaction which drops the table/index and deleted once its records are purged.
+    // ClaimedUntil is the time (ms since epoch) until which a process owns the purge, see ClaimPendingPurges()
+    k2::dto::Schema skv_schema_purge_meta {
+        .name = CatalogConsts::skv_schema_name_purge_meta,
+        .version = 1,
+        .fields = std::vector<k2::dto::SchemaField> {
+                {k2::dto::FieldType::STRING, "CollectionName", false, false},
+                {k2::dto::FieldType::STRING, "SchemaName", false, false},
+                {k2::dto::FieldType::INT64T, "SchemaVersion", false, false},
+                {k2::dto::FieldType::INT64T, "TableOid", false, false},
+                {k2::dto::FieldType::INT64T, "IndexOid", false, false},
+                {k2::dto::FieldType::INT64T, "ClaimedUntil", false, false}},
+        .partitionKeyFields = std::vector<uint32_t> { 0, 1 },
+        .rangeKeyFields = std::vector<uint32_t> {}
+    };
+
     // create above three meta tables for a DB
     CreateMetaTablesResult CreateMetaTables(std::shared_ptr<PgTxnHandler> txnHandler, const std::string& collection_name);
 
@@ -233,6 +281,17 @@ class TableInfoHandler {
             const std::string& source_database_name,
             const std::string& source_table_id);
 
+    // Same as CopyTable for a list of tables. The meta of all tables is copied first, then the data of up to
+    // catalog_copy_parallelism tables/indexes is copied concurrently.
+    CopyTablesResult CopyTables(std::shared_ptr<PgTxnHandler> target_txnHandler,
+            const std::string& target_coll_name,
+            const std::string& target_database_name,
+            uint32_t target_database_oid,
+            std::shared_ptr<PgTxnHandler> source_txnHandler,
+            const std::string& source_coll_name,
+            const std::string& source_database_name,
+            const std::vector<std::string>& source_table_ids);
+
     CreateSKVSchemaResult CreateIndexSKVSchema(std::shared_ptr<PgTxnHandler> txnHandler, const std::string& collection_name,
         std::shared_ptr<TableInfo> table, const IndexInfo& index_info);
 
@@ -240,11 +299,32 @@ class TableInfoHandler {
 
     DeleteTableResult DeleteTableMetadata(std::shared_ptr<PgTxnHandler> txnHandler, const std::string& collection_name, std::shared_ptr<TableInfo> table);
 
-    DeleteTableResult DeleteTableData(std::shared_ptr<PgTxnHandler> txnHandler, const std::string& collection_name, std::shared_ptr<TableInfo> table);
-
     DeleteIndexResult DeleteIndexMetadata(std::shared_ptr<PgTxnHandler> txnHandler, const std::string& collection_name,  const std::string& index_id);
 
-    DeleteIndexResult DeleteIndexData(std::shared_ptr<PgTxnHandler> txnHandler, const std::string& collection_name,  const std::string& index_id);
+    // Stop the purges that are running at the end of their current batch
+    void CancelPurges() {
+        purge_cancelled_ = true;
+    }
+
+    // Called on every start of sql_catalog_manager, creates the SKV schema of the pending purges if it doesn't exist
+    CreateSKVSchemaResult EnsurePurgeMetaTable();
+
+    // The SKV tables of a table and of its secondary indexes, to purge once the table is dropped
+    std::vector<PendingPurge> GetTablePurges(const std::string& collection_name, std::shared_ptr<TableInfo> table);
+
+    // The SKV table of a secondary index, to purge once the index is dropped
+    PendingPurge GetIndexPurge(const std::string& collection_name, const IndexInfo& index_info);
+
+    // Records the purges in the transaction which drops their tables/indexes, claimed by this process
+    Status PersistPendingPurges(std::shared_ptr<PgTxnHandler> txnHandler, const std::vector<PendingPurge>& purges);
+
+    // Claims the pending purges whose claim is over, e.g. those of a process which exited before finishing them. A
+    // purge is claimed in a transaction of its own, so that only one of the processes which race for it gets it
+    ClaimPendingPurgesResult ClaimPendingPurges(std::function<std::shared_ptr<PgTxnHandler>()> fnc_tx);
+
+    // Purges the records of dropped SKV tables, see PurgeSKVTable(), and deletes the pending purge record of each
+    // table once done. Stops at the first failure, leaving the remaining purges to be resumed later
+    Status PurgeData(const std::vector<PendingPurge>& purges, std::function<std::shared_ptr<PgTxnHandler>()> fnc_tx);
 
     GetBaseTableIdResult GetBaseTableId(std::shared_ptr<PgTxnHandler> txnHandler, const std::string& collection_name, const std::string& index_id);
 
@@ -255,16 +335,27 @@ class TableInfoHandler {
     CreateIndexTableResult CreateIndexTable(std::shared_ptr<PgTxnHandler> txnHandler, std::shared_ptr<DatabaseInfo> database_info, std::shared_ptr<TableInfo> base_table_info, CreateIndexTableParams &index_params);
 
     private:
-    CopySKVTableResult CopySKVTable(std::shared_ptr<PgTxnHandler> target_txnHandler,
+    // Creates the target table and its indexes from the source table meta, and adds the SKV tables whose data needs
+    // to be copied (none for shared tables) to copy_requests
+    CopyTableResult CopyTableMeta(std::shared_ptr<PgTxnHandler> target_txnHandler,
+            const std::string& target_coll_name,
+            const std::string& target_database_name,
+            uint32_t target_database_oid,
+            std::shared_ptr<PgTxnHandler> source_txnHandler,
+            const std::string& source_coll_name,
+            const std::string& source_database_name,
+            const std::string& source_table_id,
+            std::vector<CopySKVTableRequest>& copy_requests);
+
+    // Copies the records of the given SKV tables. Up to copy_parallelism_ tables are copied at a time, all the
+    // writes of a scanned page are in flight together, and the scan of the next page overlaps with them.
+    // The copies are driven by futures from the calling thread rather than by a worker pool, since a K23SITxn
+    // keeps unsynchronized op counts and must only be used by one thread.
+    CopySKVTableResult CopySKVTables(std::shared_ptr<PgTxnHandler> target_txnHandler,
             const std::string& target_coll_name,
-            const std::string& target_schema_name,
-            uint32_t target_schema_version,
             std::shared_ptr<PgTxnHandler> source_txnHandler,
             const std::string& source_coll_name,
-            const std::string& source_schema_name,
-            uint32_t source_schema_version,
-            PgOid source_table_oid,
-            PgOid source_index_oid);
+            const std::vector<CopySKVTableRequest>& requests);
 
     // A SKV Schema of perticular version is not mutable, thus, we only create a new specified version if that version doesn't exists yet
     CreateSKVSchemaResult CreateTableSKVSchema(std::shared_ptr<PgTxnHandler> txnHandler, const std::string& collection_name, std::shared_ptr<TableInfo> table);
@@ -309,14 +400,37 @@ class TableInfoHandler {
 
     void AddDefaultPartitionKeys(std::shared_ptr<k2::dto::Schema> schema);
 
+    // Deletes all the records of a SKV table (base table or secondary index) in batches. A batch is a scanned page
+    // whose records are deleted concurrently in a transaction of its own, while the next page is read by the scan
+    // transaction. Waits purge_batch_interval_ after each batch to limit the load on the cluster, and renews the
+    // claim on the purge before it is over. Returns Aborted if the purge is cancelled before its end.
+    Status PurgeSKVTable(const PendingPurge& purge, std::function<std::shared_ptr<PgTxnHandler>()> fnc_tx);
+
+    // Extends the claim of this process on a pending purge, unless the purge record is gone
+    Status RenewPurgeClaim(const PendingPurge& purge, std::function<std::shared_ptr<PgTxnHandler>()> fnc_tx);
+
+    k2::dto::SKVRecord MakePurgeRecord(const PendingPurge& purge, std::optional<int64_t> claimed_until);
+
+    // ClaimedUntil for a purge claimed now
+    int64_t PurgeClaimDeadline();
+
     // Build a range record for a scan, optionally using third param table_id when applicable(e.g. in sys table).
     k2::dto::SKVRecord buildRangeRecord(const std::string& collection_name, std::shared_ptr<k2::dto::Schema> schema, PgOid table_oid, PgOid index_oid, std::optional<std::string> table_id);
 
     std::shared_ptr<k2::dto::Schema> table_meta_SKVSchema_;
     std::shared_ptr<k2::dto::Schema> tablecolumn_meta_SKVSchema_;
     std::shared_ptr<k2::dto::Schema> indexcolumn_meta_SKVSchema_;
+    std::shared_ptr<k2::dto::Schema> purge_meta_SKVSchema_;
 
     std::shared_ptr<K2Adapter> k2_adapter_;
+
+    size_t copy_parallelism_;
+
+    k2::Duration purge_batch_interval_;
+
+    k2::Duration purge_claim_duration_;
+
+    std::atomic<bool> purge_cancelled_{false};
 };
 
 } // namespace catalog
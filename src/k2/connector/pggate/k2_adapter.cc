@@ -16,12 +16,18 @@
 
 #include "k2_adapter.h"
 
+#include <algorithm>
 #include <cstddef>
+#include <deque>
+#include <limits>
+#include <optional>
+#include <type_traits>
 #include <unordered_map>
 
 #include <seastar/core/memory.hh>
 #include <seastar/core/resource.hh>
 
+#include "common/pgsql_error.h"
 #include "pg_gate_defaults.h"
 #include "pg_op_api.h"
 
@@ -45,6 +51,56 @@ Status K2Adapter::Shutdown() {
     return Status::OK();
 }
 
+std::shared_ptr<k2::dto::Schema> SchemaCache::Find(const std::string& collectionName, const std::string& schemaName, uint64_t schemaVersion) {
+    std::shared_lock lock(mutex_);
+    auto it = schemas_.find(Key{collectionName, schemaName, schemaVersion});
+    return it == schemas_.end() ? nullptr : it->second;
+}
+
+void SchemaCache::Insert(const std::string& collectionName, const std::string& schemaName, uint64_t schemaVersion,
+                         std::shared_ptr<k2::dto::Schema> schema) {
+    std::unique_lock lock(mutex_);
+    schemas_[Key{collectionName, schemaName, schemaVersion}] = std::move(schema);
+}
+
+void SchemaCache::OnCatalogVersionChange(uint64_t catalogVersion) {
+    std::unique_lock lock(mutex_);
+    if (catalogVersion > catalogVersion_) {
+        K2LOG_D(log::k2Adapter, "Clearing schema cache due to catalog version change {} -> {}", catalogVersion_, catalogVersion);
+        catalogVersion_ = catalogVersion;
+        schemas_.clear();
+    }
+}
+
+void SchemaCache::EraseCollection(const std::string& collectionName) {
+    std::unique_lock lock(mutex_);
+    for (auto it = schemas_.begin(); it != schemas_.end();) {
+        if (it->first.collectionName == collectionName) {
+            it = schemas_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+k2::GetSchemaResult K2Adapter::GetSchemaCached(const std::string& collectionName, const std::string& schemaName, uint64_t schemaVersion) {
+    std::shared_ptr<k2::dto::Schema> schema = schemaCache_.Find(collectionName, schemaName, schemaVersion);
+    if (schema) {
+        return k2::GetSchemaResult{.status=k2::dto::K23SIStatus::OK(""), .schema=std::move(schema)};
+    }
+
+    k2::GetSchemaResult result = k23si_->getSchema(collectionName, schemaName, schemaVersion).get();
+    if (result.status.is2xxOK() && result.schema) {
+        K2LOG_D(log::k2Adapter, "Caching schema {} version {} in {}", schemaName, result.schema->version, collectionName);
+        schemaCache_.Insert(collectionName, schemaName, schemaVersion, result.schema);
+    }
+    return result;
+}
+
+void K2Adapter::OnCatalogVersionChange(uint64_t catalogVersion) {
+    schemaCache_.OnCatalogVersionChange(catalogVersion);
+}
+
 std::string K2Adapter::GetRowIdFromReadRecord(k2::dto::SKVRecord& record) {
     k2::dto::SKVRecord key_record = record.getSKVKeyRecord();
     return SerializeSKVRecordToString(key_record);
@@ -54,36 +110,44 @@ std::string K2Adapter::GetRowIdFromReadRecord(k2::dto::SKVRecord& record) {
 k2::dto::expression::Expression K2Adapter::ToK2Expression(PgExpr* pg_expr) {
     switch(pg_expr->opcode()) {
         case PgExpr::Opcode::PG_EXPR_EQ:
+        case PgExpr::Opcode::PG_EXPR_NE:
         case PgExpr::Opcode::PG_EXPR_GE:
         case PgExpr::Opcode::PG_EXPR_GT:
         case PgExpr::Opcode::PG_EXPR_LE:
         case PgExpr::Opcode::PG_EXPR_LT:
+        case PgExpr::Opcode::PG_EXPR_STARTS_WITH:
         {
             return ToK2BinaryLogicOperator(static_cast<PgOperator *>(pg_expr));
         } break;
-        case PgExpr::Opcode::PG_EXPR_AND: {
+        case PgExpr::Opcode::PG_EXPR_AND:
+        case PgExpr::Opcode::PG_EXPR_OR: {
             PgOperator* pg_opr = static_cast<PgOperator *>(pg_expr);
             K2LOG_D(log::k2Adapter, "Converting PgOperator {}", *pg_opr);
+            if (pg_opr->getArgs().empty()) {
+                throw std::invalid_argument("AND/OR operator should have at least one argument");
+            }
             std::vector<PgExpr*> args;
             for (auto arg : pg_opr->getArgs()) {
                 args.emplace_back(arg);
             }
-            return ToK2AndOrOperator(k2::dto::expression::Operation::AND, args);
+            return ToK2AndOrOperator(ToK2OperationType(pg_opr), args);
         } break;
+        case PgExpr::Opcode::PG_EXPR_NOT:
+            return ToK2NotOperator(static_cast<PgOperator *>(pg_expr));
+            break;
+        case PgExpr::Opcode::PG_EXPR_IN:
+            return ToK2InOperator(static_cast<PgOperator *>(pg_expr));
+            break;
+        case PgExpr::Opcode::PG_EXPR_IS_NULL:
+            return ToK2IsNullOperator(static_cast<PgOperator *>(pg_expr));
+            break;
         case PgExpr::Opcode::PG_EXPR_BETWEEN:
             return ToK2BetweenOperator(static_cast<PgOperator *>(pg_expr));
             break;
-        // don't support OR for now
-        case PgExpr::Opcode::PG_EXPR_OR:
-        // don't support NOT for now
-        case PgExpr::Opcode::PG_EXPR_NOT:
-        case PgExpr::Opcode::PG_EXPR_NE:
         // don't support constant and column reference at the top level
         case PgExpr::Opcode::PG_EXPR_CONSTANT:
         case PgExpr::Opcode::PG_EXPR_COLREF:
-        // don't support set operator in K2 yet
-        case PgExpr::Opcode::PG_EXPR_IN:
-        // don't support aggregation in K2 yet
+        // SKV has no aggregation, pushed down aggregates are computed by AccumulateAggregates instead
         case PgExpr::Opcode::PG_EXPR_AVG:
         case PgExpr::Opcode::PG_EXPR_SUM:
         case PgExpr::Opcode::PG_EXPR_COUNT:
@@ -91,6 +155,11 @@ k2::dto::expression::Expression K2Adapter::ToK2Expression(PgExpr* pg_expr) {
         case PgExpr::Opcode::PG_EXPR_MIN:
         // don't support built-in func call yet
         case PgExpr::Opcode::PG_EXPR_EVAL_EXPR_CALL:
+        // SKV filters have no arithmetic, UPDATE assignments are computed by EvalAssignExpr instead
+        case PgExpr::Opcode::PG_EXPR_ADD:
+        case PgExpr::Opcode::PG_EXPR_SUB:
+        case PgExpr::Opcode::PG_EXPR_MUL:
+        case PgExpr::Opcode::PG_EXPR_CONCAT:
         default: {
             std::stringstream oss;
             oss << "Unsupported PgExpr " << pg_expr->opcode();
@@ -130,40 +199,106 @@ k2::dto::expression::Expression K2Adapter::ToK2BinaryLogicOperator(PgOperator* p
         oss << "First argument should be column reference, but actually is " << args[0]->opcode();
         throw std::invalid_argument(oss.str());
     }
-    if (!args[1]->is_constant()) {
-        // only consider value here
+    if (!args[1]->is_constant() && !args[1]->is_colref()) {
         std::stringstream oss;
-        oss << "Second argument should be a value, but actually is " << args[1]->opcode();
+        oss << "Second argument should be a value or a column reference, but actually is " << args[1]->opcode();
         throw std::invalid_argument(oss.str());
     }
 
     PgColumnRef* ref = static_cast<PgColumnRef *>(args[0]);
-    PgConstant* val = static_cast<PgConstant *>(args[1]);
-
-    if (pg_opr->opcode() == PgExpr::Opcode::PG_EXPR_EQ) {
-        // special handing for a NULL value
-        if (val->getValue()->IsNull()) {
-            std::vector<k2::dto::expression::Value> values;
-            values.emplace_back(ToK2ColumnRef(ref));
-            return k2::dto::expression::makeExpression(k2::dto::expression::Operation::IS_NULL, std::move(values), {});
-        } else {
-            std::vector<k2::dto::expression::Value> values;
-            values.emplace_back(ToK2ColumnRef(ref));
-            values.emplace_back(ToK2Value(val));
-            return k2::dto::expression::makeExpression(ToK2OperationType(pg_opr), std::move(values), {});
-        }
+    std::vector<k2::dto::expression::Value> values;
+    values.emplace_back(ToK2ColumnRef(ref));
+    if (args[1]->is_colref()) {
+        // comparison between two columns of the same row
+        values.emplace_back(ToK2ColumnRef(static_cast<PgColumnRef *>(args[1])));
     } else {
+        PgConstant* val = static_cast<PgConstant *>(args[1]);
         if (val->getValue()->IsNull()) {
+            // special handing for a NULL value
+            if (pg_opr->opcode() == PgExpr::Opcode::PG_EXPR_EQ) {
+                return k2::dto::expression::makeExpression(k2::dto::expression::Operation::IS_NULL, std::move(values), {});
+            }
             // NULL value should not be handled here
             std::stringstream oss;
             oss << "NULL value should not be handled by operator " << pg_opr->opcode();
             throw std::invalid_argument(oss.str());
         }
+        values.emplace_back(ToK2Value(val));
+    }
+
+    if (pg_opr->opcode() == PgExpr::Opcode::PG_EXPR_NE) {
+        // SKV has no inequality operation, NE is NOT(EQ)
+        std::vector<k2::dto::expression::Expression> exprs;
+        exprs.emplace_back(k2::dto::expression::makeExpression(k2::dto::expression::Operation::EQ, std::move(values), {}));
+        return k2::dto::expression::makeExpression(k2::dto::expression::Operation::NOT, {}, std::move(exprs));
+    }
+    return k2::dto::expression::makeExpression(ToK2OperationType(pg_opr), std::move(values), {});
+}
+
+k2::dto::expression::Expression K2Adapter::ToK2NotOperator(PgOperator* pg_opr) {
+    K2LOG_D(log::k2Adapter, "Converting PgOperator {}", *pg_opr);
+    auto& args = pg_opr->getArgs();
+    if (args.size() != 1) {
+        throw std::invalid_argument("NOT operator should have 1 argument, but actually has " + std::to_string(args.size()));
+    }
+    std::vector<k2::dto::expression::Expression> exprs;
+    exprs.emplace_back(ToK2Expression(args[0]));
+    return k2::dto::expression::makeExpression(k2::dto::expression::Operation::NOT, {}, std::move(exprs));
+}
+
+// combine the given expressions with a balanced tree of binary AND/OR operators, so that long IN lists don't
+// turn into deeply nested filters
+static k2::dto::expression::Expression CombineK2Expressions(k2::dto::expression::Operation op,
+        std::vector<k2::dto::expression::Expression>& exprs, size_t begin, size_t end) {
+    if (end - begin == 1) {
+        return std::move(exprs[begin]);
+    }
+    size_t middle = begin + (end - begin) / 2;
+    std::vector<k2::dto::expression::Expression> children;
+    children.emplace_back(CombineK2Expressions(op, exprs, begin, middle));
+    children.emplace_back(CombineK2Expressions(op, exprs, middle, end));
+    return k2::dto::expression::makeExpression(op, {}, std::move(children));
+}
+
+k2::dto::expression::Expression K2Adapter::ToK2InOperator(PgOperator* pg_opr) {
+    K2LOG_D(log::k2Adapter, "Converting PgOperator {}", *pg_opr);
+    auto& args = pg_opr->getArgs();
+    if (args.size() < 2 || !args[0]->is_colref()) {
+        throw std::invalid_argument("IN operator should have a column reference followed by values");
+    }
+
+    // IN is OR(EQ, EQ, ...), NULLs in the list never match
+    std::vector<k2::dto::expression::Expression> exprs;
+    for (size_t i = 1; i < args.size(); i++) {
+        if (!args[i]->is_constant()) {
+            std::stringstream oss;
+            oss << "Argument " << i << " of IN operator should be value, but actually is " << args[i]->opcode();
+            throw std::invalid_argument(oss.str());
+        }
+        PgConstant* val = static_cast<PgConstant *>(args[i]);
+        if (val->getValue()->IsNull()) {
+            continue;
+        }
         std::vector<k2::dto::expression::Value> values;
-        values.emplace_back(ToK2ColumnRef(ref));
+        values.emplace_back(ToK2ColumnRef(static_cast<PgColumnRef *>(args[0])));
         values.emplace_back(ToK2Value(val));
-        return k2::dto::expression::makeExpression(ToK2OperationType(pg_opr), std::move(values), {});
+        exprs.emplace_back(k2::dto::expression::makeExpression(k2::dto::expression::Operation::EQ, std::move(values), {}));
+    }
+    if (exprs.empty()) {
+        throw std::invalid_argument("IN operator should have at least one non-null value");
+    }
+    return CombineK2Expressions(k2::dto::expression::Operation::OR, exprs, 0, exprs.size());
+}
+
+k2::dto::expression::Expression K2Adapter::ToK2IsNullOperator(PgOperator* pg_opr) {
+    K2LOG_D(log::k2Adapter, "Converting PgOperator {}", *pg_opr);
+    auto& args = pg_opr->getArgs();
+    if (args.size() != 1 || !args[0]->is_colref()) {
+        throw std::invalid_argument("IS NULL operator should have a single column reference argument");
     }
+    std::vector<k2::dto::expression::Value> values;
+    values.emplace_back(ToK2ColumnRef(static_cast<PgColumnRef *>(args[0])));
+    return k2::dto::expression::makeExpression(k2::dto::expression::Operation::IS_NULL, std::move(values), {});
 }
 
 k2::dto::expression::Expression K2Adapter::ToK2BetweenOperator(PgOperator* pg_opr) {
@@ -240,6 +375,12 @@ k2::dto::expression::Operation K2Adapter::ToK2OperationType(PgExpr* pg_expr) {
         case PgExpr::Opcode::PG_EXPR_OR:
             opr_type = k2::dto::expression::Operation::OR;
             break;
+        case PgExpr::Opcode::PG_EXPR_IS_NULL:
+            opr_type = k2::dto::expression::Operation::IS_NULL;
+            break;
+        case PgExpr::Opcode::PG_EXPR_STARTS_WITH:
+            opr_type = k2::dto::expression::Operation::STARTS_WITH;
+            break;
         default:
             K2LOG_W(log::k2Adapter, "Unsupported PgExpr type {}", pg_expr->opcode());
             break;
@@ -283,6 +424,76 @@ k2::dto::expression::Value K2Adapter::ToK2ColumnRef(PgColumnRef* pg_colref) {
     return k2::dto::expression::makeValueReference(pg_colref->attr_name());
 }
 
+// true if the given value can be serialized into a key field of the given SKV type
+static bool IsKeyCompatible(const SqlValue& value, k2::dto::FieldType type) {
+    switch (value.type_) {
+        case SqlValue::ValueType::BOOL:
+            return type == k2::dto::FieldType::BOOL;
+        case SqlValue::ValueType::INT:
+            return type == k2::dto::FieldType::INT64T;
+        case SqlValue::ValueType::FLOAT:
+            return type == k2::dto::FieldType::FLOAT;
+        case SqlValue::ValueType::DOUBLE:
+            return type == k2::dto::FieldType::DOUBLE;
+        case SqlValue::ValueType::SLICE:
+            return type == k2::dto::FieldType::STRING;
+        default:
+            return false;
+    }
+}
+
+// The smallest non-null value of the given key field type, if the type has one we can express.
+// Used to skip the nulls at the beginning of a nulls-first field when the scan has no start bound on it
+static std::optional<SqlValue> MinKeyValue(const k2::dto::SchemaField& field) {
+    switch (field.type) {
+        case k2::dto::FieldType::BOOL:
+            return SqlValue(false);
+        case k2::dto::FieldType::INT64T:
+            return SqlValue(std::numeric_limits<int64_t>::min());
+        case k2::dto::FieldType::FLOAT:
+            return SqlValue(-std::numeric_limits<float>::infinity());
+        case k2::dto::FieldType::DOUBLE:
+            return SqlValue(-std::numeric_limits<double>::infinity());
+        case k2::dto::FieldType::STRING:
+            return SqlValue(std::string());
+        default:
+            return std::nullopt;
+    }
+}
+
+void K2Adapter::SerializeKeyFieldRange(const k2::dto::SchemaField& field, const KeyFieldBounds& bounds, k2::dto::SKVRecord& start, k2::dto::SKVRecord& end) {
+    // The start record is inclusive and the end record is exclusive. Whenever an exact bound cannot be expressed
+    // we use a looser one; the conditions are always sent as filters too.
+    if (bounds.lower) {
+        std::optional<SqlValue> startValue;
+        if (bounds.lower_inclusive || !bounds.lower->HasUpperBound()) {
+            startValue = *bounds.lower;
+        } else {
+            startValue = bounds.lower->UpperBound();
+        }
+        // -0.0 and 0.0 are equal in SQL, make sure we start before both of them
+        if (startValue->type_ == SqlValue::ValueType::FLOAT && startValue->data_.float_val_ == 0) {
+            startValue = SqlValue(-0.0f);
+        } else if (startValue->type_ == SqlValue::ValueType::DOUBLE && startValue->data_.double_val_ == 0) {
+            startValue = SqlValue(-0.0);
+        }
+        K2Adapter::SerializeValueToSKVRecord(*startValue, start);
+    } else if (!field.nullLast) {
+        // range conditions never match nulls, so skip over them when they come first
+        if (auto minValue = MinKeyValue(field)) {
+            K2Adapter::SerializeValueToSKVRecord(*minValue, start);
+        }
+    }
+
+    if (bounds.upper && (!bounds.upper_inclusive || bounds.upper->HasUpperBound())) {
+        K2Adapter::SerializeValueToSKVRecord(bounds.upper_inclusive ? bounds.upper->UpperBound() : *bounds.upper, end);
+    } else if (field.nullLast) {
+        // nothing sorts right after the upper bound, or there is none, but the nulls are the first keys after
+        // all values, so we can stop right before them
+        end.serializeNull();
+    }
+}
+
 Status K2Adapter::HandleRangeConditions(PgExpr *range_conds, std::vector<PgExpr *>& leftover_exprs, k2::dto::SKVRecord& start, k2::dto::SKVRecord& end) {
     if (range_conds == nullptr) {
         return Status::OK();
@@ -300,492 +511,764 @@ Status K2Adapter::HandleRangeConditions(PgExpr *range_conds, std::vector<PgExpr
         return Status::OK();
     }
 
-    // use multimap since the same column might have multiple conditions
-    std::multimap<std::string, PgExpr*> children_by_col_name;
+    const std::vector<k2::dto::SchemaField>& fields = start.schema->fields;
+    const size_t key_field_count = start.schema->partitionKeyFields.size();
+    std::unordered_map<std::string, size_t> field_map;
+    for (size_t i = SKV_FIELD_OFFSET; i < key_field_count; i++) {
+        field_map[fields[i].name] = i;
+    }
+
+    // collect the bounds per key field. Comparison conditions are always pushed to K2 as filters as well, so that
+    // loose bounds are still correct; equality conditions are only kept as filters if they are not used for the range
+    std::vector<KeyFieldBounds> bounds(key_field_count);
     for (auto& pg_expr : pg_opr->getArgs()) {
         // the children should be PgOperators for the top "and" condition
-        auto& child_args = static_cast<PgOperator *>(pg_expr)->getArgs();
+        auto& args = static_cast<PgOperator *>(pg_expr)->getArgs();
         // the first arg for the child should column reference
-        if (!child_args[0]->is_colref()) {
+        if (!args[0]->is_colref()) {
             std::stringstream oss;
-            oss << "First argument should be column reference, but actually is " << child_args[0]->opcode();
+            oss << "First argument should be column reference, but actually is " << args[0]->opcode();
             throw std::invalid_argument(oss.str());
         }
-        PgColumnRef* child_col_ref = static_cast<PgColumnRef *>(child_args[0]);
-        children_by_col_name.insert(std::make_pair(child_col_ref->attr_name(), pg_expr));
-    }
-
-    std::vector<PgExpr*> sorted_args;
-    std::vector<k2::dto::SchemaField> fields = start.schema->fields;
-    std::unordered_map<std::string, int> field_map;
-    for (int i = SKV_FIELD_OFFSET; i < fields.size(); i++) {
-        field_map[fields[i].name] = i;
-        auto range = children_by_col_name.equal_range(fields[i].name);
-        for (auto it = range.first; it != range.second; ++it) {
-            sorted_args.push_back(it->second);
+        for (size_t i = 1; i < args.size(); i++) {
+            if (!args[i]->is_constant()) {
+                // only consider value here
+                // TODO:: apply NOT to other types of expressions
+                std::stringstream oss;
+                oss << "Argument " << i << " should be value, but actually is " << args[i]->opcode();
+                throw std::invalid_argument(oss.str());
+            }
         }
-    }
-
-    // make sure that the record cursor in the correct start position
-    start.seekField(SKV_FIELD_OFFSET);
-    end.seekField(SKV_FIELD_OFFSET);
 
-    int start_idx = SKV_FIELD_OFFSET - 1;
-    bool didBranch = false;
-    for (auto& pg_expr : sorted_args) {
-         if (didBranch) {
-            // there was a branch in the processing of previous condition and we cannot continue.
-            // Ideally, this shouldn't happen if the query parser did its job well.
-            // This is not an error, and so we can still process the request. PG would down-filter the result set after
-            K2LOG_D(log::k2Adapter, "Condition branched at previous key field. Use the condition as filter condition");
+        PgColumnRef* col_ref = static_cast<PgColumnRef *>(args[0]);
+        auto field_it = field_map.find(col_ref->attr_name());
+        auto opcode = pg_expr->opcode();
+        bool usable = field_it != field_map.end() && args.size() > 1;
+        for (size_t i = 1; usable && i < args.size(); i++) {
+            const SqlValue& value = *static_cast<PgConstant *>(args[i])->getValue();
+            usable = !value.IsNull() && IsKeyCompatible(value, fields[field_it->second].type);
+        }
+        if (!usable) {
+            K2LOG_D(log::k2Adapter, "Condition on {} cannot be used for the key range, use it as filter", col_ref->attr_name());
             leftover_exprs.emplace_back(pg_expr);
-            continue; // keep going so that we log all skipped expressions;
+            continue;
         }
-        switch(pg_expr->opcode()) {
+
+        KeyFieldBounds& field_bounds = bounds[field_it->second];
+        // tighten the lower/upper bound with the given value
+        auto setLower = [&field_bounds](const SqlValue& value, bool inclusive) {
+            if (field_bounds.lower && field_bounds.lower->type_ == value.type_) {
+                int cmp = value.Compare(*field_bounds.lower);
+                if (cmp < 0 || (cmp == 0 && inclusive)) return;
+            } else if (field_bounds.lower) {
+                return;
+            }
+            field_bounds.lower = value;
+            field_bounds.lower_inclusive = inclusive;
+        };
+        auto setUpper = [&field_bounds](const SqlValue& value, bool inclusive) {
+            if (field_bounds.upper && field_bounds.upper->type_ == value.type_) {
+                int cmp = value.Compare(*field_bounds.upper);
+                if (cmp > 0 || (cmp == 0 && inclusive)) return;
+            } else if (field_bounds.upper) {
+                return;
+            }
+            field_bounds.upper = value;
+            field_bounds.upper_inclusive = inclusive;
+        };
+
+        switch(opcode) {
             case PgExpr::Opcode::PG_EXPR_EQ: {
-                auto& args = static_cast<PgOperator *>(pg_expr)->getArgs();
-                if (!args[1]->is_constant()) {
-                    // only consider value here
-                    // TODO:: apply NOT to other types of expressions
-                    std::stringstream oss;
-                    oss << "Second argument should be value, but actually is " << args[1]->opcode();
-                    throw std::invalid_argument(oss.str());
-                }
-                PgColumnRef* col_ref = static_cast<PgColumnRef *>(args[0]);
-                PgConstant* val = static_cast<PgConstant *>(args[1]);
-                int cur_idx = field_map[col_ref->attr_name()];
-                if (cur_idx - start_idx == 0 || cur_idx - start_idx == 1) {
-                    start_idx = cur_idx;
-                    K2Adapter::SerializeValueToSKVRecord(*(val->getValue()), start);
-                    K2Adapter::SerializeValueToSKVRecord(*(val->getValue()), end);
-                } else {
-                    didBranch = true;
-                    leftover_exprs.emplace_back(pg_expr);
+                if (!field_bounds.eq) {
+                    field_bounds.eq = *static_cast<PgConstant *>(args[1])->getValue();
+                    field_bounds.eq_expr = pg_expr;
+                    continue; // decided below whether it needs to be a filter
                 }
             } break;
             case PgExpr::Opcode::PG_EXPR_GE:
-            case PgExpr::Opcode::PG_EXPR_GT: {
-                auto& args = static_cast<PgOperator *>(pg_expr)->getArgs();
-                if (!args[1]->is_constant()) {
-                    // only consider value here
-                    // TODO:: apply NOT to other types of expressions
-                    std::stringstream oss;
-                    oss << "Second argument should be value, but actually is " << args[1]->opcode();
-                    throw std::invalid_argument(oss.str());
-                }
-                PgColumnRef* col_ref = static_cast<PgColumnRef *>(args[0]);
-                PgConstant* val = static_cast<PgConstant *>(args[1]);
-                if (val->getValue()->IsInteger()) {
-                    int cur_idx = field_map[col_ref->attr_name()];
-                    if (cur_idx - start_idx == 0 || cur_idx - start_idx == 1) {
-                        start_idx = cur_idx;
-                        K2Adapter::SerializeValueToSKVRecord(*(val->getValue()), start);
-                    } else {
-                        didBranch = true;
-                    }
-                } else {
-                    didBranch = true;
-                }
-                // always push the comparison operator to K2 as discussed
-                leftover_exprs.emplace_back(pg_expr);
-            } break;
-            case PgExpr::Opcode::PG_EXPR_LT: {
-                auto& args = static_cast<PgOperator *>(pg_expr)->getArgs();
-                if (!args[1]->is_constant()) {
-                    // only consider value here
-                    // TODO:: apply NOT to other types of expressions
-                    std::stringstream oss;
-                    oss << "Second argument should be value, but actually is " << args[1]->opcode();
-                    throw std::invalid_argument(oss.str());
-                }
-                PgColumnRef* col_ref = static_cast<PgColumnRef *>(args[0]);
-                PgConstant* val = static_cast<PgConstant *>(args[1]);
-                if (val->getValue()->IsInteger()) {
-                    int cur_idx = field_map[col_ref->attr_name()];
-                    if (cur_idx - start_idx == 0 || cur_idx - start_idx == 1) {
-                        start_idx = cur_idx;
-                        K2Adapter::SerializeValueToSKVRecord(*(val->getValue()), end);
-                    } else {
-                        didBranch = true;
-                    }
-                } else {
-                    didBranch = true;
-                }
-                // always push the comparison operator to K2 as discussed
-                leftover_exprs.emplace_back(pg_expr);
-            } break;
-            case PgExpr::Opcode::PG_EXPR_LE: {
-                auto& args = static_cast<PgOperator *>(pg_expr)->getArgs();
-                if (!args[1]->is_constant()) {
-                    // only consider value here
-                    // TODO:: apply NOT to other types of expressions
-                    std::stringstream oss;
-                    oss << "Second argument should be value, but actually is " << args[1]->opcode();
-                    throw std::invalid_argument(oss.str());
-                }
-                PgColumnRef* col_ref = static_cast<PgColumnRef *>(args[0]);
-                PgConstant* val = static_cast<PgConstant *>(args[1]);
-                if (val->getValue()->IsInteger()) {
-                    int cur_idx = field_map[col_ref->attr_name()];
-                    if (cur_idx - start_idx == 0 || cur_idx - start_idx == 1) {
-                        start_idx = cur_idx;
-                        if (val->getValue()->IsMaxInteger()) {
-                            // do not set the range if the value is maximum
-                            didBranch = true;
-                        } else {
-                            K2Adapter::SerializeValueToSKVRecord(val->getValue()->UpperBound(), end);
-                        }
-                    } else {
-                        didBranch = true;
-                    }
-                } else {
-                    didBranch = true;
-                }
-                leftover_exprs.emplace_back(pg_expr);
-            } break;
+                setLower(*static_cast<PgConstant *>(args[1])->getValue(), true);
+                break;
+            case PgExpr::Opcode::PG_EXPR_GT:
+                setLower(*static_cast<PgConstant *>(args[1])->getValue(), false);
+                break;
+            case PgExpr::Opcode::PG_EXPR_LE:
+                setUpper(*static_cast<PgConstant *>(args[1])->getValue(), true);
+                break;
+            case PgExpr::Opcode::PG_EXPR_LT:
+                setUpper(*static_cast<PgConstant *>(args[1])->getValue(), false);
+                break;
             case PgExpr::Opcode::PG_EXPR_BETWEEN: {
-                auto& args = static_cast<PgOperator *>(pg_expr)->getArgs();
                 if (args.size() != 3) {
-                    throw std::invalid_argument("Between operator should have 3 arguments, but actually has " + args.size());
+                    throw std::invalid_argument("Between operator should have 3 arguments, but actually has " + std::to_string(args.size()));
                 }
-                if (!args[1]->is_constant() || !args[2]->is_constant()) {
-                    // only consider value here
-                    // TODO:: apply NOT to other types of expressions
-                    std::stringstream oss;
-                    oss << "Second and third arguments should be value, but actually are " << args[1]->opcode() << " and " << args[2]->opcode();
-                    throw std::invalid_argument(oss.str());
+                const SqlValue& val1 = *static_cast<PgConstant *>(args[1])->getValue();
+                const SqlValue& val2 = *static_cast<PgConstant *>(args[2])->getValue();
+                if (val1.type_ == val2.type_) {
+                    bool swap = val1.Compare(val2) > 0;
+                    setLower(swap ? val2 : val1, true);
+                    setUpper(swap ? val1 : val2, true);
                 }
-                PgColumnRef* col_ref = static_cast<PgColumnRef *>(args[0]);
-                PgConstant* val1 = static_cast<PgConstant *>(args[1]);
-                PgConstant* val2 = static_cast<PgConstant *>(args[2]);
-
-                K2ASSERT(log::k2Adapter, !val1->getValue()->IsNull() && !val2->getValue()->IsNull(), "Between operator should not have null values");
-                if (val1->getValue()->IsInteger() && val2->getValue()->IsInteger()) {
-                    PgConstant* lower = val1;
-                    PgConstant* higher = val2;
-                    if (val1->getValue()->Compare(val2->getValue()) > 0) {
-                        lower = val2;
-                        higher = val1;
-                    }
-                    int cur_idx = field_map[col_ref->attr_name()];
-                    if (cur_idx - start_idx == 0 || cur_idx - start_idx == 1) {
-                        start_idx = cur_idx;
-                        K2Adapter::SerializeValueToSKVRecord(*(lower->getValue()), start);
-                        K2Adapter::SerializeValueToSKVRecord(*(higher->getValue()), end);
-                    } else {
-                        didBranch = true;
+            } break;
+            case PgExpr::Opcode::PG_EXPR_IN: {
+                // the key range spans from the smallest to the largest value in the list, the list itself is
+                // applied as a filter. Lists on key prefixes are usually split into point scans before we get here
+                const SqlValue* min = static_cast<PgConstant *>(args[1])->getValue();
+                const SqlValue* max = min;
+                bool sameType = true;
+                for (size_t i = 2; sameType && i < args.size(); i++) {
+                    const SqlValue* value = static_cast<PgConstant *>(args[i])->getValue();
+                    sameType = value->type_ == min->type_;
+                    if (sameType && value->Compare(*min) < 0) {
+                        min = value;
+                    } else if (sameType && value->Compare(*max) > 0) {
+                        max = value;
                     }
-                } else {
-                    didBranch = true;
                 }
-                leftover_exprs.emplace_back(pg_expr);
+                if (sameType) {
+                    setLower(*min, true);
+                    setUpper(*max, true);
+                }
             } break;
             default: {
-                const char* msg = "Expression Condition must be one of [BETWEEN, EQ, GE, LE]";
+                const char* msg = "Expression Condition must be one of [BETWEEN, EQ, GE, GT, IN, LE, LT]";
                 K2LOG_W(log::k2Adapter, "{}", msg);
-                didBranch = true;
-                leftover_exprs.emplace_back(pg_expr);
             } break;
         }
+        // always push the comparison operator to K2 as discussed
+        leftover_exprs.emplace_back(pg_expr);
     }
 
-    return Status::OK();
-}
+    // make sure that the record cursor in the correct start position
+    start.seekField(SKV_FIELD_OFFSET);
+    end.seekField(SKV_FIELD_OFFSET);
 
-// Helper function for handleReadOp when a vector of k2pgctids are set in the request
-void K2Adapter::handleReadByRowIds(std::shared_ptr<K23SITxn> k23SITxn,
-                                    std::shared_ptr<PgReadOpTemplate> op,
-                                    std::shared_ptr<std::promise<Status>> prom) {
-    std::shared_ptr<SqlOpReadRequest> request = op->request();
-    SqlOpResponse& response = op->response();
+    // the key range is built from the longest prefix of key fields with equality conditions, optionally followed by
+    // one field with range conditions. Conditions on the fields after that can only be applied as filters
+    bool didBranch = false;
+    for (size_t i = SKV_FIELD_OFFSET; i < key_field_count; i++) {
+        KeyFieldBounds& field_bounds = bounds[i];
+        if (!didBranch && field_bounds.eq) {
+            K2Adapter::SerializeValueToSKVRecord(*field_bounds.eq, start);
+            K2Adapter::SerializeValueToSKVRecord(*field_bounds.eq, end);
+            continue;
+        }
+        // ranges are not computed for descending key fields yet (see issue #268), their conditions only act as filters
+        if (!didBranch && (field_bounds.lower || field_bounds.upper) && !fields[i].descending) {
+            SerializeKeyFieldRange(fields[i], field_bounds, start, end);
+        }
+        didBranch = true;
+        if (field_bounds.eq_expr != nullptr) {
+            K2LOG_D(log::k2Adapter, "Condition branched at previous key field. Use the condition as filter condition");
+            leftover_exprs.emplace_back(field_bounds.eq_expr);
+        }
+    }
 
-    k2::Status status;
-    std::vector<CBFuture<k2::ReadResult<k2::dto::SKVRecord>>> result_futures;
-    for (auto& k2pgctid_column_value : request->k2pgctid_column_values) {
-        k2::GetSchemaResult schema_result = k23si_->getSchema(request->collection_name,
-                                                    request->table_id, k2::K23SIClient::ANY_VERSION).get();
+    return Status::OK();
+}
 
-        if (!schema_result.status.is2xxOK()) {
-            throw std::runtime_error(fmt::format("Failed to get schema for {} in {} due to {}",
-                        request->table_id, request->collection_name, schema_result.status));
+template <typename T>
+void AggregateFieldVisitor(std::optional<T> field, const k2::String& fieldName, const std::vector<PgExpr*>& targets, std::vector<SqlOpAggregatePartial>& partials) {
+    if (!field) {
+        // aggregates skip NULLs
+        return;
+    }
+    for (size_t i = 0; i < targets.size(); ++i) {
+        PgExpr* arg = static_cast<PgOperator*>(targets[i])->getArgs()[0];
+        if (!arg->is_colref() || static_cast<PgColumnRef*>(arg)->attr_name() != fieldName.c_str()) {
+            continue;
         }
-        k2::dto::SKVRecord key_record = K2PGTIDToRecord(request->collection_name,
-                                                             schema_result.schema,
-                                                             k2pgctid_column_value);
-        result_futures.push_back(k23SITxn->read(std::move(key_record)));
-    }
-
-    int idx = 0;
-    for (auto& result_future : result_futures) {
-        k2::ReadResult<k2::dto::SKVRecord> read = result_future.get();
-        if (read.status.is2xxOK()) {
-            op->mutable_rows_data()->emplace_back(std::move(read.value));
-            // use the last read response as the batch response
-            status = std::move(read.status);
-            idx++;
+        SqlOpAggregatePartial value;
+        value.has_value = true;
+        if (targets[i]->opcode() == PgExpr::Opcode::PG_EXPR_COUNT) {
+            value.int_val = 1;
+        } else if constexpr (std::is_floating_point<T>::value) {
+            value.is_float = true;
+            value.float_val = field.value();
+        } else if constexpr (std::is_arithmetic<T>::value) {
+            value.int_val = (int64_t)field.value();
         } else {
-            // If any read failed, abort and fail the batch
-            K2LOG_E(log::k2Adapter, "Failed to read for {}, due to {}", k2::String(K2PGTIDToString(request->k2pgctid_column_values[idx])), read.status.message);
-            status = std::move(read.status);
-            break;
+            throw std::invalid_argument(fmt::format("Unsupported field type for aggregate on {}", fieldName));
         }
+        partials[i].Combine(targets[i]->opcode(), value);
     }
+}
 
-    response.paging_state = nullptr;
-    K2LOG_D(log::k2Adapter, "handleReadByRowIds set response paging state to null for read op tid={}", op->request()->table_id);
-    response.status = K2StatusToPGStatus(status);
-    prom->set_value(K2StatusToK2PgStatus(status));
+void K2Adapter::AccumulateAggregates(const std::vector<PgExpr*>& targets, k2::dto::SKVRecord& record, std::vector<SqlOpAggregatePartial>& partials) {
+    for (size_t i = 0; i < targets.size(); ++i) {
+        PgExpr* arg = static_cast<PgOperator*>(targets[i])->getArgs()[0];
+        // COUNT(*) and COUNT(const) count every row
+        if (arg->is_constant() && targets[i]->opcode() == PgExpr::Opcode::PG_EXPR_COUNT &&
+            !static_cast<PgConstant*>(arg)->getValue()->IsNull()) {
+            partials[i].int_val++;
+        }
+    }
+    FOR_EACH_RECORD_FIELD(record, AggregateFieldVisitor, targets, partials);
 }
 
-CBFuture<Status> K2Adapter::handleReadOp(std::shared_ptr<K23SITxn> k23SITxn,
-                                            std::shared_ptr<PgReadOpTemplate> op) {
-    auto prom = std::make_shared<std::promise<Status>>();
-    auto result = CBFuture<Status>(prom->get_future(), []{});
+std::vector<k2::String> K2Adapter::GetProjection(SqlOpReadRequest& request, const k2::dto::Schema& schema) {
+    std::vector<k2::String> projection;
+    if (request.targets.empty()) {
+        return projection;
+    }
+    auto add = [&projection] (k2::String name) {
+        if (std::find(projection.begin(), projection.end(), name) == projection.end()) {
+            projection.push_back(std::move(name));
+        }
+    };
 
-    threadPool_.enqueue([this, k23SITxn, op, prom] () {
-        try {
+    // Projections must include key fields so that k2pgctid/rowid can be created from the resulting
+    // record
+    for (uint32_t keyIdx : schema.partitionKeyFields) {
+        add(schema.fields[keyIdx].name);
+    }
+    for (PgExpr * target : request.targets) {
+        if (request.is_aggregate && target->is_aggregate()) {
+            // aggregates only need their argument columns
+            for (PgExpr* arg : static_cast<PgOperator *>(target)->getArgs()) {
+                if (arg->is_colref()) {
+                    add(static_cast<PgColumnRef *>(arg)->attr_name());
+                }
+            }
+            continue;
+        }
+        if (!target->is_colref()) {
+            throw std::logic_error("Non-projection type in read targets");
+        }
 
-        std::shared_ptr<SqlOpReadRequest> request = op->request();
-        SqlOpResponse& response = op->response();
-        response.skipped = false;
+        PgColumnRef *col_ref = static_cast<PgColumnRef *>(target);
 
-        if (request->k2pgctid_column_values.size() > 0) {
-            // TODO SKV doesn't support k2pgctid_column_value on query yet so no projection or filtering
-            return handleReadByRowIds(k23SITxn, op, prom);
+        // Skip the virtual column which is not stored in K2
+        if (col_ref->attr_num() == VIRTUAL_COLUMN) {
+            continue;
         }
+        add(col_ref->attr_name());
+    }
+    return projection;
+}
+
+template <typename T>
+void ProjectFieldVisitor(std::optional<T> field, const k2::String& fieldName, const std::vector<k2::String>& projection,
+                         k2::dto::SKVRecord& projected) {
+    if (field && std::find(projection.begin(), projection.end(), fieldName) != projection.end()) {
+        projected.serializeNext<T>(std::move(field.value()));
+    } else {
+        projected.serializeNull();
+    }
+}
 
-        std::shared_ptr<k2::Query> scan = nullptr;
+k2::dto::SKVRecord K2Adapter::ProjectRecord(k2::dto::SKVRecord& record, const std::vector<k2::String>& projection) {
+    k2::dto::SKVRecord projected(record.collectionName, record.schema);
+    FOR_EACH_RECORD_FIELD(record, ProjectFieldVisitor, projection, projected);
+    return projected;
+}
 
-        if (request->paging_state && request->paging_state->query) {
-            scan = request->paging_state->query;
-        } else {
-            auto scan_create_result = k23si_->createScanRead(request->collection_name, request->table_id).get();
-            if (!scan_create_result.status.is2xxOK()) {
-                K2LOG_E(log::k2Adapter, "Unable to create scan read request");
-                response.rows_affected_count = 0;
-                response.status = K2StatusToPGStatus(scan_create_result.status);
-                prom->set_value(K2StatusToK2PgStatus(scan_create_result.status));
-                return;
-            }
+// Helper function for the read op task when a vector of k2pgctids are set in the request
+seastar::future<Status> K2Adapter::ReadByRowIds(k2::K2TxnHandle& txn,
+                                                std::shared_ptr<PgReadOpTemplate> op,
+                                                std::shared_ptr<k2::dto::Schema> schema) {
+    std::shared_ptr<SqlOpReadRequest> request = op->request();
 
-            scan = scan_create_result.query;
-            scan->setReverseDirection(!request->is_forward_scan);
+    // issue all reads at once. The client routes each one to the partition which owns the key
+    std::vector<seastar::future<k2::ReadResult<k2::dto::SKVRecord>>> reads;
+    reads.reserve(request->k2pgctid_column_values.size());
+    for (auto& k2pgctid_column_value : request->k2pgctid_column_values) {
+        reads.push_back(txn.read(K2PGTIDToRecord(request->collection_name, schema, k2pgctid_column_value)));
+    }
 
-            std::shared_ptr<k2::dto::Schema> schema = scan->startScanRecord.schema;
-            // Projections must include key fields so that k2pgctid/rowid can be created from the resulting
-            // record
-            if (request->targets.size()) {
-                for (uint32_t keyIdx : schema->partitionKeyFields) {
-                    scan->addProjection(schema->fields[keyIdx].name);
+    // SKV point reads return the full record, the projection is applied to the records read
+    return seastar::when_all_succeed(reads.begin(), reads.end())
+        .then([op, projection=GetProjection(*request, *schema)] (std::vector<k2::ReadResult<k2::dto::SKVRecord>>&& reads) {
+            std::shared_ptr<SqlOpReadRequest> request = op->request();
+            SqlOpResponse& response = op->response();
+
+            k2::Status status;
+            int idx = 0;
+            for (auto& read : reads) {
+                if (read.status.is2xxOK()) {
+                    op->mutable_rows_data()->emplace_back(projection.empty() ? std::move(read.value) : ProjectRecord(read.value, projection));
+                    // use the last read response as the batch response
+                    status = std::move(read.status);
+                    idx++;
+                } else {
+                    // If any read failed, abort and fail the batch
+                    K2LOG_E(log::k2Adapter, "Failed to read for {}, due to {}", k2::String(K2PGTIDToString(request->k2pgctid_column_values[idx])), read.status.message);
+                    status = std::move(read.status);
+                    break;
                 }
             }
-            for (PgExpr * target : request->targets) {
-                if (!target->is_colref()) {
-                    prom->set_exception(std::make_exception_ptr(std::logic_error("Non-projection type in read targets")));
-                    return;
-                }
 
-                PgColumnRef *col_ref = static_cast<PgColumnRef *>(target);
+            response.paging_state = nullptr;
+            K2LOG_D(log::k2Adapter, "ReadByRowIds set response paging state to null for read op tid={}", request->table_id);
+            response.status = K2StatusToPGStatus(status);
+            return K2StatusToK2PgStatus(status);
+        });
+}
 
-                // Skip the virtual column which is not stored in K2
-                if (col_ref->attr_num() == VIRTUAL_COLUMN) {
-                    continue;
-                }
+std::optional<k2::dto::SKVRecord> K2Adapter::MakePointReadRecord(SqlOpReadRequest& request, std::shared_ptr<k2::dto::Schema> schema) {
+    if (request.range_conds == nullptr || request.range_conds->opcode() != PgExpr::Opcode::PG_EXPR_AND ||
+        !request.key_column_values.empty()) {
+        return std::nullopt;
+    }
+    // SKV point reads can't filter
+    if (request.where_conds != nullptr &&
+        (request.where_conds->opcode() != PgExpr::Opcode::PG_EXPR_AND || !static_cast<PgOperator *>(request.where_conds)->getArgs().empty())) {
+        return std::nullopt;
+    }
 
-                k2::String name = col_ref->attr_name();
-                // Skip key fields which were already projected above
-                bool skip = false;
-                for (uint32_t keyIdx : schema->partitionKeyFields) {
-                    if (name == schema->fields[keyIdx].name) {
-                        skip = true;
-                        break;
-                    }
-                }
-                if (skip) {
-                    continue;
-                }
+    const std::vector<k2::dto::SchemaField>& fields = schema->fields;
+    const size_t key_field_count = schema->partitionKeyFields.size();
+    std::vector<const SqlValue*> values(key_field_count, nullptr);
+    for (PgExpr* cond : static_cast<PgOperator *>(request.range_conds)->getArgs()) {
+        auto& args = static_cast<PgOperator *>(cond)->getArgs();
+        if (cond->opcode() != PgExpr::Opcode::PG_EXPR_EQ || args.size() != 2 || !args[0]->is_colref() || !args[1]->is_constant()) {
+            return std::nullopt;
+        }
+        k2::String name(static_cast<PgColumnRef *>(args[0])->attr_name());
+        const SqlValue* value = static_cast<PgConstant *>(args[1])->getValue();
+        size_t idx = SKV_FIELD_OFFSET;
+        while (idx < key_field_count && fields[idx].name != name) {
+            idx++;
+        }
+        if (idx == key_field_count || values[idx] != nullptr || value->IsNull() || !IsKeyCompatible(*value, fields[idx].type)) {
+            return std::nullopt;
+        }
+        values[idx] = value;
+    }
+
+    k2::dto::SKVRecord record(request.collection_name, schema);
+    record.serializeNext<int64_t>(request.base_table_oid);
+    record.serializeNext<int64_t>(request.index_oid);
+    for (size_t idx = SKV_FIELD_OFFSET; idx < key_field_count; idx++) {
+        if (values[idx] == nullptr) {
+            return std::nullopt;
+        }
+        K2Adapter::SerializeValueToSKVRecord(*values[idx], record);
+    }
+    return record;
+}
+
+seastar::future<Status> K2Adapter::ReadByKey(k2::K2TxnHandle& txn, std::shared_ptr<PgReadOpTemplate> op, k2::dto::SKVRecord&& key) {
+    return txn.read(std::move(key))
+        .then([op] (k2::ReadResult<k2::dto::SKVRecord>&& read) {
+            std::shared_ptr<SqlOpReadRequest> request = op->request();
+            SqlOpResponse& response = op->response();
+            response.paging_state = nullptr;
 
-                scan->addProjection(name);
-                K2LOG_V(log::k2Adapter, "Projection added for name={}", name);
+            if (request->is_aggregate) {
+                std::vector<SqlOpAggregatePartial>& partials = *(op->mutable_aggregates());
+                partials.clear();
+                for (PgExpr* target : request->targets) {
+                    partials.push_back(SqlOpAggregatePartial::Initial(target->opcode()));
+                }
             }
 
-            // create the start/end records based on the data found in the request and the hard-coded tableid/idxid
-            auto [startRecord, startStatus] = MakeSKVRecordWithKeysSerialized(*request, false);
-            auto [endRecord, endStatus] = MakeSKVRecordWithKeysSerialized(*request, false);
-
-            if (!startStatus.ok() || !endStatus.ok()) {
-                // An error here means the schema could not be retrieved, which shouldn't happen
-                // because the schema would have been used to make the original query
-                K2LOG_E(log::k2Adapter, "Scan request cannot create SKVRecords due to: {} ;;; {}", startStatus, endStatus);
-                response.status = SqlOpResponse::RequestStatus::PGSQL_STATUS_RUNTIME_ERROR;
-                response.rows_affected_count = 0;
-                prom->set_value(std::move(startStatus.ok() ? endStatus : startStatus));
-                return;
+            if (read.status == k2::dto::K23SIStatus::KeyNotFound) {
+                // no row with the key, same as an empty scan
+                read.status = k2::dto::K23SIStatus::OK;
+            } else if (read.status.is2xxOK()) {
+                if (request->is_aggregate) {
+                    AccumulateAggregates(request->targets, read.value, *(op->mutable_aggregates()));
+                } else {
+                    // the full record is returned, only keep the projected fields as a scan would
+                    std::vector<k2::String> projection = GetProjection(*request, *read.value.schema);
+                    op->mutable_rows_data()->emplace_back(projection.empty() ? std::move(read.value) : ProjectRecord(read.value, projection));
+                }
+            } else {
+                K2LOG_E(log::k2Adapter, "Failed to read key for table {}, due to {}", request->table_id, read.status.message);
             }
 
-            // update the records based on the range condition found in the request
-            std::vector<PgExpr *> leftover_exprs;
-            auto rngStatus = HandleRangeConditions(request->range_conds, leftover_exprs, startRecord, endRecord);
-            if (!rngStatus.ok()) {
-                response.status = SqlOpResponse::RequestStatus::PGSQL_STATUS_RUNTIME_ERROR;
-                response.rows_affected_count = 0;
-                prom->set_value(std::move(rngStatus));
-                return;
+            response.status = K2StatusToPGStatus(read.status);
+            return K2StatusToK2PgStatus(read.status);
+        });
+}
+
+Status K2Adapter::PrepareScan(SqlOpReadRequest& request, std::shared_ptr<k2::dto::Schema> schema, k2::Query& scan) {
+    scan.setReverseDirection(!request.is_forward_scan);
+
+    for (k2::String& name : GetProjection(request, *schema)) {
+        K2LOG_V(log::k2Adapter, "Projection added for name={}", name);
+        scan.addProjection(std::move(name));
+    }
+
+    // create the start/end records based on the data found in the request and the hard-coded tableid/idxid
+    k2::dto::SKVRecord startRecord = MakeSKVRecordWithKeysSerialized(request, schema, false);
+    k2::dto::SKVRecord endRecord = MakeSKVRecordWithKeysSerialized(request, schema, false);
+
+    // update the records based on the range condition found in the request
+    std::vector<PgExpr *> leftover_exprs;
+    RETURN_NOT_OK(HandleRangeConditions(request.range_conds, leftover_exprs, startRecord, endRecord));
+
+    scan.startScanRecord = std::move(startRecord);
+    scan.endScanRecord = std::move(endRecord);
+
+    if (request.where_conds != nullptr || !leftover_exprs.empty()) {
+        const K2PgTypeEntity *bool_type = K2PgFindTypeEntity(BOOL_TYPE_OID);
+        PgOperator top_and_opr("and", bool_type);
+        PgOperator *top_opr;
+        if (request.where_conds != nullptr) {
+            top_opr = static_cast<PgOperator *>(request.where_conds);
+        } else {
+            top_opr = &top_and_opr;
+        }
+        if (!leftover_exprs.empty()) {
+            // add the left over conditions to where conditions
+            // the top level expression is an AND, thus, we can add the left_over as its arguments
+            for (auto leftover_expr : leftover_exprs) {
+                top_opr->AppendArg(leftover_expr);
             }
+        }
 
-            scan->startScanRecord = std::move(startRecord);
-            scan->endScanRecord = std::move(endRecord);
+        if (!top_opr->getArgs().empty()) {
+            scan.setFilterExpression(ToK2Expression(top_opr));
+        }
+    }
 
-            if (request->where_conds != nullptr || !leftover_exprs.empty()) {
-                const K2PgTypeEntity *bool_type = K2PgFindTypeEntity(BOOL_TYPE_OID);
-                PgOperator top_and_opr("and", bool_type);
-                PgOperator *top_opr;
-                if (request->where_conds != nullptr) {
-                    top_opr = static_cast<PgOperator *>(request->where_conds);
-                } else {
-                    top_opr = &top_and_opr;
-                }
-                if (!leftover_exprs.empty()) {
-                    // add the left over conditions to where conditions
-                    // the top level expression is an AND, thus, we can add the left_over as its arguments
-                    for (auto leftover_expr : leftover_exprs) {
-                        top_opr->AppendArg(leftover_expr);
-                    }
-                }
+    // this is a total limit.
+    if (request.limit > 0) {
+        scan.setLimit(request.limit);
+    }
+    return Status::OK();
+}
 
-                if (!top_opr->getArgs().empty()) {
-                    scan->setFilterExpression(ToK2Expression(top_opr));
-                }
+seastar::future<Status> K2Adapter::RunScan(k2::K2TxnHandle& txn,
+                                           std::shared_ptr<PgReadOpTemplate> op,
+                                           std::shared_ptr<k2::Query> scan) {
+    return txn.query(*scan)
+        .then([op, scan] (k2::QueryResult&& scan_result) {
+            std::shared_ptr<SqlOpReadRequest> request = op->request();
+            SqlOpResponse& response = op->response();
+
+            if (scan->isDone()) {
+                response.paging_state = nullptr;
+                K2LOG_D(log::k2Adapter, "Scan is done, set response paging state to null for request {}", request->table_id);
+            } else if (request->paging_state) {
+                response.paging_state = request->paging_state;
+                response.paging_state->total_num_rows_read += scan_result.records.size();
+                K2LOG_D(log::k2Adapter, "Request paging state is null? {}, for request {}, total num of read {}", (request->paging_state == nullptr), request->table_id, response.paging_state->total_num_rows_read);
+            } else {
+                response.paging_state = std::make_shared<SqlOpPagingState>();
+                response.paging_state->query = scan;
+                response.paging_state->total_num_rows_read += scan_result.records.size();
+                K2LOG_D(log::k2Adapter, "Created paging state for request {}, total rows read={}", request->table_id,  response.paging_state->total_num_rows_read);
             }
 
-            // this is a total limit.
-            if (request->limit > 0) {
-                scan->setLimit(request->limit);
+            if (request->is_aggregate) {
+                // SKV can't aggregate yet, so fold the page here and only hand the partial results over to PG
+                std::vector<SqlOpAggregatePartial>& partials = *(op->mutable_aggregates());
+                partials.clear();
+                for (PgExpr* target : request->targets) {
+                    partials.push_back(SqlOpAggregatePartial::Initial(target->opcode()));
+                }
+                for (k2::dto::SKVRecord& record : scan_result.records) {
+                    AccumulateAggregates(request->targets, record, partials);
+                }
+            } else {
+                *(op->mutable_rows_data()) = std::move(scan_result.records);
             }
+
+            response.status = K2StatusToPGStatus(scan_result.status);
+            return K2StatusToK2PgStatus(scan_result.status);
+        });
+}
+
+OpTask K2Adapter::MakeReadOpTask(std::shared_ptr<PgReadOpTemplate> op, std::shared_ptr<k2::dto::Schema> schema) {
+    return [this, op, schema] (k2::K23SIClient& client, k2::K2TxnHandle& txn) {
+        std::shared_ptr<SqlOpReadRequest> request = op->request();
+        op->response().skipped = false;
+
+        if (request->k2pgctid_column_values.size() > 0) {
+            return ReadByRowIds(txn, op, schema);
         }
 
-        k2::QueryResult scan_result = k23SITxn->scanRead(scan).get();
-        if (scan->isDone()) {
-            response.paging_state = nullptr;
-            K2LOG_D(log::k2Adapter, "Scan is done, set response paging state to null for request {}", request->table_id);
-        } else if (request->paging_state) {
-            response.paging_state = request->paging_state;
-            response.paging_state->total_num_rows_read += scan_result.records.size();
-            K2LOG_D(log::k2Adapter, "Request paging state is null? {}, for request {}, total num of read {}", (request->paging_state == nullptr), request->table_id, response.paging_state->total_num_rows_read);
-        } else {
-            response.paging_state = std::make_shared<SqlOpPagingState>();
-            response.paging_state->query = scan;
-            response.paging_state->total_num_rows_read += scan_result.records.size();
-            K2LOG_D(log::k2Adapter, "Created paging state for request {}, total rows read={}", request->table_id,  response.paging_state->total_num_rows_read);
+        if (request->paging_state && request->paging_state->query) {
+            return RunScan(txn, op, request->paging_state->query);
+        }
+
+        if (std::optional<k2::dto::SKVRecord> key = MakePointReadRecord(*request, schema)) {
+            return ReadByKey(txn, op, std::move(*key));
         }
 
-        *(op->mutable_rows_data()) = std::move(scan_result.records);
+        return client.createQuery(k2::String(request->collection_name), k2::String(request->table_id))
+            .then([this, op, schema, &txn] (auto&& result) {
+                SqlOpResponse& response = op->response();
+                if (!result.status.is2xxOK()) {
+                    K2LOG_E(log::k2Adapter, "Unable to create scan read request");
+                    response.rows_affected_count = 0;
+                    response.status = K2StatusToPGStatus(result.status);
+                    return seastar::make_ready_future<Status>(K2StatusToK2PgStatus(result.status));
+                }
+
+                auto scan = std::make_shared<k2::Query>(std::move(result.query));
+                Status status = PrepareScan(*op->request(), schema, *scan);
+                if (!status.ok()) {
+                    response.status = SqlOpResponse::RequestStatus::PGSQL_STATUS_RUNTIME_ERROR;
+                    response.rows_affected_count = 0;
+                    return seastar::make_ready_future<Status>(std::move(status));
+                }
+                return RunScan(txn, op, scan);
+            });
+    };
+}
 
-        response.status = K2StatusToPGStatus(scan_result.status);
-        prom->set_value(K2StatusToK2PgStatus(scan_result.status));
+static SqlValue NullSqlValue(SqlValue::ValueType type) {
+    SqlValue value((int64_t)0);
+    value.set_int64_value(0, true);
+    value.type_ = type;
+    return value;
+}
 
-        } catch (const std::exception& e) {
-            K2LOG_W(log::k2Adapter, "Throw in handleReadOp {}", e.what());
-            prom->set_exception(std::current_exception());
+// true if some of the new values of the UPDATE are computed from the current row, e.g. SET col = col + 1
+static bool HasAssignExprs(const SqlOpWriteRequest& request) {
+    if (request.stmt_type != SqlOpWriteRequest::StmtType::PGSQL_UPDATE) {
+        return false;
+    }
+    for (const std::shared_ptr<BindVariable>& column : request.column_new_values) {
+        if (column != nullptr && column->expr != nullptr && column->expr->is_assign_expr()) {
+            return true;
         }
-    });
+    }
+    return false;
+}
 
-    return result;
+template <typename T>
+void AssignRowFieldVisitor(std::optional<T> field, const k2::String& fieldName, K2Adapter::AssignRow& row) {
+    std::string name(fieldName.c_str(), fieldName.size());
+    if constexpr (std::is_same<T, k2::String>::value) {
+        row.emplace(std::move(name), field ? SqlValue(std::string(field->c_str(), field->size())) : NullSqlValue(SqlValue::ValueType::SLICE));
+    } else if constexpr (std::is_same<T, bool>::value) {
+        row.emplace(std::move(name), field ? SqlValue(field.value()) : NullSqlValue(SqlValue::ValueType::BOOL));
+    } else if constexpr (std::is_same<T, float>::value) {
+        row.emplace(std::move(name), field ? SqlValue(field.value()) : NullSqlValue(SqlValue::ValueType::FLOAT));
+    } else if constexpr (std::is_same<T, double>::value) {
+        row.emplace(std::move(name), field ? SqlValue(field.value()) : NullSqlValue(SqlValue::ValueType::DOUBLE));
+    } else if constexpr (std::is_integral<T>::value) {
+        row.emplace(std::move(name), field ? SqlValue((int64_t)field.value()) : NullSqlValue(SqlValue::ValueType::INT));
+    }
+    // the other SKV types are never created for SQL columns
 }
 
-CBFuture<Status> K2Adapter::handleWriteOp(std::shared_ptr<K23SITxn> k23SITxn,
-                                             std::shared_ptr<PgWriteOpTemplate> op) {
-    auto prom = std::make_shared<std::promise<Status>>();
-    auto result = CBFuture<Status>(prom->get_future(), [] {});
+// Builds the index record of a base table row. The index columns are the base table columns of the same name, plus
+// the k2pgctid of the row and, for unique indexes, the key suffix which is set the same way as for the index writes
+// from PG: to the k2pgctid if some of the key columns are null, so that such rows don't conflict with each other
+static k2::dto::SKVRecord MakeIndexRecord(k2::dto::SKVRecord& row, const std::string& collection_name,
+                                          std::shared_ptr<k2::dto::Schema> index_schema,
+                                          k2pg::sql::PgOid base_table_oid, k2pg::sql::PgOid index_oid) {
+    SqlValue basectid(K2Adapter::GetRowIdFromReadRecord(row));
+    K2Adapter::AssignRow values;
+    FOR_EACH_RECORD_FIELD(row, AssignRowFieldVisitor, values);
+
+    bool has_null_key = false;
+    for (uint32_t idx : index_schema->partitionKeyFields) {
+        const k2::String& name = index_schema->fields[idx].name;
+        auto it = values.find(std::string(name.c_str(), name.size()));
+        if (idx >= K2Adapter::SKV_FIELD_OFFSET && it != values.end() && it->second.IsNull()) {
+            has_null_key = true;
+            break;
+        }
+    }
 
-    threadPool_.enqueue([this, k23SITxn, op, prom] () {
-        try {
+    k2::dto::SKVRecord record(collection_name, index_schema);
+    record.serializeNext<int64_t>(base_table_oid);
+    record.serializeNext<int64_t>(index_oid);
+    for (size_t idx = K2Adapter::SKV_FIELD_OFFSET; idx < index_schema->fields.size(); ++idx) {
+        std::string name(index_schema->fields[idx].name.c_str(), index_schema->fields[idx].name.size());
+        if (name == "k2pgidxbasectid") {
+            K2Adapter::SerializeValueToSKVRecord(basectid, record);
+        } else if (name == "k2pguniqueidxkeysuffix") {
+            K2Adapter::SerializeValueToSKVRecord(has_null_key ? basectid : NullSqlValue(SqlValue::ValueType::SLICE), record);
+        } else {
+            auto it = values.find(name);
+            if (it == values.end()) {
+                throw std::logic_error("Index column " + name + " is not a column of the base table");
+            }
+            K2Adapter::SerializeValueToSKVRecord(it->second, record);
+        }
+    }
+    return record;
+}
 
+OpTask K2Adapter::MakeWriteOpTask(std::shared_ptr<PgWriteOpTemplate> op, std::shared_ptr<k2::dto::Schema> schema) {
+    return [this, op, schema] (k2::K23SIClient&, k2::K2TxnHandle& txn) {
         std::shared_ptr<SqlOpWriteRequest> writeRequest = op->request();
-        SqlOpResponse& response = op->response();
-        response.skipped = false;
+        op->response().skipped = false;
 
         if (writeRequest->targets.size()) {
             throw std::logic_error("Targets are not supported for write");
         }
 
-        bool ignoreK2PGTID = writeRequest->stmt_type == SqlOpWriteRequest::StmtType::PGSQL_INSERT;
-        auto [record, status] = MakeSKVRecordWithKeysSerialized(*writeRequest, writeRequest->k2pgctid_column_value != nullptr, ignoreK2PGTID);
-        if (!status.ok()) {
-            response.status = SqlOpResponse::RequestStatus::PGSQL_STATUS_RUNTIME_ERROR;
-            response.rows_affected_count = 0;
-            prom->set_value(std::move(status));
-            return;
+        if (!HasAssignExprs(*writeRequest)) {
+            return RunWrite(txn, op, schema, nullptr);
         }
-        bool useK2PGTID = !ignoreK2PGTID && writeRequest->k2pgctid_column_value;
-
-        K2LOG_V(log::k2Adapter, "Record made for write with ignore={}, k2pgctid={}, record={}", ignoreK2PGTID, writeRequest->k2pgctid_column_value, record);
 
-        bool erase = writeRequest->stmt_type == SqlOpWriteRequest::StmtType::PGSQL_DELETE;
-
-        k2::dto::ExistencePrecondition precondition = k2::dto::ExistencePrecondition::None;
-        if (writeRequest->stmt_type == SqlOpWriteRequest::StmtType::PGSQL_INSERT) {
-            precondition = k2::dto::ExistencePrecondition::NotExists;
-        } else if (writeRequest->stmt_type == SqlOpWriteRequest::StmtType::PGSQL_DELETE) {
-            precondition = k2::dto::ExistencePrecondition::Exists;
+        // SKV can't evaluate update expressions yet (see chogori-platform issue #137), so read the current row and
+        // compute the new values from it here, in the same continuation chain as the partial update
+        if (writeRequest->k2pgctid_column_value == nullptr) {
+            throw std::logic_error("Assignment expressions need the k2pgctid of the updated row");
         }
+        return txn.read(K2PGTIDToRecord(writeRequest->collection_name, schema, writeRequest->k2pgctid_column_value))
+            .then([this, &txn, op, schema] (k2::ReadResult<k2::dto::SKVRecord>&& current) {
+                if (current.status == k2::dto::K23SIStatus::KeyNotFound) {
+                    // same as the precondition failure of a regular UPDATE, i.e. no rows affected
+                    return seastar::make_ready_future<Status>(HandleWriteStatus(op, k2::dto::K23SIStatus::ConditionFailed));
+                }
+                if (!current.status.is2xxOK()) {
+                    return seastar::make_ready_future<Status>(HandleWriteStatus(op, std::move(current.status)));
+                }
+                auto row = std::make_shared<AssignRow>();
+                FOR_EACH_RECORD_FIELD(current.value, AssignRowFieldVisitor, *row);
+                return RunWrite(txn, op, schema, row.get()).finally([row] {});
+            });
+    };
+}
 
-        // UDPATE and DELETE only, get the cached key record
-        k2::dto::SKVRecord keyRecord{};
-        if (useK2PGTID) {
-            keyRecord = K2PGTIDToRecord(record.collectionName, record.schema, writeRequest->k2pgctid_column_value);
-        }
+seastar::future<Status> K2Adapter::RunWrite(k2::K2TxnHandle& txn,
+                                            std::shared_ptr<PgWriteOpTemplate> op,
+                                            std::shared_ptr<k2::dto::Schema> schema,
+                                            const AssignRow* currentRow) {
+    std::shared_ptr<SqlOpWriteRequest> writeRequest = op->request();
+    if (writeRequest->record != nullptr) {
+        // serialized on the PG thread, copy it to make it RDMA safe
+        k2::dto::SKVRecord record = writeRequest->record->deepCopy();
+        k2::dto::ExistencePrecondition precondition = writeRequest->stmt_type == SqlOpWriteRequest::StmtType::PGSQL_INSERT
+                ? k2::dto::ExistencePrecondition::NotExists : k2::dto::ExistencePrecondition::None;
+        return txn.write(record, false, precondition)
+            .then([op] (k2::WriteResult&& writeResult) {
+                return HandleWriteStatus(op, std::move(writeResult.status));
+            });
+    }
 
-        // populate the data, fieldsForUpdate is only relevant for UPDATE
-        std::vector<std::shared_ptr<BindVariable>>& values = writeRequest->stmt_type != SqlOpWriteRequest::StmtType::PGSQL_UPDATE
-                ? writeRequest->column_values : writeRequest->column_new_values;
-        std::vector<uint32_t> fieldsForUpdate = SerializeSKVValueFields(record, values);
+    bool ignoreK2PGTID = writeRequest->stmt_type == SqlOpWriteRequest::StmtType::PGSQL_INSERT;
+    k2::dto::SKVRecord record = MakeSKVRecordWithKeysSerialized(*writeRequest, schema, writeRequest->k2pgctid_column_value != nullptr, ignoreK2PGTID);
+    bool useK2PGTID = !ignoreK2PGTID && writeRequest->k2pgctid_column_value;
 
-        k2::Status writeStatus;
+    K2LOG_V(log::k2Adapter, "Record made for write with ignore={}, k2pgctid={}, record={}", ignoreK2PGTID, writeRequest->k2pgctid_column_value, record);
 
-        // For DELETE we need to use the key record we got from k2pgctid if it exists,
-        // not the record generated from column values
-        if (writeRequest->stmt_type == SqlOpWriteRequest::StmtType::PGSQL_DELETE &&
-            useK2PGTID) {
-            record = std::move(keyRecord);
-        }
+    bool erase = writeRequest->stmt_type == SqlOpWriteRequest::StmtType::PGSQL_DELETE;
 
-        // block-write
-        if (writeRequest->stmt_type != SqlOpWriteRequest::StmtType::PGSQL_UPDATE) {
-            k2::WriteResult writeResult = k23SITxn->write(std::move(record), erase, precondition).get();
-            writeStatus = std::move(writeResult.status);
-        } else {
-            k2::PartialUpdateResult updateResult = k23SITxn->partialUpdate(std::move(record),
-                            std::move(fieldsForUpdate), keyRecord.getPartitionKey()).get();
-            writeStatus = std::move(updateResult.status);
-        }
+    k2::dto::ExistencePrecondition precondition = k2::dto::ExistencePrecondition::None;
+    if (writeRequest->stmt_type == SqlOpWriteRequest::StmtType::PGSQL_INSERT) {
+        precondition = k2::dto::ExistencePrecondition::NotExists;
+    } else if (writeRequest->stmt_type == SqlOpWriteRequest::StmtType::PGSQL_DELETE) {
+        precondition = k2::dto::ExistencePrecondition::Exists;
+    }
 
-        if (writeStatus.is2xxOK()) {
-            response.rows_affected_count = 1;
-        } else if (writeRequest->stmt_type == SqlOpWriteRequest::StmtType::PGSQL_INSERT ||
-                    writeStatus != k2::dto::K23SIStatus::ConditionFailed) {
-            response.rows_affected_count = 0;
-            response.error_message = writeStatus.message;
-            // TODO pg_error_code or txn_error_code in response?
-            K2LOG_E(log::k2Adapter, "K2 write failed due to {}", response.error_message);
-        } else {
-            // ConditionFailed status. SQL expects this to be an OK status with no rows affected if update or
-            // delete
-            response.rows_affected_count = 0;
-            writeStatus = k2::dto::K23SIStatus::OK;
-        }
+    // UDPATE and DELETE only, get the cached key record
+    k2::dto::SKVRecord keyRecord{};
+    if (useK2PGTID) {
+        keyRecord = K2PGTIDToRecord(record.collectionName, record.schema, writeRequest->k2pgctid_column_value);
+    }
 
-        K2LOG_D(log::k2Adapter, "K2 write status: {}", writeStatus);
-        response.status = K2StatusToPGStatus(writeStatus);
-        prom->set_value(K2StatusToK2PgStatus(writeStatus));
+    // populate the data, fieldsForUpdate is only relevant for UPDATE
+    std::vector<std::shared_ptr<BindVariable>>& values = writeRequest->stmt_type != SqlOpWriteRequest::StmtType::PGSQL_UPDATE
+            ? writeRequest->column_values : writeRequest->column_new_values;
+    std::vector<uint32_t> fieldsForUpdate;
+    Status status = SerializeSKVValueFields(record, values, currentRow, fieldsForUpdate);
+    if (!status.ok()) {
+        SqlOpResponse& response = op->response();
+        response.status = SqlOpResponse::RequestStatus::PGSQL_STATUS_RUNTIME_ERROR;
+        response.rows_affected_count = 0;
+        response.error_message = status.ToString();
+        return seastar::make_ready_future<Status>(std::move(status));
+    }
 
-        } catch (const std::exception& e) {
-            K2LOG_W(log::k2Adapter, "Throw in handlewrite: {}", e.what());
-            prom->set_exception(std::current_exception());
+    // For DELETE we need to use the key record we got from k2pgctid if it exists,
+    // not the record generated from column values
+    if (writeRequest->stmt_type == SqlOpWriteRequest::StmtType::PGSQL_DELETE &&
+        useK2PGTID) {
+        record = std::move(keyRecord);
+    }
+
+    // The record is built on this thread, so it is RDMA safe without an extra copy
+    seastar::future<k2::Status> write = seastar::make_ready_future<k2::Status>();
+    if (writeRequest->stmt_type != SqlOpWriteRequest::StmtType::PGSQL_UPDATE) {
+        write = txn.write(record, erase, precondition)
+            .then([] (k2::WriteResult&& writeResult) { return std::move(writeResult.status); });
+    } else {
+        k2::dto::Key key{};
+        if (useK2PGTID) {
+            key.schemaName = record.schema->name;
+            key.partitionKey = keyRecord.getPartitionKey();
+            key.rangeKey = "";
         }
+        write = txn.partialUpdate(record, std::move(fieldsForUpdate), std::move(key))
+            .then([] (k2::PartialUpdateResult&& updateResult) { return std::move(updateResult.status); });
+    }
+
+    return write.then([op] (k2::Status&& writeStatus) {
+        return HandleWriteStatus(op, std::move(writeStatus));
     });
+}
 
-    return result;
+Status K2Adapter::HandleWriteStatus(std::shared_ptr<PgWriteOpTemplate> op, k2::Status writeStatus) {
+    std::shared_ptr<SqlOpWriteRequest> writeRequest = op->request();
+    SqlOpResponse& response = op->response();
+    if (writeStatus.is2xxOK()) {
+        response.rows_affected_count = 1;
+    } else if (writeRequest->stmt_type == SqlOpWriteRequest::StmtType::PGSQL_INSERT ||
+                writeStatus != k2::dto::K23SIStatus::ConditionFailed) {
+        response.rows_affected_count = 0;
+        response.error_message = writeStatus.message;
+        // TODO pg_error_code or txn_error_code in response?
+        K2LOG_E(log::k2Adapter, "K2 write failed due to {}", response.error_message);
+    } else {
+        // ConditionFailed status. SQL expects this to be an OK status with no rows affected if update or
+        // delete
+        response.rows_affected_count = 0;
+        writeStatus = k2::dto::K23SIStatus::OK;
+    }
+
+    K2LOG_D(log::k2Adapter, "K2 write status: {}", writeStatus);
+    response.status = K2StatusToPGStatus(writeStatus);
+    return K2StatusToK2PgStatus(writeStatus);
+}
+
+Status K2Adapter::MakeOpTask(std::shared_ptr<PgOpTemplate> op, OpTask& task, OpCounts& counts) {
+    op->allocateResponse();
+    SqlOpResponse& response = op->response();
+    k2::GetSchemaResult schema_result;
+    switch (op->type()) {
+        case PgOpTemplate::WRITE: {
+            auto write_op = std::static_pointer_cast<PgWriteOpTemplate>(op);
+            std::shared_ptr<SqlOpWriteRequest> request = write_op->request();
+            K2LOG_D(log::k2Adapter, "Executing writing operation for table {}", request->table_id);
+            schema_result = GetSchemaCached(request->collection_name, request->table_id, request->schema_version);
+            if (schema_result.status.is2xxOK()) {
+                counts.writes++;
+                if (HasAssignExprs(*request)) {
+                    // the current row is read first to compute the new values
+                    counts.reads++;
+                }
+                task = MakeWriteOpTask(write_op, schema_result.schema);
+            }
+        } break;
+        case PgOpTemplate::READ: {
+            auto read_op = std::static_pointer_cast<PgReadOpTemplate>(op);
+            std::shared_ptr<SqlOpReadRequest> request = read_op->request();
+            K2LOG_D(log::k2Adapter, "Executing reading operation for table {}", request->table_id);
+            bool byRowIds = request->k2pgctid_column_values.size() > 0;
+            schema_result = GetSchemaCached(request->collection_name, request->table_id,
+                byRowIds ? k2::K23SIClient::ANY_VERSION : request->schema_version);
+            if (schema_result.status.is2xxOK()) {
+                if (byRowIds) {
+                    counts.reads += request->k2pgctid_column_values.size();
+                } else {
+                    counts.scans++;
+                }
+                task = MakeReadOpTask(read_op, schema_result.schema);
+            }
+        } break;
+        default:
+          throw std::logic_error("Unsupported op template type");
+    }
+
+    if (!schema_result.status.is2xxOK()) {
+        // The schema would have been used to make the original query, so this shouldn't happen
+        K2LOG_E(log::k2Adapter, "Cannot get the SKV schema for the op due to {}", schema_result.status);
+        response.status = SqlOpResponse::RequestStatus::PGSQL_STATUS_RUNTIME_ERROR;
+        response.rows_affected_count = 0;
+        return K2StatusToK2PgStatus(schema_result.status);
+    }
+    return Status::OK();
 }
 
 CBFuture<k2::Status> K2Adapter::CreateCollection(const std::string& collection_name, const std::string& DBName)
@@ -833,70 +1316,419 @@ CBFuture<CreateScanReadResult> K2Adapter::CreateScanRead(const std::string& coll
 
 CBFuture<Status> K2Adapter::Exec(std::shared_ptr<K23SITxn> k23SITxn, std::shared_ptr<PgOpTemplate> op) {
     auto start = k2::Clock::now();
-    // 1) check the request in op and construct the SKV request based on the op type, i.e., READ or WRITE
-    // 2) call read or write on k23SITxn
-    // 3) create create a runner in a thread pool to check the response of the SKV call
-    // 4) return a promise and return the future as the response for this method
-    // 5) once the response from SKV returns
+    // 1) check the request in op and look up the SKV schema for it on this thread
+    // 2) hand a task over to the seastar thread, which constructs the SKV request based on the op type, i.e.,
+    //    READ or WRITE, and runs it as continuations on the native txn handle
+    // 3) once the response from SKV returns, still on the seastar thread
     //   a) populate the response object in op
     //   b) populate the data field in op as result set
-    //   c) set the value for future
-    op->allocateResponse();
-    switch (op->type()) {
-        case PgOpTemplate::WRITE: {
-            K2LOG_D(log::k2Adapter, "Executing writing operation for table {}", std::static_pointer_cast<PgWriteOpTemplate>(op)->request()->table_id);
-            auto result = handleWriteOp(k23SITxn, std::static_pointer_cast<PgWriteOpTemplate>(op));
-            K2LOG_V(log::k2Adapter, "Exec took {}", k2::Clock::now() - start);
-            return result;
-        } break;
-        case PgOpTemplate::READ: {
-            K2LOG_D(log::k2Adapter, "Executing reading operation for table {}", std::static_pointer_cast<PgReadOpTemplate>(op)->request()->table_id);
-            auto result = handleReadOp(k23SITxn, std::static_pointer_cast<PgReadOpTemplate>(op));
-            K2LOG_V(log::k2Adapter, "Exec took {}", k2::Clock::now() - start);
-            return result;
-        } break;
-        default:
-          throw new std::logic_error("Unsupported op template type");
+    //   c) set the value for the single future returned by this method
+    OpTask task;
+    OpCounts counts;
+    Status status = MakeOpTask(op, task, counts);
+    if (!status.ok()) {
+        std::promise<Status> prom;
+        prom.set_value(std::move(status));
+        return CBFuture<Status>(prom.get_future(), [] {});
     }
+
+    auto result = k23SITxn->runOp(std::move(task), counts);
+    K2LOG_V(log::k2Adapter, "Exec took {}", k2::Clock::now() - start);
+    return result;
 }
 
-CBFuture<Status> K2Adapter::BatchExec(std::shared_ptr<K23SITxn> k23SITxn, const std::vector<std::shared_ptr<PgOpTemplate>>& ops) {
+CBFuture<Status> K2Adapter::ExecOneShot(std::shared_ptr<PgOpTemplate> op) {
     auto start = k2::Clock::now();
-    // same as the above except that send multiple requests and need to handle multiple futures from SKV
-    // but only return a single future to this method caller. Return Status will be OK all Execs are
-    // successful, otherwise Status will be one of the failed Execs
+    OpTask task;
+    OpCounts counts;
+    Status status = MakeOpTask(op, task, counts);
+    if (!status.ok()) {
+        std::promise<Status> prom;
+        prom.set_value(std::move(status));
+        return CBFuture<Status>(prom.get_future(), [] {});
+    }
+
+    auto result = RunOneShot(std::move(task), counts);
+    K2LOG_V(log::k2Adapter, "ExecOneShot took {}", k2::Clock::now() - start);
+    return result;
+}
+
+CBFuture<Status> K2Adapter::RunOneShot(OpTask&& task, const OpCounts& counts) {
+    // the task ends its own transaction: commit if the task succeeded, otherwise abort and report the task error
+    OpTask oneShot = [task=std::move(task)] (k2::K23SIClient& client, k2::K2TxnHandle& txn) {
+        return seastar::futurize_invoke(task, client, txn)
+            .then([&txn] (Status&& status) {
+                bool commit = status.ok();
+                return txn.end(commit)
+                    .then([commit, status=std::move(status)] (k2::EndResult&& endResult) mutable {
+                        if (!endResult.status.is2xxOK()) {
+                            K2LOG_W(log::k2Adapter, "One shot txn end with commit={} failed due to: {}", commit, endResult.status);
+                        }
+                        return commit ? K2StatusToK2PgStatus(endResult.status) : std::move(status);
+                    });
+            });
+    };
 
-    // This only works if the Exec calls are executed in order by the threadpool, otherwise we could
-    // deadlock if the waiting thread below is executed first
-    auto op_futures = std::make_shared<std::vector<CBFuture<Status>>>();
+    return k23si_->runOneShotOp(MakeTxnOptions(), std::move(oneShot), counts);
+}
+
+CBFuture<Status> K2Adapter::BatchExec(std::shared_ptr<K23SITxn> k23SITxn, const std::vector<std::shared_ptr<PgOpTemplate>>& ops) {
+    auto start = k2::Clock::now();
+    // same as the above except that all the ops run concurrently within a single task on the seastar thread,
+    // so that the caller only waits for a single future. Return Status will be OK all ops are successful,
+    // otherwise Status will be one of the failed ops
+    auto tasks = std::make_shared<std::vector<OpTask>>();
+    tasks->reserve(ops.size());
+    OpCounts counts;
+    Status prepare_status;
     for (const std::shared_ptr<PgOpTemplate>& op : ops) {
-        op_futures->emplace_back(Exec(k23SITxn, op));
+        OpTask task;
+        Status status = MakeOpTask(op, task, counts);
+        if (status.ok()) {
+            tasks->push_back(std::move(task));
+        } else {
+            prepare_status = std::move(status);
+        }
     }
 
-    auto prom = std::make_shared<std::promise<Status>>();
-    auto result = CBFuture<Status>(prom->get_future(), [] {});
-    threadPool_.enqueue([op_futures, prom] () {
-        Status status = Status::OK();
-        std::exception_ptr e = nullptr;
+    OpTask batch = [tasks, prepare_status=std::move(prepare_status)] (k2::K23SIClient& client, k2::K2TxnHandle& txn) {
+        std::vector<seastar::future<Status>> futs;
+        futs.reserve(tasks->size());
+        for (OpTask& task : *tasks) {
+            futs.push_back(seastar::futurize_invoke(task, client, txn));
+        }
+        return seastar::when_all(futs.begin(), futs.end())
+            .then([tasks, prepare_status] (std::vector<seastar::future<Status>>&& results) mutable {
+                Status status = std::move(prepare_status);
+                std::exception_ptr e = nullptr;
+                for (seastar::future<Status>& result : results) {
+                    if (result.failed()) {
+                        e = result.get_exception();
+                        continue;
+                    }
+                    Status exec_status = result.get0();
+                    if (!exec_status.ok()) {
+                        status = std::move(exec_status);
+                    }
+                }
 
-        for (CBFuture<Status>& op : *op_futures) {
-            try {
-                Status exec_status = op.get();
-                if (!exec_status.ok()) {
-                    status = std::move(exec_status);
+                if (e) {
+                    return seastar::make_exception_future<Status>(e);
                 }
-            } catch (...) {
-                e = std::current_exception();
+                return seastar::make_ready_future<Status>(std::move(status));
+            });
+    };
+
+    auto result = k23SITxn->runOp(std::move(batch), counts);
+    K2LOG_V(log::k2Adapter, "BatchExec took {}", k2::Clock::now() - start);
+    return result;
+}
+
+seastar::future<Status> K2Adapter::ScanAndWrite(k2::K23SIClient& client, k2::K2TxnHandle& txn, const std::string& collection_name,
+                                                std::shared_ptr<k2::dto::Schema> schema, k2pg::sql::PgOid table_oid, k2pg::sql::PgOid index_oid,
+                                                PageWriter writer, uint64_t* count,
+                                                std::optional<int64_t> key_lower, std::optional<int64_t> key_upper) {
+    return client.createQuery(k2::String(collection_name), schema->name)
+        .then([=, &txn] (auto&& result) {
+            if (!result.status.is2xxOK()) {
+                K2LOG_E(log::k2Adapter, "Unable to create scan of {} in {}", schema->name, collection_name);
+                return seastar::make_ready_future<Status>(K2StatusToK2PgStatus(result.status));
+            }
+
+            // all the records with the table and index id, i.e. the rows of the table or of the index
+            auto scan = std::make_shared<k2::Query>(std::move(result.query));
+            k2::dto::SKVRecord startRecord(collection_name, schema);
+            startRecord.serializeNext<int64_t>(table_oid);
+            startRecord.serializeNext<int64_t>(index_oid);
+            if (key_lower) {
+                startRecord.serializeNext<int64_t>(*key_lower);
+            }
+            k2::dto::SKVRecord endRecord(collection_name, schema);
+            endRecord.serializeNext<int64_t>(table_oid);
+            endRecord.serializeNext<int64_t>(index_oid);
+            if (key_upper && *key_upper < std::numeric_limits<int64_t>::max()) {
+                endRecord.serializeNext<int64_t>(*key_upper + 1);
             }
+            scan->startScanRecord = std::move(startRecord);
+            scan->endScanRecord = std::move(endRecord);
+
+            auto status = std::make_shared<Status>();
+            return seastar::repeat([=, &txn] {
+                return txn.query(*scan)
+                    .then([=, &txn] (k2::QueryResult&& page) {
+                        if (!page.status.is2xxOK()) {
+                            *status = K2StatusToK2PgStatus(page.status);
+                            return seastar::make_ready_future<seastar::stop_iteration>(seastar::stop_iteration::yes);
+                        }
+
+                        // the writes of a page run concurrently
+                        std::vector<seastar::future<k2::WriteResult>> writes = writer(txn, page.records);
+                        *count += writes.size();
+                        return seastar::when_all_succeed(writes.begin(), writes.end())
+                            .then([=] (std::vector<k2::WriteResult>&& results) {
+                                for (k2::WriteResult& write : results) {
+                                    if (!write.status.is2xxOK()) {
+                                        *status = K2StatusToK2PgStatus(write.status);
+                                        return seastar::stop_iteration::yes;
+                                    }
+                                }
+                                return scan->isDone() ? seastar::stop_iteration::yes : seastar::stop_iteration::no;
+                            });
+                    });
+            }).then([status] { return std::move(*status); });
+        });
+}
+
+// Ranges of the leading key narrower than this are not worth a backfill transaction of their own
+static constexpr int64_t MIN_BACKFILL_RANGE_KEYS = 1000;
+// Each concurrent backfill gets a few ranges, so that a failed range only redoes a part of its share
+static constexpr int64_t BACKFILL_RANGES_PER_WORKER = 4;
+// Attempts of a backfill range whose transaction failed with a transient error
+static constexpr int BACKFILL_RANGE_ATTEMPTS = 3;
+
+// Conflicts with other transactions and unavailable partitions are worth retrying the backfill of a range for
+static bool IsTransientBackfillError(const Status& status) {
+    return status.IsAborted() || status.IsTimedOut() || status.IsServiceUnavailable();
+}
+
+// Deletes all the given records
+static std::vector<seastar::future<k2::WriteResult>> EraseRecords(k2::K2TxnHandle& txn, std::vector<k2::dto::SKVRecord>& rows) {
+    std::vector<seastar::future<k2::WriteResult>> writes;
+    writes.reserve(rows.size());
+    for (k2::dto::SKVRecord& row : rows) {
+        writes.push_back(txn.write(row, true /*erase*/, k2::dto::ExistencePrecondition::None));
+    }
+    return writes;
+}
+
+// Reads the leading key of the first row of the table, or of the last one for a reverse scan. The key is left unset
+// for an empty table
+static seastar::future<Status> FindEdgeKey(k2::K23SIClient& client, k2::K2TxnHandle& txn, const std::string& collection_name,
+                                           std::shared_ptr<k2::dto::Schema> schema, k2pg::sql::PgOid table_oid, bool reverse,
+                                           std::shared_ptr<std::optional<int64_t>> key) {
+    return client.createQuery(k2::String(collection_name), schema->name)
+        .then([=, &txn] (auto&& result) {
+            if (!result.status.is2xxOK()) {
+                return seastar::make_ready_future<Status>(K2Adapter::K2StatusToK2PgStatus(result.status));
+            }
+
+            auto scan = std::make_shared<k2::Query>(std::move(result.query));
+            k2::dto::SKVRecord startRecord(collection_name, schema);
+            startRecord.serializeNext<int64_t>(table_oid);
+            startRecord.serializeNext<int64_t>(0);
+            k2::dto::SKVRecord endRecord(collection_name, schema);
+            endRecord.serializeNext<int64_t>(table_oid);
+            endRecord.serializeNext<int64_t>(0);
+            scan->startScanRecord = std::move(startRecord);
+            scan->endScanRecord = std::move(endRecord);
+            scan->setLimit(1);
+            scan->setReverseDirection(reverse);
+
+            // a page may be empty without the scan being done, e.g. at a partition boundary
+            auto status = std::make_shared<Status>();
+            return seastar::repeat([=, &txn] {
+                return txn.query(*scan)
+                    .then([=] (k2::QueryResult&& page) {
+                        if (!page.status.is2xxOK()) {
+                            *status = K2Adapter::K2StatusToK2PgStatus(page.status);
+                            return seastar::stop_iteration::yes;
+                        }
+                        if (!page.records.empty()) {
+                            *key = page.records[0].deserializeField<int64_t>(schema->fields[K2Adapter::SKV_FIELD_OFFSET].name);
+                            return seastar::stop_iteration::yes;
+                        }
+                        return scan->isDone() ? seastar::stop_iteration::yes : seastar::stop_iteration::no;
+                    });
+            }).then([status] { return std::move(*status); });
+        });
+}
+
+Result<std::vector<K2Adapter::BackfillRange>> K2Adapter::SplitBackfillRanges(const std::string& collection_name,
+                                                                             std::shared_ptr<k2::dto::Schema> schema,
+                                                                             k2pg::sql::PgOid table_oid) {
+    std::vector<BackfillRange> ranges;
+    // e.g. the generated row id of a table without a primary key can't be split. Neither can a descending key, whose
+    // ranges aren't computed yet (see issue #268)
+    if (schema->partitionKeyFields.size() <= SKV_FIELD_OFFSET || schema->fields[SKV_FIELD_OFFSET].type != k2::dto::FieldType::INT64T ||
+        schema->fields[SKV_FIELD_OFFSET].descending) {
+        ranges.emplace_back();
+        return ranges;
+    }
+
+    auto min_key = std::make_shared<std::optional<int64_t>>();
+    auto max_key = std::make_shared<std::optional<int64_t>>();
+    OpTask task = [=] (k2::K23SIClient& client, k2::K2TxnHandle& txn) {
+        return FindEdgeKey(client, txn, collection_name, schema, table_oid, false, min_key)
+            .then([=, &client, &txn] (Status&& status) {
+                if (!status.ok()) {
+                    return seastar::make_ready_future<Status>(std::move(status));
+                }
+                return FindEdgeKey(client, txn, collection_name, schema, table_oid, true, max_key);
+            });
+    };
+    RETURN_NOT_OK(RunOneShot(std::move(task), OpCounts{.scans=2}).get());
+    if (!*min_key || !*max_key || **min_key > **max_key) {
+        return ranges;
+    }
+
+    const __int128 width = (__int128)**max_key - **min_key + 1;
+    const int64_t workers = std::max(1, ScanParallelism());
+    const int64_t range_count = (int64_t)std::max<__int128>(1, std::min<__int128>(workers * BACKFILL_RANGES_PER_WORKER,
+                                                                                  width / MIN_BACKFILL_RANGE_KEYS));
+    const __int128 step = width / range_count;
+    // the first and the last range are open so that rows past the keys found above are not missed
+    int64_t lower = **min_key;
+    for (int64_t idx = 0; idx < range_count; ++idx) {
+        BackfillRange range;
+        if (idx > 0) {
+            range.lower = lower;
+        }
+        if (idx < range_count - 1) {
+            range.upper = (int64_t)(lower + step - 1);
+            lower = *range.upper + 1;
         }
+        ranges.push_back(range);
+    }
+    return ranges;
+}
 
-        if (!e) {
-            prom->set_value(std::move(status));
-        } else {
-            prom->set_exception(e);
+Status K2Adapter::BackfillIndex(std::shared_ptr<K23SITxn> k23SITxn, const std::string& collection_name,
+                                uint32_t base_schema_version, const k2pg::sql::IndexInfo& index_info, uint64_t* indexed_rows) {
+    auto start = k2::Clock::now();
+    *indexed_rows = 0;
+    k2::GetSchemaResult base_result = GetSchemaCached(collection_name, index_info.base_table_id(), base_schema_version);
+    k2::GetSchemaResult index_result = base_result.status.is2xxOK()
+        ? GetSchemaCached(collection_name, index_info.table_id(), index_info.version()) : base_result;
+    if (!index_result.status.is2xxOK()) {
+        K2LOG_E(log::k2Adapter, "Failed to get the schemas to backfill index {} in {} due to {}", index_info.table_id(), collection_name, index_result.status);
+        return K2StatusToK2PgStatus(index_result.status);
+    }
+
+    std::shared_ptr<k2::dto::Schema> base_schema = base_result.schema;
+    std::shared_ptr<k2::dto::Schema> index_schema = index_result.schema;
+    k2pg::sql::PgOid base_table_oid = index_info.base_table_oid();
+    k2pg::sql::PgOid index_oid = index_info.table_oid();
+    k2::dto::ExistencePrecondition precondition = index_info.is_unique() ? k2::dto::ExistencePrecondition::NotExists
+                                                                         : k2::dto::ExistencePrecondition::None;
+
+    // the scan of a range may return the first rows past its upper bound, which belong to the next range
+    auto makeWriter = [=] (std::optional<int64_t> key_upper) -> PageWriter {
+        return [=] (k2::K2TxnHandle& txn, std::vector<k2::dto::SKVRecord>& rows) {
+            std::vector<seastar::future<k2::WriteResult>> writes;
+            writes.reserve(rows.size());
+            for (k2::dto::SKVRecord& row : rows) {
+                if (key_upper) {
+                    std::optional<int64_t> key = row.deserializeField<int64_t>(base_schema->fields[SKV_FIELD_OFFSET].name);
+                    row.seekField(0);
+                    if (key && *key > *key_upper) {
+                        continue;
+                    }
+                }
+                k2::dto::SKVRecord record = MakeIndexRecord(row, collection_name, index_schema, base_table_oid, index_oid);
+                writes.push_back(txn.write(record, false, precondition));
+            }
+            return writes;
+        };
+    };
+
+    if (k23SITxn->_writeOps > 0) {
+        // the rows written by this transaction are only visible to it, so the index has to be built in it
+        PageWriter writer = makeWriter(std::nullopt);
+        OpTask task = [=] (k2::K23SIClient& client, k2::K2TxnHandle& txn) {
+            // the rows of the base table have a zero index id
+            return ScanAndWrite(client, txn, collection_name, base_schema, base_table_oid, 0, writer, indexed_rows);
+        };
+        Status status = k23SITxn->runOp(std::move(task), OpCounts{.writes=1, .scans=1}).get();
+        K2LOG_V(log::k2Adapter, "BackfillIndex took {}", k2::Clock::now() - start);
+        return status;
+    }
+
+    std::vector<BackfillRange> ranges = VERIFY_RESULT(SplitBackfillRanges(collection_name, base_schema, base_table_oid));
+    const size_t workers = std::max(1, ScanParallelism());
+    Status status;
+    for (int attempt = 1; attempt <= BACKFILL_RANGE_ATTEMPTS; ++attempt) {
+        // the ranges which aren't done yet, each in a one shot transaction, with at most workers of them in flight.
+        // The counts are shared with the tasks since an exception may leave some of them running after we return
+        struct RunningRange {
+            BackfillRange* range;
+            std::shared_ptr<uint64_t> rows;
+            CBFuture<Status> result;
+        };
+        std::deque<RunningRange> running;
+        status = Status::OK();
+        auto awaitOldest = [&] {
+            RunningRange& oldest = running.front();
+            Status range_status = oldest.result.get();
+            if (range_status.ok()) {
+                oldest.range->done = true;
+                *indexed_rows += *oldest.rows;
+            } else if (status.ok() || !IsTransientBackfillError(range_status)) {
+                // a permanent error, e.g. a duplicate key of a unique index, wins over a transient one
+                status = std::move(range_status);
+            }
+            running.pop_front();
+        };
+        for (BackfillRange& range : ranges) {
+            if (!status.ok() && !IsTransientBackfillError(status)) {
+                break;
+            }
+            if (range.done) {
+                continue;
+            }
+            if (running.size() >= workers) {
+                awaitOldest();
+            }
+            auto rows = std::make_shared<uint64_t>(0);
+            PageWriter writer = makeWriter(range.upper);
+            OpTask task = [=, lower=range.lower, upper=range.upper] (k2::K23SIClient& client, k2::K2TxnHandle& txn) {
+                return ScanAndWrite(client, txn, collection_name, base_schema, base_table_oid, 0, writer, rows.get(), lower, upper);
+            };
+            running.push_back(RunningRange{.range=&range, .rows=rows, .result=RunOneShot(std::move(task), OpCounts{.writes=1, .scans=1})});
         }
-    });
-    K2LOG_V(log::k2Adapter, "BatchExec took {}", k2::Clock::now() - start);
+        while (!running.empty()) {
+            awaitOldest();
+        }
+        if (status.ok() || !IsTransientBackfillError(status)) {
+            break;
+        }
+        K2LOG_W(log::k2Adapter, "Backfill of index {} in {} failed on attempt {} due to {}", index_info.table_id(), collection_name, attempt, status);
+    }
+
+    if (!status.ok() && std::any_of(ranges.begin(), ranges.end(), [] (const BackfillRange& range) { return range.done; })) {
+        // the committed ranges are not rolled back with the transaction of the build, so remove what they wrote
+        auto deleted_rows = std::make_shared<uint64_t>(0);
+        OpTask cleanup = [=] (k2::K23SIClient& client, k2::K2TxnHandle& txn) {
+            return ScanAndWrite(client, txn, collection_name, index_schema, base_table_oid, index_oid, EraseRecords, deleted_rows.get());
+        };
+        Status cleanup_status = RunOneShot(std::move(cleanup), OpCounts{.writes=1, .scans=1}).get();
+        if (!cleanup_status.ok()) {
+            K2LOG_W(log::k2Adapter, "Failed to remove the rows of index {} in {} after a failed backfill due to {}", index_info.table_id(), collection_name, cleanup_status);
+        }
+    }
+    K2LOG_V(log::k2Adapter, "BackfillIndex of {} ranges took {}", ranges.size(), k2::Clock::now() - start);
+    return status;
+}
+
+CBFuture<Status> K2Adapter::DeleteAllRows(std::shared_ptr<K23SITxn> k23SITxn, const std::string& collection_name,
+                                          const std::string& schema_name, uint32_t schema_version,
+                                          k2pg::sql::PgOid table_oid, k2pg::sql::PgOid index_oid, uint64_t* deleted_rows) {
+    auto start = k2::Clock::now();
+    *deleted_rows = 0;
+    k2::GetSchemaResult schema_result = GetSchemaCached(collection_name, schema_name, schema_version);
+    if (!schema_result.status.is2xxOK()) {
+        K2LOG_E(log::k2Adapter, "Failed to get the schema to delete all rows of {} in {} due to {}", schema_name, collection_name, schema_result.status);
+        std::promise<Status> prom;
+        prom.set_value(K2StatusToK2PgStatus(schema_result.status));
+        return CBFuture<Status>(prom.get_future(), [] {});
+    }
+
+    std::shared_ptr<k2::dto::Schema> schema = schema_result.schema;
+    OpTask task = [=] (k2::K23SIClient& client, k2::K2TxnHandle& txn) {
+        return ScanAndWrite(client, txn, collection_name, schema, table_oid, index_oid, EraseRecords, deleted_rows);
+    };
+
+    auto result = k23SITxn->runOp(std::move(task), OpCounts{.writes=1, .scans=1});
+    K2LOG_V(log::k2Adapter, "DeleteAllRows took {}", k2::Clock::now() - start);
     return result;
 }
 
@@ -982,8 +1814,7 @@ std::string K2Adapter::GetRowId(const std::string& collection_name, const std::s
     k2pg::sql::PgOid base_table_oid, k2pg::sql::PgOid index_oid, std::unordered_map<std::string, SqlValue *>& key_values)
 {
     auto start = k2::Clock::now();
-    CBFuture<k2::GetSchemaResult> schema_f = k23si_->getSchema(collection_name, schema_name, schema_version);
-    k2::GetSchemaResult schema_result = schema_f.get();
+    k2::GetSchemaResult schema_result = GetSchemaCached(collection_name, schema_name, schema_version);
     if (!schema_result.status.is2xxOK()) {
         throw std::runtime_error(fmt::format("Failed to get schema for {} in {} due to {}",
                                     schema_name, collection_name, schema_result.status));
@@ -1009,14 +1840,43 @@ std::string K2Adapter::GetRowId(const std::string& collection_name, const std::s
     return SerializeSKVRecordToString(record);
 }
 
-CBFuture<K23SITxn> K2Adapter::BeginTransaction() {
+std::shared_ptr<k2::dto::SKVRecord> K2Adapter::MakeRecord(const std::string& collection_name, const std::string& schema_name,
+    uint32_t schema_version, k2pg::sql::PgOid base_table_oid, k2pg::sql::PgOid index_oid,
+    const std::unordered_map<std::string, SqlValue *>& values)
+{
+    k2::GetSchemaResult schema_result = GetSchemaCached(collection_name, schema_name, schema_version);
+    if (!schema_result.status.is2xxOK()) {
+        throw std::runtime_error(fmt::format("Failed to get schema for {} in {} due to {}",
+                                    schema_name, collection_name, schema_result.status));
+    }
+    auto record = std::make_shared<k2::dto::SKVRecord>(collection_name, schema_result.schema);
+
+    record->serializeNext<int64_t>(base_table_oid);
+    record->serializeNext<int64_t>(index_oid);
+    const std::vector<k2::dto::SchemaField>& fields = schema_result.schema->fields;
+    for (size_t i = SKV_FIELD_OFFSET; i < fields.size(); i++) {
+        auto it = values.find(std::string(fields[i].name.c_str(), fields[i].name.size()));
+        if (it != values.end() && it->second != nullptr) {
+            K2Adapter::SerializeValueToSKVRecord(*it->second, *record);
+        } else {
+            record->serializeNull();
+        }
+    }
+    return record;
+}
+
+k2::K2TxnOptions K2Adapter::MakeTxnOptions() {
     k2::K2TxnOptions options{};
     // use default values for now
     // TODO: read from configuration/env files
     // Actual partition request deadline is min of this and command line option
     options.deadline = k2::Duration(60000s);
     //options.priority = k2::dto::TxnPriority::Medium;
-    auto result = k23si_->beginTxn(options);
+    return options;
+}
+
+CBFuture<K23SITxn> K2Adapter::BeginTransaction() {
+    auto result = k23si_->beginTxn(MakeTxnOptions());
     return result;
 }
 
@@ -1055,16 +1915,16 @@ void K2Adapter::SerializeValueToSKVRecord(const SqlValue& value, k2::dto::SKVRec
 
 template <class T> // Works with SqlOpWriteRequest and SqlOpReadRequest types
 std::pair<k2::dto::SKVRecord, Status> K2Adapter::MakeSKVRecordWithKeysSerialized(T& request, bool existYbctids, bool ignoreK2PGTID) {
-    CBFuture<k2::GetSchemaResult> schema_f = k23si_->getSchema(request.collection_name, request.table_id,
-                                                                  request.schema_version);
-    // TODO Schemas are cached by SKVClient but we can add a cache to K2 adapter to reduce
-    // cross-thread traffic
-    k2::GetSchemaResult schema_result = schema_f.get();
+    k2::GetSchemaResult schema_result = GetSchemaCached(request.collection_name, request.table_id, request.schema_version);
     if (!schema_result.status.is2xxOK()) {
         return std::make_pair(k2::dto::SKVRecord(), K2StatusToK2PgStatus(schema_result.status));
     }
 
-    std::shared_ptr<k2::dto::Schema>& schema = schema_result.schema;
+    return std::make_pair(MakeSKVRecordWithKeysSerialized(request, schema_result.schema, existYbctids, ignoreK2PGTID), Status());
+}
+
+template <class T> // Works with SqlOpWriteRequest and SqlOpReadRequest types
+k2::dto::SKVRecord K2Adapter::MakeSKVRecordWithKeysSerialized(T& request, std::shared_ptr<k2::dto::Schema> schema, bool existYbctids, bool ignoreK2PGTID) {
     k2::dto::SKVRecord record(request.collection_name, schema);
 
     if (existYbctids && !ignoreK2PGTID) {
@@ -1092,14 +1952,14 @@ std::pair<k2::dto::SKVRecord, Status> K2Adapter::MakeSKVRecordWithKeysSerialized
         }
     }
 
-    return std::make_pair(std::move(record), Status());
+    return record;
 }
 
 // Sorts values by field index, serializes values into SKVRecord, and returns skv indexes of written fields
-std::vector<uint32_t> K2Adapter::SerializeSKVValueFields(k2::dto::SKVRecord& record,
-                                                         std::vector<std::shared_ptr<BindVariable>>& values) {
-    std::vector<uint32_t> fieldsForUpdate;
-
+Status K2Adapter::SerializeSKVValueFields(k2::dto::SKVRecord& record,
+                                          std::vector<std::shared_ptr<BindVariable>>& values,
+                                          const AssignRow* currentRow,
+                                          std::vector<uint32_t>& fieldsForUpdate) {
     std::sort(values.begin(), values.end(), [] (std::shared_ptr<BindVariable> a, std::shared_ptr<BindVariable> b) {
         return a->idx < b->idx; }
     );
@@ -1109,7 +1969,8 @@ std::vector<uint32_t> K2Adapter::SerializeSKVValueFields(k2::dto::SKVRecord& rec
            throw std::logic_error("Null binding variable in column_values");
         }
 
-        if (!column->expr->is_constant()) {
+        bool isAssignExpr = currentRow != nullptr && column->expr->is_assign_expr();
+        if (!column->expr->is_constant() && !isAssignExpr) {
             throw std::logic_error("Non value type in column_values");
         }
 
@@ -1128,7 +1989,11 @@ std::vector<uint32_t> K2Adapter::SerializeSKVValueFields(k2::dto::SKVRecord& rec
 
         // TODO support update on key fields
         fieldsForUpdate.push_back(skvIndex);
-        K2Adapter::SerializeValueToSKVRecord(*(static_cast<PgConstant *>(column->expr)->getValue()), record);
+        if (isAssignExpr) {
+            K2Adapter::SerializeValueToSKVRecord(VERIFY_RESULT(EvalAssignExpr(column->expr, *currentRow)), record);
+        } else {
+            K2Adapter::SerializeValueToSKVRecord(*(static_cast<PgConstant *>(column->expr)->getValue()), record);
+        }
     }
 
     // For partial updates, need to explicitly skip remaining columns
@@ -1136,7 +2001,127 @@ std::vector<uint32_t> K2Adapter::SerializeSKVValueFields(k2::dto::SKVRecord& rec
         record.serializeNull();
     }
 
-    return fieldsForUpdate;
+    return Status::OK();
+}
+
+// PG reports the overflow of an integer type with the SQL name of the type
+static Status IntegerOutOfRange(K2PgDataType type) {
+    const char* name = type == K2SQL_DATA_TYPE_INT16 ? "smallint" : (type == K2SQL_DATA_TYPE_INT32 ? "integer" : "bigint");
+    return STATUS(InvalidArgument, fmt::format("{} out of range", name), Slice(),
+                  PgsqlError(K2PgErrorCode::K2PG_NUMERIC_VALUE_OUT_OF_RANGE));
+}
+
+static double ToDouble(const SqlValue& value) {
+    switch (value.type_) {
+        case SqlValue::ValueType::INT:
+            return value.data_.int_val_;
+        case SqlValue::ValueType::FLOAT:
+            return value.data_.float_val_;
+        case SqlValue::ValueType::DOUBLE:
+            return value.data_.double_val_;
+        default:
+            throw std::invalid_argument("Non numeric value in arithmetic assignment");
+    }
+}
+
+// Computes a float4 or float8 operation in its own precision, with the overflow and underflow checks of PG's
+// check_float4_val()/check_float8_val(): only multiplication can underflow, and only when neither operand is 0
+template <typename T>
+static Result<SqlValue> FloatAssignResult(PgExpr::Opcode opcode, T l, T r) {
+    T result;
+    bool zero_is_valid = true;
+    switch (opcode) {
+        case PgExpr::Opcode::PG_EXPR_ADD:
+            result = l + r;
+            break;
+        case PgExpr::Opcode::PG_EXPR_SUB:
+            result = l - r;
+            break;
+        default:
+            result = l * r;
+            zero_is_valid = l == 0 || r == 0;
+            break;
+    }
+    if (std::isinf(result) && !std::isinf(l) && !std::isinf(r)) {
+        return STATUS(InvalidArgument, "value out of range: overflow", Slice(),
+                      PgsqlError(K2PgErrorCode::K2PG_NUMERIC_VALUE_OUT_OF_RANGE));
+    }
+    if (result == 0 && !zero_is_valid) {
+        return STATUS(InvalidArgument, "value out of range: underflow", Slice(),
+                      PgsqlError(K2PgErrorCode::K2PG_NUMERIC_VALUE_OUT_OF_RANGE));
+    }
+    return SqlValue(result);
+}
+
+Result<SqlValue> K2Adapter::EvalAssignExpr(PgExpr* expr, const AssignRow& row) {
+    if (expr->is_constant()) {
+        return *static_cast<PgConstant *>(expr)->getValue();
+    }
+    if (expr->is_colref()) {
+        auto it = row.find(static_cast<PgColumnRef *>(expr)->attr_name());
+        if (it == row.end()) {
+            return STATUS_FORMAT(NotFound, "Column {} is not in the current row", static_cast<PgColumnRef *>(expr)->attr_name());
+        }
+        return it->second;
+    }
+
+    const std::vector<PgExpr*>& args = static_cast<PgOperator *>(expr)->getArgs();
+    if (!expr->is_assign_expr() || args.size() != 2) {
+        return STATUS_FORMAT(NotSupported, "Unsupported expression in UPDATE assignment: {}", expr->opcode());
+    }
+    SqlValue left = VERIFY_RESULT(EvalAssignExpr(args[0], row));
+    SqlValue right = VERIFY_RESULT(EvalAssignExpr(args[1], row));
+    const K2PgTypeEntity* type_entity = expr->type_entity();
+    // all the supported operators are strict, i.e. NULL if any of the arguments is NULL
+    if (left.IsNull() || right.IsNull()) {
+        return SqlValue(type_entity, 0, true);
+    }
+
+    if (expr->opcode() == PgExpr::Opcode::PG_EXPR_CONCAT) {
+        if (left.type_ != SqlValue::ValueType::SLICE || right.type_ != SqlValue::ValueType::SLICE) {
+            return STATUS(InvalidArgument, "Non string value in concatenation assignment");
+        }
+        return SqlValue(left.data_.slice_val_ + right.data_.slice_val_);
+    }
+
+    switch (type_entity->k2pg_type) {
+        case K2SQL_DATA_TYPE_INT16:
+        case K2SQL_DATA_TYPE_INT32:
+        case K2SQL_DATA_TYPE_INT64: {
+            if (left.type_ != SqlValue::ValueType::INT || right.type_ != SqlValue::ValueType::INT) {
+                return STATUS(InvalidArgument, "Non integer value in integer assignment");
+            }
+            int64_t result = 0;
+            bool overflow = false;
+            switch (expr->opcode()) {
+                case PgExpr::Opcode::PG_EXPR_ADD:
+                    overflow = __builtin_add_overflow(left.data_.int_val_, right.data_.int_val_, &result);
+                    break;
+                case PgExpr::Opcode::PG_EXPR_SUB:
+                    overflow = __builtin_sub_overflow(left.data_.int_val_, right.data_.int_val_, &result);
+                    break;
+                default:
+                    overflow = __builtin_mul_overflow(left.data_.int_val_, right.data_.int_val_, &result);
+                    break;
+            }
+            // SKV stores all the integer types as int64, so the range of the SQL type is checked here
+            if (overflow ||
+                (type_entity->k2pg_type == K2SQL_DATA_TYPE_INT16 &&
+                    (result < std::numeric_limits<int16_t>::min() || result > std::numeric_limits<int16_t>::max())) ||
+                (type_entity->k2pg_type == K2SQL_DATA_TYPE_INT32 &&
+                    (result < std::numeric_limits<int32_t>::min() || result > std::numeric_limits<int32_t>::max()))) {
+                return IntegerOutOfRange(type_entity->k2pg_type);
+            }
+            return SqlValue(result);
+        }
+        case K2SQL_DATA_TYPE_FLOAT:
+            // like float4pl/float4mi/float4mul, the operands are float4 and the result is computed in float
+            return FloatAssignResult<float>(expr->opcode(), static_cast<float>(ToDouble(left)), static_cast<float>(ToDouble(right)));
+        case K2SQL_DATA_TYPE_DOUBLE:
+            return FloatAssignResult<double>(expr->opcode(), ToDouble(left), ToDouble(right));
+        default:
+            return STATUS_FORMAT(NotSupported, "Unsupported type {} in arithmetic assignment", (int)type_entity->k2pg_type);
+    }
 }
 
 std::string K2Adapter::K2PGTIDToString(std::shared_ptr<BindVariable> k2pgctid_column_value) {
@@ -17,17 +17,22 @@
 
 #pragma once
 #include <boost/function.hpp>
+#include <optional>
+#include <shared_mutex>
+#include <unordered_map>
 
+#include "common/result.h"
 #include "common/status.h"
 #include "entities/schema.h"
 #include "entities/expr.h"
+#include "entities/index.h"
 #include "k2_config.h"
 #include "k2_gate.h"
 #include "k2_includes.h"
 #include "k2_log.h"
-#include "k2_thread_pool.h"
 #include "k2_txn.h"
 #include "pg_env.h"
+#include "pg_gate_defaults.h"
 #include "pg_op_api.h"
 
 namespace k2pg {
@@ -38,6 +43,48 @@ using k2pg::sql::PgExpr;
 using k2pg::sql::PgConstant;
 using k2pg::sql::PgOperator;
 
+// The SKV schemas looked up by a process, keyed by (collection, schema name, version) and shared by all its threads.
+// Schemas with a given version never change, so those entries only go away with the collection. ANY_VERSION entries
+// may go stale after DDL, and are dropped together with everything else on a catalog version bump.
+class SchemaCache {
+public:
+  std::shared_ptr<k2::dto::Schema> Find(const std::string& collectionName, const std::string& schemaName, uint64_t schemaVersion);
+
+  void Insert(const std::string& collectionName, const std::string& schemaName, uint64_t schemaVersion,
+              std::shared_ptr<k2::dto::Schema> schema);
+
+  // Drops all the entries if the given catalog version is newer than the one the cache was populated under
+  void OnCatalogVersionChange(uint64_t catalogVersion);
+
+  void EraseCollection(const std::string& collectionName);
+
+  uint64_t catalogVersion() {
+    std::shared_lock lock(mutex_);
+    return catalogVersion_;
+  }
+
+private:
+  struct Key {
+    std::string collectionName;
+    std::string schemaName;
+    uint64_t schemaVersion;
+    bool operator==(const Key& o) const {
+      return schemaVersion == o.schemaVersion && schemaName == o.schemaName && collectionName == o.collectionName;
+    }
+  };
+  struct KeyHash {
+    size_t operator()(const Key& k) const {
+      size_t h = std::hash<std::string>()(k.collectionName);
+      h = h * 31 + std::hash<std::string>()(k.schemaName);
+      return h * 31 + std::hash<uint64_t>()(k.schemaVersion);
+    }
+  };
+
+  std::unordered_map<Key, std::shared_ptr<k2::dto::Schema>, KeyHash> schemas_;
+  uint64_t catalogVersion_ = 0;
+  std::shared_mutex mutex_;
+};
+
 // An adapter between SQL/Connector layer operations and K2 SKV storage, designed to be the ONLY interface in between.
 // It contains 5 sub-groups of APIs
 //  1) SKV Schema APIs (CRUD of Collection, Schema, similar to DDL)
@@ -54,9 +101,16 @@ public:
   CBFuture<k2::GetSchemaResult> GetSchema(const std::string& collectionName, const std::string& schemaName, uint64_t schemaVersion)
     { return k23si_->getSchema(collectionName, schemaName, schemaVersion); }
 
+  // Same as GetSchema, but served from the process-wide schema cache when possible so that the caller doesn't have
+  // to wait for a round trip to the seastar thread
+  k2::GetSchemaResult GetSchemaCached(const std::string& collectionName, const std::string& schemaName, uint64_t schemaVersion);
+
+  // Drops all cached schemas if the given catalog version is newer than the one the cache was populated under
+  void OnCatalogVersionChange(uint64_t catalogVersion);
+
   CBFuture<k2::Status> CreateCollection(const std::string& collection_name, const std::string& DBName);
   CBFuture<k2::Status> DropCollection(const std::string& collection_name)
-    { return k23si_->dropCollection(collection_name); }
+    { InvalidateSchemaCache(collection_name); return k23si_->dropCollection(collection_name); }
 
   // 2/5 K2-3SI transaction APIs
   CBFuture<K23SITxn> BeginTransaction();
@@ -82,11 +136,39 @@ public:
 
   CBFuture<Status> BatchExec(std::shared_ptr<K23SITxn> k23SITxn, const std::vector<std::shared_ptr<PgOpTemplate>>& ops);
 
+  // Runs a single row write in a transaction of its own, which is begun, written and committed (or aborted if the
+  // write failed) on the seastar thread, so that the caller waits for a single round trip instead of three
+  CBFuture<Status> ExecOneShot(std::shared_ptr<PgOpTemplate> op);
+
+  // Runs the given task in a transaction of its own, which is committed if the task succeeds and aborted otherwise,
+  // all on the seastar thread. The result is the task's error or the commit status
+  CBFuture<Status> RunOneShot(OpTask&& task, const OpCounts& counts);
+
+  // Writes the index records of all the rows of the base table, i.e. builds a new index from the table data without
+  // shipping the rows to PG. The table is read page by page and the records of a page are written concurrently.
+  // Unless the given transaction already wrote something, which only it can see, the table is split into ranges of
+  // its leading key which are backfilled concurrently, each in a transaction of its own. A range which fails with a
+  // transient error is retried while the committed ranges are kept. Unique indexes fail with AlreadyPresent on a
+  // duplicate key. Blocks until the index is built. Sets the number of indexed rows
+  Status BackfillIndex(std::shared_ptr<K23SITxn> k23SITxn, const std::string& collection_name,
+                       uint32_t base_schema_version, const k2pg::sql::IndexInfo& index_info, uint64_t* indexed_rows);
+
+  // Deletes all the rows of a table or an index in the given transaction, with the deletes of each page of rows sent
+  // concurrently. Sets the number of deleted rows
+  CBFuture<Status> DeleteAllRows(std::shared_ptr<K23SITxn> k23SITxn, const std::string& collection_name,
+                                 const std::string& schema_name, uint32_t schema_version,
+                                 k2pg::sql::PgOid table_oid, k2pg::sql::PgOid index_oid, uint64_t* deleted_rows);
+
   // 4/5 Utility APIs and Misc.
   std::string GetRowId(std::shared_ptr<SqlOpWriteRequest> request);
   std::string GetRowId(const std::string& collection_name, const std::string& schema_name, uint32_t schema_version,
     k2pg::sql::PgOid base_table_oid, k2pg::sql::PgOid index_oid, std::unordered_map<std::string, SqlValue *>& key_values);
  static std::string GetRowIdFromReadRecord(k2::dto::SKVRecord& record);
+  // Serializes a whole row, given by column name, into a record of the given schema, e.g. to write it with
+  // SqlOpWriteRequest::record. The columns which are not given are null
+  std::shared_ptr<k2::dto::SKVRecord> MakeRecord(const std::string& collection_name, const std::string& schema_name,
+    uint32_t schema_version, k2pg::sql::PgOid base_table_oid, k2pg::sql::PgOid index_oid,
+    const std::unordered_map<std::string, SqlValue *>& values);
 
   static void SerializeValueToSKVRecord(const SqlValue& value, k2::dto::SKVRecord& record);
   static Status K2StatusToK2PgStatus(const k2::Status& status);
@@ -95,9 +177,19 @@ public:
   // We have two implicit fields (tableID and indexID) in the SKV, so this is the offset to get a user field
   static constexpr uint32_t SKV_FIELD_OFFSET = 2;
 
+  // Max number of concurrent sub-scans a single scan can be split into
+  int32_t ScanParallelism() const { return scanParallelism_; }
+
+  // Max number of writes a session buffers before flushing them in one batch
+  int32_t SessionMaxBatchSize() const { return sessionMaxBatchSize_; }
+
+  // Max number of batches of buffered writes a session keeps in flight at the same time
+  int32_t SessionMaxInflightBatches() const { return sessionMaxInflightBatches_; }
+
   // 5/5 Self managment APIs
-  // TODO make thead pool size configurable and investigate best number of threads
-  K2Adapter():threadPool_(conf_.get("thread_pool_size", 2)) {
+  K2Adapter():scanParallelism_(conf_.get("psql_select_parallelism", default_psql_select_parallelism)),
+              sessionMaxBatchSize_(conf_.get("session_max_batch_size", default_session_max_batch_size)),
+              sessionMaxInflightBatches_(conf_.get("session_max_inflight_batches", default_session_max_inflight_batches)) {
     k23si_ = std::make_shared<K23SIGate>();
   };
 
@@ -108,36 +200,142 @@ public:
   static k2::dto::expression::Expression ToK2AndOrOperator(k2::dto::expression::Operation op, std::vector<PgExpr*> args);
   static k2::dto::expression::Expression ToK2BinaryLogicOperator(PgOperator* pg_opr);
   static k2::dto::expression::Expression ToK2BetweenOperator(PgOperator* pg_opr);
+  static k2::dto::expression::Expression ToK2NotOperator(PgOperator* pg_opr);
+  static k2::dto::expression::Expression ToK2InOperator(PgOperator* pg_opr);
+  static k2::dto::expression::Expression ToK2IsNullOperator(PgOperator* pg_opr);
   static k2::dto::expression::Operation ToK2OperationType(PgExpr* pg_expr) ;
   static k2::dto::expression::Value ToK2Value(PgConstant* pg_const);
   static k2::dto::expression::Value ToK2ColumnRef(PgColumnRef* pg_colref);
 
+  // Column values of a row by column name, i.e. the input of the UPDATE assignments such as SET col = col + 1
+  using AssignRow = std::unordered_map<std::string, SqlValue>;
+
+  // Computes the new value of an UPDATE assignment from the current row. Fails like PG does if the result is out of
+  // range for the column type
+  static Result<SqlValue> EvalAssignExpr(PgExpr* expr, const AssignRow& row);
+
   private:
   std::shared_ptr<K23SIGate> k23si_;
   Config conf_;
 
-  ThreadPool threadPool_;
+  int32_t scanParallelism_;
+  int32_t sessionMaxBatchSize_;
+  int32_t sessionMaxInflightBatches_;
+
+  SchemaCache schemaCache_;
+
+  // removes the cached schemas of the given collection
+  void InvalidateSchemaCache(const std::string& collectionName)
+    { schemaCache_.EraseCollection(collectionName); }
 
   // will consume/move record param
   CBFuture<k2::WriteResult> WriteRecord(std::shared_ptr<K23SITxn> k23SITxn, k2::dto::SKVRecord& record, bool isDelete)
     { return k23SITxn->write(std::move(record), isDelete); }
 
-  CBFuture<Status> handleReadOp(std::shared_ptr<K23SITxn> k23SITxn, std::shared_ptr<PgReadOpTemplate> op);
-  CBFuture<Status> handleWriteOp(std::shared_ptr<K23SITxn> k23SITxn, std::shared_ptr<PgWriteOpTemplate> op);
+  // Allocates the op response and builds the seastar-side task for the op, counting the K2 operations it does. The
+  // SKV schema is looked up here, on the calling thread, so that the task never has to wait for it. Returns an error,
+  // with the op response filled in, if the op fails before anything needs to be sent to K2
+  Status MakeOpTask(std::shared_ptr<PgOpTemplate> op, OpTask& task, OpCounts& counts);
+
+  // Options for the K2 transactions started by the adapter
+  static k2::K2TxnOptions MakeTxnOptions();
+
+  // The tasks below and their helpers run on the seastar thread
+  OpTask MakeReadOpTask(std::shared_ptr<PgReadOpTemplate> op, std::shared_ptr<k2::dto::Schema> schema);
+  OpTask MakeWriteOpTask(std::shared_ptr<PgWriteOpTemplate> op, std::shared_ptr<k2::dto::Schema> schema);
+
+  // Writes the record of the write request. The new values of assignment expressions are computed from currentRow,
+  // which is null if the request has none
+  seastar::future<Status> RunWrite(k2::K2TxnHandle& txn,
+                                   std::shared_ptr<PgWriteOpTemplate> op,
+                                   std::shared_ptr<k2::dto::Schema> schema,
+                                   const AssignRow* currentRow);
+
+  // Fills in the op response from the K2 write status and converts the status
+  static Status HandleWriteStatus(std::shared_ptr<PgWriteOpTemplate> op, k2::Status writeStatus);
+
+  // Sets the projections, the key range, the filter and the limit of a new scan from the read request
+  Status PrepareScan(SqlOpReadRequest& request, std::shared_ptr<k2::dto::Schema> schema, k2::Query& scan);
+
+  // Reads the next page of the scan into the op response
+  seastar::future<Status> RunScan(k2::K2TxnHandle& txn, std::shared_ptr<PgReadOpTemplate> op, std::shared_ptr<k2::Query> scan);
+
+  // Issues the writes for a page of scanned records
+  using PageWriter = std::function<std::vector<seastar::future<k2::WriteResult>>(k2::K2TxnHandle& txn, std::vector<k2::dto::SKVRecord>& records)>;
+
+  // Scans all the records of a table or an index page by page and waits for the writes of each page before reading
+  // the next one. Stops at the first error. The optional bounds narrow the scan to a range of the leading key, which
+  // must be an integer; the writer still has to skip the records past the upper bound. Adds the number of writes to count
+  static seastar::future<Status> ScanAndWrite(k2::K23SIClient& client, k2::K2TxnHandle& txn, const std::string& collection_name,
+                                              std::shared_ptr<k2::dto::Schema> schema, k2pg::sql::PgOid table_oid, k2pg::sql::PgOid index_oid,
+                                              PageWriter writer, uint64_t* count,
+                                              std::optional<int64_t> key_lower=std::nullopt, std::optional<int64_t> key_upper=std::nullopt);
+
+  // A range of the leading key of a table, both bounds inclusive. A missing bound means the range is open on that side
+  struct BackfillRange {
+      std::optional<int64_t> lower;
+      std::optional<int64_t> upper;
+      // committed, so a retry skips it
+      bool done = false;
+  };
+
+  // Splits the rows of the table into ranges of its leading key to be backfilled concurrently, based on its smallest
+  // and largest leading key. Tables whose leading key isn't an ascending integer are a single range. Empty tables have no range
+  Result<std::vector<BackfillRange>> SplitBackfillRanges(const std::string& collection_name, std::shared_ptr<k2::dto::Schema> schema,
+                                                         k2pg::sql::PgOid table_oid);
 
   Status HandleRangeConditions(PgExpr *range_conds, std::vector<PgExpr *>& leftover_exprs, k2::dto::SKVRecord& start, k2::dto::SKVRecord& end);
 
-  // Helper funcxtion for handleReadOp when k2pgctid is set in the request
-  void handleReadByRowIds(std::shared_ptr<K23SITxn> k23SITxn,
-                           std::shared_ptr<PgReadOpTemplate> op,
-                           std::shared_ptr<std::promise<Status>> prom);
+  // The tightest bounds found in the range conditions for a single key field
+  struct KeyFieldBounds {
+      std::optional<SqlValue> eq;
+      PgExpr* eq_expr = nullptr;
+      std::optional<SqlValue> lower;
+      bool lower_inclusive = true;
+      std::optional<SqlValue> upper;
+      bool upper_inclusive = true;
+  };
+
+  // Serializes the range bounds of the last key field used for the scan into the start/end records, taking the
+  // null placement of the field into account
+  static void SerializeKeyFieldRange(const k2::dto::SchemaField& field, const KeyFieldBounds& bounds, k2::dto::SKVRecord& start, k2::dto::SKVRecord& end);
+
+  // Folds the given scanned record into the partial results of the pushed down aggregates in targets
+  static void AccumulateAggregates(const std::vector<PgExpr*>& targets, k2::dto::SKVRecord& record, std::vector<SqlOpAggregatePartial>& partials);
+
+  // The fields read for the targets of the request: the key fields, so that the k2pgctid of the rows can be built,
+  // and the target columns, or the argument columns of pushed down aggregates. Empty if the request reads whole rows
+  static std::vector<k2::String> GetProjection(SqlOpReadRequest& request, const k2::dto::Schema& schema);
+
+  // Copies a record read by key with only the projected fields, the others are null, i.e. the same record a scan with
+  // the projection returns
+  static k2::dto::SKVRecord ProjectRecord(k2::dto::SKVRecord& record, const std::vector<k2::String>& projection);
+
+  // Helper function for the read op task when k2pgctid is set in the request
+  seastar::future<Status> ReadByRowIds(k2::K2TxnHandle& txn,
+                                       std::shared_ptr<PgReadOpTemplate> op,
+                                       std::shared_ptr<k2::dto::Schema> schema);
+
+  // The key record to read if the range conditions of the request bind every key field with an equality condition
+  // and there is nothing else to filter on, e.g. for the sub-scans of an IN list on the key. Such a request is run
+  // as a point read instead of a scan
+  static std::optional<k2::dto::SKVRecord> MakePointReadRecord(SqlOpReadRequest& request, std::shared_ptr<k2::dto::Schema> schema);
+
+  // Helper function for the read op task when the request reads a single key, see MakePointReadRecord()
+  static seastar::future<Status> ReadByKey(k2::K2TxnHandle& txn, std::shared_ptr<PgReadOpTemplate> op, k2::dto::SKVRecord&& key);
 
   template <class T> // Works with SqlOpWriteRequest and SqlOpReadRequest types
   std::pair<k2::dto::SKVRecord, Status> MakeSKVRecordWithKeysSerialized(T& request, bool existYbctids, bool ignoreK2PGTID=false);
+  // Same as above with the SKV schema already at hand, so it never waits for the schema
+  template <class T>
+  k2::dto::SKVRecord MakeSKVRecordWithKeysSerialized(T& request, std::shared_ptr<k2::dto::Schema> schema, bool existYbctids, bool ignoreK2PGTID=false);
 
-  // Sorts values by field index, serializes values into SKVRecord, and returns skv indexes of written fields
-  std::vector<uint32_t> SerializeSKVValueFields(k2::dto::SKVRecord& record,
-                                                std::vector<std::shared_ptr<BindVariable>>& values);
+  // Sorts values by field index, serializes values into SKVRecord, and returns skv indexes of written fields in
+  // fieldsForUpdate. Assignment expressions are computed from currentRow
+  Status SerializeSKVValueFields(k2::dto::SKVRecord& record,
+                                 std::vector<std::shared_ptr<BindVariable>>& values,
+                                 const AssignRow* currentRow,
+                                 std::vector<uint32_t>& fieldsForUpdate);
 
   static std::string K2PGTIDToString(std::shared_ptr<BindVariable> k2pgctid_column_value);
   static std::string SerializeSKVRecordToString(k2::dto::SKVRecord& record);
@@ -44,7 +44,25 @@ CBFuture<K23SITxn> K23SIGate::beginTxn(const K2TxnOptions& txnOpts) {
         session::txn_begin_latency->observe(Clock::now() - start);
     });
     K2LOG_D(log::k2Client, "starting txn: enqueue");
-    pushQ(beginTxQ, std::move(qr));
+    pushQ(std::move(qr));
+    return result;
+}
+
+CBFuture<k2pg::Status> K23SIGate::runOneShotOp(const K2TxnOptions& txnOpts, OpTask&& task, const OpCounts& counts) {
+    auto start = Clock::now();
+    OneShotOpRequest qr{.opts=txnOpts, .task=std::move(task), .prom={}};
+    qr.opts.syncFinalize = _syncFinalize;
+
+    auto result = CBFuture<k2pg::Status>(qr.prom.get_future(), [start, counts] {
+        auto now = Clock::now();
+        session::txn_latency->observe(now - start);
+        session::txn_ops->observe(counts.reads + counts.writes + counts.scans);
+        session::txn_read_ops->observe(counts.reads);
+        session::txn_write_ops->observe(counts.writes);
+        session::txn_scan_ops->observe(counts.scans);
+    });
+    K2LOG_D(log::k2Client, "one shot op: reads={}, writes={}, scans={}", counts.reads, counts.writes, counts.scans);
+    pushQ(std::move(qr));
     return result;
 }
 
@@ -55,7 +73,7 @@ CBFuture<k2::GetSchemaResult> K23SIGate::getSchema(const k2::String& collectionN
         session::gate_get_schema_latency->observe(Clock::now() - st);
     });
     K2LOG_D(log::k2Client, "get schema: collname={}, schema={}, version={}", collectionName, schemaName, schemaVersion);
-    pushQ(schemaGetTxQ, std::move(qr));
+    pushQ(std::move(qr));
     return result;
 }
 
@@ -66,7 +84,7 @@ CBFuture<k2::CreateSchemaResult> K23SIGate::createSchema(const k2::String& colle
         session::gate_create_schema_latency->observe(Clock::now() - st);
     });
     K2LOG_D(log::k2Client, "create schema: collname={}, schema={}, raw={}", collectionName, schema.name, schema);
-    pushQ(schemaCreateTxQ, std::move(qr));
+    pushQ(std::move(qr));
     return result;
 }
 
@@ -79,7 +97,7 @@ CBFuture<k2::Status> K23SIGate::createCollection(k2::dto::CollectionCreateReques
     });
 
     K2LOG_D(log::k2Client, "create collection: cname={}", req.ccr.metadata.name);
-    pushQ(collectionCreateTxQ, std::move(req));
+    pushQ(std::move(req));
     return result;
 }
 
@@ -92,7 +110,7 @@ CBFuture<k2::Status> K23SIGate::dropCollection(const k2::String& collectionName)
     });
 
     K2LOG_D(log::k2Client, "drop collection: cname={}", collectionName);
-    pushQ(collectionDropTxQ, std::move(req));
+    pushQ(std::move(req));
     return result;
 }
 
@@ -104,7 +122,7 @@ CBFuture<CreateScanReadResult> K23SIGate::createScanRead(const k2::String& colle
         session::gate_create_scanread_latency->observe(Clock::now() - st);
     });
     K2LOG_D(log::k2Client, "create scanread: coll={}, schema={}", collectionName, schemaName);
-    pushQ(scanReadCreateTxQ, std::move(cr));
+    pushQ(std::move(cr));
     return result;
 }
 
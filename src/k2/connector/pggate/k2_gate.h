@@ -52,6 +52,11 @@ public:
     // the result future is eventually satisfied with a valid transaction handle, or with an exception if the library
     // is unable to start a transaction
     CBFuture<K23SITxn> beginTxn(const k2::K2TxnOptions& txnOpts);
+
+    // Runs the given task in a new transaction with the given options (see OneShotOpRequest). The task must end
+    // the transaction. The result future is eventually satisfied with the status returned by the task, or with an
+    // exception if the library is unable to start a transaction
+    CBFuture<k2pg::Status> runOneShotOp(const k2::K2TxnOptions& txnOpts, OpTask&& task, const OpCounts& counts);
     CBFuture<k2::GetSchemaResult> getSchema(const k2::String& collectionName, const k2::String& schemaName, uint64_t schemaVersion);
     CBFuture<k2::CreateSchemaResult> createSchema(const k2::String& collectionName, k2::dto::Schema& schema);
     CBFuture<k2::Status> createCollection(k2::dto::CollectionCreateRequest&& ccr);
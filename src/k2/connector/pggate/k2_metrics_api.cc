@@ -0,0 +1,318 @@
+/*
+MIT License
+
+Copyright(c) 2021 Futurewei Cloud
+
+    Permission is hereby granted,
+    free of charge, to any person obtaining a copy of this software and associated documentation files(the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and / or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions :
+
+    The above copyright notice and this permission notice shall be included in all copies
+    or
+    substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS",
+    WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+    DAMAGES OR OTHER
+    LIABILITY,
+    WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include "k2_metrics_api.h"
+
+#include <seastar/core/metrics.hh>
+
+#include <algorithm>
+#include <cmath>
+#include <mutex>
+
+namespace k2pg::metrics {
+
+namespace {
+// all live metrics
+struct Registry {
+    std::mutex mutex;
+    std::vector<MetricBase*> metrics;
+};
+
+Registry& registry() {
+    static Registry reg;
+    return reg;
+}
+
+// bumped whenever the set of series to export changes
+std::atomic<uint64_t> generation{0};
+
+// the seastar metric group of all PG-side metrics
+constexpr const char* EXPORT_GROUP = "pggate";
+
+void atomicAdd(std::atomic<double>& target, double value) {
+    double current = target.load(std::memory_order_relaxed);
+    while (!target.compare_exchange_weak(current, current + value, std::memory_order_relaxed));
+}
+
+// Looks up (or creates) the series for the given key in a label map guarded by a shared mutex
+template <typename MapT>
+auto& findOrCreateSeries(MapT& map, std::shared_mutex& mutex, std::string key) {
+    {
+        std::shared_lock lock(mutex);
+        auto it = map.find(key);
+        if (it != map.end()) {
+            return *it->second;
+        }
+    }
+    std::unique_lock lock(mutex);
+    auto& series = map[std::move(key)];
+    if (!series) {
+        series = std::make_unique<typename MapT::mapped_type::element_type>();
+        generation.fetch_add(1, std::memory_order_relaxed);
+    }
+    return *series;
+}
+
+std::vector<seastar::metrics::label_instance> labelInstances(const std::vector<std::pair<std::string, std::string>>& labels) {
+    std::vector<seastar::metrics::label_instance> result;
+    result.reserve(labels.size());
+    for (auto& [key, value] : labels) {
+        result.emplace_back(key, value);
+    }
+    return result;
+}
+}  // namespace
+
+size_t threadSlot() {
+    static std::atomic<size_t> nextSlot{0};
+    thread_local size_t slot = std::min(nextSlot.fetch_add(1, std::memory_order_relaxed), MAX_THREAD_SLOTS - 1);
+    return slot;
+}
+
+MetricBase::MetricBase(std::string name, std::string help, std::vector<std::string> labels):
+        _name(std::move(name)), _help(std::move(help)), _labels(std::move(labels)) {
+    std::lock_guard lock(registry().mutex);
+    registry().metrics.push_back(this);
+    generation.fetch_add(1, std::memory_order_relaxed);
+}
+
+MetricBase::~MetricBase() {
+    std::lock_guard lock(registry().mutex);
+    auto& metrics = registry().metrics;
+    metrics.erase(std::remove(metrics.begin(), metrics.end(), this), metrics.end());
+    generation.fetch_add(1, std::memory_order_relaxed);
+}
+
+std::string MetricBase::_seriesKey(const char** label_values) const {
+    std::string key;
+    if (label_values == NULL) {
+        return key;
+    }
+    for (size_t i = 0; i < _labels.size(); ++i) {
+        key += label_values[i] ? label_values[i] : "";
+        key += '\0';
+    }
+    return key;
+}
+
+std::vector<std::pair<std::string, std::string>> MetricBase::_seriesLabels(const std::string& seriesKey) const {
+    std::vector<std::pair<std::string, std::string>> result;
+    size_t pos = 0;
+    for (size_t i = 0; i < _labels.size() && pos < seriesKey.size(); ++i) {
+        size_t end = seriesKey.find('\0', pos);
+        result.emplace_back(_labels[i], seriesKey.substr(pos, end - pos));
+        pos = end + 1;
+    }
+    return result;
+}
+
+Histogram::Histogram(std::string name, std::string help, int start, double factor, int count, std::vector<std::string> labels):
+        MetricBase(std::move(name), std::move(help), std::move(labels)) {
+    K2LOG_D(log::k2Client, "creating histogram metric: {}", _name);
+    _bounds.reserve(count);
+    double bound = start;
+    for (int i = 0; i < count; ++i) {
+        _bounds.push_back(bound);
+        bound *= factor;
+    }
+    _logStart = std::log(start);
+    _logFactor = std::log(factor);
+}
+
+Histogram::~Histogram() {
+    K2LOG_D(log::k2Client, "deleting histogram metric: {}", _name);
+}
+
+Histogram::Series::~Series() {
+    for (auto& shard : shards) {
+        delete shard.load(std::memory_order_acquire);
+    }
+}
+
+size_t Histogram::_bucketFor(double value) const {
+    // the last bucket (index == _bounds.size()) is +Inf. The value is finite, see observe()
+    if (_bounds.empty() || value <= _bounds[0]) {
+        return 0;
+    }
+    double idx = std::ceil((std::log(value) - _logStart) / _logFactor);
+    size_t bucket = idx >= _bounds.size() ? _bounds.size() : static_cast<size_t>(idx);
+    // correct for floating point error in the log math
+    while (bucket < _bounds.size() && value > _bounds[bucket]) ++bucket;
+    while (bucket > 0 && value <= _bounds[bucket - 1]) --bucket;
+    return bucket;
+}
+
+Histogram::Series& Histogram::_series(const char** label_values) {
+    if (label_values == NULL || _labels.empty()) {
+        return _default;
+    }
+    return findOrCreateSeries(_labeled, _labeledMutex, _seriesKey(label_values));
+}
+
+void Histogram::observe(double value, const char** label_values) {
+    if (!std::isfinite(value)) {
+        // there is no bucket for NaN, and an infinite value would make the sum meaningless
+        K2LOG_W(log::k2Client, "dropping non-finite value {} observed in histogram metric: {}", value, _name);
+        return;
+    }
+    auto& slot = _series(label_values).shards[threadSlot()];
+    Shard* shard = slot.load(std::memory_order_acquire);
+    if (!shard) {
+        auto* fresh = new Shard(_bounds.size() + 1);
+        if (slot.compare_exchange_strong(shard, fresh, std::memory_order_acq_rel)) {
+            shard = fresh;
+        } else {
+            // another thread sharing the overflow slot beat us to it
+            delete fresh;
+        }
+    }
+    shard->counts[_bucketFor(value)].fetch_add(1, std::memory_order_relaxed);
+    atomicAdd(shard->sum, value);
+}
+
+void Histogram::exportTo(seastar::metrics::metric_groups& groups, const std::string& group) {
+    auto exportSeries = [this, &groups, &group](const std::string& key, Series& series) {
+        groups.add_group(group, {
+            seastar::metrics::make_histogram(_name, [this, &series] {
+                std::vector<uint64_t> counts(_bounds.size() + 1, 0);
+                seastar::metrics::histogram result;
+                result.sample_sum = 0;
+                for (auto& slot : series.shards) {
+                    Shard* shard = slot.load(std::memory_order_acquire);
+                    if (!shard) continue;
+                    for (size_t i = 0; i < counts.size(); ++i) {
+                        counts[i] += shard->counts[i].load(std::memory_order_relaxed);
+                    }
+                    result.sample_sum += shard->sum.load(std::memory_order_relaxed);
+                }
+                // seastar buckets are cumulative and the +Inf bucket is implied by the sample count
+                uint64_t cumulative = 0;
+                result.buckets.reserve(_bounds.size());
+                for (size_t i = 0; i < _bounds.size(); ++i) {
+                    cumulative += counts[i];
+                    result.buckets.push_back(seastar::metrics::histogram_bucket{cumulative, _bounds[i]});
+                }
+                result.sample_count = cumulative + counts.back();
+                return result;
+            }, seastar::metrics::description(_help), labelInstances(_seriesLabels(key)))
+        });
+    };
+    exportSeries(std::string{}, _default);
+    std::shared_lock lock(_labeledMutex);
+    for (auto& [key, series] : _labeled) {
+        exportSeries(key, *series);
+    }
+}
+
+Gauge::Gauge(std::string name, std::string help, std::vector<std::string> labels) :
+        MetricBase(std::move(name), std::move(help), std::move(labels)) {
+    K2LOG_D(log::k2Client, "create gauge metric: {}", _name);
+}
+
+Gauge::~Gauge() {
+    K2LOG_D(log::k2Client, "destroy gauge metric: {}", _name);
+}
+
+std::atomic<double>& Gauge::_value(const char** label_values) {
+    if (label_values == NULL || _labels.empty()) {
+        return _default;
+    }
+    return findOrCreateSeries(_labeled, _labeledMutex, _seriesKey(label_values));
+}
+
+void Gauge::set(double value, const char** label_values) {
+    _value(label_values).store(value, std::memory_order_relaxed);
+}
+
+void Gauge::add(double value, const char** label_values) {
+    atomicAdd(_value(label_values), value);
+}
+
+void Gauge::exportTo(seastar::metrics::metric_groups& groups, const std::string& group) {
+    auto exportSeries = [this, &groups, &group](const std::string& key, std::atomic<double>& value) {
+        groups.add_group(group, {
+            seastar::metrics::make_gauge(_name, [&value] {
+                return value.load(std::memory_order_relaxed);
+            }, seastar::metrics::description(_help), labelInstances(_seriesLabels(key)))
+        });
+    };
+    exportSeries(std::string{}, _default);
+    std::shared_lock lock(_labeledMutex);
+    for (auto& [key, value] : _labeled) {
+        exportSeries(key, *value);
+    }
+}
+
+Counter::Counter(std::string name, std::string help, std::vector<std::string> labels) :
+        MetricBase(std::move(name), std::move(help), std::move(labels)) {
+    K2LOG_D(log::k2Client, "create counter metric: {}", _name);
+}
+
+Counter::~Counter() {
+    K2LOG_D(log::k2Client, "destroy counter metric: {}", _name);
+}
+
+Counter::Series& Counter::_series(const char** label_values) {
+    if (label_values == NULL || _labels.empty()) {
+        return _default;
+    }
+    return findOrCreateSeries(_labeled, _labeledMutex, _seriesKey(label_values));
+}
+
+void Counter::add(double value, const char** label_values) {
+    atomicAdd(_series(label_values).slots[threadSlot()], value);
+}
+
+void Counter::exportTo(seastar::metrics::metric_groups& groups, const std::string& group) {
+    auto exportSeries = [this, &groups, &group](const std::string& key, Series& series) {
+        groups.add_group(group, {
+            // per-thread partial sums, added up on collection
+            seastar::metrics::make_counter(_name, [&series] {
+                double total = 0;
+                for (auto& slot : series.slots) {
+                    total += slot.load(std::memory_order_relaxed);
+                }
+                return total;
+            }, seastar::metrics::description(_help), labelInstances(_seriesLabels(key)))
+        });
+    };
+    exportSeries(std::string{}, _default);
+    std::shared_lock lock(_labeledMutex);
+    for (auto& [key, series] : _labeled) {
+        exportSeries(key, *series);
+    }
+}
+
+void exportAll(seastar::metrics::metric_groups& groups) {
+    groups.clear();
+    std::lock_guard lock(registry().mutex);
+    for (auto* metric : registry().metrics) {
+        metric->exportTo(groups, EXPORT_GROUP);
+    }
+}
+
+uint64_t exportGeneration() {
+    return generation.load(std::memory_order_relaxed);
+}
+
+}  // namespace k2pg::metrics
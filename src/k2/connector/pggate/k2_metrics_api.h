@@ -23,99 +23,138 @@ Copyright(c) 2021 Futurewei Cloud
 
 #pragma once
 
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <shared_mutex>
 #include <string>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "k2_includes.h"
 #include "k2_log.h"
 
-extern "C" {
+namespace seastar::metrics {
+class metric_groups;
+}
 
 namespace k2pg::metrics {
-struct Histogram {
-    Histogram(std::string name, std::string help, int start, double factor, int count, std::vector<std::string> labels):
-            _name(std::move(name)), _help(std::move(help)), _start(start), _factor(factor), _count(count), _labels(std::move(labels)) {
-        K2LOG_D(log::k2Client, "creating histogram metric: {}", _name);
-        _labels_c.reserve(_labels.size());
-        for (auto& l: _labels) {
-            _labels_c.push_back(l.c_str());
-        }
-    }
 
-    ~Histogram() {
-        K2LOG_D(log::k2Client, "deleting histogram metric: {}", _name);
-    }
+// Max number of threads which get their own, uncontended slot in each metric. Threads beyond this share the
+// last slot, which is still correct, only slower
+inline constexpr size_t MAX_THREAD_SLOTS = 64;
 
-    void observe(double value, const char** label_values=NULL) {
-        K2LOG_D(log::k2Client, "observe value {} in histogram metric: {}", value, _name);
-    }
+// Returns the slot index of the calling thread
+size_t threadSlot();
 
-    void observe(k2::Duration value, const char** label_values=NULL) {
-        K2LOG_D(log::k2Client, "observe duration {} in histogram metric: {}", value, _name);
-    }
+// Common base for all metrics. Metrics register themselves with the process-wide registry on construction and
+// are exported as seastar metrics of the K2 app, which pushes them to prometheus together with its own
+class MetricBase {
+public:
+    MetricBase(std::string name, std::string help, std::vector<std::string> labels);
+    virtual ~MetricBase();
+    MetricBase(const MetricBase&) = delete;
+    MetricBase& operator=(const MetricBase&) = delete;
+
+    // add all series of this metric to the given seastar metric group. Must run on the reactor thread
+    virtual void exportTo(seastar::metrics::metric_groups& groups, const std::string& group) = 0;
+
+protected:
+    // builds the series key out of the given label values. Empty key means no labels
+    std::string _seriesKey(const char** label_values) const;
+    // splits the given series key into the label values, in the order of _labels
+    std::vector<std::pair<std::string, std::string>> _seriesLabels(const std::string& seriesKey) const;
 
-private:
     std::string _name;
     std::string _help;
-    int _start{0};
-    double _factor{0};
-    int _count{0};
     std::vector<std::string> _labels;
-    std::vector<const char*> _labels_c;
 };
 
-struct Gauge {
-    Gauge(std::string name, std::string help, std::vector<std::string> labels) :
-            _name(std::move(name)), _help(std::move(help)), _labels(std::move(labels)) {
-        K2LOG_D(log::k2Client, "create gauge metric: {}", _name);
-        _labels_c.reserve(_labels.size());
-        for (auto& l : _labels) {
-            _labels_c.push_back(l.c_str());
-        }
-    }
+// Histogram with exponential buckets: start, start*factor, ..., start*factor^(count-1), +Inf
+class Histogram : public MetricBase {
+public:
+    Histogram(std::string name, std::string help, int start, double factor, int count, std::vector<std::string> labels);
+    ~Histogram();
 
-    ~Gauge() {
-        K2LOG_D(log::k2Client, "destroy gauge metric: {}", _name);
-    }
+    void observe(double value, const char** label_values=NULL);
 
-    void set(double value, const char** label_values=NULL) {
-        K2LOG_D(log::k2Client, "set gauge metric: {} for name {}", value, _name);
+    // durations are observed in usec
+    void observe(k2::Duration value, const char** label_values=NULL) {
+        observe(std::chrono::duration<double, std::micro>(value).count(), label_values);
     }
 
-    void add(double value, const char** label_values=NULL) {
-        K2LOG_D(log::k2Client, "add gauge metric: {} for name {}", value, _name);
-    }
+    void exportTo(seastar::metrics::metric_groups& groups, const std::string& group) override;
 
 private:
-    std::string _name;
-    std::string _help;
-    std::vector<std::string> _labels;
-    std::vector<const char*> _labels_c;
+    // per-thread bucket counts. Only the owning thread writes to it, scrapes read it
+    struct Shard {
+        explicit Shard(size_t buckets): counts(buckets) {}
+        std::vector<std::atomic<uint64_t>> counts;
+        std::atomic<double> sum{0};
+    };
+    struct Series {
+        std::array<std::atomic<Shard*>, MAX_THREAD_SLOTS> shards{};
+        ~Series();
+    };
+
+    size_t _bucketFor(double value) const;
+    Series& _series(const char** label_values);
+
+    std::vector<double> _bounds;
+    double _logStart{0};
+    double _logFactor{0};
+
+    Series _default;
+    std::unordered_map<std::string, std::unique_ptr<Series>> _labeled;
+    std::shared_mutex _labeledMutex;
 };
 
-struct Counter {
-    Counter(std::string name, std::string help, std::vector<std::string> labels) :
-            _name(std::move(name)), _help(std::move(help)), _labels(std::move(labels)) {
-        K2LOG_D(log::k2Client, "create counter metric: {}", _name);
-        _labels_c.reserve(_labels.size());
-        for (auto& l : _labels) {
-            _labels_c.push_back(l.c_str());
-        }
-    }
+class Gauge : public MetricBase {
+public:
+    Gauge(std::string name, std::string help, std::vector<std::string> labels);
+    ~Gauge();
 
-    ~Counter() {
-        K2LOG_D(log::k2Client, "destroy counter metric: {}", _name);
-    }
+    void set(double value, const char** label_values=NULL);
+    void add(double value, const char** label_values=NULL);
 
-    void add(double value, const char** label_values=NULL) {
-        K2LOG_D(log::k2Client, "add counter metric: {} for name {}", value, _name);
-    }
+    void exportTo(seastar::metrics::metric_groups& groups, const std::string& group) override;
 
 private:
-    std::string _name;
-    std::string _help;
-    std::vector<std::string> _labels;
-    std::vector<const char*> _labels_c;
+    std::atomic<double>& _value(const char** label_values);
+
+    std::atomic<double> _default{0};
+    std::unordered_map<std::string, std::unique_ptr<std::atomic<double>>> _labeled;
+    std::shared_mutex _labeledMutex;
 };
-}
-}
+
+class Counter : public MetricBase {
+public:
+    Counter(std::string name, std::string help, std::vector<std::string> labels);
+    ~Counter();
+
+    void add(double value, const char** label_values=NULL);
+
+    void exportTo(seastar::metrics::metric_groups& groups, const std::string& group) override;
+
+private:
+    // per-thread partial sums, added up on scrape
+    struct Series {
+        std::array<std::atomic<double>, MAX_THREAD_SLOTS> slots{};
+    };
+    Series& _series(const char** label_values);
+
+    Series _default;
+    std::unordered_map<std::string, std::unique_ptr<Series>> _labeled;
+    std::shared_mutex _labeledMutex;
+};
+
+// Exports all live metrics to the given seastar metric group, replacing what it exported before. Must run on the
+// reactor thread of the K2 app, whose prometheus push then pushes them
+void exportAll(seastar::metrics::metric_groups& groups);
+
+// Changes whenever the set of series to export changes, i.e. a metric or a labeled series is created or destroyed
+uint64_t exportGeneration();
+
+}  // namespace k2pg::metrics
@@ -22,11 +22,16 @@ Copyright(c) 2020 Futurewei Cloud
 */
 #pragma once
 
+#include <array>
 #include <atomic>
 #include <future>
-#include <queue>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <variant>
 
 #include "k2_includes.h"
+#include "k2_ring.h"
 #include "k2_txn.h"
 
 namespace k2pg {
@@ -103,6 +108,15 @@ struct ReadRequest {
     K2_DEF_FMT(ReadRequest, mtr, key, collectionName);
 };
 
+// A batch of point reads within the same transaction, e.g. base table rows found via a secondary index.
+// Results are returned in the same order as the records
+struct MultiReadRequest {
+    k2::dto::K23SI_MTR mtr;
+    std::vector<k2::dto::SKVRecord> records;
+    std::promise<std::vector<k2::ReadResult<k2::dto::SKVRecord>>> prom;
+    K2_DEF_FMT(MultiReadRequest, mtr);
+};
+
 struct WriteRequest {
     k2::dto::K23SI_MTR mtr;
     bool erase = false;
@@ -121,49 +135,191 @@ struct UpdateRequest {
     K2_DEF_FMT(UpdateRequest, mtr, fieldsForUpdate, key);
 };
 
-// Lock-free mutex
-class LFMutex {
-private:
-    std::atomic_flag _flag = ATOMIC_FLAG_INIT;
+// A whole SQL operation to run on the seastar thread, see OpTask
+struct OpRequest {
+    k2::dto::K23SI_MTR mtr;
+    OpTask task;
+    std::promise<k2pg::Status> prom;
+    K2_DEF_FMT(OpRequest, mtr);
+};
+
+// A whole SQL operation which runs in a transaction of its own, e.g. a single row write in autocommit mode.
+// The seastar thread begins the transaction and runs the task, which is responsible for ending the transaction,
+// so that the PG thread only waits once for the begin, the operation and the commit.
+struct OneShotOpRequest {
+    k2::K2TxnOptions opts;
+    OpTask task;
+    std::promise<k2pg::Status> prom;
+    K2_DEF_FMT(OneShotOpRequest, opts);
+};
 
+// All request types which can be submitted to the seastar thread. The monostate alternative marks an empty ring slot.
+using Request = std::variant<std::monostate,
+                             BeginTxnRequest,
+                             EndTxnRequest,
+                             SchemaGetRequest,
+                             SchemaCreateRequest,
+                             CollectionCreateRequest,
+                             CollectionDropRequest,
+                             ScanReadCreateRequest,
+                             ScanReadRequest,
+                             ReadRequest,
+                             MultiReadRequest,
+                             WriteRequest,
+                             UpdateRequest,
+                             OpRequest,
+                             OneShotOpRequest>;
+
+// The submission channel between PG-side threads and the seastar thread.
+// Each producer thread gets its own lock-free SPSC ring, registered on first use, so that producers never contend
+// with each other or with the consumer. A ring is released when its thread exits and reused by the next thread which
+// registers, so MAX_PRODUCERS bounds the number of live producer threads only. The seastar thread is the single
+// consumer of all rings, and it parks on the doorbell when all rings are empty instead of spinning.
+class RequestChannel {
 public:
-    void lock() {
-        while (_flag.test_and_set(std::memory_order_acquire));
+    static constexpr size_t RING_CAPACITY = 1024;
+    static constexpr size_t MAX_PRODUCERS = 64;
+    using Ring = SPSCRing<Request, RING_CAPACITY>;
+
+    // Producer side: publish a request and wake the consumer if it is parked. Returns false, without touching the
+    // request, if the channel has been shut down. The check and the push are atomic with respect to
+    // shutdownAndDrain(), so a request is either refused here or seen by the consumer
+    template <typename RequestT>
+    bool push(RequestT&& r) {
+        const size_t idx = _producerIdx();
+        std::atomic<bool>& pushing = _pushing[idx].flag;
+        // pairs with the seq_cst store of _shutdown: either we see the shutdown or the consumer sees us pushing
+        pushing.store(true, std::memory_order_seq_cst);
+        if (_shutdown.load(std::memory_order_seq_cst)) {
+            pushing.store(false, std::memory_order_relaxed);
+            return false;
+        }
+        _rings[idx]->push(Request(std::forward<RequestT>(r)));
+        _doorbell.ring();
+        pushing.store(false, std::memory_order_release);
+        return true;
     }
-    void unlock() {
-        _flag.clear(std::memory_order_release);
+
+    // Consumer side: call the visitor with each pending request from all producer rings.
+    // Returns the number of requests consumed.
+    template <typename Func>
+    size_t drain(Func&& visitor) {
+        size_t total = 0;
+        const size_t count = _ringCount.load(std::memory_order_acquire);
+        for (size_t i = 0; i < count; ++i) {
+            total += _rings[i]->drain(visitor);
+        }
+        return total;
+    }
+
+    // Consumer side: true if there are no pending requests in any producer ring
+    bool empty() const {
+        const size_t count = _ringCount.load(std::memory_order_acquire);
+        for (size_t i = 0; i < count; ++i) {
+            if (!_rings[i]->empty()) {
+                return false;
+            }
+        }
+        return true;
     }
-};
 
+    Doorbell& doorbell() { return _doorbell; }
 
-// mutex for locking outgoing request queues
-inline LFMutex requestQMutex;
+    // Refuses all the pushes from now on
+    void shutdown() { _shutdown.store(true, std::memory_order_seq_cst); }
 
-// signal between consumer and producers that the queue processing is shutdown
-inline volatile bool shutdown{false};
+    // Consumer side: shuts the channel down and calls the visitor with every request which was pushed, including
+    // the ones whose push was in progress. Nothing can be pushed once this returns
+    template <typename Func>
+    void shutdownAndDrain(Func&& visitor) {
+        shutdown();
+        const size_t count = _ringCount.load(std::memory_order_seq_cst);
+        for (size_t i = 0; i < count; ++i) {
+            // keep draining while a producer finishes its push, since it may be waiting for room in a full ring
+            while (_pushing[i].flag.load(std::memory_order_seq_cst)) {
+                _rings[i]->drain(visitor);
+                std::this_thread::yield();
+            }
+        }
+        drain(visitor);
+    }
 
-// Shared queues for submitting requests to the seastar thread
-inline std::queue<BeginTxnRequest> beginTxQ;
-inline std::queue<EndTxnRequest> endTxQ;
-inline std::queue<SchemaGetRequest> schemaGetTxQ;
-inline std::queue<SchemaCreateRequest> schemaCreateTxQ;
-inline std::queue<CollectionCreateRequest> collectionCreateTxQ;
-inline std::queue<CollectionDropRequest> collectionDropTxQ;
-inline std::queue<ScanReadCreateRequest> scanReadCreateTxQ;
-inline std::queue<ScanReadRequest> scanReadTxQ;
-inline std::queue<ReadRequest> readTxQ;
-inline std::queue<WriteRequest> writeTxQ;
-inline std::queue<UpdateRequest> updateTxQ;
+private:
+    // The ring of a producer thread, released when the thread exits
+    struct ProducerSlot {
+        RequestChannel* channel = nullptr;
+        size_t idx = 0;
 
-// Helper function used to push an item onto a request queue safely.
-template <typename Q, typename Request>
-void pushQ(Q& queue, Request&& r) {
-    std::lock_guard lock{requestQMutex};
-    if (shutdown) {
-        r.prom.set_exception(std::make_exception_ptr(std::runtime_error("queue processing has been shutdown")));
+        ~ProducerSlot() {
+            if (channel != nullptr) {
+                // pairs with the acquire in _acquireRing(), so that our pushes happen before those of the next owner
+                channel->_ringInUse[idx].store(false, std::memory_order_release);
+            }
+        }
+    };
+
+    // returns the index of the ring of the calling thread, registering one if this is the first push from the thread
+    size_t _producerIdx() {
+        thread_local ProducerSlot slot;
+        if (slot.channel == nullptr) {
+            slot.idx = _acquireRing();
+            slot.channel = this;
+        }
+        return slot.idx;
+    }
+
+    // takes a ring released by an exited thread, or adds a new one. The rings are never freed, so the consumer can
+    // keep draining a released ring, including the requests its previous thread left in it
+    size_t _acquireRing() {
+        std::lock_guard lock{_registerMutex};
+        const size_t count = _ringCount.load(std::memory_order_relaxed);
+        for (size_t i = 0; i < count; ++i) {
+            if (!_ringInUse[i].load(std::memory_order_acquire)) {
+                _ringInUse[i].store(true, std::memory_order_relaxed);
+                return i;
+            }
+        }
+        if (count >= MAX_PRODUCERS) {
+            throw std::runtime_error("too many live producer threads for the request channel");
+        }
+        _rings[count] = std::make_unique<Ring>();
+        _ringInUse[count].store(true, std::memory_order_relaxed);
+        // seq_cst so that shutdownAndDrain() sees the new ring if it sees the shutdown after our first push
+        _ringCount.store(count + 1, std::memory_order_seq_cst);
+        return count;
     }
-    else {
-        queue.push(std::forward<Request>(r));
+
+    std::array<std::unique_ptr<Ring>, MAX_PRODUCERS> _rings;
+    std::array<std::atomic<bool>, MAX_PRODUCERS> _ringInUse{};
+    // set by the producer of a ring while it pushes, on its own cache line so that producers don't contend
+    struct alignas(CACHE_LINE_SIZE) PushingFlag {
+        std::atomic<bool> flag{false};
+    };
+    std::array<PushingFlag, MAX_PRODUCERS> _pushing{};
+    std::atomic<size_t> _ringCount{0};
+    // only used when a producer thread registers its ring
+    std::mutex _registerMutex;
+    Doorbell _doorbell;
+    std::atomic<bool> _shutdown{false};
+};
+
+// Shared channel for submitting requests to the seastar thread
+inline RequestChannel requestChannel;
+
+// Optional hook which starts the K2 client app on demand. When set, it is invoked exactly once, by the first
+// request pushed from this process. Backends which never talk to K2 (e.g. cancel requests or failed
+// authentication) then never pay for booting the seastar app.
+inline void (*startK2AppFunc)() = nullptr;
+inline std::once_flag startK2AppFlag;
+
+// Helper function used to push a request onto the request channel safely.
+template <typename RequestT>
+void pushQ(RequestT&& r) {
+    if (startK2AppFunc) {
+        std::call_once(startK2AppFlag, startK2AppFunc);
+    }
+    if (!requestChannel.push(std::forward<RequestT>(r))) {
+        r.prom.set_exception(std::make_exception_ptr(std::runtime_error("queue processing has been shutdown")));
     }
 }
 
@@ -0,0 +1,166 @@
+/*
+MIT License
+
+Copyright(c) 2021 Futurewei Cloud
+
+    Permission is hereby granted,
+    free of charge, to any person obtaining a copy of this software and associated documentation files(the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and / or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions :
+
+    The above copyright notice and this permission notice shall be included in all copies
+    or
+    substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS",
+    WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+    DAMAGES OR OTHER
+    LIABILITY,
+    WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+#pragma once
+
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+
+namespace k2pg {
+
+// Size used to keep producer and consumer state on separate cache lines
+inline constexpr size_t CACHE_LINE_SIZE = 64;
+
+// Bounded, lock-free single-producer/single-consumer ring.
+// The producer and consumer indexes live on their own cache lines, and each side keeps a cached copy of the
+// other side's index so that the shared cache line is only touched when the ring looks full (producer) or
+// empty (consumer).
+// Capacity must be a power of 2.
+template <typename T, size_t Capacity>
+class SPSCRing {
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "ring capacity must be a power of 2");
+    static constexpr size_t MASK = Capacity - 1;
+
+public:
+    // Producer side. Returns false if the ring is full, in which case the item is left untouched
+    bool tryPush(T&& item) {
+        const size_t tail = _tail.load(std::memory_order_relaxed);
+        if (tail - _cachedHead == Capacity) {
+            _cachedHead = _head.load(std::memory_order_acquire);
+            if (tail - _cachedHead == Capacity) {
+                return false;
+            }
+        }
+        _slots[tail & MASK].value = std::move(item);
+        _tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Producer side. Spins (yielding the CPU) until there is room in the ring
+    void push(T&& item) {
+        while (!tryPush(std::move(item))) {
+            std::this_thread::yield();
+        }
+    }
+
+    // Consumer side. Calls the visitor with each available item, moved out of the ring, and returns the number
+    // of items consumed. At most `max` items are consumed in one call.
+    template <typename Func>
+    size_t drain(Func&& visitor, size_t max = Capacity) {
+        size_t head = _head.load(std::memory_order_relaxed);
+        if (head == _cachedTail) {
+            _cachedTail = _tail.load(std::memory_order_acquire);
+        }
+        size_t count = 0;
+        while (head != _cachedTail && count < max) {
+            T item(std::move(_slots[head & MASK].value));
+            _slots[head & MASK].value = T{};
+            ++head;
+            ++count;
+            // publish each slot before invoking the visitor so that the producer can reuse it right away
+            _head.store(head, std::memory_order_release);
+            visitor(item);
+        }
+        return count;
+    }
+
+    // Consumer side. True if there is nothing to consume. Uses a fresh view of the producer index
+    bool empty() const {
+        return _head.load(std::memory_order_relaxed) == _tail.load(std::memory_order_acquire);
+    }
+
+private:
+    struct alignas(CACHE_LINE_SIZE) Slot {
+        T value{};
+    };
+
+    // consumer state
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> _head{0};
+    size_t _cachedTail{0};
+
+    // producer state
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> _tail{0};
+    size_t _cachedHead{0};
+
+    std::array<Slot, Capacity> _slots;
+};
+
+// An eventfd-based doorbell, used by producers to wake up a consumer which has parked itself because there was no
+// work. Producers only pay for the write() syscall when the consumer has declared that it is parked.
+class Doorbell {
+public:
+    Doorbell() {
+        _fd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (_fd < 0) {
+            throw std::runtime_error("unable to create eventfd for doorbell");
+        }
+    }
+
+    ~Doorbell() {
+        ::close(_fd);
+    }
+
+    Doorbell(const Doorbell&) = delete;
+    Doorbell& operator=(const Doorbell&) = delete;
+
+    // The file descriptor the consumer should wait on for readability
+    int fd() const { return _fd; }
+
+    // Consumer side: declare the intent to park. The consumer must re-check for work after calling this and before
+    // actually blocking on the fd, otherwise a wake-up may be lost.
+    void park() {
+        _parked.store(true, std::memory_order_seq_cst);
+    }
+
+    // Consumer side: declare that the consumer is running again
+    void unpark() {
+        _parked.store(false, std::memory_order_relaxed);
+    }
+
+    // Producer side: wake the consumer if it is parked. Must be called after the item has been published.
+    void ring() {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (_parked.load(std::memory_order_relaxed) && _parked.exchange(false, std::memory_order_acq_rel)) {
+            forceRing();
+        }
+    }
+
+    // Unconditionally wake the consumer, e.g. for shutdown
+    void forceRing() {
+        uint64_t one = 1;
+        while (::write(_fd, &one, sizeof(one)) < 0 && errno == EINTR);
+    }
+
+private:
+    int _fd{-1};
+    alignas(CACHE_LINE_SIZE) std::atomic<bool> _parked{false};
+};
+
+}  // namespace k2pg
@@ -23,7 +23,12 @@ Copyright(c) 2020 Futurewei Cloud
 
 #include "k2_seastar_app.h"
 
+#include <cerrno>
+#include <cstring>
+#include <system_error>
+
 #include "k2_includes.h"
+#include "k2_metrics_api.h"
 #include "k2_queue_defs.h"
 #include "k2_txn.h"
 
@@ -43,18 +48,20 @@ PGK2Client::~PGK2Client() {
 
 seastar::future<> PGK2Client::gracefulStop() {
     K2LOG_I(log::k2ss, "Stopping");
-    {
-        std::unique_lock lock(requestQMutex);
-        shutdown = true;
-    }
+    requestChannel.shutdown();
     _stop = true;
+    // wake up the poller in case it is parked
+    requestChannel.doorbell().forceRing();
     return std::move(_poller)
+        .then([this] {
+            return _inFlight.close();
+        })
         .then([this] {
             return _client->gracefulStop();
         })
         .then([this] {
             // drain all queue items and fail them due to shutdown
-            return _pollForWork();
+            _failPending();
         });
 }
 
@@ -63,285 +70,348 @@ seastar::future<> PGK2Client::start() {
     // start polling the request queues only on core 0
     if (seastar::this_shard_id() == 0) {
         K2LOG_I(log::k2ss, "Poller starting");
+        // the channel owns the eventfd. Use a dup so that seastar can own and close its own descriptor
+        int fd = ::dup(requestChannel.doorbell().fd());
+        if (fd < 0) {
+            int err = errno;
+            K2LOG_E(log::k2ss, "Failed to dup the request channel doorbell: {}", strerror(err));
+            return seastar::make_exception_future<>(std::system_error(err, std::system_category(), "dup of the request channel doorbell"));
+        }
+        _doorbellFd = std::make_unique<seastar::pollable_fd>(seastar::file_desc::from_fd(fd));
+        _exportMetrics();
         _poller = _poller.then([this] {
-            return seastar::do_until(
-                [this] {
-                    return _stop;
-                },
-                [this] {
-                    return _pollForWork();
-                }
-            );
+            return _pollForWork();
         });
     }
     return _client->start();
 }
 
-// Helper function used to poll a given queue. The given Func visitor is called with each element
-// pulled off the queue in sequence
-template <typename Q, typename Func>
-seastar::future<> pollQ(Q& q, Func&& visitor) {
-    // lock the mutex before manipulating the queue
-    std::unique_lock lock(requestQMutex);
-
-    std::vector<seastar::future<>> futs;
-    futs.reserve(q.size());
-
-    while (!q.empty()) {
-        K2LOG_V(log::k2ss, "Found op in queue");
-        futs.push_back(
-            seastar::do_with(std::move(q.front()), std::forward<Func>(visitor),
-            [] (auto& req, auto& visitor) {
-                try {
-                    return visitor(req)
-                        .handle_exception([&req](auto exc) {
-                            K2LOG_W_EXC(log::k2ss, exc, "caught exception");
-                            req.prom.set_exception(exc);
-                        });
-                }
-                catch (const std::exception& exc) {
-                    K2LOG_W(log::k2ss, "Caught exception during poll of {}: {}", typeid(Q).name(), exc.what());
-                    req.prom.set_exception(std::current_exception());
+template <typename RequestT>
+void PGK2Client::_launch(RequestT&& request) {
+    K2LOG_V(log::k2ss, "Found op in queue");
+    // The request is moved into the continuation state so that it stays alive until its handler completes.
+    // We don't wait for the handler here - the poller keeps pulling new requests while this one is in flight.
+    (void)seastar::with_gate(_inFlight, [this, request=std::move(request)] () mutable {
+        return seastar::do_with(std::move(request), [this] (auto& req) {
+            try {
+                if (_stop) {
+                    req.prom.set_exception(std::make_exception_ptr(std::runtime_error("seastar app has been shutdown")));
                     return seastar::make_ready_future();
                 }
-                catch (...) {
-                    K2LOG_W(log::k2ss, "Caught unknown exception during poll of {}", typeid(Q).name());
-                    req.prom.set_exception(std::current_exception());
-                    return seastar::make_ready_future();
-                }
-            }));
-        q.pop();
-    }
-    return seastar::when_all_succeed(futs.begin(), futs.end());
+                return _handle(req)
+                    .handle_exception([&req](auto exc) {
+                        K2LOG_W_EXC(log::k2ss, exc, "caught exception");
+                        req.prom.set_exception(exc);
+                    });
+            }
+            catch (const std::exception& exc) {
+                K2LOG_W(log::k2ss, "Caught exception during processing of {}: {}", typeid(req).name(), exc.what());
+                req.prom.set_exception(std::current_exception());
+                return seastar::make_ready_future();
+            }
+            catch (...) {
+                K2LOG_W(log::k2ss, "Caught unknown exception during processing of {}", typeid(req).name());
+                req.prom.set_exception(std::current_exception());
+                return seastar::make_ready_future();
+            }
+        });
+    });
 }
 
-seastar::future<> PGK2Client::_pollBeginQ() {
-    return pollQ(beginTxQ, [this](auto& req) {
-        K2LOG_D(log::k2ss, "Begin txn...");
-        if (_stop) {
-            return seastar::make_exception_future(std::runtime_error("seastar app has been shutdown"));
-        }
-        return _client->beginTxn(req.opts)
-            .then([this, &req](auto&& txn) {
-                K2LOG_D(log::k2ss, "txn: {}", txn.mtr());
-                auto mtr = txn.mtr();
-                (*_txns)[txn.mtr()] = std::move(txn);
-                req.prom.set_value(K23SITxn(mtr, req.startTime));  // send a copy to the promise
-
-            });
+size_t PGK2Client::_dispatchAll() {
+    return requestChannel.drain([this](Request& item) {
+        std::visit([this](auto& req) {
+            using T = std::decay_t<decltype(req)>;
+            if constexpr (!std::is_same_v<T, std::monostate>) {
+                _launch(std::move(req));
+            }
+        }, item);
     });
 }
 
-seastar::future<> PGK2Client::_pollEndQ() {
-    return pollQ(endTxQ, [this](auto& req) {
-        K2LOG_D(log::k2ss, "End txn...");
-        if (_stop) {
-            return seastar::make_exception_future(std::runtime_error("seastar app has been shutdown"));
-        }
-        auto fiter = _txns->find(req.mtr);
-        if (fiter == _txns->end()) {
-            K2LOG_W(log::k2ss, "invalid txn id: {}", req.mtr);
-            // PG sends Abort after a failed Commit call (in this case we don't fail the abort)
-            req.prom.set_value(req.shouldCommit ?
-               k2::EndResult(k2::dto::K23SIStatus::OperationNotAllowed("invalid txn id")) :
-               k2::EndResult(k2::dto::K23SIStatus::OK("")));
-            return seastar::make_ready_future();
-        }
-        K2LOG_D(log::k2ss, "Ending txn: {}, with commit={}", req.mtr, req.shouldCommit);
-        return fiter->second.end(req.shouldCommit)
-            .then([this, &req](auto&& endResult) {
-                K2LOG_D(log::k2ss, "Ended txn: {}, with result: {}", req.mtr, endResult);
-                _txns->erase(req.mtr);
-                req.prom.set_value(std::move(endResult));
-            });
+void PGK2Client::_failPending() {
+    requestChannel.shutdownAndDrain([](Request& item) {
+        std::visit([](auto& req) {
+            using T = std::decay_t<decltype(req)>;
+            if constexpr (!std::is_same_v<T, std::monostate>) {
+                req.prom.set_exception(std::make_exception_ptr(std::runtime_error("queue processing has been shutdown")));
+            }
+        }, item);
     });
 }
 
-seastar::future<> PGK2Client::_pollSchemaGetQ() {
-    return pollQ(schemaGetTxQ, [this](auto& req) {
-        K2LOG_D(log::k2ss, "Schema get {}", req);
-        if (_stop) {
-            return seastar::make_exception_future(std::runtime_error("seastar app has been shutdown"));
-        }
-        // Strings will be copied into a payload by transport so will be RDMA safe without extra copy
-        return _client->getSchema(req.collectionName, req.schemaName, req.schemaVersion)
-            .then([this, &req](auto&& result) {
-                K2LOG_D(log::k2ss, "Schema get received {}", result);
-                req.prom.set_value(std::move(result));
-            });
-    });
+seastar::future<> PGK2Client::_waitForWork() {
+    auto& bell = requestChannel.doorbell();
+    bell.park();
+    // re-check after announcing that we park, otherwise we may miss a request published just before park()
+    if (_stop || !requestChannel.empty()) {
+        bell.unpark();
+        return seastar::make_ready_future();
+    }
+    K2LOG_V(log::k2ss, "Poller parked");
+    return _doorbellFd->read_some(reinterpret_cast<char*>(&_doorbellCount), sizeof(_doorbellCount))
+        .then([&bell](size_t) {
+            bell.unpark();
+        });
 }
 
-seastar::future<> PGK2Client::_pollSchemaCreateQ() {
-    return pollQ(schemaCreateTxQ, [this](auto& req) {
-        K2LOG_D(log::k2ss, "Schema create... {}", req);
-        if (_stop) {
-            return seastar::make_exception_future(std::runtime_error("seastar app has been shutdown"));
-        }
-        // Parameters will be copied into a payload by transport so will be RDMA safe without extra copy
-        return _client->createSchema(req.collectionName, req.schema)
-            .then([this, &req](auto&& result) {
-                K2LOG_D(log::k2ss, "Schema create received {}", result);
-                req.prom.set_value(std::move(result));
-            });
-    });
+void PGK2Client::_exportMetrics() {
+    uint64_t generation = metrics::exportGeneration();
+    if (generation != _metricsGeneration) {
+        _metricsGeneration = generation;
+        metrics::exportAll(_metricGroups);
+    }
 }
 
-seastar::future<> PGK2Client::_pollCreateCollectionQ() {
-    return pollQ(collectionCreateTxQ, [this](auto& req) {
-        K2LOG_D(log::k2ss, "Collection create... {}", req);
-        if (_stop) {
-            return seastar::make_exception_future(std::runtime_error("seastar app has been shutdown"));
+seastar::future<> PGK2Client::_pollForWork() {
+    return seastar::do_until(
+        [this] {
+            return _stop;
+        },
+        [this] {
+            _exportMetrics();
+            if (_dispatchAll() > 0) {
+                _idlePolls = 0;
+                return seastar::make_ready_future();
+            }
+            if (++_idlePolls < IDLE_POLLS_BEFORE_PARK) {
+                // let the reactor run (e.g. complete network io) before we poll again
+                return seastar::later();
+            }
+            _idlePolls = 0;
+            return _waitForWork();
         }
-        return _client->makeCollection(std::move(req.ccr.metadata), std::move(req.ccr.rangeEnds))
-            .then([this, &req](auto&& result) {
-                K2LOG_D(log::k2ss, "Collection create received {}", result);
-                req.prom.set_value(std::move(result));
-            });
-    });
+    );
 }
 
-seastar::future<> PGK2Client::_pollDropCollectionQ() {
-    return pollQ(collectionDropTxQ, [this](auto& req) {
-        K2LOG_D(log::k2ss, "Collection drop... {}", req);
-        if (_stop) {
-            return seastar::make_exception_future(std::runtime_error("seastar app has been shutdown"));
-        }
-        k2::dto::CollectionDropRequest request{std::move(req.collectionName)};
-
-        return k2::RPC().callRPC<k2::dto::CollectionDropRequest, k2::dto::CollectionDropResponse>
-                        (k2::dto::Verbs::CPO_COLLECTION_DROP, request,
-                        *(_client->cpo_client.cpo), k2::Duration(10s)).then([this, &req] (auto&& response) {
-                auto& [status, k2response] = response;
-                K2LOG_D(log::k2ss, "Collection drop received {}", status);
-                req.prom.set_value(std::move(status));
-            });
-    });
+seastar::future<> PGK2Client::_handle(BeginTxnRequest& req) {
+    K2LOG_D(log::k2ss, "Begin txn...");
+    return _client->beginTxn(req.opts)
+        .then([this, &req](auto&& txn) {
+            K2LOG_D(log::k2ss, "txn: {}", txn.mtr());
+            auto mtr = txn.mtr();
+            (*_txns)[txn.mtr()] = std::move(txn);
+            req.prom.set_value(K23SITxn(mtr, req.startTime));  // send a copy to the promise
+        });
 }
 
-seastar::future<> PGK2Client::_pollReadQ() {
-    return pollQ(readTxQ, [this](auto& req) mutable {
-        K2LOG_D(log::k2ss, "Read... {}", req);
-        if (_stop) {
-            return seastar::make_exception_future(std::runtime_error("seastar app has been shutdown"));
-        }
-        auto fiter = _txns->find(req.mtr);
-        if (fiter == _txns->end()) {
-            K2LOG_W(log::k2ss, "invalid txn id: {}", req.mtr);
-            req.prom.set_value(k2::ReadResult<k2::dto::SKVRecord>(k2::dto::K23SIStatus::OperationNotAllowed("invalid txn id"), k2::dto::SKVRecord()));
-            return seastar::make_ready_future();
-        }
+seastar::future<> PGK2Client::_handle(EndTxnRequest& req) {
+    K2LOG_D(log::k2ss, "End txn...");
+    auto fiter = _txns->find(req.mtr);
+    if (fiter == _txns->end()) {
+        K2LOG_W(log::k2ss, "invalid txn id: {}", req.mtr);
+        // PG sends Abort after a failed Commit call (in this case we don't fail the abort)
+        req.prom.set_value(req.shouldCommit ?
+           k2::EndResult(k2::dto::K23SIStatus::OperationNotAllowed("invalid txn id")) :
+           k2::EndResult(k2::dto::K23SIStatus::OK("")));
+        return seastar::make_ready_future();
+    }
+    K2LOG_D(log::k2ss, "Ending txn: {}, with commit={}", req.mtr, req.shouldCommit);
+    return fiter->second.end(req.shouldCommit)
+        .then([this, &req](auto&& endResult) {
+            K2LOG_D(log::k2ss, "Ended txn: {}, with result: {}", req.mtr, endResult);
+            _txns->erase(req.mtr);
+            req.prom.set_value(std::move(endResult));
+        });
+}
 
-        if (!req.key.partitionKey.empty()) {
-            // Parameters will be copied into a payload by transport so will be RDMA safe without extra copy
-            return fiter->second.read(std::move(req.key), std::move(req.collectionName))
-            .then([this, &req](auto&& readResult) {
-                K2LOG_D(log::k2ss, "Key Read received: {}", readResult);
-                req.prom.set_value(std::move(readResult));
-            });
-        }
+seastar::future<> PGK2Client::_handle(SchemaGetRequest& req) {
+    K2LOG_D(log::k2ss, "Schema get {}", req);
+    // Strings will be copied into a payload by transport so will be RDMA safe without extra copy
+    return _client->getSchema(req.collectionName, req.schemaName, req.schemaVersion)
+        .then([this, &req](auto&& result) {
+            K2LOG_D(log::k2ss, "Schema get received {}", result);
+            req.prom.set_value(std::move(result));
+        });
+}
 
-        // Copy SKVRecrod to make RDMA safe
-        return fiter->second.read(req.record.deepCopy())
-            .then([this, &req](auto&& readResult) {
-                K2LOG_D(log::k2ss, "Read received: {}", readResult);
-                req.prom.set_value(std::move(readResult));
-            });
-    });
+seastar::future<> PGK2Client::_handle(SchemaCreateRequest& req) {
+    K2LOG_D(log::k2ss, "Schema create... {}", req);
+    // Parameters will be copied into a payload by transport so will be RDMA safe without extra copy
+    return _client->createSchema(req.collectionName, req.schema)
+        .then([this, &req](auto&& result) {
+            K2LOG_D(log::k2ss, "Schema create received {}", result);
+            req.prom.set_value(std::move(result));
+        });
 }
 
-seastar::future<> PGK2Client::_pollCreateScanReadQ() {
-    return pollQ(scanReadCreateTxQ, [this](auto& req) {
-        K2LOG_D(log::k2ss, "Create scan... {}", req);
-        if (_stop) {
-            return seastar::make_exception_future(std::runtime_error("seastar app has been shutdown"));
-        }
+seastar::future<> PGK2Client::_handle(CollectionCreateRequest& req) {
+    K2LOG_D(log::k2ss, "Collection create... {}", req);
+    return _client->makeCollection(std::move(req.ccr.metadata), std::move(req.ccr.rangeEnds))
+        .then([this, &req](auto&& result) {
+            K2LOG_D(log::k2ss, "Collection create received {}", result);
+            req.prom.set_value(std::move(result));
+        });
+}
+
+seastar::future<> PGK2Client::_handle(CollectionDropRequest& req) {
+    K2LOG_D(log::k2ss, "Collection drop... {}", req);
+    k2::dto::CollectionDropRequest request{std::move(req.collectionName)};
+
+    return k2::RPC().callRPC<k2::dto::CollectionDropRequest, k2::dto::CollectionDropResponse>
+                    (k2::dto::Verbs::CPO_COLLECTION_DROP, request,
+                    *(_client->cpo_client.cpo), k2::Duration(10s)).then([this, &req] (auto&& response) {
+            auto& [status, k2response] = response;
+            K2LOG_D(log::k2ss, "Collection drop received {}", status);
+            req.prom.set_value(std::move(status));
+        });
+}
+
+seastar::future<> PGK2Client::_handle(ReadRequest& req) {
+    K2LOG_D(log::k2ss, "Read... {}", req);
+    auto fiter = _txns->find(req.mtr);
+    if (fiter == _txns->end()) {
+        K2LOG_W(log::k2ss, "invalid txn id: {}", req.mtr);
+        req.prom.set_value(k2::ReadResult<k2::dto::SKVRecord>(k2::dto::K23SIStatus::OperationNotAllowed("invalid txn id"), k2::dto::SKVRecord()));
+        return seastar::make_ready_future();
+    }
+
+    if (!req.key.partitionKey.empty()) {
         // Parameters will be copied into a payload by transport so will be RDMA safe without extra copy
-        return _client->createQuery(req.collectionName, req.schemaName)
-            .then([this, &req](auto&& result) {
-                K2LOG_D(log::k2ss, "Created scan... {}", result);
-                CreateScanReadResult response {
-                    .status = std::move(result.status),
-                    .query = std::make_shared<k2::Query>(std::move(result.query))
-                };
-                req.prom.set_value(std::move(response));
-            });
-    });
+        return fiter->second.read(std::move(req.key), std::move(req.collectionName))
+        .then([this, &req](auto&& readResult) {
+            K2LOG_D(log::k2ss, "Key Read received: {}", readResult);
+            req.prom.set_value(std::move(readResult));
+        });
+    }
+
+    // Copy SKVRecrod to make RDMA safe
+    return fiter->second.read(req.record.deepCopy())
+        .then([this, &req](auto&& readResult) {
+            K2LOG_D(log::k2ss, "Read received: {}", readResult);
+            req.prom.set_value(std::move(readResult));
+        });
 }
 
-seastar::future<> PGK2Client::_pollScanReadQ() {
-    return pollQ(scanReadTxQ, [this](auto& req) mutable {
-        K2LOG_D(log::k2ss, "Scan... {}", req);
-        if (_stop) {
-            return seastar::make_exception_future(std::runtime_error("seastar app has been shutdown"));
-        }
-        auto fiter = _txns->find(req.mtr);
-        if (fiter == _txns->end()) {
-            K2LOG_W(log::k2ss, "invalid txn id: {}", req.mtr);
-            req.prom.set_value(k2::QueryResult(k2::dto::K23SIStatus::OperationNotAllowed("invalid txn id")));
-            return seastar::make_ready_future();
+seastar::future<> PGK2Client::_handle(MultiReadRequest& req) {
+    K2LOG_D(log::k2ss, "Multi read... {}, records: {}", req, req.records.size());
+    auto fiter = _txns->find(req.mtr);
+    if (fiter == _txns->end()) {
+        K2LOG_W(log::k2ss, "invalid txn id: {}", req.mtr);
+        std::vector<k2::ReadResult<k2::dto::SKVRecord>> results;
+        results.reserve(req.records.size());
+        for (size_t i = 0; i < req.records.size(); ++i) {
+            results.emplace_back(k2::dto::K23SIStatus::OperationNotAllowed("invalid txn id"), k2::dto::SKVRecord());
         }
-        req.query->copyPayloads();
-        return fiter->second.query(*req.query)
-            .then([this, &req](auto&& queryResult) {
-                K2LOG_D(log::k2ss, "Scanned... {}, records: {}", queryResult, queryResult.records.size());
-                req.prom.set_value(std::move(queryResult));
-            });
-    });
+        req.prom.set_value(std::move(results));
+        return seastar::make_ready_future();
+    }
+
+    // issue all reads at once. The client routes each one to the partition which owns the key
+    std::vector<seastar::future<k2::ReadResult<k2::dto::SKVRecord>>> futs;
+    futs.reserve(req.records.size());
+    for (auto& record : req.records) {
+        // Copy SKVRecrod to make RDMA safe
+        futs.push_back(fiter->second.read(record.deepCopy()));
+    }
+    return seastar::when_all_succeed(futs.begin(), futs.end())
+        .then([this, &req](auto&& readResults) {
+            K2LOG_D(log::k2ss, "Multi read received: {} results", readResults.size());
+            req.prom.set_value(std::move(readResults));
+        });
 }
 
-seastar::future<> PGK2Client::_pollWriteQ() {
-    return pollQ(writeTxQ, [this](auto& req) mutable {
-        K2LOG_D(log::k2ss, "Write... {}", req);
-        if (_stop) {
-            return seastar::make_exception_future(std::runtime_error("seastar app has been shutdown"));
-        }
-        auto fiter = _txns->find(req.mtr);
-        if (fiter == _txns->end()) {
-            K2LOG_W(log::k2ss, "invalid txn id: {}", req.mtr);
-            req.prom.set_value(k2::WriteResult(k2::dto::K23SIStatus::OperationNotAllowed("invalid txn id"), k2::dto::K23SIWriteResponse{}));
-            return seastar::make_ready_future();
-        }
-        // Copy SKVRecord to make RDMA safe
-        k2::dto::SKVRecord copy = req.record.deepCopy();
-        return fiter->second.write(copy, req.erase, req.precondition)
-            .then([this, &req](auto&& writeResult) {
-                K2LOG_D(log::k2ss, "Written... {}", writeResult);
-                req.prom.set_value(std::move(writeResult));
-            });
-    });
+seastar::future<> PGK2Client::_handle(ScanReadCreateRequest& req) {
+    K2LOG_D(log::k2ss, "Create scan... {}", req);
+    // Parameters will be copied into a payload by transport so will be RDMA safe without extra copy
+    return _client->createQuery(req.collectionName, req.schemaName)
+        .then([this, &req](auto&& result) {
+            K2LOG_D(log::k2ss, "Created scan... {}", result);
+            CreateScanReadResult response {
+                .status = std::move(result.status),
+                .query = std::make_shared<k2::Query>(std::move(result.query))
+            };
+            req.prom.set_value(std::move(response));
+        });
 }
 
-seastar::future<> PGK2Client::_pollUpdateQ() {
-    return pollQ(updateTxQ, [this](auto& req) mutable {
-        K2LOG_D(log::k2ss, "Update... {}", req);
-        if (_stop) {
-            return seastar::make_exception_future(std::runtime_error("seastar app has been shutdown"));
-        }
-        auto fiter = _txns->find(req.mtr);
-        if (fiter == _txns->end()) {
-            K2LOG_W(log::k2ss, "invalid txn id: {}", req.mtr);
-            req.prom.set_value(k2::PartialUpdateResult(k2::dto::K23SIStatus::OperationNotAllowed("invalid txn id")));
-            return seastar::make_ready_future();
-        }
-        // Copy SKVRecord to make RDMA safe
-        k2::dto::SKVRecord copy = req.record.deepCopy();
-        return fiter->second.partialUpdate(copy, std::move(req.fieldsForUpdate), std::move(req.key))
-            .then([this, &req](auto&& updateResult) {
-                K2LOG_D(log::k2ss, "Updated... {}", updateResult);
-                req.prom.set_value(std::move(updateResult));
-            });
-    });
+seastar::future<> PGK2Client::_handle(ScanReadRequest& req) {
+    K2LOG_D(log::k2ss, "Scan... {}", req);
+    auto fiter = _txns->find(req.mtr);
+    if (fiter == _txns->end()) {
+        K2LOG_W(log::k2ss, "invalid txn id: {}", req.mtr);
+        req.prom.set_value(k2::QueryResult(k2::dto::K23SIStatus::OperationNotAllowed("invalid txn id")));
+        return seastar::make_ready_future();
+    }
+    req.query->copyPayloads();
+    return fiter->second.query(*req.query)
+        .then([this, &req](auto&& queryResult) {
+            K2LOG_D(log::k2ss, "Scanned... {}, records: {}", queryResult, queryResult.records.size());
+            req.prom.set_value(std::move(queryResult));
+        });
 }
 
-seastar::future<> PGK2Client::_pollForWork() {
-    return seastar::when_all_succeed(
-        _pollBeginQ(), _pollEndQ(), _pollSchemaGetQ(),
-        _pollSchemaCreateQ(), _pollScanReadQ(), _pollReadQ(),
-        _pollWriteQ(), _pollCreateScanReadQ(), _pollUpdateQ(),
-        _pollCreateCollectionQ(),
-        _pollDropCollectionQ())
-        .discard_result();  // TODO: collection creation is rare, maybe consider some optimization later on to pull on demand only.
+seastar::future<> PGK2Client::_handle(WriteRequest& req) {
+    K2LOG_D(log::k2ss, "Write... {}", req);
+    auto fiter = _txns->find(req.mtr);
+    if (fiter == _txns->end()) {
+        K2LOG_W(log::k2ss, "invalid txn id: {}", req.mtr);
+        req.prom.set_value(k2::WriteResult(k2::dto::K23SIStatus::OperationNotAllowed("invalid txn id"), k2::dto::K23SIWriteResponse{}));
+        return seastar::make_ready_future();
+    }
+    // Copy SKVRecord to make RDMA safe
+    k2::dto::SKVRecord copy = req.record.deepCopy();
+    return fiter->second.write(copy, req.erase, req.precondition)
+        .then([this, &req](auto&& writeResult) {
+            K2LOG_D(log::k2ss, "Written... {}", writeResult);
+            req.prom.set_value(std::move(writeResult));
+        });
+}
+
+seastar::future<> PGK2Client::_handle(UpdateRequest& req) {
+    K2LOG_D(log::k2ss, "Update... {}", req);
+    auto fiter = _txns->find(req.mtr);
+    if (fiter == _txns->end()) {
+        K2LOG_W(log::k2ss, "invalid txn id: {}", req.mtr);
+        req.prom.set_value(k2::PartialUpdateResult(k2::dto::K23SIStatus::OperationNotAllowed("invalid txn id")));
+        return seastar::make_ready_future();
+    }
+    // Copy SKVRecord to make RDMA safe
+    k2::dto::SKVRecord copy = req.record.deepCopy();
+    return fiter->second.partialUpdate(copy, std::move(req.fieldsForUpdate), std::move(req.key))
+        .then([this, &req](auto&& updateResult) {
+            K2LOG_D(log::k2ss, "Updated... {}", updateResult);
+            req.prom.set_value(std::move(updateResult));
+        });
+}
+
+seastar::future<> PGK2Client::_handle(OpRequest& req) {
+    K2LOG_D(log::k2ss, "Op... {}", req);
+    auto fiter = _txns->find(req.mtr);
+    if (fiter == _txns->end()) {
+        K2LOG_W(log::k2ss, "invalid txn id: {}", req.mtr);
+        req.prom.set_value(STATUS(IllegalState, "invalid txn id"));
+        return seastar::make_ready_future();
+    }
+    // The task builds its SKV records on this thread, so they are RDMA safe without an extra copy
+    return req.task(*_client, fiter->second)
+        .then([&req](k2pg::Status&& status) {
+            K2LOG_D(log::k2ss, "Op done: {}", status);
+            req.prom.set_value(std::move(status));
+        });
+}
+
+seastar::future<> PGK2Client::_handle(OneShotOpRequest& req) {
+    K2LOG_D(log::k2ss, "One shot op... {}", req);
+    return _client->beginTxn(req.opts)
+        .then([this, &req](auto&& txn) {
+            K2LOG_D(log::k2ss, "one shot txn: {}", txn.mtr());
+            // The txn is not registered in _txns since nothing else can refer to it
+            return seastar::do_with(std::move(txn), [this, &req](auto& txn) {
+                return seastar::futurize_invoke(req.task, *_client, txn)
+                    .handle_exception([&txn](auto exc) {
+                        // the task normally ends the txn, but not if it failed with an exception
+                        return txn.end(false).then_wrapped([exc](auto&& fut) {
+                            fut.ignore_ready_future();
+                            return seastar::make_exception_future<k2pg::Status>(exc);
+                        });
+                    })
+                    .then([&req](k2pg::Status&& status) {
+                        K2LOG_D(log::k2ss, "One shot op done: {}", status);
+                        req.prom.set_value(std::move(status));
+                    });
+            });
+        });
 }
 
 }  // namespace gate
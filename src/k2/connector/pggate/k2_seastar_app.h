@@ -21,7 +21,12 @@ Copyright(c) 2020 Futurewei Cloud
     SOFTWARE.
 */
 #pragma once
+#include <seastar/core/gate.hh>
+#include <seastar/core/metrics_registration.hh>
+#include <seastar/core/reactor.hh>
+
 #include "k2_includes.h"
+#include "k2_queue_defs.h"
 
 namespace k2 {
     class K2TxnHandle;
@@ -49,17 +54,47 @@ private:
     seastar::future<> _poller = seastar::make_ready_future();
     seastar::future<> _pollForWork();
 
-    seastar::future<> _pollBeginQ();
-    seastar::future<> _pollEndQ();
-    seastar::future<> _pollSchemaGetQ();
-    seastar::future<> _pollSchemaCreateQ();
-    seastar::future<> _pollReadQ();
-    seastar::future<> _pollCreateScanReadQ();
-    seastar::future<> _pollScanReadQ();
-    seastar::future<> _pollWriteQ();
-    seastar::future<> _pollUpdateQ();
-    seastar::future<> _pollCreateCollectionQ();
-    seastar::future<> _pollDropCollectionQ();
+    // pull all pending requests off the request channel and start processing them. Returns the number of requests
+    size_t _dispatchAll();
+    // park the poller until a producer rings the doorbell
+    seastar::future<> _waitForWork();
+    // fail all requests still in the request channel, including the ones being pushed concurrently. Used after shutdown
+    void _failPending();
+
+    // start processing the given request in the background
+    template <typename RequestT>
+    void _launch(RequestT&& request);
+
+    seastar::future<> _handle(BeginTxnRequest& req);
+    seastar::future<> _handle(EndTxnRequest& req);
+    seastar::future<> _handle(SchemaGetRequest& req);
+    seastar::future<> _handle(SchemaCreateRequest& req);
+    seastar::future<> _handle(ReadRequest& req);
+    seastar::future<> _handle(MultiReadRequest& req);
+    seastar::future<> _handle(ScanReadCreateRequest& req);
+    seastar::future<> _handle(ScanReadRequest& req);
+    seastar::future<> _handle(WriteRequest& req);
+    seastar::future<> _handle(UpdateRequest& req);
+    seastar::future<> _handle(OpRequest& req);
+    seastar::future<> _handle(OneShotOpRequest& req);
+    seastar::future<> _handle(CollectionCreateRequest& req);
+    seastar::future<> _handle(CollectionDropRequest& req);
+
+    // tracks requests which are being processed so that we can wait for them on shutdown
+    seastar::gate _inFlight;
+    // seastar-side handle for the request channel doorbell
+    std::unique_ptr<seastar::pollable_fd> _doorbellFd;
+    uint64_t _doorbellCount{0};
+    // number of consecutive empty polls. We only park after a few of these to avoid paying for the doorbell
+    // when requests arrive back-to-back
+    uint32_t _idlePolls{0};
+    static constexpr uint32_t IDLE_POLLS_BEFORE_PARK = 64;
+
+    // the PG-side metrics, exported as seastar metrics so that they are pushed along with the K2 app's own
+    seastar::metrics::metric_groups _metricGroups;
+    uint64_t _metricsGeneration{0};
+    // export the metrics again if new ones or new series were created since the last export
+    void _exportMetrics();
 
     bool _stop = false;
 };
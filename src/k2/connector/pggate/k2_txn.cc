@@ -35,12 +35,40 @@ K23SITxn::K23SITxn(k2::dto::K23SI_MTR mtr, k2::TimePoint startTime):_mtr(std::mo
     session::in_flight_txns->observe(_inFlightTxns);
 }
 
+K23SITxn::K23SITxn(CBFuture<K23SITxn>&& begin):_begin(std::make_shared<CBFuture<K23SITxn>>(std::move(begin))) {
+    K2LOG_D(log::k2Client, "starting txn with begin in flight");
+}
+
 K23SITxn::~K23SITxn() {
     K2LOG_D(log::k2Client, "dtor for txn {} started at {}", _mtr, _startTime);
 }
 
+void K23SITxn::_awaitBegin() {
+    if (!_begin) {
+        return;
+    }
+    auto begin = std::move(_begin);
+    K23SITxn txn = begin->get();
+    _mtr = std::move(txn._mtr);
+    _startTime = txn._startTime;
+    K2LOG_D(log::k2Client, "txn {} begun at time: {}", _mtr, _startTime);
+}
+
 CBFuture<EndResult> K23SITxn::endTxn(bool shouldCommit) {
+    _awaitBegin();
     EndTxnRequest qr{.mtr=_mtr, .shouldCommit = shouldCommit, .prom={}};
+    if (_writeOps == 0) {
+        // Nothing was written, so there is nothing to commit or abort in K2 and the end doesn't go over the
+        // network. The seastar thread still has to release its handle but we don't need to wait for it
+        K2LOG_D(log::k2Client, "ending txn {} with no writes locally", _mtr);
+        _inFlightTxns--;
+        _reportEndMetrics(Clock::now());
+        pushQ(std::move(qr));
+        std::promise<EndResult> prom;
+        prom.set_value(EndResult(dto::K23SIStatus::OK("")));
+        return CBFuture<EndResult>(prom.get_future(), [] {});
+    }
+
     _inFlightOps ++;
     session::in_flight_ops->observe(_inFlightOps);
     auto result = CBFuture<EndResult>(qr.prom.get_future(), [this, st=_startTime, endRequestTime=Clock::now()] {
@@ -55,12 +83,13 @@ CBFuture<EndResult> K23SITxn::endTxn(bool shouldCommit) {
     });
 
     K2LOG_D(log::k2Client, "endtxn: {}", qr.mtr);
-    pushQ(endTxQ, std::move(qr));
+    pushQ(std::move(qr));
     return result;
 }
 
 
 CBFuture<k2::QueryResult> K23SITxn::scanRead(std::shared_ptr<k2::Query> query) {
+    _awaitBegin();
     _scanOps++;
     ScanReadRequest sr {.mtr = _mtr, .query=query, .prom={}};
 
@@ -72,11 +101,12 @@ CBFuture<k2::QueryResult> K23SITxn::scanRead(std::shared_ptr<k2::Query> query) {
     });
 
     K2LOG_D(log::k2Client, "scanread: mtr={}, query={}", sr.mtr, (*query));
-    pushQ(scanReadTxQ, std::move(sr));
+    pushQ(std::move(sr));
     return result;
 }
 
 CBFuture<ReadResult<dto::SKVRecord>> K23SITxn::read(dto::SKVRecord&& rec) {
+    _awaitBegin();
     _readOps++;
     ReadRequest qr {.mtr = _mtr, .record=std::move(rec), .key=k2::dto::Key(), .collectionName="", .prom={}};
 
@@ -94,11 +124,12 @@ CBFuture<ReadResult<dto::SKVRecord>> K23SITxn::read(dto::SKVRecord&& rec) {
             qr.record.schema->version,
             qr.record.getPartitionKey(),
             qr.record.getRangeKey());
-    pushQ(readTxQ, std::move(qr));
+    pushQ(std::move(qr));
     return result;
 }
 
 CBFuture<k2::ReadResult<k2::dto::SKVRecord>> K23SITxn::read(k2::dto::Key key, std::string collectionName) {
+    _awaitBegin();
     _readOps++;
     ReadRequest qr {.mtr = _mtr, .record=k2::dto::SKVRecord(), .key=std::move(key),
                     .collectionName=std::move(collectionName), .prom={}};
@@ -115,11 +146,29 @@ CBFuture<k2::ReadResult<k2::dto::SKVRecord>> K23SITxn::read(k2::dto::Key key, st
                 qr.collectionName,
                 qr.key.partitionKey,
                 qr.key.rangeKey);
-    pushQ(readTxQ, std::move(qr));
+    pushQ(std::move(qr));
+    return result;
+}
+
+CBFuture<std::vector<ReadResult<dto::SKVRecord>>> K23SITxn::multiRead(std::vector<dto::SKVRecord>&& recs) {
+    _awaitBegin();
+    _readOps += recs.size();
+    MultiReadRequest qr {.mtr = _mtr, .records=std::move(recs), .prom={}};
+
+    _inFlightOps++;
+    session::in_flight_ops->observe(_inFlightOps);
+    auto result = CBFuture<std::vector<ReadResult<dto::SKVRecord>>>(qr.prom.get_future(), [this, st = Clock::now()] {
+        _inFlightOps--;
+        session::read_op_latency->observe(Clock::now() - st);
+    });
+
+    K2LOG_D(log::k2Client, "multi read: mtr={}, records={}", qr.mtr, qr.records.size());
+    pushQ(std::move(qr));
     return result;
 }
 
 CBFuture<WriteResult> K23SITxn::write(dto::SKVRecord&& rec, bool erase, k2::dto::ExistencePrecondition precondition) {
+    _awaitBegin();
     _writeOps++;
     WriteRequest qr{.mtr = _mtr, .erase=erase, .precondition=precondition, .record=std::move(rec), .prom={}};
 
@@ -141,13 +190,14 @@ CBFuture<WriteResult> K23SITxn::write(dto::SKVRecord&& rec, bool erase, k2::dto:
         qr.record.getPartitionKey(),
         qr.record.getRangeKey());
 
-    pushQ(writeTxQ, std::move(qr));
+    pushQ(std::move(qr));
     return result;
 }
 
 CBFuture<PartialUpdateResult> K23SITxn::partialUpdate(dto::SKVRecord&& rec,
                                                          std::vector<uint32_t> fieldsForUpdate,
                                                          std::string partitionKey) {
+    _awaitBegin();
     _writeOps++;
     k2::dto::Key key{};
     if (!partitionKey.empty()) {
@@ -173,11 +223,38 @@ CBFuture<PartialUpdateResult> K23SITxn::partialUpdate(dto::SKVRecord&& rec,
         qr.key.partitionKey,
         qr.key.rangeKey,
         qr.fieldsForUpdate);
-    pushQ(updateTxQ, std::move(qr));
+    pushQ(std::move(qr));
+    return result;
+}
+
+CBFuture<k2pg::Status> K23SITxn::runOp(OpTask&& task, const OpCounts& counts) {
+    _awaitBegin();
+    _readOps += counts.reads;
+    _writeOps += counts.writes;
+    _scanOps += counts.scans;
+    OpRequest qr{.mtr = _mtr, .task = std::move(task), .prom = {}};
+
+    _inFlightOps++;
+    session::in_flight_ops->observe(_inFlightOps);
+    auto result = CBFuture<k2pg::Status>(qr.prom.get_future(), [this, counts, st = Clock::now()] {
+        _inFlightOps--;
+        auto latency = Clock::now() - st;
+        if (counts.scans > 0) {
+            session::scan_op_latency->observe(latency);
+        } else if (counts.writes > 0) {
+            session::write_op_latency->observe(latency);
+        } else {
+            session::read_op_latency->observe(latency);
+        }
+    });
+
+    K2LOG_D(log::k2Client, "op: mtr={}, reads={}, writes={}, scans={}", qr.mtr, counts.reads, counts.writes, counts.scans);
+    pushQ(std::move(qr));
     return result;
 }
 
-const k2::dto::K23SI_MTR& K23SITxn::mtr() const {
+const k2::dto::K23SI_MTR& K23SITxn::mtr() {
+    _awaitBegin();
     return _mtr;
 }
 
@@ -28,6 +28,9 @@ Copyright(c) 2020 Futurewei Cloud
 //
 
 #pragma once
+#include <functional>
+
+#include "common/status.h"
 #include "k2_includes.h"
 #include "k2_log.h"
 #include "k2_future.h"
@@ -35,6 +38,18 @@ Copyright(c) 2020 Futurewei Cloud
 namespace k2pg {
 namespace gate {
 
+// A SQL operation which runs entirely on the seastar thread as a chain of continuations: building the SKV requests,
+// the K2 calls and the handling of their results. The task is given the native client and the native handle of the
+// transaction, which are only valid on the seastar thread, and the operation is complete when the returned future is.
+using OpTask = std::function<seastar::future<k2pg::Status>(k2::K23SIClient& client, k2::K2TxnHandle& txn)>;
+
+// The number of K2 operations of each kind an OpTask performs. Only used for the transaction metrics
+struct OpCounts {
+    uint32_t reads = 0;
+    uint32_t writes = 0;
+    uint32_t scans = 0;
+};
+
 // These transaction handles are produced by the K23SIGate class. The user should use this
 // handle to perform operation which should be part of the transaction
 // all APIs are semantically the same as defined in
@@ -44,6 +59,10 @@ public:
     // Ctor: creates a new transaction with the given mtr.
     K23SITxn(k2::dto::K23SI_MTR mtr, k2::TimePoint startTime);
 
+    // Ctor: creates a new transaction whose begin is still in flight. The begin is only waited for when the
+    // transaction is first used, so that it overlaps with the preparation of the first operation.
+    explicit K23SITxn(CBFuture<K23SITxn>&& begin);
+
     ~K23SITxn();
 private:
     friend class K2Adapter;
@@ -60,6 +79,11 @@ private:
     CBFuture<k2::ReadResult<k2::dto::SKVRecord>> read(k2::dto::SKVRecord&& rec);
     CBFuture<k2::ReadResult<k2::dto::SKVRecord>> read(k2::dto::Key key, std::string collectionName);
 
+    // Reads a batch of records from K2 with a single request to the seastar thread.
+    // The result future is eventually satisfied with the results of the reads, in the same order as the records.
+    // Uncaught exceptions may also be propagated and show up as exceptional futures here.
+    CBFuture<std::vector<k2::ReadResult<k2::dto::SKVRecord>>> multiRead(std::vector<k2::dto::SKVRecord>&& recs);
+
     // Writes a record (full) into K2. The erase flag is used if this write should delete
     // the record from K2.
     // The result future is eventually satisfied with the result of the write
@@ -76,7 +100,13 @@ private:
                                                        std::vector<uint32_t> fieldsForUpdate,
                                                        std::string key="");
 
+    // Runs the given task on the seastar thread within this transaction (see OpTask).
+    // The result future is eventually satisfied with the status returned by the task.
+    // Uncaught exceptions may also be propagated and show up as exceptional futures here.
+    CBFuture<k2pg::Status> runOp(OpTask&& task, const OpCounts& counts);
+
     // Ends the transaction. The transaction can be either committed or aborted.
+    // A transaction which didn't write anything is ended locally, without waiting for K2.
     // The result future is eventually satisfied with the result of the end operation
     // Uncaught exceptions may also be propagated and show up as exceptional futures here.
     CBFuture<k2::EndResult> endTxn(bool shouldCommit);
@@ -84,12 +114,18 @@ private:
     // Returns the MTR for this transaction. This is unique for each transaction and
     // can be useful to keep track of transactions or to log
     // The MTR will be unique in spacetime
-    const k2::dto::K23SI_MTR& mtr() const;
+    const k2::dto::K23SI_MTR& mtr();
 
  // fields
     k2::dto::K23SI_MTR _mtr; // mtr for this transaction
     void _reportEndMetrics(k2::TimePoint now);
 
+    // waits for the begin of the transaction if it is still in flight
+    void _awaitBegin();
+
+    // the in flight begin, if any. Shared so that the txn handle stays copyable
+    std::shared_ptr<CBFuture<K23SITxn>> _begin;
+
     // the time at which SQL asked to start this txn
     k2::TimePoint _startTime;
 
@@ -218,6 +218,23 @@ Status PgDropTable::Exec() {
   return s;
 }
 
+//--------------------------------------------------------------------------------------------------
+// PgTruncateTable
+//--------------------------------------------------------------------------------------------------
+
+PgTruncateTable::PgTruncateTable(std::shared_ptr<PgSession> pg_session,
+                                 const PgObjectId& table_object_id)
+    : PgDdl(pg_session),
+      table_object_id_(table_object_id) {
+}
+
+PgTruncateTable::~PgTruncateTable() {
+}
+
+Status PgTruncateTable::Exec() {
+  return pg_session_->TruncateTable(table_object_id_);
+}
+
 //--------------------------------------------------------------------------------------------------
 // PgAlterTable
 //--------------------------------------------------------------------------------------------------
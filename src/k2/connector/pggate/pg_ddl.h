@@ -212,6 +212,25 @@ class PgDropTable: public PgDdl {
   bool if_exist_;
 };
 
+//--------------------------------------------------------------------------------------------------
+// TRUNCATE TABLE
+//--------------------------------------------------------------------------------------------------
+
+class PgTruncateTable: public PgDdl {
+ public:
+  // Constructors.
+  PgTruncateTable(std::shared_ptr<PgSession> pg_session, const PgObjectId& table_object_id);
+  virtual ~PgTruncateTable();
+
+  StmtOp stmt_op() const override { return StmtOp::STMT_TRUNCATE_TABLE; }
+
+  // Execute.
+  CHECKED_STATUS Exec();
+
+ protected:
+  const PgObjectId table_object_id_;
+};
+
 //--------------------------------------------------------------------------------------------------
 // ALTER TABLE
 //--------------------------------------------------------------------------------------------------
@@ -93,6 +93,20 @@ Status PgDml::AppendTargetVar(PgExpr *target) {
   // Append to targets_.
   targets_.push_back(target);
 
+  if (target->is_aggregate()) {
+    // Pushed down aggregates are computed by K2Adapter from the scanned rows, it only needs their argument columns
+    for (PgExpr *arg : static_cast<PgOperator *>(target)->getArgs()) {
+      if (arg->is_colref()) {
+        PgColumnRef *arg_ref = static_cast<PgColumnRef *>(arg);
+        PgColumn *col = VERIFY_RESULT(target_desc_->FindColumn(arg_ref->attr_num()));
+        arg_ref->set_attr_name(col->attr_name());
+        RETURN_NOT_OK(PrepareColumnForRead(arg_ref->attr_num(), nullptr));
+      }
+    }
+    GetTargets().push_back(target);
+    return Status::OK();
+  }
+
   if (!target->is_colref()) {
       return STATUS(InternalError, "Unexpected expression, only column refs supported in SKV");
   }
@@ -336,7 +350,7 @@ Result<bool> PgDml::GetNextRow(PgTuple *pg_tuple) {
     if (rowset.NextRowOrder() <= current_row_order_) {
       // Write row to postgres tuple.
       int64_t row_order = -1;
-      RETURN_NOT_OK(rowset.WritePgTuple(targets_, targets_by_name_, pg_tuple, &row_order));
+      RETURN_NOT_OK(rowset.WritePgTuple(targets_, targets_by_name_, &tuple_decoder_, pg_tuple, &row_order));
       SCHECK(row_order == -1 || row_order == current_row_order_, InternalError,
              "The resulting row are not arranged in indexing order");
 
@@ -411,6 +425,9 @@ Status PgDml::PrepareExpression(PgExpr *target, std::shared_ptr<BindVariable> ex
     // TODO: add aggregation function support once SKV supports that
     if (target->is_logic_expr()) {
       expr_var->expr = target;
+    } else if (target->is_assign_expr()) {
+      RETURN_NOT_OK(PrepareAssignExpression(target));
+      expr_var->expr = target;
     }
   }
   K2LOG_V(log::pg, "Finished PrepareExpression target:{} var expr {}", (*target), (*expr_var));
@@ -418,5 +435,21 @@ Status PgDml::PrepareExpression(PgExpr *target, std::shared_ptr<BindVariable> ex
   return Status::OK();
 }
 
+Status PgDml::PrepareAssignExpression(PgExpr *expr) {
+  if (expr->is_colref()) {
+    PgColumnRef *col_ref = static_cast<PgColumnRef *>(expr);
+    PgColumn *col = VERIFY_RESULT(target_desc_->FindColumn(col_ref->attr_num()));
+    col_ref->set_attr_name(col->attr_name());
+  } else if (expr->is_assign_expr()) {
+    for (PgExpr *arg : static_cast<PgOperator *>(expr)->getArgs()) {
+      RETURN_NOT_OK(PrepareAssignExpression(arg));
+    }
+  } else if (!expr->is_constant()) {
+    return STATUS_FORMAT(InvalidArgument, "Unsupported expression in UPDATE assignment: {}", expr->opcode());
+  }
+
+  return Status::OK();
+}
+
 }  // namespace gate
 }  // namespace k2pg
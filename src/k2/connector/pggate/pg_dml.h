@@ -162,6 +162,9 @@ class PgDml : public PgStatement {
   // set up binding variable based on PgExpr
   CHECKED_STATUS PrepareExpression(PgExpr *target, std::shared_ptr<BindVariable> expr_var);
 
+  // resolve the column names referenced by an UPDATE assignment expression, e.g. SET col = col + 1
+  CHECKED_STATUS PrepareAssignExpression(PgExpr *expr);
+
   // -----------------------------------------------------------------------------------------------
   // Data members that define the DML statement.
 
@@ -196,6 +199,8 @@ class PgDml : public PgStatement {
   std::vector<PgExpr *> targets_;
   // helper map over the above vector, maps targets by their attribute names.
   std::unordered_map<string, PgExpr*> targets_by_name_;
+  // decodes the SKV records read for the targets, compiled from the above map on the first row
+  PgTupleDecoder tuple_decoder_;
 
   // bind_desc_ is the descriptor of the table whose key columns' values will be specified by the
   // the DML statement being executed.
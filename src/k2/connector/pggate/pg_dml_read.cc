@@ -227,7 +227,45 @@ Status PgDmlRead::BindColumnCondIn(int attr_num, int n_attr_values, PgExpr **att
   DCHECK(attr_num != static_cast<int>(PgSystemAttrNum::kPgTupleId))
     << "Operator IN cannot be applied to ROWID";
 
-  throw std::logic_error("K2 does not support set operator yet");
+  // Find column.
+  PgColumn *col = VERIFY_RESULT(bind_desc_->FindColumn(attr_num));
+
+  if (n_attr_values <= 0) {
+    return Status::OK();
+  }
+
+  const K2PgTypeEntity *bool_type = K2PgFindTypeEntity(BOOL_TYPE_OID);
+  PgOperator *top_expr;
+  if (col->is_primary()) {
+    // bind to range_conds, PgReadOp splits the scan into one sub-scan per listed key when it can
+    if (read_req_->range_conds == NULL) {
+      std::unique_ptr<PgExpr> range_expr = std::make_unique<PgOperator>("and", bool_type);
+      read_req_->range_conds = range_expr.get();
+      AddExpr(std::move(range_expr));
+    }
+    top_expr = static_cast<PgOperator *>(read_req_->range_conds);
+  } else {
+    // bind to where_conds
+    if (read_req_->where_conds == NULL) {
+      std::unique_ptr<PgExpr> where_expr = std::make_unique<PgOperator>("and", bool_type);
+      read_req_->where_conds = where_expr.get();
+      AddExpr(std::move(where_expr));
+    }
+    top_expr = static_cast<PgOperator *>(read_req_->where_conds);
+  }
+
+  std::unique_ptr<PgOperator> in_opr = std::make_unique<PgOperator>("in", bool_type);
+  std::unique_ptr<PgColumnRef> col_ref = std::make_unique<PgColumnRef>(attr_num, attr_values[0]->type_entity(), attr_values[0]->type_attrs());
+  col_ref->set_attr_name(col->attr_name());
+  in_opr->AppendArg(col_ref.get());
+  for (int i = 0; i < n_attr_values; i++) {
+    in_opr->AppendArg(attr_values[i]);
+  }
+  top_expr->AppendArg(in_opr.get());
+  AddExpr(std::move(col_ref));
+  AddExpr(std::move(in_opr));
+
+  return Status::OK();
 }
 
 Status PgDmlRead::PopulateAttrName(PgExpr *pg_expr) {
@@ -274,6 +312,8 @@ Status PgDmlRead::BindWhereConds(PgExpr *where_conds) {
 }
 
 Status PgDmlRead::Exec(const PgExecParameters *exec_params) {
+  read_req_->is_aggregate = has_aggregate_targets();
+
   // Initialize sql operator.
   if (sql_op_) {
     sql_op_->ExecuteInit(exec_params);
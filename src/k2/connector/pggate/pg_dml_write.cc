@@ -88,7 +88,7 @@ void PgDmlWrite::PrepareColumns() {
   }
 }
 
-Status PgDmlWrite::Exec() {
+Status PgDmlWrite::Exec(bool force_non_bufferable) {
   // Delete allocated binds that are not associated with a value.
   RETURN_NOT_OK(DeleteEmptyPrimaryBinds());
 
@@ -105,6 +105,13 @@ Status PgDmlWrite::Exec() {
   // Initialize sql operator.
   sql_op_->ExecuteInit(nullptr);
 
+  // Buffer the write if possible. Catalog changes are never buffered since the catalog version is bumped
+  // right after them.
+  if (!force_non_bufferable && !psql_catalog_change_ && stmt_op() != StmtOp::STMT_TRUNCATE &&
+      VERIFY_RESULT(static_cast<PgWriteOp*>(sql_op_.get())->ExecuteBuffered(shared_from_this()))) {
+    return Status::OK();
+  }
+
   // Execute the statement. If the request has been sent, get the result and handle any rows
   // returned.
   if (VERIFY_RESULT(sql_op_->Execute()) == true) {
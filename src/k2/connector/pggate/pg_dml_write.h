@@ -68,7 +68,9 @@ class PgDmlWrite : public PgDml {
   // Setup internal structures for binding values during prepare.
   void PrepareColumns();
 
-  CHECKED_STATUS Exec();
+  // Execute the write. Unless force_non_bufferable is set, a write whose result isn't needed right away may be
+  // buffered in the session and flushed later in a batch with other writes.
+  CHECKED_STATUS Exec(bool force_non_bufferable = false);
 
   void SetIsSystemCatalogChange() {
       psql_catalog_change_ = true;
@@ -396,12 +396,13 @@ K2PgStatus PgGate_NewTruncateTable(K2PgOid database_oid,
                                 K2PgOid table_oid,
                                 K2PgStatement *handle){
   K2LOG_V(log::pg, "PgGateAPI: PgGate_NewTruncateTable {}, {}", database_oid, table_oid);
-  return K2PgStatusOK();
+  const PgObjectId table_object_id(database_oid, table_oid);
+  return ToK2PgStatus(api_impl->NewTruncateTable(table_object_id, handle));
 }
 
 K2PgStatus PgGate_ExecTruncateTable(K2PgStatement handle){
   K2LOG_V(log::pg, "PgGateAPI: PgGate_ExecTruncateTable");
-  return K2PgStatusOK();
+  return ToK2PgStatus(api_impl->ExecTruncateTable(handle));
 }
 
 K2PgStatus PgGate_GetTableDesc(K2PgOid database_oid,
@@ -538,6 +539,16 @@ K2PgStatus PgGate_AsyncUpdateIndexPermissions(
   return ToK2PgStatus(api_impl->AsyncUpdateIndexPermissions(indexed_table_object_id));
 }
 
+K2PgStatus PgGate_BackfillIndex(const K2PgOid database_oid,
+                                const K2PgOid table_oid,
+                                const K2PgOid index_oid,
+                                uint64_t *indexed_rows) {
+  K2LOG_V(log::pg, "PgGateAPI: PgGate_BackfillIndex {}, {}, {}", database_oid, table_oid, index_oid);
+  const PgObjectId table_object_id(database_oid, table_oid);
+  const PgObjectId index_object_id(database_oid, index_oid);
+  return ToK2PgStatus(api_impl->BackfillIndex(table_object_id, index_object_id, indexed_rows));
+}
+
 //--------------------------------------------------------------------------------------------------
 // DML statements (select, insert, update, delete, truncate)
 //--------------------------------------------------------------------------------------------------
@@ -671,6 +682,17 @@ K2PgStatus PgGate_InsertStmtSetWriteTime(K2PgStatement handle, const uint64_t wr
   return ToK2PgStatus(api_impl->InsertStmtSetWriteTime(handle, write_time));
 }
 
+K2PgStatus PgGate_InsertRow(K2PgOid database_oid,
+                            K2PgOid table_oid,
+                            const K2PgAttrValueDescriptor *attrs,
+                            int32_t nattrs,
+                            bool upsert,
+                            uint64_t *k2pgctid){
+  K2LOG_V(log::pg, "PgGateAPI: PgGate_InsertRow {}, {}, {}", database_oid, table_oid, nattrs);
+  const PgObjectId table_object_id(database_oid, table_oid);
+  return ToK2PgStatus(api_impl->InsertRow(table_object_id, attrs, nattrs, upsert, k2pgctid));
+}
+
 // UPDATE ------------------------------------------------------------------------------------------
 K2PgStatus PgGate_NewUpdate(K2PgOid database_oid,
                          K2PgOid table_oid,
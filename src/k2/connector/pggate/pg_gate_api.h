@@ -256,6 +256,13 @@ K2PgStatus PgGate_AsyncUpdateIndexPermissions(
     const K2PgOid database_oid,
     const K2PgOid indexed_table_oid);
 
+// Fill the new index of a populated table from the table rows in storage, as part of the current transaction.
+// Only for indexes on plain columns, i.e. with no expressions and no predicate.
+K2PgStatus PgGate_BackfillIndex(const K2PgOid database_oid,
+                                const K2PgOid table_oid,
+                                const K2PgOid index_oid,
+                                uint64_t *indexed_rows);
+
 //--------------------------------------------------------------------------------------------------
 // DML statements (select, insert, update, delete, truncate)
 //--------------------------------------------------------------------------------------------------
@@ -337,6 +344,16 @@ K2PgStatus PgGate_InsertStmtSetUpsertMode(K2PgStatement handle);
 
 K2PgStatus PgGate_InsertStmtSetWriteTime(K2PgStatement handle, const uint64_t write_time);
 
+// Insert (or upsert) a row given by its attribute values without creating a statement, e.g. for COPY and index
+// entries. The row may be buffered, so that a failure can be reported by a later call. Sets the k2pgctid of the row
+// if k2pgctid is not NULL.
+K2PgStatus PgGate_InsertRow(K2PgOid database_oid,
+                            K2PgOid table_oid,
+                            const K2PgAttrValueDescriptor *attrs,
+                            int32_t nattrs,
+                            bool upsert,
+                            uint64_t *k2pgctid);
+
 // UPDATE ------------------------------------------------------------------------------------------
 K2PgStatus PgGate_NewUpdate(K2PgOid database_oid,
                          K2PgOid table_oid,
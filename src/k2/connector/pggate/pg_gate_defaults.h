@@ -40,11 +40,19 @@ namespace gate {
 
     static const uint64_t default_psql_request_limit = 1;
 
-    static const uint64_t default_psql_select_parallelism = 1;
+    // Max number of concurrent sub-scans a single unordered scan can be split into
+    static const uint64_t default_psql_select_parallelism = 4;
+
+    // Max number of sub-scans an IN list on the key columns is expanded into, see PgReadOp::SplitScanByKeyInList()
+    static const uint64_t default_psql_max_key_in_list_scans = 1024;
 
     static const double default_psql_backward_prefetch_scale_factor = 0.25;
 
-    static const int default_session_max_batch_size = 1;
+    // Max number of writes a session buffers before flushing them to SKV in one batch
+    static const int default_session_max_batch_size = 512;
+
+    // Max number of batches of buffered writes a session keeps in flight before it waits for the oldest one
+    static const int default_session_max_inflight_batches = 4;
 
 }  // namespace gate
 }  // namespace k2pg
@@ -431,6 +431,21 @@ Status PgGateApiImpl::ExecDropTable(PgStatement *handle) {
   return dynamic_cast<PgDropTable*>(handle)->Exec();
 }
 
+Status PgGateApiImpl::NewTruncateTable(const PgObjectId& table_object_id,
+                                       PgStatement **handle) {
+  auto stmt = std::make_shared<PgTruncateTable>(pg_session_, table_object_id);
+  RETURN_NOT_OK(AddToCurrentMemctx(stmt, handle));
+  return Status::OK();
+}
+
+Status PgGateApiImpl::ExecTruncateTable(PgStatement *handle) {
+  if (!PgStatement::IsValidStmt(handle, StmtOp::STMT_TRUNCATE_TABLE)) {
+    // Invalid handle.
+    return STATUS(InvalidArgument, "Invalid statement handle");
+  }
+  return dynamic_cast<PgTruncateTable*>(handle)->Exec();
+}
+
 Status PgGateApiImpl::GetTableDesc(const PgObjectId& table_object_id,
                                PgTableDesc **handle) {
   // First read from memory context.
@@ -582,6 +597,10 @@ Status PgGateApiImpl::AsyncUpdateIndexPermissions(const PgObjectId& indexed_tabl
   return pg_session_->AsyncUpdateIndexPermissions(indexed_table_object_id);
 }
 
+Status PgGateApiImpl::BackfillIndex(const PgObjectId& table_object_id, const PgObjectId& index_object_id, uint64_t* indexed_rows) {
+  return pg_session_->BackfillIndex(table_object_id, index_object_id, indexed_rows);
+}
+
 // Sequence -----------------------------------------------------------------------------------------
 
 Status PgGateApiImpl::CreateSequencesDataTable() {
@@ -694,7 +713,8 @@ Status PgGateApiImpl::DmlExecWriteOp(PgStatement *handle, int32_t *rows_affected
     case StmtOp::STMT_TRUNCATE:
       {
         auto dml_write = dynamic_cast<PgDmlWrite *>(handle);
-        RETURN_NOT_OK(dml_write->Exec());
+        // the write can't be buffered if the caller needs the number of affected rows
+        RETURN_NOT_OK(dml_write->Exec(rows_affected_count != nullptr));
         if (rows_affected_count) {
           *rows_affected_count = dml_write->GetRowsAffectedCount();
         }
@@ -903,6 +923,18 @@ Status PgGateApiImpl::InsertStmtSetWriteTime(PgStatement *handle, const uint64_t
   return Status::OK();
 }
 
+Status PgGateApiImpl::InsertRow(const PgObjectId& table_object_id, const PgAttrValueDescriptor *attrs, int32_t nattrs,
+                                bool upsert, uint64_t *k2pgctid) {
+  if (k2pgctid == nullptr) {
+    return pg_session_->BufferInsertRow(table_object_id, attrs, nattrs, upsert, nullptr /* row_id */);
+  }
+  std::string id;
+  RETURN_NOT_OK(pg_session_->BufferInsertRow(table_object_id, attrs, nattrs, upsert, &id));
+  const K2PgTypeEntity *type_entity = FindTypeEntity(kPgByteArrayOid);
+  *k2pgctid = type_entity->k2pg_to_datum(id.data(), id.size(), nullptr /* type_attrs */);
+  return Status::OK();
+}
+
 // Update ------------------------------------------------------------------------------------------
 
 Status PgGateApiImpl::NewUpdate(const PgObjectId& table_object_id,
@@ -945,21 +977,25 @@ Status PgGateApiImpl::ExecDelete(PgStatement *handle) {
 
 Status PgGateApiImpl::BeginTransaction() {
   pg_session_->InvalidateForeignKeyReferenceCache();
+  pg_session_->DropBufferedOperations();
   return pg_txn_handler_->BeginTransaction();
 }
 
 Status PgGateApiImpl::RestartTransaction() {
   pg_session_->InvalidateForeignKeyReferenceCache();
+  pg_session_->DropBufferedOperations();
   return pg_txn_handler_->RestartTransaction();
 }
 
 Status PgGateApiImpl::CommitTransaction() {
   pg_session_->InvalidateForeignKeyReferenceCache();
+  RETURN_NOT_OK(pg_session_->FlushBufferedOperations());
   return pg_txn_handler_->CommitTransaction();
 }
 
 Status PgGateApiImpl::AbortTransaction() {
   pg_session_->InvalidateForeignKeyReferenceCache();
+  pg_session_->DropBufferedOperations();
   return pg_txn_handler_->AbortTransaction();
 }
 
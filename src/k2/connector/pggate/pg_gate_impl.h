@@ -213,6 +213,11 @@ class PgGateApiImpl {
 
   CHECKED_STATUS ExecDropTable(PgStatement *handle);
 
+  CHECKED_STATUS NewTruncateTable(const PgObjectId& table_object_id,
+                                  PgStatement **handle);
+
+  CHECKED_STATUS ExecTruncateTable(PgStatement *handle);
+
   CHECKED_STATUS GetTableDesc(const PgObjectId& table_object_id,
                               PgTableDesc **handle);
 
@@ -260,6 +265,8 @@ class PgGateApiImpl {
 
   CHECKED_STATUS AsyncUpdateIndexPermissions(const PgObjectId& indexed_table_object_id);
 
+  CHECKED_STATUS BackfillIndex(const PgObjectId& table_object_id, const PgObjectId& index_object_id, uint64_t* indexed_rows);
+
   // Sequence Operations -----------------------------------------------------------------------------
 
   // Setup the table to store sequences data.
@@ -374,6 +381,9 @@ class PgGateApiImpl {
 
   CHECKED_STATUS InsertStmtSetWriteTime(PgStatement *handle, const uint64_t write_time);
 
+  CHECKED_STATUS InsertRow(const PgObjectId& table_object_id, const PgAttrValueDescriptor *attrs, int32_t nattrs,
+                           bool upsert, uint64_t *k2pgctid);
+
   //------------------------------------------------------------------------------------------------
   // Update.
   CHECKED_STATUS NewUpdate(const PgObjectId& table_object_id,
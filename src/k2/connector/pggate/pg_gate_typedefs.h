@@ -191,10 +191,14 @@ typedef struct PgExecParameters {
   int rowmark = -1;
   uint64_t read_time = 0;
   char *partition_key = NULL;
+  // Set when the caller doesn't rely on rows coming back in key order. The scan may then be split
+  // into several sub-scans which run concurrently.
+  bool allow_unordered = false;
 #else
   int rowmark;
   uint64_t read_time;
   char *partition_key;
+  bool allow_unordered;
 #endif
 } K2PgExecParameters;
 
@@ -208,6 +212,7 @@ typedef struct PgAttrValueDescriptor {
 typedef struct PgCallbacks {
   void (*FetchUniqueConstraintName)(K2PgOid, char*, size_t);
   K2PgMemctx (*GetCurrentYbMemctx)();
+  const char* (*GetDebugQueryString)();
 } K2PgCallbacks;
 
 typedef struct PgTableProperties {
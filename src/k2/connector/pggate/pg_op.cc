@@ -46,7 +46,10 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 //
 
+#include <algorithm>
 #include <boost/algorithm/string.hpp>
+#include <limits>
+#include <optional>
 
 #include "common/type/decimal.h"
 #include "common/k2pg-internal.h"
@@ -220,44 +223,99 @@ Status TranslateSysCol<k2::String>(int attr_num, std::optional<k2::String> field
 }
 
 template<typename T>
-void FieldParser(std::optional<T> field, const k2::String& fieldName, const std::unordered_map<std::string, PgExpr*>& targets_by_name, PgTuple* pg_tuple, Status& result, int32_t* num) {
-    auto iter = targets_by_name.find(fieldName.c_str());
-    if (iter == targets_by_name.end()) {
-        if (k2pg::sql::catalog::CatalogConsts::TABLE_ID_COLUMN_NAME == fieldName.c_str() ||
-            k2pg::sql::catalog::CatalogConsts::INDEX_ID_COLUMN_NAME == fieldName.c_str()) {
-        }
-        else {
-            K2LOG_D(log::pg, "Encountered field {}, without target reference", fieldName);
-        }
-        result = Status::OK();
-        return;
+Status DecodeSysField(k2::dto::SKVRecord& record, const PgTupleDecoder::FieldStep& step, PgTuple* pg_tuple) {
+    record.seekField(step.skv_index);
+    std::optional<T> field = record.deserializeNext<T>();
+    if (!field) {
+        return STATUS(InternalError, "Null system column encountered");
     }
-    if (!iter->second->is_colref()) {
-        result= STATUS(InternalError, "Unexpected expression, only column refs supported in SKV");
-        return;
+    return TranslateSysCol(step.attr_num, std::move(field), pg_tuple);
+}
+
+template<typename T>
+Status DecodeUserField(k2::dto::SKVRecord& record, const PgTupleDecoder::FieldStep& step, PgTuple* pg_tuple) {
+    record.seekField(step.skv_index);
+    std::optional<T> field = record.deserializeNext<T>();
+    if (!field) {
+        pg_tuple->WriteNull(step.attr_num - 1);
+        return Status::OK();
     }
-    const PgColumnRef* target = (PgColumnRef*)iter->second;
-    int attr_num = target->attr_num();
+    return TranslateUserCol(step.attr_num - 1, step.type_entity, step.type_attrs, std::move(field), pg_tuple);
+}
 
-    if (attr_num < 0) {
-        if (!field) {
-            result= STATUS(InternalError, "Null system column encountered");
-            return;
+template<typename T>
+PgTupleDecoder::DecodeFn DecodeFieldFn(int attr_num) {
+    return attr_num < 0 ? &DecodeSysField<T> : &DecodeUserField<T>;
+}
+
+Status PgTupleDecoder::Compile(const std::unordered_map<std::string, PgExpr*>& targets_by_name,
+                               std::shared_ptr<k2::dto::Schema> schema) {
+    K2ASSERT(log::pg, targets_by_name.size() > 0, "targets should not be empty");
+    schema_ = nullptr;
+    steps_.clear();
+
+    for (uint32_t i = 0; i < schema->fields.size(); ++i) {
+        const k2::dto::SchemaField& field = schema->fields[i];
+        auto iter = targets_by_name.find(field.name.c_str());
+        if (iter == targets_by_name.end()) {
+            if (k2pg::sql::catalog::CatalogConsts::TABLE_ID_COLUMN_NAME != field.name.c_str() &&
+                k2pg::sql::catalog::CatalogConsts::INDEX_ID_COLUMN_NAME != field.name.c_str()) {
+                K2LOG_D(log::pg, "Encountered field {}, without target reference", field.name);
+            }
+            continue;
         }
-        result = TranslateSysCol(attr_num, std::move(field), pg_tuple);
-    }
-    else {
-        if (!field) {
-            pg_tuple->WriteNull(attr_num-1);
-            result = Status::OK();
+        if (!iter->second->is_colref()) {
+            return STATUS(InternalError, "Unexpected expression, only column refs supported in SKV");
         }
-        else {
-            result = TranslateUserCol(attr_num-1, target->type_entity(), target->type_attrs(), std::move(field), pg_tuple);
+
+        const PgColumnRef* target = (PgColumnRef*)iter->second;
+        FieldStep step{i, target->attr_num(), target->type_entity(), target->type_attrs(), nullptr};
+        switch (field.type) {
+            case k2::dto::FieldType::STRING:
+                step.decode = DecodeFieldFn<k2::String>(step.attr_num);
+                break;
+            case k2::dto::FieldType::INT16T:
+                step.decode = DecodeFieldFn<int16_t>(step.attr_num);
+                break;
+            case k2::dto::FieldType::INT32T:
+                step.decode = DecodeFieldFn<int32_t>(step.attr_num);
+                break;
+            case k2::dto::FieldType::INT64T:
+                step.decode = DecodeFieldFn<int64_t>(step.attr_num);
+                break;
+            case k2::dto::FieldType::FLOAT:
+                step.decode = DecodeFieldFn<float>(step.attr_num);
+                break;
+            case k2::dto::FieldType::DOUBLE:
+                step.decode = DecodeFieldFn<double>(step.attr_num);
+                break;
+            case k2::dto::FieldType::BOOL:
+                step.decode = DecodeFieldFn<bool>(step.attr_num);
+                break;
+            default:
+                K2LOG_E(log::pg, "Unsupported SKV type of field {}", field.name);
+                return STATUS(InternalError, "unsupported SKV field type");
         }
+        steps_.push_back(step);
     }
-    (*num)++;
-    K2LOG_V(log::pg, "Parsed field {}, num: {} in targets_by_name map with size: {}",
-            fieldName, (*num), targets_by_name.size());
+
+    // k2pgctid is a virtual column and won't be in the SKV record
+    size_t num = steps_.size() + (targets_by_name.find("k2pgctid") != targets_by_name.end() ? 1 : 0);
+    if (num != targets_by_name.size()) {
+        return STATUS_FORMAT(InternalError, "All target columns should be in the SKV schema: {} != {}",
+                             num, targets_by_name.size());
+    }
+
+    schema_ = std::move(schema);
+    K2LOG_V(log::pg, "Compiled tuple decoder of {} fields for schema {}", steps_.size(), schema_->name);
+    return Status::OK();
+}
+
+Status PgTupleDecoder::Decode(k2::dto::SKVRecord& record, PgTuple* pg_tuple) const {
+    for (const FieldStep& step : steps_) {
+        RETURN_NOT_OK(step.decode(record, step, pg_tuple));
+    }
+    return Status::OK();
 }
 
 PgOpResult::PgOpResult(std::vector<k2::dto::SKVRecord>&& data) : data_(std::move(data)) {
@@ -269,6 +327,10 @@ PgOpResult::PgOpResult(std::vector<k2::dto::SKVRecord>&& data, std::list<int64_t
     ProcessSystemColumns();
 }
 
+PgOpResult::PgOpResult(std::vector<SqlOpAggregatePartial>&& aggregates): aggregates_(std::move(aggregates)) {
+    syscol_processed_ = true;
+}
+
 PgOpResult::~PgOpResult() {
 }
 
@@ -277,17 +339,31 @@ int64_t PgOpResult::NextRowOrder() {
 }
 
 // Get the postgres tuple from this batch.
-Status PgOpResult::WritePgTuple(const std::vector<PgExpr *> &targets, const std::unordered_map<std::string, PgExpr*>& targets_by_name, PgTuple *pg_tuple, int64_t *row_order) {
+Status PgOpResult::WritePgTuple(const std::vector<PgExpr *> &targets, const std::unordered_map<std::string, PgExpr*>& targets_by_name,
+                                PgTupleDecoder *decoder, PgTuple *pg_tuple, int64_t *row_order) {
     Status result;
-    K2ASSERT(log::pg, targets_by_name.size() > 0, "targets should not be empty");
+    if (aggregates_) {
+        K2ASSERT(log::pg, targets.size() == aggregates_->size(), "Every aggregate target needs a result");
+        for (size_t i = 0; i < targets.size(); ++i) {
+            const SqlOpAggregatePartial& agg = (*aggregates_)[i];
+            if (!agg.has_value) {
+                pg_tuple->WriteNull(i);
+            } else if (agg.is_float) {
+                RETURN_NOT_OK(TranslateUserCol(i, targets[i]->type_entity(), targets[i]->type_attrs(), std::optional<double>(agg.float_val), pg_tuple));
+            } else {
+                RETURN_NOT_OK(TranslateUserCol(i, targets[i]->type_entity(), targets[i]->type_attrs(), std::optional<int64_t>(agg.int_val), pg_tuple));
+            }
+        }
+        *row_order = -1;
+        ++nextToConsume_;
+        return result;
+    }
     K2ASSERT(log::pg, syscol_processed_, "System columns have not been processed yet");
-    int32_t num = 0;
-    FOR_EACH_RECORD_FIELD(data_[nextToConsume_], FieldParser, targets_by_name, pg_tuple, result, &num);
-     if (targets_by_name.find("k2pgctid") != targets_by_name.end()) {
-        // k2pgctid is a virtual column and won't be in the SKV record
-        num++;
+    k2::dto::SKVRecord& record = data_[nextToConsume_];
+    if (!decoder->IsCompiledFor(record.schema)) {
+        RETURN_NOT_OK(decoder->Compile(targets_by_name, record.schema));
     }
-    K2ASSERT(log::pg, num == targets_by_name.size(), "All target columns should be processed: {} != {}", num, targets_by_name.size());
+    RETURN_NOT_OK(decoder->Decode(record, pg_tuple));
 
     if (pg_tuple->syscols()) {
         auto& k2pgctid_str = k2pgctid_strings_[nextToConsume_];
@@ -377,7 +453,14 @@ Status PgOp::GetResult(std::list<PgOpResult> *rowsets) {
     // If the execution has error, return without reading any rows.
     RETURN_NOT_OK(exec_status_);
 
-    if (!end_of_data_) {
+    if (end_of_data_) {
+        K2LOG_D(log::pg, "Done, GetResult end_of_data_: {}", end_of_data_);
+    }
+
+    // An empty result means the end of the data to our caller, so keep reading past pages which don't
+    // produce any rows, e.g. pages folded into the partial results of pushed down aggregates.
+    bool has_rows = false;
+    while (!end_of_data_ && !has_rows) {
         // Send request now in case prefetching was suppressed.
         if (suppress_next_result_prefetching_ && !requestAsyncRunResult_.valid()) {
             K2LOG_D(log::pg, "suppress_next_result_prefetching_: {} send request...", suppress_next_result_prefetching_);
@@ -387,10 +470,8 @@ Status PgOp::GetResult(std::list<PgOpResult> *rowsets) {
 
         DCHECK(requestAsyncRunResult_.valid());
         auto rows = VERIFY_RESULT(ProcessResponse(requestAsyncRunResult_.get()));
-        // In case ProcessResponse doesn't fail with an error
-        // it should return non empty rows and/or set end_of_data_.
-        DCHECK(!rows.empty() || end_of_data_);
         K2LOG_D(log::pg, "GetResult rows: {}, end_of_data_: {}", rows.size(), end_of_data_);
+        has_rows = !rows.empty();
         rowsets->splice(rowsets->end(), rows);
         // Prefetch next portion of data if needed.
         if (!(end_of_data_ || suppress_next_result_prefetching_)) {
@@ -400,8 +481,6 @@ Status PgOp::GetResult(std::list<PgOpResult> *rowsets) {
             exec_status_ = SendRequest();
             RETURN_NOT_OK(exec_status_);
         }
-    } else {
-        K2LOG_D(log::pg, "Done, GetResult end_of_data_: {}", end_of_data_);
     }
 
     return Status::OK();
@@ -432,31 +511,26 @@ Status PgOp::ClonePgsqlOps(int op_count) {
 }
 
 void PgOp::MoveInactiveOpsOutside() {
-    // Move inactive op to the end.
+    // Move inactive op to the end. The active ops keep their relative order, since the sub-scans of an
+    // ordered scan are sent in key order
     const int total_op_count = pgsql_ops_.size();
     bool has_sorting_order = !batch_row_orders_.empty();
-    int left_iter = 0;
-    int right_iter = total_op_count - 1;
-    while (true) {
-        // Advance left iterator.
-        while (left_iter < total_op_count && pgsql_ops_[left_iter]->is_active()) left_iter++;
-
-        // Advance right iterator.
-        while (right_iter >= 0 && !pgsql_ops_[right_iter]->is_active()) right_iter--;
-
-        // Move inactive operator to the end by swapping the pointers.
-        if (left_iter < right_iter) {
-        std::swap(pgsql_ops_[left_iter], pgsql_ops_[right_iter]);
-        if (has_sorting_order) {
-            std::swap(batch_row_orders_[left_iter], batch_row_orders_[right_iter]);
+    int active_count = 0;
+    for (int op_index = 0; op_index < total_op_count; op_index++) {
+        if (!pgsql_ops_[op_index]->is_active()) {
+            continue;
         }
-        } else {
-            break;
+        if (op_index != active_count) {
+            std::swap(pgsql_ops_[active_count], pgsql_ops_[op_index]);
+            if (has_sorting_order) {
+                std::swap(batch_row_orders_[active_count], batch_row_orders_[op_index]);
+            }
         }
+        active_count++;
     }
 
     // Set active op count.
-    active_op_count_ = left_iter;
+    active_op_count_ = active_count;
 }
 
 Status PgOp::SendRequest() {
@@ -495,8 +569,11 @@ Result<std::list<PgOpResult>> PgOp::ProcessResponse(const Status& status) {
 Result<std::list<PgOpResult>> PgOp::ProcessResponseResult() {
     K2LOG_D(log::pg, "Received response for request");
 
+    // Only the first "parallelism_level_" active ops were sent, the others are still waiting for their turn
+    int32_t send_count = std::min(parallelism_level_, active_op_count_);
+
     // Check for errors reported by storage server.
-    for (int op_index = 0; op_index < active_op_count_; op_index++) {
+    for (int op_index = 0; op_index < send_count; op_index++) {
         RETURN_NOT_OK(pg_session_->HandleResponse(*pgsql_ops_[op_index], PgObjectId()));
     }
 
@@ -505,7 +582,7 @@ Result<std::list<PgOpResult>> PgOp::ProcessResponseResult() {
     bool no_sorting_order = batch_row_orders_.size() == 0;
 
     rows_affected_count_ = 0;
-    for (int op_index = 0; op_index < active_op_count_; op_index++) {
+    for (int op_index = 0; op_index < send_count; op_index++) {
         PgOpTemplate *pgsql_op = pgsql_ops_[op_index].get();
         // Get total number of rows that are operated on.
         rows_affected_count_ += pgsql_op->response().rows_affected_count;
@@ -539,6 +616,7 @@ void PgReadOp::ExecuteInit(const PgExecParameters *exec_params) {
     PgOp::ExecuteInit(exec_params);
 
     template_op_->set_return_paging_state(true);
+    aggregate_results_.clear();
     SetRequestTotalLimit();
     SetRowMark();
     SetReadTime();
@@ -551,20 +629,54 @@ void PgReadOp::SetReadTime() {
 Result<std::list<PgOpResult>> PgReadOp::ProcessResponseImpl() {
     // Process result from storage server and check result status.
     auto result = VERIFY_RESULT(ProcessResponseResult());
+    const bool is_aggregate = template_op_->request()->is_aggregate;
+    if (is_aggregate) {
+        CombineAggregates();
+    }
 
     // Process paging state and check status.
     RETURN_NOT_OK(ProcessResponsePagingState());
+    if (is_aggregate && end_of_data_) {
+        // all sub-scans are done, hand over the one row with the final partial results
+        result.emplace_back(std::move(aggregate_results_));
+        aggregate_results_.clear();
+    }
     K2LOG_D(log::pg, "ProcessResponseImpl for ReadOp with result size: {}", result.size());
     return result;
 }
 
+void PgReadOp::CombineAggregates() {
+    const std::vector<PgExpr *>& targets = template_op_->request()->targets;
+    if (aggregate_results_.empty()) {
+        for (PgExpr* target : targets) {
+            aggregate_results_.push_back(SqlOpAggregatePartial::Initial(target->opcode()));
+        }
+    }
+    int32_t send_count = std::min(parallelism_level_, active_op_count_);
+    for (int op_index = 0; op_index < send_count; op_index++) {
+        std::vector<SqlOpAggregatePartial> partials = GetReadOp(op_index)->aggregates();
+        for (size_t i = 0; i < partials.size() && i < aggregate_results_.size(); ++i) {
+            aggregate_results_[i].Combine(targets[i]->opcode(), partials[i]);
+        }
+    }
+}
+
 Status PgReadOp::CreateRequests() {
     if (request_population_completed_) {
         return Status::OK();
     }
 
+    if (VERIFY_RESULT(SplitScanByKeyInList())) {
+        request_population_completed_ = true;
+        return Status::OK();
+    }
+
+    if (VERIFY_RESULT(SplitScanByKeyRange())) {
+        request_population_completed_ = true;
+        return Status::OK();
+    }
+
     // No optimization.
-    // TODO: create separate requests for different partitions once SKV partition information is available
     pgsql_ops_.push_back(template_op_);
     template_op_->set_active(true);
     active_op_count_ = 1;
@@ -572,6 +684,237 @@ Status PgReadOp::CreateRequests() {
     return Status::OK();
 }
 
+Result<bool> PgReadOp::SplitScanByKeyRange() {
+    // SKV doesn't expose the collection partition map to us, so we split on the values of the leading key
+    // column instead. This needs both an upper and a lower bound on that column.
+    std::shared_ptr<SqlOpReadRequest> req = template_op_->request();
+    const int32_t parallelism = pg_session_->GetScanParallelism();
+    if (parallelism <= 1 || !exec_params_.allow_unordered || !exec_params_.limit_use_default ||
+        !req->k2pgctid_column_values.empty() ||
+        req->range_conds == nullptr || req->range_conds->opcode() != PgExpr::Opcode::PG_EXPR_AND ||
+        table_desc_->num_key_columns() == 0) {
+        return false;
+    }
+
+    const std::string& key_name = table_desc_->columns()[0].attr_name();
+    PgColumnRef* key_ref = nullptr;
+    const K2PgTypeEntity* key_type = nullptr;
+    std::optional<int64_t> lower;
+    std::optional<int64_t> upper;
+    std::vector<PgExpr*> other_conds;
+    for (PgExpr* cond : static_cast<PgOperator*>(req->range_conds)->getArgs()) {
+        auto& args = static_cast<PgOperator*>(cond)->getArgs();
+        if (!args[0]->is_colref() || static_cast<PgColumnRef*>(args[0])->attr_name() != key_name) {
+            other_conds.push_back(cond);
+            continue;
+        }
+        for (size_t i = 1; i < args.size(); ++i) {
+            if (!args[i]->is_constant() || !static_cast<PgConstant*>(args[i])->getValue()->IsInteger()) {
+                return false;
+            }
+        }
+        key_ref = static_cast<PgColumnRef*>(args[0]);
+        key_type = args[1]->type_entity();
+        int64_t v1 = static_cast<PgConstant*>(args[1])->getValue()->data_.int_val_;
+        switch (cond->opcode()) {
+            case PgExpr::Opcode::PG_EXPR_GE:
+                lower = lower ? std::max(*lower, v1) : v1;
+                break;
+            case PgExpr::Opcode::PG_EXPR_GT:
+                if (v1 == std::numeric_limits<int64_t>::max()) return false;
+                lower = lower ? std::max(*lower, v1 + 1) : v1 + 1;
+                break;
+            case PgExpr::Opcode::PG_EXPR_LE:
+                upper = upper ? std::min(*upper, v1) : v1;
+                break;
+            case PgExpr::Opcode::PG_EXPR_LT:
+                if (v1 == std::numeric_limits<int64_t>::min()) return false;
+                upper = upper ? std::min(*upper, v1 - 1) : v1 - 1;
+                break;
+            case PgExpr::Opcode::PG_EXPR_BETWEEN: {
+                int64_t v2 = static_cast<PgConstant*>(args[2])->getValue()->data_.int_val_;
+                lower = lower ? std::max(*lower, std::min(v1, v2)) : std::min(v1, v2);
+                upper = upper ? std::min(*upper, std::max(v1, v2)) : std::max(v1, v2);
+            } break;
+            default:
+                // equality or an unknown condition on the leading key column: nothing to split
+                return false;
+        }
+    }
+    if (!lower || !upper || *lower > *upper) {
+        return false;
+    }
+
+    // don't bother with sub-scans narrower than a prefetch batch
+    const __int128 width = (__int128)*upper - *lower + 1;
+    const int64_t op_count = (int64_t)std::min<__int128>(parallelism, width / default_psql_prefetch_limit);
+    if (op_count <= 1) {
+        return false;
+    }
+    const int64_t step = (int64_t)(width / op_count);
+
+    RETURN_NOT_OK(ClonePgsqlOps(op_count));
+    const K2PgTypeEntity *bool_type = K2PgFindTypeEntity(BOOL_TYPE_OID);
+    int64_t sub_lower = *lower;
+    for (int64_t idx = 0; idx < op_count; ++idx) {
+        int64_t sub_upper = (idx == op_count - 1) ? *upper : sub_lower + step - 1;
+
+        auto and_opr = std::make_unique<PgOperator>("and", bool_type);
+        for (PgExpr* cond : other_conds) {
+            and_opr->AppendArg(cond);
+        }
+        auto lower_const = std::make_unique<PgConstant>(key_type, SqlValue(sub_lower));
+        auto upper_const = std::make_unique<PgConstant>(key_type, SqlValue(sub_upper));
+        auto ge_opr = std::make_unique<PgOperator>(">=", bool_type);
+        ge_opr->AppendArg(key_ref);
+        ge_opr->AppendArg(lower_const.get());
+        and_opr->AppendArg(ge_opr.get());
+        auto le_opr = std::make_unique<PgOperator>("<=", bool_type);
+        le_opr->AppendArg(key_ref);
+        le_opr->AppendArg(upper_const.get());
+        and_opr->AppendArg(le_opr.get());
+
+        PgReadOpTemplate *read_op = GetReadOp(idx);
+        read_op->request()->range_conds = and_opr.get();
+        read_op->set_active(true);
+
+        AddExpr(std::move(lower_const));
+        AddExpr(std::move(upper_const));
+        AddExpr(std::move(ge_opr));
+        AddExpr(std::move(le_opr));
+        AddExpr(std::move(and_opr));
+        sub_lower = sub_upper + 1;
+    }
+    active_op_count_ = op_count;
+    K2LOG_D(log::pg, "Split scan on table {} into {} sub-scans over key {} in [{}, {}]",
+            req->table_id, op_count, key_name, *lower, *upper);
+    return true;
+}
+
+Result<bool> PgReadOp::SplitScanByKeyInList() {
+    // SKV has neither a multi-get nor a multi-range scan, so a list of keys is read with one sub-scan per key.
+    // The sub-scans which bind the whole key are run as point reads by K2Adapter
+    std::shared_ptr<SqlOpReadRequest> req = template_op_->request();
+    const size_t num_key_columns = table_desc_->num_key_columns();
+    if (!req->k2pgctid_column_values.empty() ||
+        req->range_conds == nullptr || req->range_conds->opcode() != PgExpr::Opcode::PG_EXPR_AND ||
+        num_key_columns == 0) {
+        return false;
+    }
+
+    // the first "=" or "in" condition on each key column with values we can sort, everything else stays a condition
+    // of every sub-scan
+    std::vector<PgExpr*> key_conds(num_key_columns, nullptr);
+    std::vector<std::vector<PgExpr*>> key_values(num_key_columns);
+    std::vector<PgExpr*> other_conds;
+    for (PgExpr* cond : static_cast<PgOperator*>(req->range_conds)->getArgs()) {
+        auto& args = static_cast<PgOperator*>(cond)->getArgs();
+        size_t idx = num_key_columns;
+        if ((cond->opcode() == PgExpr::Opcode::PG_EXPR_EQ || cond->opcode() == PgExpr::Opcode::PG_EXPR_IN) &&
+            args.size() > 1 && args[0]->is_colref()) {
+            const std::string& name = static_cast<PgColumnRef*>(args[0])->attr_name();
+            idx = 0;
+            while (idx < num_key_columns && table_desc_->columns()[idx].attr_name() != name) {
+                idx++;
+            }
+        }
+        bool usable = idx < num_key_columns && key_conds[idx] == nullptr;
+        for (size_t i = 1; usable && i < args.size(); ++i) {
+            if (!args[i]->is_constant()) {
+                usable = false;
+                break;
+            }
+            // floating point keys are left out because of -0.0 and NaN
+            const SqlValue* value = static_cast<PgConstant*>(args[i])->getValue();
+            usable = !value->IsNull() && value->type_ == static_cast<PgConstant*>(args[1])->getValue()->type_ &&
+                (value->type_ == SqlValue::ValueType::INT || value->type_ == SqlValue::ValueType::BOOL ||
+                 value->type_ == SqlValue::ValueType::SLICE);
+        }
+        if (!usable) {
+            other_conds.push_back(cond);
+            continue;
+        }
+        key_conds[idx] = cond;
+        key_values[idx].assign(args.begin() + 1, args.end());
+    }
+
+    // sort and dedupe the values of the longest prefix of bound key columns, in the order of the key
+    auto value_of = [](PgExpr* expr) { return static_cast<PgConstant*>(expr)->getValue(); };
+    size_t prefix = 0;
+    uint64_t op_count = 1;
+    bool has_in_list = false;
+    for (; prefix < num_key_columns && key_conds[prefix] != nullptr; ++prefix) {
+        std::vector<PgExpr*>& values = key_values[prefix];
+        const ColumnSchema::SortingType sorting_type = table_desc_->columns()[prefix].desc()->sorting_type();
+        const bool descending = sorting_type == ColumnSchema::SortingType::kDescending ||
+            sorting_type == ColumnSchema::SortingType::kDescendingNullsLast;
+        std::sort(values.begin(), values.end(), [&](PgExpr* lhs, PgExpr* rhs) {
+            int cmp = value_of(lhs)->Compare(*value_of(rhs));
+            return descending ? cmp > 0 : cmp < 0;
+        });
+        values.erase(std::unique(values.begin(), values.end(), [&](PgExpr* lhs, PgExpr* rhs) {
+            return value_of(lhs)->Compare(*value_of(rhs)) == 0;
+        }), values.end());
+        if (op_count * values.size() > default_psql_max_key_in_list_scans) {
+            break;
+        }
+        op_count *= values.size();
+        has_in_list |= key_conds[prefix]->opcode() == PgExpr::Opcode::PG_EXPR_IN;
+    }
+    if (!has_in_list) {
+        // a single sub-scan, K2Adapter handles it as a plain range scan
+        return false;
+    }
+    for (size_t idx = prefix; idx < num_key_columns; ++idx) {
+        if (key_conds[idx] != nullptr) {
+            other_conds.push_back(key_conds[idx]);
+        }
+    }
+
+    RETURN_NOT_OK(ClonePgsqlOps(static_cast<int>(op_count)));
+    const K2PgTypeEntity *bool_type = K2PgFindTypeEntity(BOOL_TYPE_OID);
+    // the combination of values of the current sub-scan, as indexes into key_values, advanced like an odometer
+    std::vector<size_t> positions(prefix, 0);
+    for (uint64_t op_index = 0; op_index < op_count; ++op_index) {
+        auto and_opr = std::make_unique<PgOperator>("and", bool_type);
+        for (PgExpr* cond : other_conds) {
+            and_opr->AppendArg(cond);
+        }
+        for (size_t idx = 0; idx < prefix; ++idx) {
+            auto eq_opr = std::make_unique<PgOperator>("=", bool_type);
+            eq_opr->AppendArg(static_cast<PgOperator*>(key_conds[idx])->getArgs()[0]);
+            eq_opr->AppendArg(key_values[idx][positions[idx]]);
+            and_opr->AppendArg(eq_opr.get());
+            AddExpr(std::move(eq_opr));
+        }
+
+        // a backward scan reads the keys in reverse order
+        PgReadOpTemplate *read_op = GetReadOp(req->is_forward_scan ? op_index : op_count - 1 - op_index);
+        read_op->request()->range_conds = and_opr.get();
+        read_op->set_active(true);
+        AddExpr(std::move(and_opr));
+
+        for (size_t idx = prefix; idx-- > 0;) {
+            if (++positions[idx] < key_values[idx].size()) {
+                break;
+            }
+            positions[idx] = 0;
+        }
+    }
+    active_op_count_ = static_cast<int32_t>(op_count);
+
+    // Point reads return at most one row each, so they can all run at once without breaking the key order.
+    // Sub-scans on a key prefix may return several pages each, so they run one after the other unless the
+    // order does not matter
+    const bool point_reads = prefix == num_key_columns && other_conds.empty();
+    if (!point_reads && !exec_params_.allow_unordered) {
+        parallelism_level_ = 1;
+    }
+    K2LOG_D(log::pg, "Split scan on table {} into {} sub-scans over the IN lists on {} key columns, parallelism {}",
+            req->table_id, op_count, prefix, parallelism_level_);
+    return true;
+}
+
 Status PgReadOp::InitializeRowIdOperators() {
     // we only support one partition for now
     // keep this logic so that we could support multiple partitions in the future
@@ -769,6 +1112,19 @@ Status PgWriteOp::CreateRequests() {
     return Status::OK();
 }
 
+Result<bool> PgWriteOp::ExecuteBuffered(std::shared_ptr<PgStatement> owner) {
+    if (!pg_session_->ShouldBufferOperation(*write_op_)) {
+        return false;
+    }
+
+    RETURN_NOT_OK(CreateRequests());
+    RETURN_NOT_OK(pg_session_->BufferOperation(write_op_, relation_id_, std::move(owner)));
+    // the result of a buffered write is not waited for, its errors are reported when the session flushes it
+    rows_affected_count_ = 1;
+    end_of_data_ = true;
+    return true;
+}
+
 void PgWriteOp::SetWriteTime(const uint64_t write_time) {
     write_time_ = write_time;
 }
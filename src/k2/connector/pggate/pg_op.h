@@ -76,12 +76,50 @@ using k2pg::Status;
 using k2pg::Slice;
 using k2pg::sql::PgObjectId;
 
+//--------------------------------------------------------------------------------------------------
+// PgTupleDecoder writes the fields of SKV records into the slots of a PG tuple. It is compiled once
+// per statement and SKV schema from the statement's targets, into one step per SKV field to decode,
+// so that a row is decoded without looking up targets by field name or switching on field types.
+class PgTupleDecoder {
+public:
+    // Whether the decoder has been compiled for the records of the given schema
+    bool IsCompiledFor(const std::shared_ptr<k2::dto::Schema>& schema) const {
+        return schema_ != nullptr && schema_ == schema;
+    }
+
+    // Compile the decoder for the records of the given schema, which must hold every target column
+    CHECKED_STATUS Compile(const std::unordered_map<std::string, PgExpr*>& targets_by_name,
+                           std::shared_ptr<k2::dto::Schema> schema);
+
+    // Decode a record of the schema the decoder has been compiled for
+    CHECKED_STATUS Decode(k2::dto::SKVRecord& record, PgTuple* pg_tuple) const;
+
+    struct FieldStep;
+    using DecodeFn = Status (*)(k2::dto::SKVRecord& record, const FieldStep& step, PgTuple* pg_tuple);
+
+    // Decodes SKV field skv_index into the attribute attr_num of the tuple
+    struct FieldStep {
+        uint32_t skv_index;
+        int attr_num;
+        const K2PgTypeEntity* type_entity;
+        const PgTypeAttrs* type_attrs;
+        DecodeFn decode;
+    };
+
+private:
+    std::shared_ptr<k2::dto::Schema> schema_;
+    // in the order of the SKV fields
+    std::vector<FieldStep> steps_;
+};
+
 //--------------------------------------------------------------------------------------------------
 // PgOpResult represents a batch of rows in ONE reply from storage layer.
 class PgOpResult {
 public:
     explicit PgOpResult(std::vector<k2::dto::SKVRecord>&& data);
     PgOpResult(std::vector<k2::dto::SKVRecord> &&data, std::list<int64_t> &&row_orders);
+    // A single row holding the results of pushed down aggregates, one per target
+    explicit PgOpResult(std::vector<SqlOpAggregatePartial>&& aggregates);
     ~PgOpResult();
 
     // Get the order of the next row in this batch.
@@ -89,13 +127,15 @@ public:
 
     // End of this batch.
     bool is_eof() const {
-        return nextToConsume_ >= data_.size();
+        return nextToConsume_ >= (aggregates_ ? 1 : data_.size());
     }
 
-    // Get the postgres tuple from this batch.
+    // Get the postgres tuple from this batch. The decoder is (re)compiled from the targets when it
+    // hasn't been compiled for the schema of the rows yet.
     CHECKED_STATUS
     WritePgTuple(const std::vector<PgExpr *>& targets,
                  const std::unordered_map<std::string, PgExpr*>& targets_by_name,
+                 PgTupleDecoder *decoder,
                  PgTuple *pg_tuple,
                  int64_t *row_order);
 
@@ -119,6 +159,9 @@ private:
     // TODO: refactor this based on SKV payload
     std::vector<k2::dto::SKVRecord> data_;
 
+    // Set instead of data_ for the results of pushed down aggregates
+    std::optional<std::vector<SqlOpAggregatePartial>> aggregates_;
+
     // The indexing order of the row in this batch.
     // These order values help to identify the row order across all batches
     // the size is based on the returning data and thus a list instead of an array is used
@@ -291,6 +334,17 @@ private:
     // initialize op by partitions
     CHECKED_STATUS InitializeRowIdOperators();
 
+    // Split a scan which is bounded on the leading key column into concurrent sub-scans over disjoint
+    // key ranges. Returns false if the scan is not eligible for splitting.
+    Result<bool> SplitScanByKeyRange();
+
+    // Expand IN lists and equality conditions on a prefix of the key columns into one sub-scan per listed key,
+    // in key order. Returns false if there is no IN list on the key or the scan is not eligible.
+    Result<bool> SplitScanByKeyInList();
+
+    // Merge the per-page partial results of pushed down aggregates from all active ops
+    void CombineAggregates();
+
     CHECKED_STATUS PopulateDmlByRowIdOps(const std::vector<std::string>& k2pgctids) override;
 
     // Analyze options and pick the appropriate prefetch limit.
@@ -319,6 +373,9 @@ private:
 
     // Template operation, used to fill in pgsql_ops_ by either assigning or cloning.
     std::shared_ptr<PgReadOpTemplate> template_op_;
+
+    // Results of pushed down aggregates combined over all pages and sub-scans so far
+    std::vector<SqlOpAggregatePartial> aggregate_results_;
 };
 
 //--------------------------------------------------------------------------------------------------
@@ -337,6 +394,10 @@ public:
     // Set write time.
     void SetWriteTime(const uint64_t write_time);
 
+    // Buffer the write in the session instead of sending it, if the session can buffer it. Returns false if
+    // the write has to be executed right away. The owner is kept alive by the session until the write is flushed.
+    Result<bool> ExecuteBuffered(std::shared_ptr<PgStatement> owner);
+
 private:
     // Process response implementation.
     Result<std::list<PgOpResult>> ProcessResponseImpl() override;
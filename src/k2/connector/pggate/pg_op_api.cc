@@ -17,8 +17,49 @@
 
 #include "pggate/pg_op_api.h"
 
+#include <algorithm>
+#include <sstream>
+#include <stdexcept>
+
 namespace k2pg {
 namespace gate {
+    SqlOpAggregatePartial SqlOpAggregatePartial::Initial(PgExpr::Opcode opcode) {
+        SqlOpAggregatePartial partial;
+        // the COUNT of no rows is 0, while the others are NULL
+        partial.has_value = (opcode == PgExpr::Opcode::PG_EXPR_COUNT);
+        return partial;
+    }
+
+    void SqlOpAggregatePartial::Combine(PgExpr::Opcode opcode, const SqlOpAggregatePartial& other) {
+        if (!other.has_value) {
+            return;
+        }
+        if (!has_value) {
+            *this = other;
+            return;
+        }
+        switch (opcode) {
+            case PgExpr::Opcode::PG_EXPR_COUNT:
+            case PgExpr::Opcode::PG_EXPR_SUM:
+                int_val += other.int_val;
+                float_val += other.float_val;
+                break;
+            case PgExpr::Opcode::PG_EXPR_MIN:
+                int_val = std::min(int_val, other.int_val);
+                float_val = std::min(float_val, other.float_val);
+                break;
+            case PgExpr::Opcode::PG_EXPR_MAX:
+                int_val = std::max(int_val, other.int_val);
+                float_val = std::max(float_val, other.float_val);
+                break;
+            default: {
+                std::stringstream oss;
+                oss << "Unsupported aggregate " << opcode;
+                throw std::invalid_argument(oss.str());
+            }
+        }
+    }
+
     std::unique_ptr<SqlOpReadRequest> SqlOpReadRequest::clone() {
        std::unique_ptr<SqlOpReadRequest> newRequest = std::make_unique<SqlOpReadRequest>();
        newRequest->client_id = client_id;
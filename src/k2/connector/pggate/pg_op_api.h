@@ -159,9 +159,29 @@ namespace gate {
         // True only if this changes a system catalog table (or index).
         bool is_psql_catalog_change;
 
+        // The whole row, serialized by the caller into the SKV record to write, e.g. for an INSERT without a
+        // statement (see PgSession::BufferInsertRow). The bind variables are not used then.
+        std::shared_ptr<k2::dto::SKVRecord> record;
+
         std::unique_ptr<SqlOpWriteRequest> clone();
     };
 
+    // Partial result of one pushed down aggregate (COUNT, SUM, MIN or MAX) over a subset of the scanned rows,
+    // e.g. one page of one scan. Partials of the same aggregate are merged with Combine()
+    struct SqlOpAggregatePartial {
+        // false means NULL, e.g. SUM/MIN/MAX over no rows. COUNT always has a value
+        bool has_value = false;
+        bool is_float = false;
+        int64_t int_val = 0;
+        double float_val = 0;
+
+        // The initial (empty) partial for the given aggregate
+        static SqlOpAggregatePartial Initial(PgExpr::Opcode opcode);
+
+        // Merge the other partial of the same aggregate into this one
+        void Combine(PgExpr::Opcode opcode, const SqlOpAggregatePartial& other);
+    };
+
     // Response from K2 storage for both read and write.
     struct SqlOpResponse {
           enum class RequestStatus {
@@ -219,8 +239,12 @@ namespace gate {
         // api to get row_data reference and set the value
         std::vector<k2::dto::SKVRecord>* mutable_rows_data() { return &rows_data_; }
 
-        bool IsTransactional() const {
-            // use transaction for all K2 operations
+        // partial results of pushed down aggregates, one per target, in place of rows_data
+        std::vector<SqlOpAggregatePartial>&& aggregates() { return std::move(aggregates_); }
+        std::vector<SqlOpAggregatePartial>* mutable_aggregates() { return &aggregates_; }
+
+        virtual bool IsTransactional() const {
+            // use the session transaction for all K2 operations, except single row writes in autocommit mode
             return true;
         }
 
@@ -243,6 +267,7 @@ namespace gate {
         protected:
         std::unique_ptr<SqlOpResponse> response_;
         std::vector<k2::dto::SKVRecord> rows_data_;
+        std::vector<SqlOpAggregatePartial> aggregates_;
         bool is_active_ = true;
     };
 
@@ -262,7 +287,7 @@ namespace gate {
 
         bool read_only() const override { return false; };
 
-        bool IsTransactional() const;
+        bool IsTransactional() const override;
 
         void set_is_single_row_txn(bool is_single_row_txn) {
             is_single_row_txn_ = is_single_row_txn;
@@ -48,12 +48,17 @@
 
 #include "pggate/pg_op.h"
 #include "pggate/pg_session.h"
+#include "pggate/pg_statement.h"
+#include "pggate/catalog/sql_catalog_defaults.h"
+
+#include "common/pgsql_error.h"
 
 namespace k2pg {
 namespace gate {
 
 using namespace std::chrono;
 using namespace k2pg::sql;
+using k2pg::sql::catalog::CatalogConsts;
 
 RowIdentifier::RowIdentifier(const std::string& table_id, const std::string row_id) :
   table_id_(table_id), row_id_(row_id) {
@@ -87,6 +92,7 @@ PgSession::PgSession(
     : catalog_client_(catalog_client),
       k2_adapter_(k2_adapter),
       pg_txn_handler_(pg_txn_handler),
+      sequence_handler_(std::make_shared<SequenceInfoHandler>(k2_adapter)),
       pg_callbacks_(pg_callbacks),
       client_id_("K2PG") {
     ConnectDatabase(database_name);
@@ -124,10 +130,8 @@ Status PgSession::CreateDatabase(const string& database_name,
 }
 
 Status PgSession::DropDatabase(const string& database_name, PgOid database_oid) {
-  RETURN_NOT_OK(catalog_client_->DeleteDatabase(database_name,
-                                         PgObjectId::GetDatabaseUuid(database_oid)));
-  RETURN_NOT_OK(DeleteDBSequences(database_oid));
-  return Status::OK();
+  // the sequences of the database are deleted with it, see SqlCatalogManager::DeleteDatabase()
+  return catalog_client_->DeleteDatabase(database_name, PgObjectId::GetDatabaseUuid(database_oid));
 }
 
 Status PgSession::RenameDatabase(const std::string& database_name, PgOid database_oid, std::optional<std::string> rename_to) {
@@ -172,6 +176,19 @@ Status PgSession::DropIndex(const PgObjectId& index_object_id, PgOid *base_table
   return catalog_client_->DeleteIndexTable(index_object_id.GetDatabaseOid(), index_object_id.GetObjectOid(), base_table_oid);
 }
 
+Status PgSession::TruncateTable(const PgObjectId& table_object_id) {
+  // the rows written by this transaction so far are truncated as well
+  RETURN_NOT_OK(FlushBufferedOperations());
+
+  std::shared_ptr<PgTableDesc> table = VERIFY_RESULT(LoadTable(table_object_id));
+  uint64_t deleted_rows = 0;
+  RETURN_NOT_OK(k2_adapter_->DeleteAllRows(pg_txn_handler_->GetTxn(), table->collection_name(), table->table_id(),
+                                           table->SchemaVersion(), table->base_table_oid(), table->index_oid(),
+                                           &deleted_rows).get());
+  K2LOG_D(log::pg, "Truncated {} rows of {}", deleted_rows, table_object_id);
+  return Status::OK();
+}
+
 Status PgSession::ReserveOids(const PgOid database_oid,
                               const PgOid next_oid,
                               const uint32_t count,
@@ -188,7 +205,7 @@ Status PgSession::GetCatalogMasterVersion(uint64_t *catalog_version) {
 // Sequence -----------------------------------------------------------------------------------------
 
 Status PgSession::CreateSequencesDataTable() {
-  // TODO: add implementation
+  // the sequence table is created with the primary cluster, see SqlCatalogManager::InitPrimaryCluster()
   return Status::OK();
 }
 
@@ -197,8 +214,7 @@ Status PgSession::InsertSequenceTuple(int64_t db_oid,
                                       uint64_t psql_catalog_version,
                                       int64_t last_val,
                                       bool is_called) {
-  // TODO: add implementation
-  return Status::OK();
+  return sequence_handler_->InsertSequence(db_oid, seq_oid, last_val, is_called);
 }
 
 Status PgSession::UpdateSequenceTuple(int64_t db_oid,
@@ -209,8 +225,8 @@ Status PgSession::UpdateSequenceTuple(int64_t db_oid,
                                       std::optional<int64_t> expected_last_val,
                                       std::optional<bool> expected_is_called,
                                       bool* skipped) {
-  // TODO: add implementation
-  return Status::OK();
+  return sequence_handler_->UpdateSequence(db_oid, seq_oid, last_val, is_called, expected_last_val,
+                                           expected_is_called, skipped);
 }
 
 Status PgSession::ReadSequenceTuple(int64_t db_oid,
@@ -218,18 +234,11 @@ Status PgSession::ReadSequenceTuple(int64_t db_oid,
                                     uint64_t psql_catalog_version,
                                     int64_t *last_val,
                                     bool *is_called) {
-  // TODO: add implementation
-  return Status::OK();
+  return sequence_handler_->ReadSequence(db_oid, seq_oid, last_val, is_called);
 }
 
 Status PgSession::DeleteSequenceTuple(int64_t db_oid, int64_t seq_oid) {
-  // TODO: add implementation
-  return Status::OK();
-}
-
-Status PgSession::DeleteDBSequences(int64_t db_oid) {
-  // TODO: add implementation
-  return Status::OK();
+  return sequence_handler_->DeleteSequence(db_oid, seq_oid);
 }
 
 void PgSession::InvalidateTableCache(const PgObjectId& table_obj_id) {
@@ -243,6 +252,18 @@ Status PgSession::HandleResponse(PgOpTemplate& op, const PgObjectId& relation_id
   }
 
   auto& response = op.response();
+  if (response.status == SqlOpResponse::RequestStatus::PGSQL_STATUS_DUPLICATE_KEY_ERROR &&
+      relation_id.GetObjectOid() != kPgInvalidOid) {
+    // report the violated unique constraint, i.e. the index or the primary key of the relation
+    char constraint_name[0xFF];
+    constraint_name[sizeof(constraint_name) - 1] = 0;
+    pg_callbacks_.FetchUniqueConstraintName(relation_id.GetObjectOid(), constraint_name, sizeof(constraint_name) - 1);
+    return STATUS(AlreadyPresent,
+                  fmt::format("duplicate key value violates unique constraint \"{}\"", constraint_name),
+                  Slice(),
+                  PgsqlError(K2PgErrorCode::K2PG_UNIQUE_VIOLATION));
+  }
+
   if (response.pg_error_code != 0) {
     // TODO: handle pg error code
   }
@@ -266,11 +287,19 @@ Result<CBFuture<Status>> PgSession::RunAsync(const std::shared_ptr<PgOpTemplate>
                                            uint64_t* read_time) {
   DCHECK_GT(ops_count, 0);
 
+  // apply the buffered writes first, so that reads see them and writes to the same rows stay in order
+  RETURN_NOT_OK(FlushBufferedOperations());
+
   if (!ShouldHandleTransactionally(**op)) {
     InvalidateForeignKeyReferenceCache();
   }
 
-  if (ops_count == 1) {
+  if (ops_count == 1 && (*op)->type() == PgOpTemplate::WRITE && !(*op)->IsTransactional()) {
+    // a single row write in autocommit mode, which PG only marks as such when the statement touches a single row
+    // of a table without secondary indexes or triggers. It runs in a transaction of its own, begun and committed
+    // together with the write, instead of the session transaction
+    return k2_adapter_->ExecOneShot(*op);
+  } else if (ops_count == 1) {
     // run a single operation
     return k2_adapter_->Exec(pg_txn_handler_->GetTxn(), *op);
   } else {  // ops_count > 1
@@ -283,6 +312,180 @@ Result<CBFuture<Status>> PgSession::RunAsync(const std::shared_ptr<PgOpTemplate>
   }
 }
 
+bool PgSession::ShouldBufferOperation(const PgWriteOpTemplate& op) const {
+  return k2_adapter_->SessionMaxBatchSize() > 1 && op.IsTransactional() && !PgGate_IsInitDbModeEnvVarSet();
+}
+
+Status PgSession::BufferOperation(const std::shared_ptr<PgWriteOpTemplate>& op,
+                                  const PgObjectId& relation_id,
+                                  std::shared_ptr<PgStatement> owner) {
+  RowIdentifier row(op->request()->table_id, k2_adapter_->GetRowId(op->request()));
+  return BufferOperation(op, relation_id, std::move(owner), std::move(row));
+}
+
+Status PgSession::BufferOperation(const std::shared_ptr<PgWriteOpTemplate>& op,
+                                  const PgObjectId& relation_id,
+                                  std::shared_ptr<PgStatement> owner,
+                                  RowIdentifier row) {
+  if (buffered_keys_.find(row) != buffered_keys_.end()) {
+    K2LOG_D(log::pg, "Row is already written by a buffered operation, flushing {} buffered operations and {} batches",
+        buffered_ops_.size(), inflight_batches_.size());
+    RETURN_NOT_OK(FlushBufferedOperations());
+  }
+
+  const char* statement_text = pg_callbacks_.GetDebugQueryString();
+  if (statement_text == nullptr) {
+    buffering_statement_text_.reset();
+  } else if (buffering_statement_text_ == nullptr || *buffering_statement_text_ != statement_text) {
+    buffering_statement_text_ = std::make_shared<const std::string>(statement_text);
+  }
+
+  buffered_keys_.insert(std::move(row));
+  buffered_ops_.push_back(BufferableOperation{op, relation_id, std::move(owner), buffering_statement_text_});
+  if (buffered_ops_.size() >= static_cast<size_t>(k2_adapter_->SessionMaxBatchSize())) {
+    return SendBufferedOperations();
+  }
+  return Status::OK();
+}
+
+Status PgSession::BufferInsertRow(const PgObjectId& table_object_id, const PgAttrValueDescriptor *attrs, int32_t nattrs,
+                                  bool upsert, std::string* row_id) {
+  std::shared_ptr<PgTableDesc> table = VERIFY_RESULT(LoadTable(table_object_id));
+
+  // the values are referred to by column name, both for the key and for the whole row
+  std::vector<SqlValue> values;
+  values.reserve(nattrs + 1);
+  std::unordered_map<std::string, SqlValue *> row_values;
+  std::unordered_map<std::string, SqlValue *> key_values;
+  auto attrs_end = attrs + nattrs;
+  for (PgColumn& column : table->columns()) {
+    if (column.attr_num() == k2pg::sql::to_underlying(PgSystemAttrNum::kPgRowId)) {
+      // generate new rowid for kPgRowId column when no primary keys are defined
+      values.emplace_back(GenerateNewRowid());
+    } else {
+      auto attr = std::find_if(attrs, attrs_end, [&column] (const PgAttrValueDescriptor& a) {
+        return a.attr_num == column.attr_num();
+      });
+      if (attr == attrs_end) {
+        continue;
+      }
+      values.emplace_back(attr->type_entity, attr->datum, attr->is_null);
+    }
+    row_values[column.desc()->name()] = &values.back();
+    if (column.desc()->is_primary()) {
+      key_values[column.desc()->name()] = &values.back();
+    }
+  }
+
+  std::string k2pgctid = k2_adapter_->GetRowId(table->collection_name(), table->table_id(), table->SchemaVersion(),
+                                                table->base_table_oid(), table->index_oid(), key_values);
+  std::shared_ptr<PgWriteOpTemplate> op = table->NewPgsqlInsert(client_id_, GetNextStmtId());
+  std::shared_ptr<SqlOpWriteRequest> request = op->request();
+  if (upsert) {
+    request->stmt_type = SqlOpWriteRequest::StmtType::PGSQL_UPSERT;
+  }
+  request->record = k2_adapter_->MakeRecord(table->collection_name(), table->table_id(), table->SchemaVersion(),
+                                            table->base_table_oid(), table->index_oid(), row_values);
+  if (row_id != nullptr) {
+    *row_id = k2pgctid;
+  }
+
+  if (ShouldBufferOperation(*op)) {
+    return BufferOperation(op, table_object_id, nullptr, RowIdentifier(request->table_id, std::move(k2pgctid)));
+  }
+  CBFuture<Status> result = VERIFY_RESULT(RunAsync(op, table_object_id, nullptr /* read_time */));
+  Status status = result.get();
+  // report e.g. the violated unique constraint rather than the bare write error
+  Status op_status = HandleResponse(*op, table_object_id);
+  return op_status.ok() ? status : op_status;
+}
+
+Status PgSession::SendBufferedOperations() {
+  if (buffered_ops_.empty()) {
+    return Status::OK();
+  }
+
+  Status status;
+  while (!inflight_batches_.empty() &&
+         inflight_batches_.size() >= static_cast<size_t>(k2_adapter_->SessionMaxInflightBatches())) {
+    status = WaitForInflightBatch();
+    if (!status.ok()) {
+      break;
+    }
+  }
+  if (!status.ok()) {
+    // the transaction is going to be aborted, don't send more writes in it
+    DropBufferedOperations();
+    return status;
+  }
+
+  InflightBatch batch;
+  batch.ops.swap(buffered_ops_);
+  std::vector<std::shared_ptr<PgOpTemplate>> ops;
+  ops.reserve(batch.ops.size());
+  for (const BufferableOperation& buffered : batch.ops) {
+    ops.push_back(buffered.operation);
+  }
+  K2LOG_D(log::pg, "Sending {} buffered operations, {} batches in flight", ops.size(), inflight_batches_.size());
+  // not through RunAsync(), which would wait for the batches in flight first
+  batch.result = k2_adapter_->BatchExec(pg_txn_handler_->GetTxn(), ops);
+  inflight_batches_.push_back(std::move(batch));
+  return Status::OK();
+}
+
+Status PgSession::WaitForInflightBatch() {
+  DCHECK(!inflight_batches_.empty());
+  InflightBatch batch = std::move(inflight_batches_.front());
+  inflight_batches_.pop_front();
+
+  Status status = batch.result.get();
+  if (!status.ok()) {
+    // the error is reported against the operation that failed, e.g. to name the violated unique constraint, and
+    // the statement that issued it, which may have finished several statements ago
+    for (const BufferableOperation& buffered : batch.ops) {
+      if (buffered.operation->succeeded()) {
+        continue;
+      }
+      Status op_status = HandleResponse(*buffered.operation, buffered.relation_id);
+      if (op_status.ok()) {
+        op_status = status;
+      }
+      if (buffered.statement_text != nullptr) {
+        return op_status.CloneAndAppend(fmt::format("issued by statement: {}", *buffered.statement_text));
+      }
+      return op_status;
+    }
+  }
+  return status;
+}
+
+Status PgSession::FlushBufferedOperations() {
+  Status status = SendBufferedOperations();
+  // all the batches are waited for even after an error, since they refer to the buffered operations
+  while (!inflight_batches_.empty()) {
+    Status batch_status = WaitForInflightBatch();
+    if (status.ok()) {
+      status = batch_status;
+    }
+  }
+  buffered_keys_.clear();
+  return status;
+}
+
+void PgSession::DropBufferedOperations() {
+  K2LOG_D(log::pg, "Dropping {} buffered operations and {} batches in flight", buffered_ops_.size(),
+      inflight_batches_.size());
+  buffered_ops_.clear();
+  while (!inflight_batches_.empty()) {
+    // the batch refers to the buffered operations so it still has to finish, its outcome no longer matters
+    Status status = WaitForInflightBatch();
+    if (!status.ok()) {
+      K2LOG_D(log::pg, "Dropped batch failed: {}", status);
+    }
+  }
+  buffered_keys_.clear();
+}
+
 Result<std::shared_ptr<PgTableDesc>> PgSession::LoadTable(const PgObjectId& table_object_id) {
   std::string t_table_uuid = table_object_id.GetTableUuid();
   K2LOG_D(log::pg, "Loading table descriptor for {}, uuid={}", table_object_id, t_table_uuid);
@@ -376,5 +579,40 @@ Status PgSession::AsyncUpdateIndexPermissions(const PgObjectId& indexed_table_ob
   return Status::OK();
 }
 
+Status PgSession::BackfillIndex(const PgObjectId& table_object_id, const PgObjectId& index_object_id, uint64_t* indexed_rows) {
+  // the index is built from the table data in SKV, which must include the writes of this transaction
+  RETURN_NOT_OK(FlushBufferedOperations());
+
+  // the cached table may predate the new index, so load the table again
+  std::shared_ptr<TableInfo> table;
+  RETURN_NOT_OK(catalog_client_->OpenTable(table_object_id.GetDatabaseOid(), table_object_id.GetObjectOid(), &table));
+  table_cache_[table_object_id.GetTableUuid()] = table;
+
+  const auto itr = table->secondary_indexes().find(index_object_id.GetTableId());
+  if (itr == table->secondary_indexes().end()) {
+    return STATUS_FORMAT(NotFound, "Cannot find index {} in database {}", index_object_id.GetTableId(), table->database_id());
+  }
+
+  // the key ranges of the backfill commit on their own, so their rows have to be purged if this transaction aborts
+  std::shared_ptr<SqlCatalogClient> catalog_client = catalog_client_;
+  pg_txn_handler_->AddAbortAction([catalog_client, database_id=table->database_id(), index_info=itr->second] {
+    Status purge_status = catalog_client->PurgeIndexData(database_id, index_info);
+    if (!purge_status.ok()) {
+      K2LOG_W(log::pg, "Failed to purge the rows of index {} after its creation was aborted due to {}", index_info.table_id(), purge_status);
+    }
+  });
+
+  const std::string& collection_name = CatalogConsts::physical_collection(table->database_id(), table->is_shared());
+  Status s = k2_adapter_->BackfillIndex(pg_txn_handler_->GetTxn(), collection_name, table->schema().version(),
+                                        itr->second, indexed_rows);
+  if (s.IsAlreadyPresent()) {
+    return STATUS(AlreadyPresent,
+                  fmt::format("could not create unique index \"{}\"", itr->second.table_name()),
+                  Slice(),
+                  PgsqlError(K2PgErrorCode::K2PG_UNIQUE_VIOLATION));
+  }
+  return s;
+}
+
 }  // namespace gate
 }  // namespace k2pg
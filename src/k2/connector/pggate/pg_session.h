@@ -48,6 +48,7 @@
 
 #pragma once
 
+#include <deque>
 #include <optional>
 #include <unordered_set>
 
@@ -63,6 +64,7 @@
 #include "pggate/pg_op_api.h"
 #include "pggate/pg_gate_api.h"
 #include "pggate/pg_txn_handler.h"
+#include "pggate/catalog/sequence_info_handler.h"
 #include "pggate/catalog/sql_catalog_client.h"
 
 #include "k2_log.h"
@@ -73,10 +75,13 @@ namespace gate {
 using k2pg::sql::IndexPermissions;
 using k2pg::sql::PgObjectId;
 using k2pg::sql::PgOid;
+using k2pg::sql::catalog::SequenceInfoHandler;
 using k2pg::sql::catalog::SqlCatalogClient;
 using k2pg::sql::ObjectIdGenerator;
 using k2pg::Status;
 
+class PgStatement;
+
 // a place holder for a operation that it could be buffered in PG session for batch process
 // normally, read operation is called directly, write operation could be buffered in batch
 struct BufferableOperation {
@@ -84,10 +89,22 @@ struct BufferableOperation {
   // Postgres's relation id. Required to resolve constraint name in case
   // operation will fail with PGSQL_STATUS_DUPLICATE_KEY_ERROR.
   PgObjectId relation_id;
+  // The statement which created the operation. The bind variables of the operation point to expressions
+  // owned by the statement, so it is kept alive until the operation is flushed.
+  std::shared_ptr<PgStatement> owner;
+  // The SQL text of the statement which issued the operation, shared by its operations. Buffered operations
+  // outlive their statement, so a failed one is reported with the statement that issued it.
+  std::shared_ptr<const std::string> statement_text;
 };
 
 typedef std::vector<BufferableOperation> PgsqlOpBuffer;
 
+// a batch of buffered operations which has been sent to SKV and is not waited for yet
+struct InflightBatch {
+  CBFuture<Status> result;
+  PgsqlOpBuffer ops;
+};
+
 struct PgForeignKeyReference {
   uint32_t table_oid;
   std::string k2pgctid;
@@ -145,6 +162,9 @@ class PgSession {
 
   CHECKED_STATUS DropIndex(const PgObjectId& index_object_id, PgOid *base_table_oid, bool wait = true);
 
+  // Deletes all the rows of a table or an index in the session transaction, so that a rollback restores them.
+  CHECKED_STATUS TruncateTable(const PgObjectId& table_object_id);
+
   CHECKED_STATUS ReserveOids(PgOid database_oid,
                              PgOid nexte_oid,
                              uint32_t count,
@@ -179,8 +199,6 @@ class PgSession {
 
   CHECKED_STATUS DeleteSequenceTuple(int64_t db_oid, int64_t seq_oid);
 
-  CHECKED_STATUS DeleteDBSequences(int64_t db_oid);
-
   // Access functions for connected database.
   const char* connected_dbname() const {
     return connected_database_.c_str();
@@ -265,6 +283,29 @@ class PgSession {
 
   CHECKED_STATUS HandleResponse(PgOpTemplate& op, const PgObjectId& relation_id);
 
+  // Whether the given write can be buffered, i.e. queued and flushed later in a batch with other writes
+  bool ShouldBufferOperation(const PgWriteOpTemplate& op) const;
+
+  // Buffer a write which doesn't need its result right away. When the buffer is full, its writes are sent in a
+  // single batch without waiting for it, so that e.g. a COPY keeps several batches in flight. All the writes are
+  // flushed and waited for before any other operation is run (so that reads see the writes), and before the
+  // transaction commits. Errors of a buffered write are reported when its batch is waited for.
+  CHECKED_STATUS BufferOperation(const std::shared_ptr<PgWriteOpTemplate>& op,
+                                 const PgObjectId& relation_id,
+                                 std::shared_ptr<PgStatement> owner);
+
+  // Insert (or upsert) a row of a table or an index given by its attribute values, e.g. a row loaded by COPY or an
+  // index entry. The row is serialized straight into the SKV record to write, without a statement, and is buffered
+  // like the other writes when possible. Sets the k2pgctid of the row if row_id is not null.
+  CHECKED_STATUS BufferInsertRow(const PgObjectId& table_object_id, const PgAttrValueDescriptor *attrs, int32_t nattrs,
+                                 bool upsert, std::string* row_id);
+
+  // Run all buffered writes and wait for them, and for the batches already in flight, to finish.
+  CHECKED_STATUS FlushBufferedOperations();
+
+  // Discard all buffered writes, e.g. when the transaction is aborted.
+  void DropBufferedOperations();
+
   std::shared_ptr<PgTxnHandler>& GetSessionTxnHandler() {
     return pg_txn_handler_;
   }
@@ -276,6 +317,10 @@ class PgSession {
 
   CHECKED_STATUS AsyncUpdateIndexPermissions(const PgObjectId& indexed_table_object_id);
 
+  // Fills a new index from the rows of its base table within SKV, in the session transaction. Sets the number of
+  // indexed rows
+  CHECKED_STATUS BackfillIndex(const PgObjectId& table_object_id, const PgObjectId& index_object_id, uint64_t* indexed_rows);
+
   // Generate a new random and unique rowid. It is a v4 UUID.
   string GenerateNewRowid() {
     return rowid_generator_.Next(true /* binary_id */);
@@ -289,10 +334,27 @@ class PgSession {
     return catalog_client_;
   }
 
+  // Max number of concurrent sub-scans a single scan can be split into
+  int32_t GetScanParallelism() const {
+    return k2_adapter_->ScanParallelism();
+  }
+
   private:
   // Whether we should use transactional or non-transactional session.
   bool ShouldHandleTransactionally(const PgOpTemplate& op);
 
+  // Buffer a write of the given row, see BufferOperation() above.
+  CHECKED_STATUS BufferOperation(const std::shared_ptr<PgWriteOpTemplate>& op,
+                                 const PgObjectId& relation_id,
+                                 std::shared_ptr<PgStatement> owner,
+                                 RowIdentifier row);
+
+  // Send the buffered writes in a batch, first waiting for the oldest batch in flight if there are too many.
+  CHECKED_STATUS SendBufferedOperations();
+
+  // Wait for the oldest batch in flight to finish.
+  CHECKED_STATUS WaitForInflightBatch();
+
   // Connected database.
   std::string connected_database_;
 
@@ -310,9 +372,20 @@ class PgSession {
   // Session's transaction handler.
   std::shared_ptr<PgTxnHandler> pg_txn_handler_;
 
+  // Sequence data in SKV, accessed outside of the session's transaction.
+  std::shared_ptr<SequenceInfoHandler> sequence_handler_;
+
   std::unordered_map<TableId, std::shared_ptr<TableInfo>> table_cache_;
   std::unordered_set<PgForeignKeyReference, boost::hash<PgForeignKeyReference>> fk_reference_cache_;
 
+  // Buffered writes, the batches of them in flight and the rows they write. The writes run concurrently, so a
+  // second write to one of the rows flushes all of them first to keep the writes in order.
+  PgsqlOpBuffer buffered_ops_;
+  std::deque<InflightBatch> inflight_batches_;
+  std::unordered_set<RowIdentifier, boost::hash<RowIdentifier>> buffered_keys_;
+  // The SQL text of the statement issuing the buffered operations.
+  std::shared_ptr<const std::string> buffering_statement_text_;
+
   const K2PgCallbacks& pg_callbacks_;
 
   std::string client_id_;
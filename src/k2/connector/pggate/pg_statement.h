@@ -84,7 +84,7 @@ enum StmtOp {
   STMT_ALTER_DATABASE,
 };
 
-class PgStatement {
+class PgStatement : public std::enable_shared_from_this<PgStatement> {
  public:
 
   //------------------------------------------------------------------------------------------------
@@ -47,8 +47,9 @@ Status PgTxnHandler::BeginTransaction() {
     return STATUS(IllegalState, "Transaction is already in progress");
   }
   ResetTransaction();
+  // The K2 transaction is only started by its first read or write, see GetTxn(), so that a transaction which
+  // doesn't access SKV doesn't cost any round trip
   txn_in_progress_ = true;
-  txn_ = std::make_shared<K23SITxn>(adapter_->BeginTransaction().get());
   return Status::OK();
 }
 
@@ -58,9 +59,17 @@ Status PgTxnHandler::CommitTransaction() {
     return Status::OK();
   }
 
-  if (txn_ != nullptr && read_only_) {
+  if (txn_ == nullptr) {
+    K2LOG_D(log::pg, "This transaction did not access SKV, nothing to commit.");
+    ResetTransaction();
+    return Status::OK();
+  }
+
+  if (read_only_) {
     K2LOG_D(log::pg, "This was a read-only transaction, nothing to commit.");
-    // currently for K2-3SI transaction, we actually just abort the transaction if it is read only
+    // currently for K2-3SI transaction, we actually just abort the transaction if it is read only, which still
+    // counts as a commit for the abort actions
+    abort_actions_.clear();
     return AbortTransaction();
   }
 
@@ -85,12 +94,15 @@ Status PgTxnHandler::AbortTransaction() {
     return Status::OK();
   }
 
-  if (txn_already_aborted_ || (txn_ != nullptr && read_only_)) {
-    // This was a already commited or read-only transaction, nothing to commit.
+  RunAbortActions();
+  if (txn_already_aborted_ || txn_ == nullptr) {
+    // This was a already commited transaction or one which did not access SKV, nothing to abort.
     ResetTransaction();
     return Status::OK();
   }
 
+  // A transaction which did not write anything, e.g. a read-only one, is ended locally by the txn handle
+
   // Use synchronous call for now until PG supports additional state check after this call
   auto result = adapter_->EndTransaction(txn_, false/*abort*/).get();
   // always abandon current transaction and reset regardless abort success or not.
@@ -104,7 +116,7 @@ Status PgTxnHandler::AbortTransaction() {
 
 Status PgTxnHandler::RestartTransaction() {
   // TODO: how do we decide whether a transaction is restart required?
-  if (txn_ != nullptr) {
+  if (txn_in_progress_) {
     auto status = AbortTransaction();
     if (!status.ok()) {
       return status;
@@ -139,9 +151,21 @@ Status PgTxnHandler::ExitSeparateDdlTxnMode(bool success) {
   return Status::OK();
 }
 
+void PgTxnHandler::AddAbortAction(std::function<void()> action) {
+  abort_actions_.push_back(std::move(action));
+}
+
+void PgTxnHandler::RunAbortActions() {
+  std::vector<std::function<void()>> actions;
+  actions.swap(abort_actions_);
+  for (auto& action : actions) {
+    action();
+  }
+}
+
 std::shared_ptr<K23SITxn> PgTxnHandler::GetTxn() {
   // start transaction if not yet started.
-  if (txn_ == nullptr) {
+  if (!txn_in_progress_) {
     auto status = BeginTransaction();
     if (!status.ok())
     {
@@ -149,7 +173,11 @@ std::shared_ptr<K23SITxn> PgTxnHandler::GetTxn() {
     }
   }
 
-  DCHECK(txn_in_progress_);
+  if (txn_ == nullptr) {
+    // The begin is sent right away, but it is only waited for once the first operation has been prepared and
+    // needs the mtr of the transaction, so that the begin overlaps with the preparation.
+    txn_ = std::make_shared<K23SITxn>(adapter_->BeginTransaction());
+  }
   return txn_;
 }
 
@@ -158,6 +186,7 @@ void PgTxnHandler::ResetTransaction() {
   txn_in_progress_ = false;
   txn_already_aborted_ = false;
   txn_ = nullptr;
+  abort_actions_.clear();
   can_restart_.store(true, std::memory_order_release);
 }
 
@@ -24,6 +24,8 @@ Copyright(c) 2020 Futurewei Cloud
 #pragma once
 
 #include <atomic>
+#include <functional>
+#include <vector>
 
 #include "common/result.h"
 #include "pggate/k2_txn.h"
@@ -67,6 +69,10 @@ class PgTxnHandler {
 
   CHECKED_STATUS SetDeferrable(bool deferrable);
 
+  // Registers an action to run if the current transaction is aborted instead of committed, e.g. to undo what a DDL
+  // statement committed in separate transactions. The actions are dropped when the transaction commits
+  void AddAbortAction(std::function<void()> action);
+
   CHECKED_STATUS EnterSeparateDdlTxnMode();
 
   CHECKED_STATUS ExitSeparateDdlTxnMode(bool success);
@@ -75,6 +81,9 @@ class PgTxnHandler {
 
   void ResetTransaction();
 
+  // runs and clears the abort actions of the current transaction
+  void RunAbortActions();
+
   std::shared_ptr<K23SITxn> txn_ = nullptr;
 
   bool txn_in_progress_ = false;
@@ -91,6 +100,8 @@ class PgTxnHandler {
   std::atomic<bool> can_restart_{true};
 
   std::shared_ptr<K2Adapter> adapter_;
+
+  std::vector<std::function<void()>> abort_actions_;
 };
 
 }  // namespace gate
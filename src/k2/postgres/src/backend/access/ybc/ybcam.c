@@ -1488,12 +1488,19 @@ static double camIndexEvalClauseSelectivity(Bitmapset *qual_cols,
 	return K2PG_HASH_SCAN_SELECTIVITY;
 }
 
-void camIndexCostEstimate(IndexPath *path, Selectivity *selectivity,
+bool camRelHasStats(Relation relation)
+{
+	/* K2PG tables have no pages, so reltuples stays zero until ANALYZE */
+	return relation->rd_rel->reltuples > 0;
+}
+
+void camIndexCostEstimate(PlannerInfo *root, IndexPath *path, Selectivity *selectivity,
 						  Cost *startup_cost, Cost *total_cost)
 {
 	Relation	index = RelationIdGetRelation(path->indexinfo->indexoid);
 	bool		isprimary = index->rd_index->indisprimary;
-	Relation	relation = isprimary ? RelationIdGetRelation(index->rd_index->indrelid) : NULL;
+	Relation	relation = RelationIdGetRelation(index->rd_index->indrelid);
+	bool		has_stats = camRelHasStats(relation);
 	RelOptInfo *baserel = path->path.parent;
 	List	   *qinfos;
 	ListCell   *lc;
@@ -1501,6 +1508,8 @@ void camIndexCostEstimate(IndexPath *path, Selectivity *selectivity,
 	bool        is_unique = index->rd_index->indisunique;
 	bool        is_partial_idx = path->indexinfo->indpred != NIL && path->indexinfo->predOK;
 	Bitmapset  *const_quals = NULL;
+	List	   *pushed_quals = NIL;
+	List	   *const_pushed_quals = NIL;
 
 	/* Primary-index scans are always covered in K2PG (internally) */
 	bool       is_uncovered_idx_scan = !index->rd_index->indisprimary &&
@@ -1534,6 +1543,8 @@ void camIndexCostEstimate(IndexPath *path, Selectivity *selectivity,
 			{
 				const_quals = bms_add_member(const_quals, bms_idx);
 				camAddAttributeColumn(&scan_plan, attnum);
+				pushed_quals = lappend(pushed_quals, rinfo);
+				const_pushed_quals = lappend(const_pushed_quals, rinfo);
 			}
 		}
 		else
@@ -1549,8 +1560,12 @@ void camIndexCostEstimate(IndexPath *path, Selectivity *selectivity,
 				if (cam_should_pushdown_op(&scan_plan, attnum, op_strategy))
 				{
 					camAddAttributeColumn(&scan_plan, attnum);
+					pushed_quals = lappend(pushed_quals, rinfo);
 					if (qinfo->other_operand && IsA(qinfo->other_operand, Const))
+					{
 						const_quals = bms_add_member(const_quals, bms_idx);
+						const_pushed_quals = lappend(const_pushed_quals, rinfo);
+					}
 				}
 			}
 		}
@@ -1565,16 +1580,31 @@ void camIndexCostEstimate(IndexPath *path, Selectivity *selectivity,
 	                                             is_unique,
 	                                             scan_plan.hash_key,
 	                                             scan_plan.primary_key);
+
+	/*
+	 * With table stats, a lookup or range scan is estimated from the column
+	 * statistics of the pushed down conditions rather than the fixed
+	 * fractions of K2PG_DEFAULT_NUM_ROWS above. A full scan stays a full scan.
+	 */
+	if (has_stats && *selectivity < K2PG_FULL_SCAN_SELECTIVITY)
+	{
+		*selectivity = clauselist_selectivity(root, pushed_quals, baserel->relid,
+		                                      JOIN_INNER, NULL);
+		if (*selectivity * baserel->tuples < 1.0)
+			*selectivity = 1.0 / baserel->tuples;
+	}
 	path->path.rows = baserel->tuples * (*selectivity);
 
 	/*
 	 * For partial indexes, scale down the rows to account for the predicate.
 	 * Do this after setting the baserel rows since this does not apply to base rel.
-	 * TODO: this should be evaluated based on the index condition in the future.
 	 */
 	if (is_partial_idx)
 	{
-		*selectivity *= K2PG_PARTIAL_IDX_PRED_SELECTIVITY;
+		*selectivity *= has_stats
+			? clauselist_selectivity(root, path->indexinfo->indpred, baserel->relid,
+			                         JOIN_INNER, NULL)
+			: K2PG_PARTIAL_IDX_PRED_SELECTIVITY;
 	}
 
 	camCostEstimate(baserel, *selectivity, is_backwards_scan,
@@ -1590,15 +1620,19 @@ void camIndexCostEstimate(IndexPath *path, Selectivity *selectivity,
 	                                                              is_unique,
 	                                                              scan_plan.hash_key,
 	                                                              scan_plan.primary_key);
-	double baserel_rows_estimate = const_qual_selectivity * baserel->tuples;
+	if (has_stats && const_qual_selectivity < K2PG_FULL_SCAN_SELECTIVITY)
+		const_qual_selectivity = clauselist_selectivity(root, const_pushed_quals,
+		                                                baserel->relid, JOIN_INNER, NULL);
+	double baserel_rows_estimate = clamp_row_est(const_qual_selectivity * baserel->tuples);
 	if (baserel_rows_estimate < baserel->rows)
 	{
 		baserel->rows = baserel_rows_estimate;
 	}
 
+	list_free(pushed_quals);
+	list_free(const_pushed_quals);
 
-	if (relation)
-		RelationClose(relation);
+	RelationClose(relation);
 
 	RelationClose(index);
 }
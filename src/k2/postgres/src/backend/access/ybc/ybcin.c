@@ -36,6 +36,7 @@
 #include "commands/ybccmds.h"
 #include "utils/rel.h"
 #include "executor/ybcModifyTable.h"
+#include "pg_k2pg_utils.h"
 
 /* --------------------------------------------------------------------------------------------- */
 
@@ -116,18 +117,53 @@ ybcinbuildCallback(Relation index, HeapTuple heapTuple, Datum *values, bool *isn
 	buildstate->index_tuples += 1;
 }
 
+/*
+ * A secondary index on plain columns of the table holds nothing PG has to compute, so it can be
+ * filled from the table rows in storage instead of sending each row to PG and back.
+ */
+static bool
+K2PgCanBuildIndexInStorage(Relation index, struct IndexInfo *indexInfo)
+{
+	if (index->rd_index->indisprimary ||
+		indexInfo->ii_Expressions != NIL ||
+		indexInfo->ii_Predicate != NIL ||
+		indexInfo->ii_ExclusionOps != NULL)
+		return false;
+
+	for (int i = 0; i < indexInfo->ii_NumIndexAttrs; i++)
+	{
+		if (indexInfo->ii_IndexAttrNumbers[i] <= 0)
+			return false;
+	}
+	return true;
+}
+
 IndexBuildResult *
 ybcinbuild(Relation heap, Relation index, struct IndexInfo *indexInfo)
 {
 	K2PgBuildState	buildstate;
 	double			heap_tuples = 0;
 
-	/* Do the heap scan */
 	buildstate.isprimary = index->rd_index->indisprimary;
 	buildstate.index_tuples = 0;
 	buildstate.is_backfill = false;
-	heap_tuples = IndexBuildHeapScan(heap, index, indexInfo, true, ybcinbuildCallback,
-									 &buildstate, NULL);
+	if (K2PgCanBuildIndexInStorage(index, indexInfo))
+	{
+		uint64_t indexed_rows = 0;
+
+		HandleK2PgStatus(PgGate_BackfillIndex(K2PgGetDatabaseOid(heap),
+											  RelationGetRelid(heap),
+											  RelationGetRelid(index),
+											  &indexed_rows));
+		heap_tuples = indexed_rows;
+		buildstate.index_tuples = indexed_rows;
+	}
+	else
+	{
+		/* Do the heap scan */
+		heap_tuples = IndexBuildHeapScan(heap, index, indexInfo, true, ybcinbuildCallback,
+										 &buildstate, NULL);
+	}
 
 	/*
 	 * Return statistics
@@ -232,7 +268,7 @@ ybcincostestimate(struct PlannerInfo *root, struct IndexPath *path, double loop_
 				  Cost *indexStartupCost, Cost *indexTotalCost, Selectivity *indexSelectivity,
 				  double *indexCorrelation, double *indexPages)
 {
-	camIndexCostEstimate(path, indexSelectivity, indexStartupCost, indexTotalCost);
+	camIndexCostEstimate(root, path, indexSelectivity, indexStartupCost, indexTotalCost);
 }
 
 bytea *
@@ -57,6 +57,7 @@
 #include "utils/memutils.h"
 #include "utils/pg_rusage.h"
 #include "utils/sampling.h"
+#include "utils/snapmgr.h"
 #include "utils/sortsupport.h"
 #include "utils/syscache.h"
 #include "utils/timestamp.h"
@@ -94,6 +95,9 @@ static VacAttrStats *examine_attribute(Relation onerel, int attnum,
 static int acquire_sample_rows(Relation onerel, int elevel,
 					HeapTuple *rows, int targrows,
 					double *totalrows, double *totaldeadrows);
+static int k2_acquire_sample_rows(Relation onerel, int elevel,
+					   HeapTuple *rows, int targrows,
+					   double *totalrows, double *totaldeadrows);
 static int	compare_rows(const void *a, const void *b);
 static int acquire_inherited_sample_rows(Relation onerel, int elevel,
 							  HeapTuple *rows, int targrows,
@@ -245,7 +249,14 @@ analyze_rel(Oid relid, RangeVar *relation, int options,
 	/*
 	 * Check that it's of an analyzable relkind, and set up appropriately.
 	 */
-	if (onerel->rd_rel->relkind == RELKIND_RELATION ||
+	if (IsK2PgRelation(onerel) &&
+		onerel->rd_rel->relkind == RELKIND_RELATION)
+	{
+		/* K2 table, rows are sampled through a scan, there are no pages */
+		acquirefunc = k2_acquire_sample_rows;
+		relpages = 0;
+	}
+	else if (onerel->rd_rel->relkind == RELKIND_RELATION ||
 		onerel->rd_rel->relkind == RELKIND_MATVIEW)
 	{
 		/* Regular table, so we'll use the regular row acquisition function */
@@ -368,16 +379,6 @@ do_analyze_rel(Relation onerel, int options, VacuumParams *params,
 	int			save_sec_context;
 	int			save_nestlevel;
 
-	/*
-	 * ANALYZE not supported for K2PG relations.
-	 */
-	if (IsK2PgRelation(onerel))
-	{
-		ereport(WARNING,
-				(errmsg("analyzing non-temporary tables will be ignored")));
-		return;
-	}
-
 	if (inh)
 		ereport(elevel,
 				(errmsg("analyzing \"%s.%s\" inheritance tree",
@@ -644,9 +645,11 @@ do_analyze_rel(Relation onerel, int options, VacuumParams *params,
 	 */
 	if (!inh)
 	{
-		BlockNumber relallvisible;
+		BlockNumber relallvisible = 0;
 
-		visibilitymap_count(onerel, &relallvisible, NULL);
+		/* K2 relations have no visibility map */
+		if (!IsK2PgRelation(onerel))
+			visibilitymap_count(onerel, &relallvisible, NULL);
 
 		vac_update_relstats(onerel,
 							relpages,
@@ -693,8 +696,11 @@ do_analyze_rel(Relation onerel, int options, VacuumParams *params,
 		pgstat_report_analyze(onerel, totalrows, totaldeadrows,
 							  (va_cols == NIL));
 
-	/* If this isn't part of VACUUM ANALYZE, let index AMs do cleanup */
-	if (!(options & VACOPT_VACUUM))
+	/*
+	 * If this isn't part of VACUUM ANALYZE, let index AMs do cleanup.
+	 * K2 indexes have nothing to clean up.
+	 */
+	if (!(options & VACOPT_VACUUM) && !IsK2PgRelation(onerel))
 	{
 		for (ind = 0; ind < nindexes; ind++)
 		{
@@ -1306,6 +1312,100 @@ acquire_sample_rows(Relation onerel, int elevel,
 	return numrows;
 }
 
+/*
+ * k2_acquire_sample_rows -- acquire a random sample of rows from a K2 table
+ *
+ * Same API as acquire_sample_rows. K2 tables have no blocks to pick from,
+ * so we scan the whole table through PgGate and keep a reservoir of targrows
+ * rows using the Vitter algorithm, the same way postgres_fdw samples remote
+ * tables. Every row read is live, so *totalrows is exact and *totaldeadrows
+ * is always zero.
+ *
+ * The rows are left in reservoir order: there is no physical position to sort
+ * them by, and the correlation estimates are meaningless for K2 anyway.
+ */
+static int
+k2_acquire_sample_rows(Relation onerel, int elevel,
+					   HeapTuple *rows, int targrows,
+					   double *totalrows, double *totaldeadrows)
+{
+	int			numrows = 0;	/* # rows now in reservoir */
+	double		samplerows = 0; /* total # rows read */
+	double		rowstoskip = -1;	/* -1 means not set yet */
+	ReservoirStateData rstate;
+	HeapScanDesc scan;
+	HeapTuple	tuple;
+	MemoryContext tuple_context;
+	MemoryContext old_context;
+
+	Assert(targrows > 0);
+
+	reservoir_init_selection_state(&rstate, targrows);
+
+	/*
+	 * Each fetched tuple is built in a short-lived context, and only copied
+	 * out when it makes it into the reservoir.
+	 */
+	tuple_context = AllocSetContextCreate(GetCurrentMemoryContext(),
+										  "K2 analyze tuple",
+										  ALLOCSET_DEFAULT_SIZES);
+
+	scan = heap_beginscan(onerel, GetActiveSnapshot(), 0, NULL);
+
+	for (;;)
+	{
+		vacuum_delay_point();
+
+		old_context = MemoryContextSwitchTo(tuple_context);
+		tuple = heap_getnext(scan, ForwardScanDirection);
+		MemoryContextSwitchTo(old_context);
+
+		if (tuple == NULL)
+			break;
+
+		if (numrows < targrows)
+			rows[numrows++] = heap_copytuple(tuple);
+		else
+		{
+			/*
+			 * The first targrows rows fill the reservoir. After that, each
+			 * row replaces a random element of the reservoir with the
+			 * probability given by the Vitter algorithm.
+			 */
+			if (rowstoskip < 0)
+				rowstoskip = reservoir_get_next_S(&rstate, samplerows, targrows);
+
+			if (rowstoskip <= 0)
+			{
+				int			k = (int) (targrows * sampler_random_fract(rstate.randstate));
+
+				Assert(k >= 0 && k < targrows);
+				heap_freetuple(rows[k]);
+				rows[k] = heap_copytuple(tuple);
+			}
+
+			rowstoskip -= 1;
+		}
+
+		samplerows += 1;
+		MemoryContextReset(tuple_context);
+	}
+
+	heap_endscan(scan);
+	MemoryContextDelete(tuple_context);
+
+	*totalrows = samplerows;
+	*totaldeadrows = 0;
+
+	ereport(elevel,
+			(errmsg("\"%s\": scanned %.0f rows; "
+					"%d rows in sample",
+					RelationGetRelationName(onerel),
+					samplerows, numrows)));
+
+	return numrows;
+}
+
 /*
  * qsort comparator for sorting rows[] array
  */
@@ -1412,7 +1512,17 @@ acquire_inherited_sample_rows(Relation onerel, int elevel,
 		}
 
 		/* Check table type (MATVIEW can't happen, but might as well allow) */
-		if (childrel->rd_rel->relkind == RELKIND_RELATION ||
+		if (IsK2PgRelation(childrel) &&
+			childrel->rd_rel->relkind == RELKIND_RELATION)
+		{
+			/*
+			 * K2 tables have no pages, so give each of them a unit size and
+			 * thus an equal share of the sample.
+			 */
+			acquirefunc = k2_acquire_sample_rows;
+			relpages = 1;
+		}
+		else if (childrel->rd_rel->relkind == RELKIND_RELATION ||
 			childrel->rd_rel->relkind == RELKIND_MATVIEW)
 		{
 			/* Regular table, so use the regular row acquisition function */
@@ -2347,7 +2347,7 @@ CopyFrom(CopyState cstate)
 	bool		useHeapMultiInsert;
 	int			nBufferedTuples = 0;
 	int			prev_leaf_part_index = -1;
-	bool		useNonTxnInsert;
+	bool		useIntermediateCommits;
 
 #define MAX_BUFFERED_TUPLES 1000
 	HeapTuple  *bufferedTuples = NULL;	/* initialize to silence warning */
@@ -2611,19 +2611,17 @@ CopyFrom(CopyState cstate)
 	}
 
 	/*
-	 * Only use non-txn insert if it's explicitly enabled, the relation meets criteria for
-	 * multi insert (e.g. no triggers), and the relation does not have secondary indices.
+	 * Commit the rows every k2pg_copy_rows_per_transaction rows if the COPY is
+	 * the only statement of its transaction, so that a large file is not
+	 * loaded in a single huge K2 transaction. The relation must not have
+	 * triggers, whose queued events (e.g. foreign key checks) are only fired
+	 * at the end of the statement. This is also the closest K2 gets to a
+	 * non-transactional COPY.
 	 */
-	if (K2PgIsNonTxnCopyEnabled() &&
+	useIntermediateCommits = k2pg_copy_rows_per_transaction > 0 &&
 		useK2PGMultiInsert &&
-		!K2PgRelInfoHasSecondaryIndices(resultRelInfo))
-	{
-		useNonTxnInsert = true;
-	}
-	else
-	{
-		useNonTxnInsert = false;
-	}
+		resultRelInfo->ri_TrigDesc == NULL &&
+		!IsTransactionBlock();
 
 	/*
 	 * Check BEFORE STATEMENT insertion triggers. It's debatable whether we
@@ -2645,14 +2643,15 @@ CopyFrom(CopyState cstate)
 	errcallback.previous = error_context_stack;
 	error_context_stack = &errcallback;
 
-	/* Warn if non-txn COPY enabled and relation does not meet non-txn criteria. */
-	if (K2PgIsNonTxnCopyEnabled() && !useNonTxnInsert)
+	/* Warn if non-txn COPY is enabled, K2 writes always belong to a transaction. */
+	if (K2PgIsNonTxnCopyEnabled())
 		ereport(WARNING,
 				(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
-				 errmsg("non-transactional COPY is not supported on this relation; "
+				 errmsg("non-transactional COPY is not supported; "
 						"using transactional COPY instead"),
-				 errhint("Non-transactional COPY is not supported on relations with "
-						 "secondary indices or triggers.")));
+				 errhint("Set k2pg_copy_rows_per_transaction to commit the rows "
+						 "of a COPY outside of a transaction block in several "
+						 "transactions.")));
 
 	for (;;)
 	{
@@ -2867,14 +2866,7 @@ CopyFrom(CopyState cstate)
 					/* OK, store the tuple and create index entries for it */
 					if (IsK2PgRelation(resultRelInfo->ri_RelationDesc))
 					{
-						if (useNonTxnInsert)
-						{
-							K2PgExecuteNonTxnInsert(cstate->rel, tupDesc, tuple);
-						}
-						else
-						{
-							K2PgExecuteInsert(cstate->rel, tupDesc, tuple);
-						}
+						K2PgExecuteBulkInsert(cstate->rel, tupDesc, tuple);
 					}
 					else if (resultRelInfo->ri_FdwRoutine != NULL)
 					{
@@ -2923,6 +2915,13 @@ CopyFrom(CopyState cstate)
 			 * for counting tuples inserted by an INSERT command.
 			 */
 			processed++;
+
+			if (useIntermediateCommits &&
+				processed % k2pg_copy_rows_per_transaction == 0)
+			{
+				K2PgCommitTransaction();
+				HandleK2PgStatus(PgGate_BeginTransaction());
+			}
 		}
 
 	next_tuple:
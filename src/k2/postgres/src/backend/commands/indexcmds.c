@@ -77,7 +77,8 @@ static void ComputeIndexAttrs(IndexInfo *indexInfo,
 				  Oid relId,
 				  const char *accessMethodName, Oid accessMethodId,
 				  bool amcanorder,
-				  bool isconstraint);
+				  bool isconstraint,
+				  bool isprimary);
 static char *ChooseIndexName(const char *tabname, Oid namespaceId,
 				List *colnames, List *exclusionOpNames,
 				bool primary, bool isconstraint);
@@ -210,7 +211,7 @@ CheckIndexCompatible(Oid oldId,
 					  coloptions, attributeList,
 					  exclusionOpNames, relationId,
 					  accessMethodName, accessMethodId,
-					  amcanorder, isconstraint);
+					  amcanorder, isconstraint, false);
 
 
 	/* Get the soon-obsolete pg_index tuple. */
@@ -725,7 +726,7 @@ DefineIndex(Oid relationId,
 					  coloptions, allIndexParams,
 					  stmt->excludeOpNames, relationId,
 					  accessMethodName, accessMethodId,
-					  amcanorder, stmt->isconstraint);
+					  amcanorder, stmt->isconstraint, stmt->primary);
 
 	/*
 	 * Extra checks when creating a PRIMARY KEY index.
@@ -1323,14 +1324,14 @@ ComputeIndexAttrs(IndexInfo *indexInfo,
 				  const char *accessMethodName,
 				  Oid accessMethodId,
 				  bool amcanorder,
-				  bool isconstraint)
+				  bool isconstraint,
+				  bool isprimary)
 {
 	ListCell   *nextExclOp;
 	ListCell   *lc;
 	int			attn;
 	int			nkeycols = indexInfo->ii_NumIndexKeyAttrs;
 	bool		use_k2pg_ordering = false;
-	bool		colocated;
 
 	/* Allocate space for exclusion operator info, if needed */
 	if (exclusionOpNames)
@@ -1344,22 +1345,13 @@ ComputeIndexAttrs(IndexInfo *indexInfo,
 	else
 		nextExclOp = NULL;
 
-	/*
-	 * Get whether the index will use K2PG ordering and whether it will be
-	 * colocated.  For now, regarding colocation, the index always follows the
-	 * indexed table, so just figure out whether the indexed table is
-	 * colocated.
-	 */
+	/* Get whether the index will use K2PG ordering. */
 	if (IsK2PgEnabled() &&
 		!IsBootstrapProcessingMode() &&
 		!K2PgIsPreparingTemplates())
 	{
 		Relation rel = RelationIdGetRelation(relId);
 		use_k2pg_ordering = IsK2PgRelation(rel) && !IsSystemRelation(rel);
-		if (IsK2PgRelation(rel))
-			HandleK2PgStatus(PgGate_IsTableColocated(MyDatabaseId,
-												 relId,
-												 &colocated));
 		RelationClose(rel);
 	}
 
@@ -1387,17 +1379,11 @@ ComputeIndexAttrs(IndexInfo *indexInfo,
 						break;
 					case SORTBY_DEFAULT:
 						/*
-						 * In K2PG mode, first attribute defaults to HASH and
-						 * other attributes default to ASC.  However, for
-						 * colocated tables, the first attribute defaults to
-						 * ASC.
+						 * SKV keeps the index rows in key order, so all
+						 * attributes default to ASC.
 						 */
-						if (attn > 0 || colocated)
-						{
-							range_index = true;
-							break;
-						}
-						/* Fallthrough */
+						range_index = true;
+						break;
 					case SORTBY_HASH:
 						if (range_index)
 							ereport(ERROR,
@@ -1654,26 +1640,17 @@ ComputeIndexAttrs(IndexInfo *indexInfo,
 		{
 			/* default ordering is ASC */
 			/*
-             * We do not support DESC index (see chogori-sql issue #268),
-             * so commenting this out forces PG to see the index as ascending and sort if necessary
-             * This can be uncommented if the issue is resolved.
-            if (attribute->ordering == SORTBY_DESC)
+			 * We do not support DESC secondary indexes (see chogori-sql issue #268),
+			 * so PG sees them as ascending and sorts if necessary. The SKV schema of
+			 * a table keeps its DESC primary key columns in descending order though,
+			 * and the scans of the primary key must advertise that order.
+			 */
+			if (attribute->ordering == SORTBY_DESC && isprimary && use_k2pg_ordering)
 				colOptionP[attn] |= INDOPTION_DESC;
-            */
 			if (IsK2PgEnabled() &&
 				attribute->ordering == SORTBY_HASH)
 				colOptionP[attn] |= INDOPTION_HASH;
 
-			/*
-			 * In K2PG, use HASH as the default for the first column of
-			 * non-colocated tables
-			 */
-			if (use_k2pg_ordering &&
-				attn == 0 &&
-				attribute->ordering == SORTBY_DEFAULT &&
-				!colocated)
-				colOptionP[attn] |= INDOPTION_HASH;
-
 			/* default null ordering is LAST for ASC, FIRST for DESC */
 			if (attribute->nulls_ordering == SORTBY_NULLS_DEFAULT)
 			{
@@ -43,6 +43,7 @@
 #include "utils/lsyscache.h"
 #include "utils/resowner.h"
 #include "utils/syscache.h"
+#include "utils/timestamp.h"
 #include "utils/varlena.h"
 
 /*  K2PG includes. */
@@ -82,6 +83,8 @@ typedef struct SeqTableData
 	/* if last != cached, we have not used up all the cached values */
 	int64		increment;		/* copy of sequence's increment field */
 	/* note that increment is zero until we first do nextval_internal() */
+	int64		k2pg_fetch;		/* number of values K2PG reserved last time */
+	TimestampTz k2pg_fetch_time;	/* when K2PG reserved them */
 } SeqTableData;
 
 typedef SeqTableData *SeqTable;
@@ -98,6 +101,7 @@ static void fill_seq_with_data(Relation rel, HeapTuple tuple);
 static Relation lock_and_open_sequence(SeqTable seq);
 static void create_seq_hashtable(void);
 static void init_sequence(Oid relid, SeqTable *p_elm, Relation *p_rel);
+static int64 k2pg_sequence_fetch(SeqTable elm, int64 cache);
 static Form_pg_sequence_data read_seq_tuple(Relation rel,
 			   Buffer *buf, HeapTuple seqdatatuple);
 static void init_params(ParseState *pstate, List *options, bool for_identity,
@@ -750,6 +754,10 @@ nextval_internal(Oid relid, bool check_permissions)
 	cycle = pgsform->seqcycle;
 	ReleaseSysCache(pgstuple);
 
+	/* K2PG reserves more values at once than CACHE for a busy sequence */
+	if (IsK2PgEnabled())
+		cache = k2pg_sequence_fetch(elm, cache);
+
 retry:
 	rescnt = 0;
 	if (IsK2PgEnabled())
@@ -1284,6 +1292,29 @@ create_seq_hashtable(void)
 							 HASH_ELEM | HASH_BLOBS);
 }
 
+/*
+ * Number of values a K2PG backend reserves with the next update of the sequence
+ * in storage. It starts at the sequence's CACHE and doubles, up to
+ * k2pg_sequence_max_cache_size, whenever the values reserved last time were
+ * used up within a second, so that a busy sequence doesn't cost a round trip
+ * for every few values. It drops back to CACHE once the sequence is used
+ * slowly again, to not waste values.
+ */
+static int64
+k2pg_sequence_fetch(SeqTable elm, int64 cache)
+{
+	TimestampTz now = GetCurrentTimestamp();
+
+	if (elm->k2pg_fetch >= cache &&
+		elm->k2pg_fetch_time != 0 &&
+		!TimestampDifferenceExceeds(elm->k2pg_fetch_time, now, 1000))
+		elm->k2pg_fetch = Max(Min(elm->k2pg_fetch * 2, k2pg_sequence_max_cache_size), cache);
+	else
+		elm->k2pg_fetch = cache;
+	elm->k2pg_fetch_time = now;
+	return elm->k2pg_fetch;
+}
+
 /*
  * Given a relation OID, open and lock the sequence.  p_elm and p_rel are
  * output parameters.
@@ -1316,6 +1347,8 @@ init_sequence(Oid relid, SeqTable *p_elm, Relation *p_rel)
 		elm->lxid = InvalidLocalTransactionId;
 		elm->last_valid = false;
 		elm->last = elm->cached = 0;
+		elm->k2pg_fetch = 0;
+		elm->k2pg_fetch_time = 0;
 	}
 
 	/*
@@ -4890,6 +4890,9 @@ AfterTriggerEndQuery(EState *estate)
 	 */
 	qs = &afterTriggers.query_stack[afterTriggers.query_depth];
 
+	/* Look up the FK values queued by the query in batches */
+	K2PgRIPrefetchReferences();
+
 	for (;;)
 	{
 		if (afterTriggerMarkEvents(&qs->events, &afterTriggers.events, true))
@@ -5058,6 +5061,9 @@ AfterTriggerFireDeferred(void)
 void
 AfterTriggerEndXact(bool isCommit)
 {
+	/* Forget the FK values queued for batched K2PG lookups */
+	K2PgRIResetPendingChecks();
+
 	/*
 	 * Forget the pending-events list.
 	 *
@@ -5191,6 +5197,13 @@ AfterTriggerEndSubXact(bool isCommit)
 	}
 	else
 	{
+		/*
+		 * Forget the FK values queued for batched K2PG lookups, they may come
+		 * from rows or constraints that the subtransaction created.  Their
+		 * triggers are dropped below, so nothing is lost.
+		 */
+		K2PgRIResetPendingChecks();
+
 		/*
 		 * Aborting.  It is possible subxact start failed before calling
 		 * AfterTriggerBeginSubXact, in which case we mustn't risk touching
@@ -6110,6 +6123,16 @@ AfterTriggerSaveEvent(EState *estate, ResultRelInfo *relinfo,
 			}
 		}
 
+		/*
+		 * Queue the FK values of the row, so that K2PG looks them up together
+		 * with those of the other rows of the query before its immediate FK
+		 * check triggers fire.
+		 */
+		if (row_trigger && newtup != NULL && IsK2PgBackedRelation(rel) &&
+			RI_FKey_trigger_type(trigger->tgfoid) == RI_TRIGGER_FK &&
+			!afterTriggerCheckState(&new_shared))
+			K2PgRIQueueReferenceCheck(trigger, rel, newtup);
+
 		afterTriggerAddEvent(
 				&afterTriggers.query_stack[afterTriggers.query_depth].events, &new_event, &new_shared);
 	}
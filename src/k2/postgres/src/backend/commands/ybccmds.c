@@ -159,8 +159,7 @@ static void CreateTableAddColumn(K2PgStatement handle,
  */
 static void CreateTableAddColumns(K2PgStatement handle,
 								  TupleDesc desc,
-								  Constraint *primary_key,
-								  const bool colocated)
+								  Constraint *primary_key)
 {
 	/* Add all key columns first with respect to compound key order */
 	ListCell *cell;
@@ -182,14 +181,11 @@ static void CreateTableAddColumns(K2PgStatement handle,
 										" '%s' not yet supported",
 										K2PgTypeOidToStr(att->atttypid))));
 					SortByDir order = index_elem->ordering;
-					/* In K2PG mode, the first column defaults to HASH if it is
-					 * not set and its table is not colocated */
-					const bool is_first_key =
-						cell == list_head(primary_key->k2pg_index_params);
-					bool is_hash = (order == SORTBY_HASH ||
-									(is_first_key &&
-									 order == SORTBY_DEFAULT &&
-									 !colocated));
+					/*
+					 * SKV keeps the rows in key order, so key columns are
+					 * range columns unless HASH is given explicitly
+					 */
+					bool is_hash = order == SORTBY_HASH;
 					bool is_desc = false;
 					bool is_nulls_first = false;
 					ColumnSortingOptions(order,
@@ -363,7 +359,7 @@ K2PgCreateTable(CreateStmt *stmt, char relkind, TupleDesc desc, Oid relationId,
 									   colocated,
 									   &handle));
 
-	CreateTableAddColumns(handle, desc, primary_key, colocated);
+	CreateTableAddColumns(handle, desc, primary_key);
 
 	/* Create the table. */
 	HandleK2PgStatus(PgGate_ExecCreateTable(handle));
@@ -176,6 +176,7 @@ CreateExecutorState(void)
 	estate->k2pg_exec_params.limit_offset = 0;
 	estate->k2pg_exec_params.limit_use_default = true;
 	estate->k2pg_exec_params.rowmark = -1;
+	estate->k2pg_exec_params.allow_unordered = false;
 
 	return estate;
 }
@@ -217,11 +217,13 @@
 #include "postgres.h"
 
 #include "access/htup_details.h"
+#include "access/transam.h"
 #include "catalog/objectaccess.h"
 #include "catalog/pg_aggregate.h"
 #include "catalog/pg_proc.h"
 #include "catalog/pg_type.h"
 #include "catalog/ybctype.h"
+#include "common/int.h"
 #include "executor/executor.h"
 #include "executor/nodeAgg.h"
 #include "miscadmin.h"
@@ -231,7 +233,9 @@
 #include "optimizer/tlist.h"
 #include "parser/parse_agg.h"
 #include "parser/parse_coerce.h"
+#include "parser/parsetree.h"
 #include "utils/acl.h"
+#include "utils/array.h"
 #include "utils/builtins.h"
 #include "utils/fmgroids.h"
 #include "utils/lsyscache.h"
@@ -241,6 +245,8 @@
 #include "utils/tuplesort.h"
 #include "utils/datum.h"
 
+#include "pg_k2pg_utils.h"
+
 
 static void select_current_set(AggState *aggstate, int setno, bool is_hash);
 static void initialize_phase(AggState *aggstate, int newphase);
@@ -1522,19 +1528,138 @@ lookup_hash_entries(AggState *aggstate)
 	}
 }
 
+/*
+ * Checks whether a single aggregate can be computed by the K2 connector. The
+ * partial results it returns are combined by the code in agg_retrieve_direct(),
+ * so only the aggregates handled there are accepted:
+ *
+ *   COUNT(*), COUNT(col), COUNT(const)
+ *   SUM(col) over 2 and 4 byte integers and floats
+ *   MIN(col)/MAX(col) over integers and floats
+ *   AVG(col) over 2 and 4 byte integers
+ *
+ * The argument must be a plain column of the scanned relation.
+ */
+static bool
+k2_aggref_pushdown_supported(Aggref *aggref, PlanState *scan_ps)
+{
+	char	   *func_name;
+	Expr	   *arg;
+	Var		   *var;
+	TargetEntry *scan_tle;
+	Oid			argtype;
+
+	/* Only built-in aggregates without any modifiers. */
+	if (aggref->aggfnoid >= FirstNormalObjectId ||
+		aggref->aggkind != AGGKIND_NORMAL ||
+		aggref->aggorder != NIL ||
+		aggref->aggdistinct != NIL ||
+		aggref->aggfilter != NULL ||
+		aggref->aggvariadic ||
+		aggref->aggdirectargs != NIL)
+		return false;
+
+	func_name = get_func_name(aggref->aggfnoid);
+	if (func_name == NULL)
+		return false;
+
+	if (aggref->aggstar)
+		return strcmp(func_name, "count") == 0;
+
+	if (list_length(aggref->args) != 1)
+		return false;
+	arg = linitial_node(TargetEntry, aggref->args)->expr;
+
+	if (IsA(arg, Const))
+	{
+		Const *const_node = castNode(Const, arg);
+
+		/* COUNT of a constant is the number of rows (or zero for NULL). */
+		return strcmp(func_name, "count") == 0 &&
+			(const_node->constisnull || const_node->constbyval);
+	}
+
+	if (!IsA(arg, Var))
+		return false;
+
+	/*
+	 * The FDW refers to the column by its original attribute number, so make
+	 * sure that the scan output the aggregate reads is that very column and
+	 * not an expression computed by the scan projection.
+	 */
+	var = castNode(Var, arg);
+	scan_tle = get_tle_by_resno(scan_ps->plan->targetlist, var->varattno);
+	if (scan_tle == NULL || !IsA(scan_tle->expr, Var) ||
+		castNode(Var, scan_tle->expr)->varattno != var->varoattno ||
+		var->varoattno <= 0)
+		return false;
+
+	argtype = exprType((Node *) arg);
+	if (strcmp(func_name, "count") == 0)
+		return true;
+	if (strcmp(func_name, "sum") == 0)
+		return argtype == INT2OID || argtype == INT4OID ||
+			argtype == FLOAT4OID || argtype == FLOAT8OID;
+	if (strcmp(func_name, "min") == 0 || strcmp(func_name, "max") == 0)
+		return argtype == INT2OID || argtype == INT4OID || argtype == INT8OID ||
+			argtype == FLOAT4OID || argtype == FLOAT8OID;
+	if (strcmp(func_name, "avg") == 0)
+		return (argtype == INT2OID || argtype == INT4OID) &&
+			aggref->aggtranstype == INT8ARRAYOID;
+
+	return false;
+}
+
 /*
  * Evaluates whether plan supports pushdowns of aggregates to K2 platform, and sets
  * k2_pushdown_supported accordingly in AggState.
+ *
+ * SKV itself has no aggregation support yet, so pushed down aggregates are computed
+ * by the K2 connector right where the scan results arrive, per page and per
+ * concurrent sub-scan, and only the combined partial results are returned to PG.
  */
 static void
 k2_agg_pushdown_supported(AggState *aggstate)
 {
-	// disable aggregation pushdown for now
-	// TODO: re-enable this once K2 platform supports aggregations
-	// such as min, max, sum, count, and so on,
-	//
-	//    https://github.com/futurewei-cloud/chogori-platform/issues/139
+	Agg		   *node = (Agg *) aggstate->ss.ps.plan;
+	PlanState  *outer_ps = outerPlanState(aggstate);
+	ForeignScanState *scan_state;
+	ListCell   *lc;
+
 	aggstate->k2_pushdown_supported = false;
+
+	/* Only plain aggregation, i.e. no GROUP BY or grouping sets. */
+	if (!IsK2PgEnabled() ||
+		node->aggstrategy != AGG_PLAIN ||
+		node->groupingSets != NIL ||
+		aggstate->aggsplit != AGGSPLIT_SIMPLE ||
+		aggstate->aggs == NIL)
+		return;
+
+	/* The aggregate input has to come straight from a scan of a K2 table. */
+	if (outer_ps == NULL || !IsA(outer_ps, ForeignScanState))
+		return;
+	scan_state = castNode(ForeignScanState, outer_ps);
+	if (scan_state->ss.ss_currentRelation == NULL ||
+		!IsK2PgRelation(scan_state->ss.ss_currentRelation))
+		return;
+
+	/*
+	 * The FDW keeps all scan clauses as local quals, and those would have to be
+	 * evaluated before aggregating, which PG can't do once the rows stay in K2.
+	 */
+	if (scan_state->ss.ps.qual != NULL)
+		return;
+
+	foreach(lc, aggstate->aggs)
+	{
+		AggrefExprState *aggrefstate = (AggrefExprState *) lfirst(lc);
+
+		if (!k2_aggref_pushdown_supported(aggrefstate->aggref, outer_ps))
+			return;
+	}
+
+	aggstate->k2_pushdown_supported = true;
 }
 
 /*
@@ -1830,6 +1955,47 @@ agg_retrieve_direct(AggState *aggstate)
 						pergroupstate->transValue += value;
 						MemoryContextSwitchTo(oldContext);
 					}
+					else if (strcmp(func_name, "avg") == 0)
+					{
+						/*
+						 * AVG results are {count, sum} int8 arrays, the same as the
+						 * transition value, so add them up in place the way
+						 * int4_avg_combine does.
+						 */
+						if (!isnull)
+						{
+							int64 *state = (int64 *) ARR_DATA_PTR(
+								DatumGetArrayTypeP(pergroupstate->transValue));
+							int64 *partial = (int64 *) ARR_DATA_PTR(DatumGetArrayTypeP(value));
+
+							state[0] += partial[0];
+							state[1] += partial[1];
+						}
+					}
+					else if (strcmp(func_name, "sum") == 0 &&
+							 aggref->aggtranstype == INT8OID)
+					{
+						/*
+						 * SUM over 2 and 4 byte integers returns an int8 partial,
+						 * the same as the transition value, which int2_sum and
+						 * int4_sum would truncate to their argument type. Add the
+						 * partials up as int8 instead.
+						 */
+						if (!isnull)
+						{
+							int64 sum = DatumGetInt64(value);
+
+							if (!pergroupstate->transValueIsNull &&
+								pg_add_s64_overflow(DatumGetInt64(pergroupstate->transValue),
+													sum, &sum))
+								ereport(ERROR,
+										(errcode(ERRCODE_NUMERIC_VALUE_OUT_OF_RANGE),
+										 errmsg("bigint out of range")));
+							pergroupstate->transValue = Int64GetDatum(sum);
+							pergroupstate->transValueIsNull = false;
+							pergroupstate->noTransValue = false;
+						}
+					}
 					else
 					{
 						/* Set slot result as argument, then advance the transition function. */
@@ -21,11 +21,26 @@
 
 #include "postgres.h"
 
+#include "access/genam.h"
+#include "access/relscan.h"
+#include "access/stratnum.h"
+#include "catalog/catalog.h"
 #include "executor/execdebug.h"
+#include "executor/instrument.h"
+#include "executor/nodeIndexscan.h"
 #include "executor/nodeNestloop.h"
 #include "miscadmin.h"
+#include "nodes/nodeFuncs.h"
+#include "utils/array.h"
+#include "utils/lsyscache.h"
 #include "utils/memutils.h"
 
+#include "pg_k2pg_utils.h"
+
+static bool k2_nestloop_batch_supported(NestLoopState *nlstate);
+static TupleTableSlot *k2_nestloop_next_outer(NestLoopState *node);
+static TupleTableSlot *k2_nestloop_next_inner(NestLoopState *node);
+
 
 /* ----------------------------------------------------------------
  *		ExecNestLoop(node)
@@ -106,7 +121,10 @@ ExecNestLoop(PlanState *pstate)
 		if (node->nl_NeedNewOuter)
 		{
 			ENL1_printf("getting new outer tuple");
-			outerTupleSlot = ExecProcNode(outerPlan);
+			if (node->k2pg_batch_size > 0)
+				outerTupleSlot = k2_nestloop_next_outer(node);
+			else
+				outerTupleSlot = ExecProcNode(outerPlan);
 
 			/*
 			 * if there are no more outer tuples, then the join is complete..
@@ -146,10 +164,14 @@ ExecNestLoop(PlanState *pstate)
 			}
 
 			/*
-			 * now rescan the inner plan
+			 * now rescan the inner plan, or go back to the first inner tuple
+			 * of the batch
 			 */
 			ENL1_printf("rescanning inner plan");
-			ExecReScan(innerPlan);
+			if (node->k2pg_batch_size > 0 && !node->k2pg_batch_rescan)
+				node->k2pg_batch_inner_pos = 0;
+			else
+				ExecReScan(innerPlan);
 		}
 
 		/*
@@ -157,7 +179,10 @@ ExecNestLoop(PlanState *pstate)
 		 */
 		ENL1_printf("getting new inner tuple");
 
-		innerTupleSlot = ExecProcNode(innerPlan);
+		if (node->k2pg_batch_size > 0 && !node->k2pg_batch_rescan)
+			innerTupleSlot = k2_nestloop_next_inner(node);
+		else
+			innerTupleSlot = ExecProcNode(innerPlan);
 		econtext->ecxt_innertuple = innerTupleSlot;
 
 		if (TupIsNull(innerTupleSlot))
@@ -339,6 +364,26 @@ ExecInitNestLoop(NestLoop *node, EState *estate, int eflags)
 				 (int) node->join.jointype);
 	}
 
+	/*
+	 * K2PG: look up the join keys of a batch of outer tuples in the inner K2
+	 * index at once, instead of a round trip to K2 for every outer tuple.
+	 */
+	nlstate->k2pg_batch_size = 0;
+	if (k2_nestloop_batch_supported(nlstate))
+	{
+		TupleDesc	outer_desc = ExecGetResultType(outerPlanState(nlstate));
+		int			i;
+
+		nlstate->k2pg_batch_size = k2pg_nestloop_batch_size;
+		nlstate->k2pg_batch_outer = (TupleTableSlot **)
+			palloc(nlstate->k2pg_batch_size * sizeof(TupleTableSlot *));
+		for (i = 0; i < nlstate->k2pg_batch_size; i++)
+			nlstate->k2pg_batch_outer[i] = MakeSingleTupleTableSlot(outer_desc);
+		nlstate->k2pg_batch_context = AllocSetContextCreate(CurrentMemoryContext,
+															"K2PG nestloop batch",
+															ALLOCSET_DEFAULT_SIZES);
+	}
+
 	/*
 	 * finally, wipe the current outer tuple clean.
 	 */
@@ -379,6 +424,15 @@ ExecEndNestLoop(NestLoopState *node)
 	ExecEndNode(outerPlanState(node));
 	ExecEndNode(innerPlanState(node));
 
+	if (node->k2pg_batch_size > 0)
+	{
+		int			i;
+
+		for (i = 0; i < node->k2pg_batch_size; i++)
+			ExecDropSingleTupleTableSlot(node->k2pg_batch_outer[i]);
+		MemoryContextDelete(node->k2pg_batch_context);
+	}
+
 	NL1_printf("ExecEndNestLoop: %s\n",
 			   "node processing ended");
 }
@@ -407,4 +461,344 @@ ExecReScanNestLoop(NestLoopState *node)
 
 	node->nl_NeedNewOuter = true;
 	node->nl_MatchedOuter = false;
+
+	/* drop the current batch, it is read again from the rescanned outer plan */
+	node->k2pg_batch_outer_count = 0;
+	node->k2pg_batch_outer_pos = 0;
+	node->k2pg_batch_outer_done = false;
+	node->k2pg_batch_inner_count = 0;
+	node->k2pg_batch_inner_pos = 0;
+	node->k2pg_batch_rescan = false;
+}
+
+/* ----------------------------------------------------------------
+ *		K2PG batched nested loop
+ *
+ *		Every rescan of an inner index scan is a round trip to K2.  When the
+ *		inner side is an index scan on a K2 table with equality conditions on
+ *		the join keys, we read a batch of outer tuples first and bind the join
+ *		keys of all of them as IN lists of one inner scan, which K2 runs as
+ *		concurrent point or prefix reads.  Every outer tuple is then joined
+ *		with the inner tuples that pass the inner index quals and filter for
+ *		it, which keeps the results the same as rescanning the inner side.
+ *		If the inner tuples of a batch don't fit in work_mem, its outer tuples
+ *		rescan the inner side one by one instead.
+ *
+ *		The inner index scan node is not run through ExecProcNode, so its
+ *		instrumentation is updated here: the scan of a batch is timed in the
+ *		loop of its first outer tuple, and every outer tuple counts as a loop
+ *		returning its matching inner tuples.
+ * ----------------------------------------------------------------
+ */
+
+static bool
+k2_expr_uses_params_walker(Node *node, Bitmapset *paramids)
+{
+	if (node == NULL)
+		return false;
+	if (IsA(node, Param))
+	{
+		Param	   *param = (Param *) node;
+
+		return param->paramkind == PARAM_EXEC && bms_is_member(param->paramid, paramids);
+	}
+	return expression_tree_walker(node, k2_expr_uses_params_walker, (void *) paramids);
+}
+
+/*
+ * Checks whether the join can be batched, and sets k2pg_batch_keys to the
+ * runtime keys of the inner index scan which depend on the outer tuple.
+ */
+static bool
+k2_nestloop_batch_supported(NestLoopState *nlstate)
+{
+	NestLoop   *nl = (NestLoop *) nlstate->js.ps.plan;
+	PlanState  *inner_ps = innerPlanState(nlstate);
+	IndexScanState *inner;
+	Relation	relation;
+	Bitmapset  *paramids = NULL;
+	ListCell   *lc;
+	int			i;
+
+	if (!IsK2PgEnabled() || k2pg_nestloop_batch_size <= 1 || nl->nestParams == NIL)
+		return false;
+
+	/* The inner side has to be a plain scan of a K2 index. */
+	if (!IsA(inner_ps, IndexScanState))
+		return false;
+	inner = castNode(IndexScanState, inner_ps);
+	relation = inner->ss.ss_currentRelation;
+	if (relation == NULL || !IsK2PgRelation(relation) || IsSystemRelation(relation) ||
+		inner->ss.ps.plan->parallel_aware ||
+		((IndexScan *) inner->ss.ps.plan)->indexorderby != NIL ||
+		inner->iss_NumRuntimeKeys == 0)
+		return false;
+
+	/* Row locks would be taken on the inner rows of all outer tuples. */
+	if (nlstate->js.ps.state->es_rowMarks != NIL)
+		return false;
+
+	foreach(lc, nl->nestParams)
+		paramids = bms_add_member(paramids, ((NestLoopParam *) lfirst(lc))->paramno);
+
+	for (i = 0; i < inner->iss_NumRuntimeKeys; i++)
+	{
+		IndexRuntimeKeyInfo *rtkey = &inner->iss_RuntimeKeys[i];
+
+		if (!k2_expr_uses_params_walker((Node *) rtkey->key_expr->expr, paramids))
+			continue;
+
+		/* Only plain equality keys can be turned into IN lists. */
+		if (rtkey->scan_key->sk_strategy != BTEqualStrategyNumber ||
+			(rtkey->scan_key->sk_flags & ~SK_ISNULL) != 0)
+		{
+			bms_free(nlstate->k2pg_batch_keys);
+			nlstate->k2pg_batch_keys = NULL;
+			return false;
+		}
+		nlstate->k2pg_batch_keys = bms_add_member(nlstate->k2pg_batch_keys, i);
+	}
+
+	return nlstate->k2pg_batch_keys != NULL;
+}
+
+/*
+ * Stores the values of the outer tuple in the PARAM_EXEC slots of the inner
+ * plan, like ExecNestLoop does for the current outer tuple.
+ */
+static void
+k2_nestloop_set_params(NestLoopState *node, TupleTableSlot *outerTupleSlot)
+{
+	NestLoop   *nl = (NestLoop *) node->js.ps.plan;
+	ExprContext *econtext = node->js.ps.ps_ExprContext;
+	ListCell   *lc;
+
+	foreach(lc, nl->nestParams)
+	{
+		NestLoopParam *nlp = (NestLoopParam *) lfirst(lc);
+		ParamExecData *prm = &(econtext->ecxt_param_exec_vals[nlp->paramno]);
+
+		prm->value = slot_getattr(outerTupleSlot,
+								  nlp->paramval->varattno,
+								  &(prm->isnull));
+	}
+}
+
+/*
+ * Reads the inner tuples which can join with any outer tuple of the batch,
+ * with one scan of the inner index.  Gives up and sets k2pg_batch_rescan if
+ * they take more than work_mem.
+ */
+static void
+k2_nestloop_scan_inner(NestLoopState *node)
+{
+	IndexScanState *inner = castNode(IndexScanState, innerPlanState(node));
+	EState	   *estate = node->js.ps.state;
+	ExprContext *keycontext = inner->iss_RuntimeContext;
+	int			nkeys = inner->iss_NumScanKeys;
+	ScanKey		keys;
+	IndexScanDesc scandesc;
+	Instrumentation *instr = inner->ss.ps.instrument;
+	HeapTuple	tuple;
+	int			capacity;
+	Size		size;
+	Size		max_size = (Size) work_mem * 1024L;
+	int			i;
+	int			j;
+
+	/* The keys which don't depend on the outer tuple are the same for the whole batch. */
+	ResetExprContext(keycontext);
+	k2_nestloop_set_params(node, node->k2pg_batch_outer[0]);
+	ExecIndexEvalRuntimeKeys(keycontext, inner->iss_RuntimeKeys, inner->iss_NumRuntimeKeys);
+	keys = (ScanKey) palloc(nkeys * sizeof(ScanKeyData));
+	memcpy(keys, inner->iss_ScanKeys, nkeys * sizeof(ScanKeyData));
+
+	/* The others get the IN list of their values for all outer tuples. */
+	j = -1;
+	while ((j = bms_next_member(node->k2pg_batch_keys, j)) >= 0)
+	{
+		IndexRuntimeKeyInfo *rtkey = &inner->iss_RuntimeKeys[j];
+		ScanKey		key = &keys[rtkey->scan_key - inner->iss_ScanKeys];
+		Oid			elemtype = exprType((Node *) rtkey->key_expr->expr);
+		int16		elmlen;
+		bool		elmbyval;
+		char		elmalign;
+		Datum	   *values = (Datum *) palloc(node->k2pg_batch_outer_count * sizeof(Datum));
+		int			nvalues = 0;
+
+		for (i = 0; i < node->k2pg_batch_outer_count; i++)
+		{
+			bool		isnull;
+			Datum		value;
+
+			k2_nestloop_set_params(node, node->k2pg_batch_outer[i]);
+			value = ExecEvalExpr(rtkey->key_expr, keycontext, &isnull);
+			/* the key operator is strict, so NULLs never join */
+			if (isnull)
+				continue;
+			if (rtkey->key_toastable)
+				value = PointerGetDatum(PG_DETOAST_DATUM(value));
+			values[nvalues++] = value;
+		}
+
+		if (nvalues == 0)
+		{
+			/* None of the outer tuples can join. */
+			return;
+		}
+
+		get_typlenbyvalalign(elemtype, &elmlen, &elmbyval, &elmalign);
+		key->sk_flags = SK_SEARCHARRAY;
+		key->sk_argument = PointerGetDatum(construct_array(values, nvalues, elemtype,
+														   elmlen, elmbyval, elmalign));
+	}
+
+	/*
+	 * All inner tuples of the batch are needed, a LIMIT above the join does
+	 * not apply to them, and their order does not matter since every outer
+	 * tuple is matched with all of them.
+	 */
+	node->k2pg_batch_exec_params = estate->k2pg_exec_params;
+	node->k2pg_batch_exec_params.limit_count = -1;
+	node->k2pg_batch_exec_params.limit_offset = 0;
+	node->k2pg_batch_exec_params.limit_use_default = true;
+	node->k2pg_batch_exec_params.rowmark = -1;
+	node->k2pg_batch_exec_params.allow_unordered = true;
+
+	if (instr)
+		InstrStartNode(instr);
+
+	scandesc = index_beginscan(inner->ss.ss_currentRelation,
+							   inner->iss_RelationDesc,
+							   estate->es_snapshot,
+							   nkeys, 0);
+	index_rescan(scandesc, keys, nkeys, NULL, 0);
+	scandesc->k2pg_exec_params = &node->k2pg_batch_exec_params;
+
+	capacity = node->k2pg_batch_outer_count;
+	size = capacity * sizeof(HeapTuple);
+	node->k2pg_batch_inner = (HeapTuple *) palloc(capacity * sizeof(HeapTuple));
+	while ((tuple = index_getnext(scandesc, ForwardScanDirection)) != NULL)
+	{
+		CHECK_FOR_INTERRUPTS();
+
+		size += HEAPTUPLESIZE + tuple->t_len;
+		if (node->k2pg_batch_inner_count == capacity)
+		{
+			size += capacity * sizeof(HeapTuple);
+			capacity *= 2;
+			node->k2pg_batch_inner = (HeapTuple *)
+				repalloc(node->k2pg_batch_inner, capacity * sizeof(HeapTuple));
+		}
+		if (size > max_size)
+		{
+			/* the caller frees what was read with the batch context */
+			node->k2pg_batch_inner = NULL;
+			node->k2pg_batch_inner_count = 0;
+			node->k2pg_batch_rescan = true;
+			break;
+		}
+		node->k2pg_batch_inner[node->k2pg_batch_inner_count++] = heap_copytuple(tuple);
+	}
+	index_endscan(scandesc);
+
+	if (instr)
+		InstrStopNode(instr, 0);
+}
+
+/*
+ * Returns the next outer tuple, reading the next batch and its inner tuples
+ * when the current batch is done.
+ */
+static TupleTableSlot *
+k2_nestloop_next_outer(NestLoopState *node)
+{
+	PlanState  *outerPlan = outerPlanState(node);
+	PlanState  *innerPlan = innerPlanState(node);
+	MemoryContext oldcontext;
+
+	/* end the loop of the previous outer tuple like ExecReScan does */
+	if (innerPlan->instrument)
+		InstrEndLoop(innerPlan->instrument);
+
+	if (node->k2pg_batch_outer_pos < node->k2pg_batch_outer_count)
+		return node->k2pg_batch_outer[node->k2pg_batch_outer_pos++];
+
+	MemoryContextReset(node->k2pg_batch_context);
+	node->k2pg_batch_outer_count = 0;
+	node->k2pg_batch_outer_pos = 0;
+	node->k2pg_batch_inner = NULL;
+	node->k2pg_batch_inner_count = 0;
+	node->k2pg_batch_inner_pos = 0;
+	node->k2pg_batch_rescan = false;
+
+	while (!node->k2pg_batch_outer_done &&
+		   node->k2pg_batch_outer_count < node->k2pg_batch_size)
+	{
+		TupleTableSlot *slot = ExecProcNode(outerPlan);
+
+		if (TupIsNull(slot))
+		{
+			node->k2pg_batch_outer_done = true;
+			break;
+		}
+		ExecCopySlot(node->k2pg_batch_outer[node->k2pg_batch_outer_count++], slot);
+	}
+
+	if (node->k2pg_batch_outer_count == 0)
+		return NULL;
+
+	oldcontext = MemoryContextSwitchTo(node->k2pg_batch_context);
+	k2_nestloop_scan_inner(node);
+	MemoryContextSwitchTo(oldcontext);
+	if (node->k2pg_batch_rescan)
+		MemoryContextReset(node->k2pg_batch_context);
+
+	return node->k2pg_batch_outer[node->k2pg_batch_outer_pos++];
+}
+
+/*
+ * Returns the next inner tuple of the batch which passes the inner index
+ * quals and filter for the current outer tuple, projected like the inner
+ * index scan does.  The PARAM_EXEC slots hold the current outer tuple.
+ */
+static TupleTableSlot *
+k2_nestloop_next_inner(NestLoopState *node)
+{
+	IndexScanState *inner = castNode(IndexScanState, innerPlanState(node));
+	ExprContext *econtext = inner->ss.ps.ps_ExprContext;
+	TupleTableSlot *slot = inner->ss.ss_ScanTupleSlot;
+	ExprState  *qual = inner->ss.ps.qual;
+	Instrumentation *instr = inner->ss.ps.instrument;
+	TupleTableSlot *result = NULL;
+
+	if (instr)
+		InstrStartNode(instr);
+
+	while (node->k2pg_batch_inner_pos < node->k2pg_batch_inner_count)
+	{
+		HeapTuple	tuple = node->k2pg_batch_inner[node->k2pg_batch_inner_pos++];
+
+		ResetExprContext(econtext);
+		ExecStoreTuple(tuple, slot, InvalidBuffer, false);
+		econtext->ecxt_scantuple = slot;
+
+		if (!ExecQual(inner->indexqualorig, econtext))
+			continue;
+		if (qual != NULL && !ExecQual(qual, econtext))
+		{
+			InstrCountFiltered1(inner, 1);
+			continue;
+		}
+
+		if (inner->ss.ps.ps_ProjInfo != NULL)
+			result = ExecProject(inner->ss.ps.ps_ProjInfo);
+		else
+			result = slot;
+		break;
+	}
+
+	if (instr)
+		InstrStopNode(instr, TupIsNull(result) ? 0.0 : 1.0);
+	return result;
 }
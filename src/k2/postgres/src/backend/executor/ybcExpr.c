@@ -36,6 +36,7 @@
 #include "miscadmin.h"
 #include "utils/syscache.h"
 #include "utils/builtins.h"
+#include "utils/fmgroids.h"
 
 #include "pg_k2pg_utils.h"
 #include "executor/ybcExpr.h"
@@ -82,3 +83,93 @@ K2PgExpr K2PgNewEvalExprCall(K2PgStatement k2pg_stmt,
 
 	return k2pg_expr;
 }
+
+const char *K2PgAssignOperatorName(Oid funcid) {
+	switch (funcid)
+	{
+		case F_INT2PL:
+		case F_INT4PL:
+		case F_INT8PL:
+		case F_INT84PL:
+		case F_FLOAT4PL:
+		case F_FLOAT8PL:
+			return "+";
+		case F_INT2MI:
+		case F_INT4MI:
+		case F_INT8MI:
+		case F_INT84MI:
+		case F_FLOAT4MI:
+		case F_FLOAT8MI:
+			return "-";
+		case F_INT2MUL:
+		case F_INT4MUL:
+		case F_INT8MUL:
+		case F_INT84MUL:
+		case F_FLOAT4MUL:
+		case F_FLOAT8MUL:
+			return "*";
+		case F_TEXTCAT:
+			return "||";
+		default:
+			return NULL;
+	}
+}
+
+K2PgExpr K2PgNewAssignExpr(K2PgStatement k2pg_stmt, Expr *expr) {
+	switch (nodeTag(expr))
+	{
+		case T_Const:
+		{
+			Const *const_expr = castNode(Const, expr);
+			return K2PgNewConstant(k2pg_stmt, const_expr->consttype, const_expr->constvalue, const_expr->constisnull);
+		}
+		case T_Var:
+		{
+			Var *var = castNode(Var, expr);
+			K2PgTypeAttrs type_attrs = { var->vartypmod };
+			return K2PgNewColumnRef(k2pg_stmt, var->varattno, var->vartype, &type_attrs);
+		}
+		case T_RelabelType:
+			return K2PgNewAssignExpr(k2pg_stmt, castNode(RelabelType, expr)->arg);
+		case T_FuncExpr:
+		case T_OpExpr:
+		{
+			List       *args = NIL;
+			ListCell   *lc = NULL;
+			Oid        funcid = InvalidOid;
+			Oid        result_type = InvalidOid;
+
+			if (IsA(expr, FuncExpr))
+			{
+				FuncExpr *func_expr = castNode(FuncExpr, expr);
+				args = func_expr->args;
+				funcid = func_expr->funcid;
+				result_type = func_expr->funcresulttype;
+			}
+			else
+			{
+				OpExpr *op_expr = castNode(OpExpr, expr);
+				args = op_expr->args;
+				funcid = op_expr->opfuncid;
+				result_type = op_expr->opresulttype;
+			}
+
+			const char *opname = K2PgAssignOperatorName(funcid);
+			if (opname == NULL)
+				elog(ERROR, "function %u cannot be evaluated by K2", funcid);
+
+			/* The result type tells K2 which range the computed value has to fit into */
+			K2PgExpr k2pg_expr = NULL;
+			const K2PgTypeEntity *type_ent = K2PgDataTypeFromOidMod(InvalidAttrNumber, result_type);
+			HandleK2PgStatus(PgGate_NewOperator(k2pg_stmt, opname, type_ent, &k2pg_expr));
+			foreach (lc, args)
+			{
+				HandleK2PgStatus(PgGate_OperatorAppendArg(k2pg_expr, K2PgNewAssignExpr(k2pg_stmt, (Expr *) lfirst(lc))));
+			}
+			return k2pg_expr;
+		}
+		default:
+			elog(ERROR, "unsupported expression type %d in pushed down assignment", (int) nodeTag(expr));
+	}
+	return NULL;
+}
@@ -480,6 +480,68 @@ Oid K2PgExecuteNonTxnInsert(Relation rel,
 	                                true /* is_single_row_txn */);
 }
 
+Oid K2PgExecuteBulkInsert(Relation rel,
+						  TupleDesc tupleDesc,
+						  HeapTuple tuple)
+{
+	/*
+	 * Catalog changes need the catalog version and cache invalidation
+	 * handling of the regular insert.
+	 */
+	if (IsCatalogRelation(rel))
+		return K2PgExecuteInsert(rel, tupleDesc, tuple);
+
+	Oid            dboid    = K2PgGetDatabaseOid(rel);
+	Oid            relid    = RelationGetRelid(rel);
+	AttrNumber     minattr  = FirstLowInvalidHeapAttributeNumber + 1;
+	int            natts    = RelationGetNumberOfAttributes(rel);
+	Bitmapset      *pkey    = GetK2PgTablePrimaryKey(rel);
+	K2PgAttrValueDescriptor *attrs =
+			(K2PgAttrValueDescriptor*)palloc((natts - minattr + 1) * sizeof(K2PgAttrValueDescriptor));
+	K2PgAttrValueDescriptor *next_attr = attrs;
+	uint64_t       tuple_id = 0;
+
+	/* Generate a new oid for this row if needed */
+	if (rel->rd_rel->relhasoids)
+	{
+		if (!OidIsValid(HeapTupleGetOid(tuple)))
+			HeapTupleSetOid(tuple, GetNewOid(rel));
+	}
+
+	for (AttrNumber attnum = minattr; attnum <= natts; attnum++)
+	{
+		/* Skip virtual (system) and dropped columns */
+		if (!IsRealK2PgColumn(rel, attnum))
+		{
+			continue;
+		}
+
+		next_attr->attr_num = attnum;
+		next_attr->type_entity = K2PgDataTypeFromOidMod(attnum, GetTypeId(attnum, tupleDesc));
+		next_attr->datum = heap_getattr(tuple, attnum, tupleDesc, &next_attr->is_null);
+
+		/* Check not-null constraint on primary key early */
+		if (next_attr->is_null && bms_is_member(attnum - minattr, pkey))
+		{
+			ereport(ERROR,
+			        (errcode(ERRCODE_NOT_NULL_VIOLATION), errmsg(
+					        "Missing/null value for primary key column")));
+		}
+		++next_attr;
+	}
+
+	/*
+	 * The row is serialized straight into its K2 record, the K2 PG RowId, if
+	 * any, is generated along with it.
+	 */
+	HandleK2PgStatus(PgGate_InsertRow(dboid, relid, attrs, next_attr - attrs,
+									  false /* upsert */, &tuple_id));
+	tuple->t_k2pgctid = (Datum)tuple_id;
+	pfree(attrs);
+
+	return HeapTupleGetOid(tuple);
+}
+
 Oid K2PgHeapInsert(TupleTableSlot *slot,
 				  HeapTuple tuple,
 				  EState *estate)
@@ -507,6 +569,59 @@ Oid K2PgHeapInsert(TupleTableSlot *slot,
 	}
 }
 
+/*
+ * Insert an index entry, set the same way as PrepareIndexWriteStmt() does for
+ * an insert, through PgGate_InsertRow().
+ */
+static void K2PgExecuteInsertIndexRow(Relation index,
+									  Datum *values,
+									  bool *isnull,
+									  Datum k2pgbasectid)
+{
+	TupleDesc tupdesc = RelationGetDescr(index);
+	int       natts   = RelationGetNumberOfAttributes(index);
+	K2PgAttrValueDescriptor *attrs =
+			(K2PgAttrValueDescriptor*)palloc((natts + 2) * sizeof(K2PgAttrValueDescriptor));
+	K2PgAttrValueDescriptor *next_attr = attrs;
+	bool has_null_attr = false;
+
+	for (AttrNumber attnum = 1; attnum <= natts; ++attnum)
+	{
+		next_attr->attr_num = attnum;
+		next_attr->type_entity = K2PgDataTypeFromOidMod(attnum, GetTypeId(attnum, tupdesc));
+		next_attr->datum = values[attnum - 1];
+		next_attr->is_null = isnull[attnum - 1];
+		has_null_attr = has_null_attr || next_attr->is_null;
+		++next_attr;
+	}
+
+	const bool unique_index = index->rd_index->indisunique;
+
+	/* See PrepareIndexWriteStmt() for the key suffix of unique indexes */
+	if (unique_index)
+	{
+		next_attr->attr_num = K2PgUniqueIdxKeySuffixAttributeNumber;
+		next_attr->type_entity = K2PgDataTypeFromOidMod(K2PgUniqueIdxKeySuffixAttributeNumber, InvalidOid);
+		next_attr->datum = k2pgbasectid;
+		next_attr->is_null = !has_null_attr;
+		++next_attr;
+	}
+
+	next_attr->attr_num = K2PgIdxBaseTupleIdAttributeNumber;
+	next_attr->type_entity = K2PgDataTypeFromOidMod(K2PgIdxBaseTupleIdAttributeNumber, InvalidOid);
+	next_attr->datum = k2pgbasectid;
+	next_attr->is_null = false;
+	++next_attr;
+
+	/*
+	 * For non-unique indexes the primary-key component (base tuple id) already
+	 * guarantees uniqueness, so no need to read and check it in K2 PG.
+	 */
+	HandleK2PgStatus(PgGate_InsertRow(K2PgGetDatabaseOid(index), RelationGetRelid(index), attrs,
+									  next_attr - attrs, !unique_index /* upsert */, NULL /* k2pgctid */));
+	pfree(attrs);
+}
+
 void K2PgExecuteInsertIndex(Relation index,
 						   Datum *values,
 						   bool *isnull,
@@ -520,14 +635,26 @@ void K2PgExecuteInsertIndex(Relation index,
 	Oid            relid    = RelationGetRelid(index);
 	K2PgStatement insert_stmt = NULL;
 
-	/* Create the INSERT request and add the values from the tuple. */
 	/*
-	 * TODO(jason): rename `is_single_row_txn` to something like
-	 * `non_distributed_txn` when closing issue #4906.
+	 * Outside of backfill, which needs its write time, the index entry of a
+	 * user relation is written without creating a statement for it, e.g. for
+	 * each row of a COPY.
+	 */
+	if (!is_backfill && !IsSystemRelation(index))
+	{
+		K2PgExecuteInsertIndexRow(index, values, isnull, k2pgctid);
+		return;
+	}
+
+	/*
+	 * Create the INSERT request and add the values from the tuple. Backfill
+	 * writes are part of the index build's transaction, so that they are
+	 * discarded if it aborts: only the single row statements in autocommit
+	 * mode run in a K2 transaction of their own.
 	 */
 	HandleK2PgStatus(PgGate_NewInsert(dboid,
 								  relid,
-								  is_backfill /* is_single_row_txn */,
+								  false /* is_single_row_txn */,
 								  &insert_stmt));
 
 	PrepareIndexWriteStmt(insert_stmt, index, values, isnull,
@@ -698,7 +825,6 @@ bool K2PgExecuteUpdate(Relation rel,
 
 		AttrNumber attnum = att_desc->attnum;
 		int32_t type_id = att_desc->atttypid;
-		int32_t type_mod = att_desc->atttypmod;
 
 		/* Skip virtual (system) and dropped columns */
 		if (!IsRealK2PgColumn(rel, attnum))
@@ -722,7 +848,7 @@ bool K2PgExecuteUpdate(Relation rel,
 			Expr *expr = copyObject(tle->expr);
 			K2PgExprInstantiateParams(expr, estate->es_param_list_info);
 
-			K2PgExpr k2pg_expr = K2PgNewEvalExprCall(update_stmt, expr, attnum, type_id, type_mod);
+			K2PgExpr k2pg_expr = K2PgNewAssignExpr(update_stmt, expr);
 
 			HandleK2PgStatus(PgGate_DmlAssignColumn(update_stmt, attnum, k2pg_expr));
 
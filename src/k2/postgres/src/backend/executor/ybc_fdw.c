@@ -51,6 +51,8 @@
 #include "optimizer/planmain.h"
 #include "optimizer/restrictinfo.h"
 #include "optimizer/var.h"
+#include "utils/array.h"
+#include "utils/builtins.h"
 #include "utils/memutils.h"
 #include "utils/rel.h"
 #include "utils/sampling.h"
@@ -151,6 +153,7 @@ typedef struct FDWOprCond
 
 typedef struct foreign_expr_cxt {
 	List *opr_conds;          /* opr conditions */
+	List *filter_exprs;       /* other conditions, only usable as filters */
 } foreign_expr_cxt;
 
 /*
@@ -174,8 +177,26 @@ typedef struct K2FdwExecState
 
 	K2PgExecParameters *exec_params; /* execution control parameters for K2 PG */
 	bool is_exec_done; /* Each statement should be executed exactly one time */
+
+	/* Pushed down aggregates: values fetched from K2, one per aggregate target sent to K2 */
+	int num_agg_targets;
+	Datum *agg_values;
+	bool *agg_isnull;
 } K2FdwExecState;
 
+/*
+ * Context for translating the remote conditions that are not simple column-constant
+ * comparisons into K2 filter expressions, see k2_build_filter_expr().
+ */
+typedef struct FDWFilterCxt
+{
+	K2FdwExecState *fdw_state;
+	ParamListInfo paramLI;
+} FDWFilterCxt;
+
+/* Longest IN list that is sent to K2 as a filter, longer ones are only evaluated by PG */
+#define K2_FDW_MAX_IN_LIST_VALUES 1024
+
 typedef struct K2FdwScanPlanData
 {
 	/* The relation where to read data from */
@@ -576,10 +597,8 @@ foreign_expr_walker(Node *node,
 				switch (b->boolop)
 				{
 					case AND_EXPR:
-						break;
-					case OR_EXPR:  // do not support OR and NOT for now
+					case OR_EXPR:
 					case NOT_EXPR:
-						return false;
 						break;
 					default:
 						elog(ERROR, "unrecognized boolop: %d", (int) b->boolop);
@@ -862,6 +881,8 @@ static void parse_conditions(List *exprs, ParamListInfo paramLI, foreign_expr_cx
             opr_cond->column_ref_first = ref_values.column_ref_first;
 
 			expr_cxt->opr_conds = lappend(expr_cxt->opr_conds, opr_cond);
+		} else {
+			expr_cxt->filter_exprs = lappend(expr_cxt->filter_exprs, expr);
 		}
 	}
 }
@@ -1097,6 +1118,26 @@ static List *findOprCondition(foreign_expr_cxt context, int attr_num) {
 	return result;
 }
 
+// Check for types we support for filter pushdown
+// We pushdown: basic scalar types (int, float, bool),
+// text and string types, and all PG internal types that map to K2 scalar types
+static bool k2_is_pushable_type(Oid typid) {
+	switch (typid) {
+		case CHAROID:
+		case NAMEOID:
+		case TEXTOID:
+		case VARCHAROID:
+		case CSTRINGOID:
+			return true;
+		default: {
+			const K2PgTypeEntity *type_ent = K2PgFindTypeEntity(typid);
+			return type_ent != NULL &&
+				type_ent->k2pg_type != K2SQL_DATA_TYPE_BINARY &&
+				type_ent->k2pg_type != K2SQL_DATA_TYPE_STRING;
+		}
+	}
+}
+
 K2PgExpr build_expr(K2FdwExecState *fdw_state, FDWOprCond *opr_cond) {
 	K2PgExpr opr_expr = NULL;
 	const K2PgTypeEntity *type_ent = K2PgFindTypeEntity(BYTEAOID);
@@ -1126,23 +1167,9 @@ K2PgExpr build_expr(K2FdwExecState *fdw_state, FDWOprCond *opr_cond) {
 			return opr_expr;
 	}
 
-    // Check for types we support for filter pushdown
-    // We pushdown: basic scalar types (int, float, bool),
-    // text and string types, and all PG internal types that map to K2 scalar types
-	const K2PgTypeEntity *ref_type = K2PgFindTypeEntity(opr_cond->ref->attr_typid);
-    switch (opr_cond->ref->attr_typid) {
-        case CHAROID:
-        case NAMEOID:
-        case TEXTOID:
-        case VARCHAROID:
-        case CSTRINGOID:
-            break;
-        default:
-            if (ref_type->k2pg_type == K2SQL_DATA_TYPE_BINARY || ref_type->k2pg_type == K2SQL_DATA_TYPE_STRING) {
-                return opr_expr;
-            }
-            break;
-    }
+	if (!k2_is_pushable_type(opr_cond->ref->attr_typid)) {
+		return opr_expr;
+	}
 
 	PgGate_NewOperator(fdw_state->handle,  opr_name, type_ent, &opr_expr);
 	K2PgTypeAttrs ref_type_attrs = { opr_cond->ref->atttypmod};
@@ -1153,6 +1180,348 @@ K2PgExpr build_expr(K2FdwExecState *fdw_state, FDWOprCond *opr_cond) {
 	return opr_expr;
 }
 
+/*
+ * Filter translation for the remote conditions that are not simple column-constant comparisons.
+ *
+ * PG still evaluates all scan clauses on the rows returned by K2, so a K2 filter only has to
+ * keep every row that PG would keep. This lets us drop untranslatable children of an AND, or
+ * send a LIKE pattern as a looser prefix match. Below an odd number of NOTs the filter is
+ * negated, so there a child can only be dropped from an OR, and only comparisons that K2
+ * evaluates exactly like PG are translated. NULL values of columns make comparisons false in
+ * K2 where PG yields NULL, which rejects the row either way, or keeps it in K2 only when negated.
+ */
+static K2PgExpr k2_build_filter_expr(FDWFilterCxt *cxt, Expr *node, bool negated);
+
+static Expr *k2_strip_relabel(Expr *node) {
+	while (node != NULL && IsA(node, RelabelType)) {
+		node = ((RelabelType *) node)->arg;
+	}
+	return node;
+}
+
+// the column of the scanned relation referenced by the given expression, if it can be used in a K2 filter
+static Var *k2_filter_var(Expr *node) {
+	node = k2_strip_relabel(node);
+	if (node == NULL || !IsA(node, Var)) {
+		return NULL;
+	}
+	Var *var = (Var *) node;
+	if (var->varlevelsup != 0 || var->varattno <= 0 || !k2_is_pushable_type(var->vartype)) {
+		return NULL;
+	}
+	return var;
+}
+
+// the value of a constant or an external parameter
+static FDWConstValue *k2_filter_value(FDWFilterCxt *cxt, Expr *node) {
+	FDWExprRefValues ref_values;
+	ref_values.column_refs = NIL;
+	ref_values.const_values = NIL;
+	ref_values.paramLI = cxt->paramLI;
+
+	node = k2_strip_relabel(node);
+	if (node == NULL) {
+		return NULL;
+	} else if (IsA(node, Const)) {
+		parse_const((Const *) node, &ref_values);
+	} else if (IsA(node, Param) && ((Param *) node)->paramkind == PARAM_EXTERN && cxt->paramLI != NULL) {
+		parse_param((Param *) node, &ref_values);
+	} else {
+		return NULL;
+	}
+	return (FDWConstValue *) linitial(ref_values.const_values);
+}
+
+// true if K2 compares the values of the given type exactly like PG does
+static bool k2_is_exact_comparison(Oid typid, bool equality) {
+	switch (K2PgFindTypeEntity(typid)->k2pg_type) {
+		case K2SQL_DATA_TYPE_INT8:
+		case K2SQL_DATA_TYPE_INT16:
+		case K2SQL_DATA_TYPE_INT32:
+		case K2SQL_DATA_TYPE_INT64:
+		case K2SQL_DATA_TYPE_BOOL:
+			return true;
+		case K2SQL_DATA_TYPE_STRING:
+			// K2 orders strings bytewise, not by collation
+			return equality;
+		default:
+			return false;
+	}
+}
+
+static K2PgExpr k2_new_filter_operator(FDWFilterCxt *cxt, const char *opr_name) {
+	K2PgExpr opr_expr = NULL;
+	HandleK2PgStatusWithOwner(PgGate_NewOperator(cxt->fdw_state->handle, opr_name, K2PgFindTypeEntity(BYTEAOID), &opr_expr),
+							  cxt->fdw_state->handle,
+							  cxt->fdw_state->stmt_owner);
+	return opr_expr;
+}
+
+static K2PgExpr k2_new_filter_column_ref(FDWFilterCxt *cxt, Var *var) {
+	K2PgTypeAttrs type_attrs = { var->vartypmod };
+	return K2PgNewColumnRef(cxt->fdw_state->handle, var->varattno, var->vartype, &type_attrs);
+}
+
+static K2PgExpr k2_build_filter_bool_expr(FDWFilterCxt *cxt, BoolExpr *node, bool negated) {
+	if (node->boolop == NOT_EXPR) {
+		K2PgExpr arg = k2_build_filter_expr(cxt, (Expr *) linitial(node->args), !negated);
+		if (arg == NULL) {
+			return NULL;
+		}
+		K2PgExpr not_expr = k2_new_filter_operator(cxt, "not");
+		PgGate_OperatorAppendArg(not_expr, arg);
+		return not_expr;
+	}
+
+	// a child can be left out if that makes the filter looser, i.e. for AND, or for OR when it is negated
+	bool is_and = node->boolop == AND_EXPR;
+	bool can_skip = is_and != negated;
+	List *args = NIL;
+	ListCell *lc;
+	foreach (lc, node->args) {
+		K2PgExpr arg = k2_build_filter_expr(cxt, (Expr *) lfirst(lc), negated);
+		if (arg != NULL) {
+			args = lappend(args, arg);
+		} else if (!can_skip) {
+			return NULL;
+		}
+	}
+
+	if (args == NIL) {
+		return NULL;
+	} else if (list_length(args) == 1) {
+		return (K2PgExpr) linitial(args);
+	}
+	K2PgExpr bool_expr = k2_new_filter_operator(cxt, is_and ? "and" : "or");
+	foreach (lc, args) {
+		PgGate_OperatorAppendArg(bool_expr, (K2PgExpr) lfirst(lc));
+	}
+	return bool_expr;
+}
+
+// col LIKE 'abc%' is a prefix match, any other pattern with a fixed prefix gives a looser one
+static K2PgExpr k2_build_filter_like_expr(FDWFilterCxt *cxt, Expr *left, Expr *right, bool negated) {
+	Var *var = k2_filter_var(left);
+	FDWConstValue *val = k2_filter_value(cxt, right);
+	if (var == NULL || val == NULL || val->is_null || K2PgFindTypeEntity(var->vartype)->k2pg_type != K2SQL_DATA_TYPE_STRING) {
+		return NULL;
+	}
+
+	text *pattern = DatumGetTextPP(val->value);
+	const char *patt = VARDATA_ANY(pattern);
+	int len = VARSIZE_ANY_EXHDR(pattern);
+	StringInfoData prefix;
+	initStringInfo(&prefix);
+	int pos = 0;
+	for (; pos < len && patt[pos] != '%' && patt[pos] != '_'; pos++) {
+		// backslash is the default LIKE escape character
+		if (patt[pos] == '\\' && ++pos == len) {
+			return NULL;
+		}
+		appendStringInfoChar(&prefix, patt[pos]);
+	}
+
+	bool exact_match = pos == len;
+	bool exact_prefix = pos == len - 1 && patt[pos] == '%';
+	if (prefix.len == 0 || (negated && !exact_match && !exact_prefix)) {
+		return NULL;
+	}
+
+	K2PgExpr opr_expr = k2_new_filter_operator(cxt, exact_match ? "=" : "starts_with");
+	PgGate_OperatorAppendArg(opr_expr, k2_new_filter_column_ref(cxt, var));
+	PgGate_OperatorAppendArg(opr_expr, K2PgNewConstant(cxt->fdw_state->handle, TEXTOID,
+		PointerGetDatum(cstring_to_text_with_len(prefix.data, prefix.len)), false));
+	return opr_expr;
+}
+
+// column op constant, column op column and column LIKE constant
+static K2PgExpr k2_build_filter_op_expr(FDWFilterCxt *cxt, OpExpr *node, bool negated) {
+	if (list_length(node->args) != 2) {
+		return NULL;
+	}
+	Expr *left = (Expr *) linitial(node->args);
+	Expr *right = (Expr *) lsecond(node->args);
+
+	RegProcedure opr_func = get_opcode(node->opno);
+	if (opr_func == F_TEXTLIKE || opr_func == F_NAMELIKE) {
+		return k2_build_filter_like_expr(cxt, left, right, negated);
+	}
+
+	// the column reference goes first, so switch the direction of the comparison if it is on the right
+	Var *var = k2_filter_var(left);
+	Expr *other = right;
+	bool column_ref_first = var != NULL;
+	if (var == NULL) {
+		var = k2_filter_var(right);
+		other = left;
+	}
+	if (var == NULL) {
+		return NULL;
+	}
+
+	char *opr_name = NULL;
+	bool equality = false;
+	switch (get_oprrest(node->opno)) {
+		case F_EQSEL: //  equal =
+			opr_name = "=";
+			equality = true;
+			break;
+		case F_NEQSEL: // not equal <>
+			opr_name = "<>";
+			equality = true;
+			break;
+		case F_SCALARLTSEL: // Less than <
+			opr_name = column_ref_first ? "<" : ">";
+			break;
+		case F_SCALARLESEL: // Less Equal <=
+			opr_name = column_ref_first ? "<=" : ">=";
+			break;
+		case F_SCALARGTSEL: // Greater than >
+			opr_name = column_ref_first ? ">" : "<";
+			break;
+		case F_SCALARGESEL: // Greater Equal >=
+			opr_name = column_ref_first ? ">=" : "<=";
+			break;
+		default:
+			return NULL;
+	}
+	if (negated && !k2_is_exact_comparison(var->vartype, equality)) {
+		return NULL;
+	}
+
+	K2PgExpr arg = NULL;
+	Var *other_var = k2_filter_var(other);
+	if (other_var != NULL) {
+		// K2 only compares two columns of the same type
+		if (other_var->varno != var->varno || other_var->vartype != var->vartype) {
+			return NULL;
+		}
+		arg = k2_new_filter_column_ref(cxt, other_var);
+	} else {
+		FDWConstValue *val = k2_filter_value(cxt, other);
+		if (val == NULL || val->is_null) {
+			return NULL;
+		}
+		arg = K2PgNewConstant(cxt->fdw_state->handle, val->atttypid, val->value, false);
+	}
+
+	K2PgExpr opr_expr = k2_new_filter_operator(cxt, opr_name);
+	PgGate_OperatorAppendArg(opr_expr, k2_new_filter_column_ref(cxt, var));
+	PgGate_OperatorAppendArg(opr_expr, arg);
+	return opr_expr;
+}
+
+// col = ANY(array) is sent as an IN list, col <> ALL(array) as NOT IN
+static K2PgExpr k2_build_filter_array_expr(FDWFilterCxt *cxt, ScalarArrayOpExpr *node, bool negated) {
+	if (list_length(node->args) != 2) {
+		return NULL;
+	}
+	Var *var = k2_filter_var((Expr *) linitial(node->args));
+	if (var == NULL) {
+		return NULL;
+	}
+
+	RegProcedure opr_rest = get_oprrest(node->opno);
+	bool not_in = false;
+	if (node->useOr && opr_rest == F_EQSEL) {
+		not_in = false;
+	} else if (!node->useOr && opr_rest == F_NEQSEL) {
+		not_in = true;
+	} else {
+		return NULL;
+	}
+	if (negated && !k2_is_exact_comparison(var->vartype, true)) {
+		return NULL;
+	}
+
+	FDWConstValue *val = k2_filter_value(cxt, (Expr *) lsecond(node->args));
+	if (val == NULL || val->is_null) {
+		return NULL;
+	}
+	ArrayType *array = DatumGetArrayTypeP(val->value);
+	Oid elem_type = ARR_ELEMTYPE(array);
+	if (!k2_is_pushable_type(elem_type)) {
+		return NULL;
+	}
+	int16 elem_len;
+	bool elem_byval;
+	char elem_align;
+	Datum *elem_values;
+	bool *elem_nulls;
+	int num_elems;
+	get_typlenbyvalalign(elem_type, &elem_len, &elem_byval, &elem_align);
+	deconstruct_array(array, elem_type, elem_len, elem_byval, elem_align, &elem_values, &elem_nulls, &num_elems);
+	if (num_elems == 0 || num_elems > K2_FDW_MAX_IN_LIST_VALUES) {
+		return NULL;
+	}
+
+	// NULLs in the list never match, K2 skips them
+	K2PgExpr in_expr = k2_new_filter_operator(cxt, "in");
+	PgGate_OperatorAppendArg(in_expr, k2_new_filter_column_ref(cxt, var));
+	bool has_values = false;
+	for (int i = 0; i < num_elems; i++) {
+		if (!elem_nulls[i]) {
+			PgGate_OperatorAppendArg(in_expr, K2PgNewConstant(cxt->fdw_state->handle, elem_type, elem_values[i], false));
+			has_values = true;
+		}
+	}
+	if (!has_values) {
+		return NULL;
+	}
+	if (!not_in) {
+		return in_expr;
+	}
+	K2PgExpr not_expr = k2_new_filter_operator(cxt, "not");
+	PgGate_OperatorAppendArg(not_expr, in_expr);
+	return not_expr;
+}
+
+static K2PgExpr k2_build_filter_null_test(FDWFilterCxt *cxt, NullTest *node) {
+	Var *var = node->argisrow ? NULL : k2_filter_var(node->arg);
+	if (var == NULL) {
+		return NULL;
+	}
+	K2PgExpr null_expr = k2_new_filter_operator(cxt, "is_null");
+	PgGate_OperatorAppendArg(null_expr, k2_new_filter_column_ref(cxt, var));
+	if (node->nulltesttype == IS_NULL) {
+		return null_expr;
+	}
+	K2PgExpr not_expr = k2_new_filter_operator(cxt, "not");
+	PgGate_OperatorAppendArg(not_expr, null_expr);
+	return not_expr;
+}
+
+/*
+ * Translates the given remote condition into a K2 filter, see above. Returns NULL if there is no
+ * such translation, the condition is then only evaluated by PG.
+ */
+static K2PgExpr k2_build_filter_expr(FDWFilterCxt *cxt, Expr *node, bool negated) {
+	switch (nodeTag(node)) {
+		case T_BoolExpr:
+			return k2_build_filter_bool_expr(cxt, (BoolExpr *) node, negated);
+		case T_OpExpr:
+			return k2_build_filter_op_expr(cxt, (OpExpr *) node, negated);
+		case T_ScalarArrayOpExpr:
+			return k2_build_filter_array_expr(cxt, (ScalarArrayOpExpr *) node, negated);
+		case T_NullTest:
+			return k2_build_filter_null_test(cxt, (NullTest *) node);
+		case T_Var: {
+			// a boolean column by itself
+			Var *var = k2_filter_var(node);
+			if (var == NULL || var->vartype != BOOLOID) {
+				return NULL;
+			}
+			K2PgExpr opr_expr = k2_new_filter_operator(cxt, "=");
+			PgGate_OperatorAppendArg(opr_expr, k2_new_filter_column_ref(cxt, var));
+			PgGate_OperatorAppendArg(opr_expr, K2PgNewConstant(cxt->fdw_state->handle, BOOLOID, BoolGetDatum(true), false));
+			return opr_expr;
+		}
+		default:
+			elog(DEBUG4, "FDW: unsupported filter expression: %s", nodeToString(node));
+			return NULL;
+	}
+}
+
 static void K2BindScanKeys(Relation relation,
 							K2FdwExecState *fdw_state,
 							K2FdwScanPlan scan_plan) {
@@ -1163,10 +1532,12 @@ static void K2BindScanKeys(Relation relation,
 
 	foreign_expr_cxt context;
 	context.opr_conds = NIL;
+	context.filter_exprs = NIL;
 
 	parse_conditions(fdw_state->remote_exprs, scan_plan->paramLI, &context);
-	elog(DEBUG4, "FDW: found %d opr_conds from %d remote exprs for relation: %d", list_length(context.opr_conds), list_length(fdw_state->remote_exprs), relation->rd_id);
-	if (list_length(context.opr_conds) == 0) {
+	elog(DEBUG4, "FDW: found %d opr_conds and %d filter exprs from %d remote exprs for relation: %d", list_length(context.opr_conds),
+		list_length(context.filter_exprs), list_length(fdw_state->remote_exprs), relation->rd_id);
+	if (list_length(context.opr_conds) == 0 && list_length(context.filter_exprs) == 0) {
 		elog(DEBUG4, "FDW: No Opr conditions are found to bind keys for relation: %d", relation->rd_id);
 		return;
 	}
@@ -1199,10 +1570,6 @@ static void K2BindScanKeys(Relation relation,
 		}
 	}
 
-	HandleK2PgStatusWithOwner(PgGate_DmlBindRangeConds(fdw_state->handle, range_conds),
-														fdw_state->handle,
-														fdw_state->stmt_owner);
-
 	K2PgExpr where_conds = NULL;
 	// Top level should be an "AND" node
 	PgGate_NewOperator(fdw_state->handle,  "and", type_ent, &where_conds);
@@ -1223,6 +1590,31 @@ static void K2BindScanKeys(Relation relation,
 			}
 		}
 	}
+	// bind the other conditions as filters, each one on its own
+	FDWFilterCxt filter_cxt;
+	filter_cxt.fdw_state = fdw_state;
+	filter_cxt.paramLI = scan_plan->paramLI;
+	ListCell *lc = NULL;
+	foreach (lc, context.filter_exprs) {
+		Expr *expr = (Expr *) lfirst(lc);
+		K2PgExpr arg = k2_build_filter_expr(&filter_cxt, expr, false);
+		if (arg == NULL) {
+			continue;
+		}
+		// key = ANY(array) is a list of keys, pggate reads them with point or prefix scans instead of filtering
+		if (IsA(expr, ScalarArrayOpExpr) && ((ScalarArrayOpExpr *) expr)->useOr) {
+			Var *var = k2_filter_var((Expr *) linitial(((ScalarArrayOpExpr *) expr)->args));
+			if (var != NULL && bms_is_member(K2PgAttnumToBmsIndex(relation, var->varattno), scan_plan->sk_cols)) {
+				PgGate_OperatorAppendArg(range_conds, arg);
+				continue;
+			}
+		}
+		PgGate_OperatorAppendArg(where_conds, arg);
+	}
+
+	HandleK2PgStatusWithOwner(PgGate_DmlBindRangeConds(fdw_state->handle, range_conds),
+														fdw_state->handle,
+														fdw_state->stmt_owner);
 
 	HandleK2PgStatusWithOwner(PgGate_DmlBindWhereConds(fdw_state->handle, where_conds),
 														fdw_state->handle,
@@ -1242,15 +1634,32 @@ k2GetForeignRelSize(PlannerInfo *root,
 
 	fdw_plan = (K2FdwPlanState *) palloc0(sizeof(K2FdwPlanState));
 
-	/* Set the estimate for the total number of rows (tuples) in this table. */
-	baserel->tuples = K2PG_DEFAULT_NUM_ROWS;
-
 	/*
-	 * Initialize the estimate for the number of rows returned by this query.
-	 * This does not yet take into account the restriction clauses, but it will
-	 * be updated later by camIndexCostEstimate once it inspects the clauses.
+	 * Set the estimate for the total number of rows (tuples) in this table.
+	 * The planner has already loaded pg_class.reltuples into baserel->tuples,
+	 * which is only set once the table has been analyzed.
 	 */
-	baserel->rows = baserel->tuples;
+	if (baserel->tuples <= 0)
+	{
+		baserel->tuples = K2PG_DEFAULT_NUM_ROWS;
+
+		/*
+		 * Initialize the estimate for the number of rows returned by this query.
+		 * This does not yet take into account the restriction clauses, but it will
+		 * be updated later by camIndexCostEstimate once it inspects the clauses.
+		 */
+		baserel->rows = baserel->tuples;
+	}
+	else
+	{
+		/* With stats, estimate the restriction clauses the regular way */
+		baserel->rows = clamp_row_est(baserel->tuples *
+									  clauselist_selectivity(root,
+															 baserel->baserestrictinfo,
+															 0,
+															 JOIN_INNER,
+															 NULL));
+	}
 
 	baserel->fdw_private = (void *) fdw_plan;
 	fdw_plan->remote_conds = NIL;
@@ -1296,7 +1705,11 @@ k2GetForeignPaths(PlannerInfo *root,
 	                false /* is_uncovered_idx_scan */,
 	                &startup_cost, &total_cost);
 
-	/* Create a ForeignPath node and it as the scan path */
+	/*
+	 * Create a ForeignPath node and it as the scan path. It has no pathkeys, so
+	 * that K2 may split it into unordered sub-scans. The scans in primary key
+	 * order, forward and backward, are the primary key index paths below.
+	 */
 	add_path(baserel,
 	         (Path *) create_foreignscan_path(root,
 	                                          baserel,
@@ -1517,6 +1930,46 @@ k2BeginForeignScan(ForeignScanState *node, int eflags)
 														k2pg_state->stmt_owner);
 }
 
+/*
+ * Append the targets for a pushed down AVG over an integer column: K2 returns the
+ * COUNT and the SUM of the column, which k2FetchAggregates() turns into the
+ * {count, sum} transition value of AVG.
+ */
+static void
+k2AppendAvgTargets(K2FdwExecState *k2pg_state, TupleDesc tupdesc, Aggref *aggref)
+{
+	static const char *const avg_parts[] = {"count", "sum"};
+	const K2PgTypeEntity *type_entity = K2PgFindTypeEntity(INT8OID);
+	/* Original attribute number, as projection is disabled for pushed down aggregates */
+	int attno = castNode(Var, linitial_node(TargetEntry, aggref->args)->expr)->varoattno;
+	Form_pg_attribute attr = TupleDescAttr(tupdesc, attno - 1);
+	K2PgTypeAttrs type_attrs = {attr->atttypmod};
+
+	for (int i = 0; i < lengthof(avg_parts); i++)
+	{
+		K2PgExpr op_handle;
+		HandleK2PgStatusWithOwner(PgGate_NewOperator(k2pg_state->handle,
+												 avg_parts[i],
+												 type_entity,
+												 &op_handle),
+								k2pg_state->handle,
+								k2pg_state->stmt_owner);
+
+		K2PgExpr arg = K2PgNewColumnRef(k2pg_state->handle,
+										attno,
+										attr->atttypid,
+										&type_attrs);
+		HandleK2PgStatusWithOwner(PgGate_OperatorAppendArg(op_handle, arg),
+								k2pg_state->handle,
+								k2pg_state->stmt_owner);
+		HandleK2PgStatusWithOwner(PgGate_DmlAppendTarget(k2pg_state->handle,
+													 op_handle),
+								k2pg_state->handle,
+								k2pg_state->stmt_owner);
+		k2pg_state->num_agg_targets++;
+	}
+}
+
 /*
  * Setup the scan targets (either columns or aggregates).
  */
@@ -1603,6 +2056,7 @@ k2SetupScanTargets(ForeignScanState *node)
 	else
 	{
 		/* Set aggregate scan targets. */
+		k2pg_state->num_agg_targets = 0;
 		foreach(lc, node->k2pg_fdw_aggs)
 		{
 			Aggref *aggref = lfirst_node(Aggref, lc);
@@ -1611,6 +2065,13 @@ k2SetupScanTargets(ForeignScanState *node)
 			K2PgExpr op_handle;
 			const K2PgTypeEntity *type_entity;
 
+			/* AVG is sent to K2 as a COUNT and a SUM of its argument, see k2FetchAggregates() */
+			if (strcmp(func_name, "avg") == 0)
+			{
+				k2AppendAvgTargets(k2pg_state, tupdesc, aggref);
+				continue;
+			}
+
 			/* Get type entity for the operator from the aggref. */
 			type_entity = K2PgFindTypeEntity(aggref->aggtranstype);
 
@@ -1692,7 +2153,10 @@ k2SetupScanTargets(ForeignScanState *node)
 														 op_handle),
 														 k2pg_state->handle,
 														 k2pg_state->stmt_owner);
+			k2pg_state->num_agg_targets++;
 		}
+		k2pg_state->agg_values = palloc0(k2pg_state->num_agg_targets * sizeof(Datum));
+		k2pg_state->agg_isnull = palloc0(k2pg_state->num_agg_targets * sizeof(bool));
 
 		/*
 		 * Setup the scan slot based on new tuple descriptor for the given targets. This is a dummy
@@ -1706,6 +2170,61 @@ k2SetupScanTargets(ForeignScanState *node)
 	MemoryContextSwitchTo(oldcontext);
 }
 
+/*
+ * Fetch one row of pushed down aggregate results into the (virtual) scan slot,
+ * one value per aggregate.
+ */
+static bool
+k2FetchAggregates(ForeignScanState *node, TupleTableSlot *slot)
+{
+	K2FdwExecState *k2pg_state = (K2FdwExecState *) node->fdw_state;
+	bool has_data = false;
+	int target = 0;
+	int attno = 0;
+	ListCell *lc;
+
+	HandleK2PgStatusWithOwner(PgGate_DmlFetch(k2pg_state->handle,
+										  k2pg_state->num_agg_targets,
+										  (uint64_t *) k2pg_state->agg_values,
+										  k2pg_state->agg_isnull,
+										  NULL /* syscols */,
+										  &has_data),
+							k2pg_state->handle,
+							k2pg_state->stmt_owner);
+	if (!has_data)
+		return false;
+
+	foreach(lc, node->k2pg_fdw_aggs)
+	{
+		Aggref *aggref = lfirst_node(Aggref, lc);
+
+		if (strcmp(get_func_name(aggref->aggfnoid), "avg") == 0)
+		{
+			/* Build the {count, sum} int8 array. The array lives until the next tuple is read. */
+			Datum parts[2];
+			MemoryContext oldcontext =
+				MemoryContextSwitchTo(node->ss.ps.ps_ExprContext->ecxt_per_tuple_memory);
+
+			parts[0] = k2pg_state->agg_isnull[target] ? Int64GetDatum(0) : k2pg_state->agg_values[target];
+			parts[1] = k2pg_state->agg_isnull[target + 1] ? Int64GetDatum(0) : k2pg_state->agg_values[target + 1];
+			slot->tts_values[attno] = PointerGetDatum(construct_array(parts, 2, INT8OID,
+																	 sizeof(int64), FLOAT8PASSBYVAL, 'd'));
+			slot->tts_isnull[attno] = false;
+			MemoryContextSwitchTo(oldcontext);
+			target += 2;
+		}
+		else
+		{
+			slot->tts_values[attno] = k2pg_state->agg_values[target];
+			slot->tts_isnull[attno] = k2pg_state->agg_isnull[target];
+			target++;
+		}
+		attno++;
+	}
+
+	return true;
+}
+
 /*
  * k2IterateForeignScan
  *		Read next record from the data file and store it into the
@@ -1731,7 +2250,14 @@ k2IterateForeignScan(ForeignScanState *node)
 		K2BindScanKeys(relation, k2pg_state, &scan_plan);
 
 		k2SetupScanTargets(node);
-		HandleK2PgStatusWithOwner(PgGate_ExecSelect(k2pg_state->handle, k2pg_state->exec_params),
+
+		/*
+		 * Foreign scans don't advertise any sort order, so K2 is free to return the rows
+		 * in any order, e.g. from several concurrent sub-scans.
+		 */
+		K2PgExecParameters exec_params = *k2pg_state->exec_params;
+		exec_params.allow_unordered = true;
+		HandleK2PgStatusWithOwner(PgGate_ExecSelect(k2pg_state->handle, &exec_params),
 								k2pg_state->handle,
 								k2pg_state->stmt_owner);
 		k2pg_state->is_exec_done = true;
@@ -1741,6 +2267,20 @@ k2IterateForeignScan(ForeignScanState *node)
 	slot = node->ss.ss_ScanTupleSlot;
 	ExecClearTuple(slot);
 
+	if (node->k2pg_fdw_aggs != NIL)
+	{
+		/*
+		 * Aggregate results stored in virtual slot (no tuple). Set the
+		 * number of valid values and mark as non-empty.
+		 */
+		if (k2FetchAggregates(node, slot))
+		{
+			slot->tts_nvalid = slot->tts_tupleDescriptor->natts;
+			slot->tts_isempty = false;
+		}
+		return slot;
+	}
+
 	TupleDesc       tupdesc = slot->tts_tupleDescriptor;
 	Datum           *values = slot->tts_values;
 	bool            *isnull = slot->tts_isnull;
@@ -1759,28 +2299,16 @@ k2IterateForeignScan(ForeignScanState *node)
 	/* If we have result(s) update the tuple slot. */
 	if (has_data)
 	{
-		if (node->k2pg_fdw_aggs == NIL)
+		HeapTuple tuple = heap_form_tuple(tupdesc, values, isnull);
+		if (syscols.oid != InvalidOid)
 		{
-			HeapTuple tuple = heap_form_tuple(tupdesc, values, isnull);
-			if (syscols.oid != InvalidOid)
-			{
-				HeapTupleSetOid(tuple, syscols.oid);
-			}
+			HeapTupleSetOid(tuple, syscols.oid);
+		}
 
-			slot = ExecStoreTuple(tuple, slot, InvalidBuffer, false);
+		slot = ExecStoreTuple(tuple, slot, InvalidBuffer, false);
 
-			/* Setup special columns in the slot */
-			slot->tts_k2pgctid = PointerGetDatum(syscols.k2pgctid);
-		}
-		else
-		{
-			/*
-			 * Aggregate results stored in virtual slot (no tuple). Set the
-			 * number of valid values and mark as non-empty.
-			 */
-			slot->tts_nvalid = tupdesc->natts;
-			slot->tts_isempty = false;
-		}
+		/* Setup special columns in the slot */
+		slot->tts_k2pgctid = PointerGetDatum(syscols.k2pgctid);
 	}
 
 	return slot;
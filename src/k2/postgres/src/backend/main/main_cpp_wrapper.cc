@@ -1,9 +1,11 @@
+#include <atomic>
 #include <filesystem>
 #include <string>
 #include <thread>
 
 #include "postmaster/postmaster_hook.h"
 #include "pggate/k2_includes.h"
+#include "pggate/k2_queue_defs.h"
 #include "pggate/k2_seastar_app.h"
 #include "pggate/k2_config.h"
 #include "pggate/k2_log_init.h"
@@ -20,14 +22,15 @@ namespace globals {
 std::thread k2thread;
 std::unique_ptr<k2pg::gate::Config> config;
 
-bool inited = false;
+std::atomic<bool> inited{false};
 }
 
 static void
 killK2App(int, unsigned long) {
     K2LOG_I(k2pg::log::main, "shutting down K2 app");
     if (!globals::inited) {
-        K2LOG_E(k2pg::log::main, "asked to shutdown but was never initialized");
+        // expected when the app is started on demand and this backend never issued a K2 request
+        K2LOG_I(k2pg::log::main, "asked to shutdown but was never initialized");
         return;
     }
     if (globals::k2thread.joinable()) {
@@ -125,8 +128,6 @@ void startK2App() {
         addArg("--prometheus_push_interval");
         addArg(std::to_string(prometheus_push_interval_ms/1000) + "s");
     }
-    k2pg::session::start();
-
     addNamedArg("cpo");
     addNamedArg("partition_request_timeout");
     addNamedArg("cpo_request_timeout");
@@ -175,6 +176,20 @@ void startK2App() {
     globals::inited = true;
 }
 
+// this is the hook called by PG when a new backend is created. Depending on config, the K2 app is started either
+// right away, or on demand by the first request this backend sends to K2
+void initK2App() {
+    // metrics are used by the PG-side code so they have to exist even before the K2 app is started
+    k2pg::session::start();
+    k2pg::gate::Config conf;
+    if (conf.get("lazy_client_start", true)) {
+        K2LOG_I(k2pg::log::main, "Deferring PG-K2 thread creation until first K2 request");
+        k2pg::gate::startK2AppFunc = startK2App;
+        return;
+    }
+    startK2App();
+}
+
 int PostgresServerProcessMain(int argc, char** argv);
 }
 
@@ -183,7 +198,7 @@ int main(int argc, char** argv) {
     k2::logging::Logger::procName = std::filesystem::path(argv[0]).filename().c_str();
 
     // setup the k2 hooks in pg backend so that we can initialize k2 when PG forks to handle a new client
-    k2_init_func = startK2App;
+    k2_init_func = initK2App;
     k2_kill_func = killK2App;
 
     auto code= PostgresServerProcessMain(argc, argv);
@@ -2876,7 +2876,7 @@ final_cost_mergejoin(PlannerInfo *root, MergePath *path,
 	 * would amount to optimizing for the case where the join method is
 	 * disabled, which doesn't seem like the way to bet.
 	 */
-	if (!enable_mergejoin || IsK2PgEnabled())
+	if (!enable_mergejoin)
 		startup_cost += disable_cost;
 
 	/*
@@ -195,7 +195,7 @@ add_paths_to_joinrel(PlannerInfo *root,
 	 * way of implementing a full outer join, so override enable_mergejoin if
 	 * it's a full join.
 	 */
-	if ((enable_mergejoin && !IsK2PgEnabled()) || jointype == JOIN_FULL)
+	if (enable_mergejoin || jointype == JOIN_FULL)
 		extra.mergeclause_list = select_mergejoin_clauses(root,
 														  joinrel,
 														  outerrel,
@@ -2791,7 +2791,10 @@ k2pg_single_row_update_or_delete_path(PlannerInfo *root,
 		primary_key_attrs = bms_add_member(primary_key_attrs, tle->resno);
 	}
 
-	/* Verify RETURNING columns are either primary key columns or UPDATE's SET columns. */
+	/*
+	 * Verify RETURNING columns are either primary key columns or UPDATE's SET columns.
+	 * SET columns computed by K2 are not known to the query layer, so they cannot be returned.
+	 */
 	if (list_length(path->returningLists) > 0)
 	{
 		foreach(values, linitial(path->returningLists))
@@ -2802,6 +2805,8 @@ k2pg_single_row_update_or_delete_path(PlannerInfo *root,
 			if (!bms_is_member(tle->resorigcol - attr_offset, update_attrs) &&
 				!bms_is_member(tle->resorigcol, primary_key_attrs))
 				return false;
+			if (bms_is_member(tle->resorigcol, pushdown_update_attrs))
+				return false;
 		}
 	}
 
@@ -275,6 +275,8 @@ get_relation_info(PlannerInfo *root, Oid relationObjectId, bool inhparent,
 			info->amcanparallel = amroutine->amcanparallel;
 			info->amhasgettuple = (amroutine->amgettuple != NULL);
 			info->amhasgetbitmap = (amroutine->amgetbitmap != NULL);
+			info->amcanmarkpos = (amroutine->ammarkpos != NULL &&
+								  amroutine->amrestrpos != NULL);
 			info->amcostestimate = amroutine->amcostestimate;
 			Assert(info->amcostestimate != NULL);
 
@@ -955,8 +957,8 @@ estimate_rel_size(Relation rel, int32 *attr_widths,
 	double		density;
 
 	/*
-	 * TODO We don't support forwarding size estimates to postgres yet.
-	 * Use whatever is in pg_class.
+	 * K2PG tables have no pages to count, use whatever ANALYZE stored in
+	 * pg_class (reltuples is zero if the table was never analyzed).
 	 */
 	if (IsK2PgEnabled())
 	{
@@ -28,6 +28,7 @@
 #include "access/htup_details.h"
 #include "catalog/pg_proc.h"
 #include "catalog/pg_type.h"
+#include "executor/ybcExpr.h"
 #include "nodes/makefuncs.h"
 #include "nodes/nodes.h"
 #include "nodes/plannodes.h"
@@ -229,16 +230,14 @@ void K2PgExprInstantiateParams(Expr* expr, ParamListInfo paramLI)
 /*
  * Check if the function/procedure can be executed by K2 Platform (i.e. if we can
  * pushdown its execution).
- * This is for future function support in K2 platform
+ * Only the basic arithmetic and concatenation operators are evaluated by pggate next to
+ * the write, until K2 platform implements the function support.
+ *
+ * See
+ *   https://github.com/futurewei-cloud/chogori-platform/issues/137
  */
 static bool IsSupportedK2FunctionId(Oid funcid, Form_pg_proc pg_proc) {
-	// Will add logic to enable the support to push down functions once
-	// K2 platform implements the function support.
-	//
-	// See
-	//   https://github.com/futurewei-cloud/chogori-platform/issues/137
-	//
-	return false;
+	return K2PgAssignOperatorName(funcid) != NULL;
 }
 
 static bool K2PgAnalyzeExpression(Expr *expr, AttrNumber target_attnum, bool *has_vars, bool *has_k2_unsupported_funcs) {
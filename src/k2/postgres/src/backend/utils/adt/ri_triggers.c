@@ -49,7 +49,9 @@
 #include "miscadmin.h"
 #include "storage/bufmgr.h"
 #include "utils/acl.h"
+#include "utils/array.h"
 #include "utils/builtins.h"
+#include "utils/datum.h"
 #include "utils/fmgroids.h"
 #include "utils/guc.h"
 #include "utils/inval.h"
@@ -83,13 +85,14 @@
 /* these queries are executed against the PK (referenced) table: */
 #define RI_PLAN_CHECK_LOOKUPPK			1
 #define RI_PLAN_CHECK_LOOKUPPK_FROM_PK	2
-#define RI_PLAN_LAST_ON_PK				RI_PLAN_CHECK_LOOKUPPK_FROM_PK
+#define RI_PLAN_K2PG_PREFETCHPK			3
+#define RI_PLAN_LAST_ON_PK				RI_PLAN_K2PG_PREFETCHPK
 /* these queries are executed against the FK (referencing) table: */
-#define RI_PLAN_CASCADE_DEL_DODELETE	3
-#define RI_PLAN_CASCADE_UPD_DOUPDATE	4
-#define RI_PLAN_RESTRICT_CHECKREF		5
-#define RI_PLAN_SETNULL_DOUPDATE		6
-#define RI_PLAN_SETDEFAULT_DOUPDATE		7
+#define RI_PLAN_CASCADE_DEL_DODELETE	4
+#define RI_PLAN_CASCADE_UPD_DOUPDATE	5
+#define RI_PLAN_RESTRICT_CHECKREF		6
+#define RI_PLAN_SETNULL_DOUPDATE		7
+#define RI_PLAN_SETDEFAULT_DOUPDATE		8
 
 #define MAX_QUOTED_NAME_LEN  (NAMEDATALEN*2+3)
 #define MAX_QUOTED_REL_NAME_LEN  (MAX_QUOTED_NAME_LEN*2)
@@ -182,6 +185,31 @@ typedef struct RI_CompareHashEntry
 } RI_CompareHashEntry;
 
 
+/* ----------
+ * K2PgRIPendingCheck
+ *
+ *	The FK values of the rows a statement inserted or updated in a K2PG
+ *	table, queued for one constraint until they are looked up in its PK
+ *	table in batches.
+ * ----------
+ */
+typedef struct K2PgRIPendingCheck
+{
+	Oid			constraint_id;	/* OID of pg_constraint entry */
+	int			nkeys;			/* number of key columns */
+	Oid			key_types[RI_MAX_NUMKEYS];	/* types of the FK columns */
+	int16		key_typlens[RI_MAX_NUMKEYS];
+	bool		key_typbyvals[RI_MAX_NUMKEYS];
+	char		key_typaligns[RI_MAX_NUMKEYS];
+	int			nrows;			/* number of queued rows */
+	int			maxrows;		/* allocated number of rows */
+	Datum	   *values;			/* nkeys values of every queued row */
+} K2PgRIPendingCheck;
+
+/* Rows of a statement past this many are checked one by one */
+#define K2PG_RI_MAX_PENDING_ROWS		(64 * 1024)
+
+
 /* ----------
  * Local data
  * ----------
@@ -191,6 +219,8 @@ static HTAB *ri_query_cache = NULL;
 static HTAB *ri_compare_cache = NULL;
 static dlist_head ri_constraint_cache_valid_list;
 static int	ri_constraint_cache_valid_count = 0;
+static MemoryContext k2pg_ri_pending_cxt = NULL;
+static List *k2pg_ri_pending_checks = NIL;
 
 
 /* ----------
@@ -248,8 +278,11 @@ static void ri_ReportViolation(const RI_ConstraintInfo *riinfo,
 				   HeapTuple violator, TupleDesc tupdesc,
 				   int queryno) pg_attribute_noreturn();
 
-static void BuildPgTupleId(Relation pk_rel, Relation fk_rel, Relation idx,
-					const RI_ConstraintInfo *riinfo, HeapTuple tup, void **data, int64_t *bytes);
+static void BuildPgTupleId(Relation pk_rel, Relation idx_rel,
+				const RI_ConstraintInfo *riinfo, TupleDesc tupdesc,
+				const int16 *attnums, HeapTuple tup,
+				void **value, int64_t *bytes);
+static void K2PgRIPrefetchConstraint(const K2PgRIPendingCheck *pending);
 
 
 /* ----------
@@ -416,9 +449,9 @@ RI_FKey_check(TriggerData *trigdata)
 
 		BuildPgTupleId(
 			pk_rel /* Primary table */,
-			fk_rel /* Reference table */,
 			ref_table_id == pk_rel->rd_id ? pk_rel : idx_rel /* Reference index */,
-			riinfo, new_row, (void **)&tuple_id, &tuple_id_size);
+			riinfo, RelationGetDescr(fk_rel), riinfo->fk_attnums,
+			new_row, (void **)&tuple_id, &tuple_id_size);
 		RelationClose(idx_rel);
 
 		if (tuple_id != NULL && PgGate_ForeignKeyReferenceExists(ref_table_id, tuple_id, tuple_id_size))
@@ -2690,9 +2723,14 @@ ri_PerformCheck(const RI_ConstraintInfo *riinfo,
 	return SPI_processed != 0;
 }
 
+/*
+ * Build the tuple id of the referenced row from the key values at the given
+ * attnums of tup, a row of the FK table or of a query on the PK table.
+ */
 static void
-BuildPgTupleId(Relation pk_rel, Relation fk_rel, Relation idx_rel,
-				const RI_ConstraintInfo *riinfo, HeapTuple tup,
+BuildPgTupleId(Relation pk_rel, Relation idx_rel,
+				const RI_ConstraintInfo *riinfo, TupleDesc tupdesc,
+				const int16 *attnums, HeapTuple tup,
 				void **value, int64_t *bytes)
 {
 	K2PgStatement k2pg_stmt;
@@ -2706,7 +2744,6 @@ BuildPgTupleId(Relation pk_rel, Relation fk_rel, Relation idx_rel,
 	HandleK2PgStatus(PgGate_NewSelect(
 		K2PgGetDatabaseOid(idx_rel), RelationGetRelid(idx_rel), &prepare_params, &k2pg_stmt));
 
-	TupleDesc	tupdesc = fk_rel->rd_att;
 	bool using_index = idx_rel->rd_index != NULL && !idx_rel->rd_index->indisprimary;
 
 	Bitmapset *pkey = GetFullK2PgTablePrimaryKey(idx_rel);
@@ -2721,7 +2758,7 @@ BuildPgTupleId(Relation pk_rel, Relation fk_rel, Relation idx_rel,
 	for (int i = 0; i < riinfo->nkeys; i++)
 	{
 		next_attr->attr_num = using_index ? (i + 1) : riinfo->pk_attnums[i];
-		const int fk_attnum = riinfo->fk_attnums[i];
+		const int fk_attnum = attnums[i];
 		const Oid type_id = TupleDescAttr(tupdesc, fk_attnum - 1)->atttypid;
 		next_attr->type_entity = K2PgDataTypeFromOidMod(fk_attnum, type_id);
 		next_attr->datum = heap_getattr(tup, fk_attnum, tupdesc, &next_attr->is_null);
@@ -3291,3 +3328,335 @@ RI_FKey_trigger_type(Oid tgfoid)
 
 	return RI_TRIGGER_NONE;
 }
+
+
+/* ----------
+ * K2PgRIQueueReferenceCheck -
+ *
+ *	Queue the FK values of a row inserted or updated in a K2PG table, for
+ *	K2PgRIPrefetchReferences to look up in the PK table together with those
+ *	of the other rows of the statement.  The row's check trigger still runs
+ *	afterwards, and finds the PK row in the foreign key reference cache.
+ * ----------
+ */
+void
+K2PgRIQueueReferenceCheck(Trigger *trigger, Relation fk_rel, HeapTuple new_row)
+{
+	const RI_ConstraintInfo *riinfo;
+	K2PgRIPendingCheck *pending = NULL;
+	TupleDesc	tupdesc = RelationGetDescr(fk_rel);
+	MemoryContext oldcxt;
+	ListCell   *lc;
+	Datum	   *values;
+	int			i;
+
+	if (k2pg_fk_check_batch_size <= 1 || !IsK2PgRelation(fk_rel))
+		return;
+
+	riinfo = ri_FetchConstraintInfo(trigger, fk_rel, false);
+
+	/*
+	 * Multi-column keys would be looked up as the cross product of their
+	 * column values, reading and locking PK rows no row references, so they
+	 * are left to the per-row checks.
+	 */
+	if (riinfo->nkeys > 1)
+		return;
+
+	/* Keys with nulls are not looked up in the PK table */
+	if (riinfo->confmatchtype == FKCONSTR_MATCH_PARTIAL ||
+		ri_NullCheck(tupdesc, new_row, riinfo, false) != RI_KEYS_NONE_NULL)
+		return;
+
+	foreach(lc, k2pg_ri_pending_checks)
+	{
+		K2PgRIPendingCheck *check = (K2PgRIPendingCheck *) lfirst(lc);
+
+		if (check->constraint_id == riinfo->constraint_id)
+		{
+			pending = check;
+			break;
+		}
+	}
+
+	if (k2pg_ri_pending_cxt == NULL)
+		k2pg_ri_pending_cxt = AllocSetContextCreate(TopTransactionContext,
+													"K2PG RI pending checks",
+													ALLOCSET_DEFAULT_SIZES);
+	oldcxt = MemoryContextSwitchTo(k2pg_ri_pending_cxt);
+
+	if (pending == NULL)
+	{
+		pending = (K2PgRIPendingCheck *) palloc0(sizeof(K2PgRIPendingCheck));
+		pending->constraint_id = riinfo->constraint_id;
+		pending->nkeys = riinfo->nkeys;
+		for (i = 0; i < riinfo->nkeys; i++)
+		{
+			Form_pg_attribute attr = TupleDescAttr(tupdesc, riinfo->fk_attnums[i] - 1);
+
+			pending->key_types[i] = attr->atttypid;
+			pending->key_typlens[i] = attr->attlen;
+			pending->key_typbyvals[i] = attr->attbyval;
+			pending->key_typaligns[i] = attr->attalign;
+		}
+		pending->maxrows = k2pg_fk_check_batch_size;
+		pending->values = (Datum *) palloc(pending->maxrows * pending->nkeys * sizeof(Datum));
+		k2pg_ri_pending_checks = lappend(k2pg_ri_pending_checks, pending);
+	}
+	else if (pending->nrows == pending->maxrows)
+	{
+		if (pending->maxrows >= K2PG_RI_MAX_PENDING_ROWS)
+		{
+			MemoryContextSwitchTo(oldcxt);
+			return;
+		}
+		pending->maxrows = Min(pending->maxrows * 2, K2PG_RI_MAX_PENDING_ROWS);
+		pending->values = (Datum *) repalloc(pending->values,
+											 pending->maxrows * pending->nkeys * sizeof(Datum));
+	}
+
+	values = pending->values + pending->nrows * pending->nkeys;
+	for (i = 0; i < riinfo->nkeys; i++)
+	{
+		bool		isnull;
+		Datum		value = heap_getattr(new_row, riinfo->fk_attnums[i], tupdesc, &isnull);
+
+		values[i] = datumCopy(value, pending->key_typbyvals[i], pending->key_typlens[i]);
+	}
+	pending->nrows++;
+
+	MemoryContextSwitchTo(oldcxt);
+}
+
+/* ----------
+ * K2PgRIPrefetchReferences -
+ *
+ *	Look up the queued FK values in their PK tables, k2pg_fk_check_batch_size
+ *	rows per read, and add the PK rows found to the foreign key reference
+ *	cache.  Values that are not found are left to the check triggers, which
+ *	look them up again and report the violation.
+ * ----------
+ */
+void
+K2PgRIPrefetchReferences(void)
+{
+	MemoryContext cxt = k2pg_ri_pending_cxt;
+	List	   *checks = k2pg_ri_pending_checks;
+	ListCell   *lc;
+
+	if (checks == NIL)
+		return;
+
+	/* Anything queued while we run the lookups goes to a new list */
+	k2pg_ri_pending_cxt = NULL;
+	k2pg_ri_pending_checks = NIL;
+
+	foreach(lc, checks)
+		K2PgRIPrefetchConstraint((K2PgRIPendingCheck *) lfirst(lc));
+
+	MemoryContextDelete(cxt);
+}
+
+/* ----------
+ * K2PgRIResetPendingChecks -
+ *
+ *	Forget the queued FK values at the end of the transaction or on abort of
+ *	a subtransaction.  Their memory goes away together with
+ *	TopTransactionContext.
+ * ----------
+ */
+void
+K2PgRIResetPendingChecks(void)
+{
+	k2pg_ri_pending_cxt = NULL;
+	k2pg_ri_pending_checks = NIL;
+}
+
+static void
+K2PgRIPrefetchConstraint(const K2PgRIPendingCheck *pending)
+{
+	const RI_ConstraintInfo *riinfo;
+	Relation	pk_rel;
+	Relation	idx_rel;
+	Oid			ref_table_id = InvalidOid;
+	Oid			array_types[RI_MAX_NUMKEYS];
+	int16		result_attnums[RI_MAX_NUMKEYS];
+	RI_QueryKey qkey;
+	SPIPlanPtr	qplan;
+	Datum	   *elems;
+	uint64		ncached = 0;
+	int			start;
+	int			i;
+
+	riinfo = ri_LoadConstraintInfo(pending->constraint_id);
+	pk_rel = heap_open(riinfo->pk_relid, RowShareLock);
+
+	if (!IsK2PgRelation(pk_rel))
+	{
+		heap_close(pk_rel, RowShareLock);
+		return;
+	}
+
+	/*
+	 * The cached tuple ids are built from the PK rows we read, while the
+	 * check triggers build theirs from the FK values, so both must have the
+	 * same types.  The lookup also needs an array type to pass the values in.
+	 */
+	for (i = 0; i < riinfo->nkeys; i++)
+	{
+		Oid			pk_type = RIAttType(pk_rel, riinfo->pk_attnums[i]);
+		Oid			left_type;
+		Oid			right_type;
+
+		op_input_types(riinfo->pf_eq_oprs[i], &left_type, &right_type);
+		array_types[i] = get_array_type(pk_type);
+		if (pk_type != pending->key_types[i] || left_type != pk_type ||
+			right_type != pk_type || !OidIsValid(array_types[i]))
+		{
+			heap_close(pk_rel, RowShareLock);
+			return;
+		}
+		result_attnums[i] = i + 1;
+	}
+
+	/*
+	 * Get the referenced index table.
+	 * For primary key index, we need to use the base table relation.
+	 */
+	idx_rel = RelationIdGetRelation(riinfo->conindid);
+	if (idx_rel->rd_index != NULL)
+	{
+		ref_table_id = idx_rel->rd_index->indisprimary ?
+				idx_rel->rd_index->indrelid : riinfo->conindid;
+	}
+
+	if (SPI_connect() != SPI_OK_CONNECT)
+		elog(ERROR, "SPI_connect failed");
+
+	/*
+	 * Fetch or prepare a saved plan for the lookup
+	 */
+	ri_BuildQueryKey(&qkey, riinfo, RI_PLAN_K2PG_PREFETCHPK);
+
+	if ((qplan = ri_FetchPreparedPlan(&qkey)) == NULL)
+	{
+		StringInfoData querybuf;
+		char		pkrelname[MAX_QUOTED_REL_NAME_LEN];
+		char		attname[MAX_QUOTED_NAME_LEN];
+		char		paramname[16];
+		const char *querysep;
+
+		/* ----------
+		 * The query string built is
+		 *	SELECT pkatt1 [, ...] FROM ONLY <pktable> x
+		 *		   WHERE pkatt1 = ANY ($1) [AND ...] FOR KEY SHARE OF x
+		 * The $ parameters are arrays of the PK attribute types, which are
+		 * the FK attribute types as well.  Only single column keys are
+		 * queued, see K2PgRIQueueReferenceCheck.
+		 * ----------
+		 */
+		initStringInfo(&querybuf);
+		querysep = "SELECT";
+		for (i = 0; i < riinfo->nkeys; i++)
+		{
+			quoteOneName(attname,
+						 RIAttName(pk_rel, riinfo->pk_attnums[i]));
+			appendStringInfo(&querybuf, "%s x.%s", querysep, attname);
+			querysep = ",";
+		}
+		quoteRelationName(pkrelname, pk_rel);
+		appendStringInfo(&querybuf, " FROM ONLY %s x", pkrelname);
+		querysep = "WHERE";
+		for (i = 0; i < riinfo->nkeys; i++)
+		{
+			Oid			pk_type = RIAttType(pk_rel, riinfo->pk_attnums[i]);
+
+			quoteOneName(attname,
+						 RIAttName(pk_rel, riinfo->pk_attnums[i]));
+			sprintf(paramname, "ANY ($%d)", i + 1);
+			ri_GenerateQual(&querybuf, querysep,
+							attname, pk_type,
+							riinfo->pf_eq_oprs[i],
+							paramname, pk_type);
+			querysep = "AND";
+		}
+
+		appendStringInfoString(&querybuf, " FOR KEY SHARE OF x");
+
+		/* Prepare and save the plan */
+		qplan = ri_PlanCheck(querybuf.data, riinfo->nkeys, array_types,
+							 &qkey, pk_rel, pk_rel, true);
+	}
+
+	elems = (Datum *) palloc(Min(pending->nrows, k2pg_fk_check_batch_size) * sizeof(Datum));
+	for (start = 0; start < pending->nrows; start += k2pg_fk_check_batch_size)
+	{
+		int			nrows = Min(pending->nrows - start, k2pg_fk_check_batch_size);
+		Datum		vals[RI_MAX_NUMKEYS];
+		char		nulls[RI_MAX_NUMKEYS];
+		Oid			save_userid;
+		int			save_sec_context;
+		int			spi_result;
+		int			k;
+		uint64		j;
+
+		for (i = 0; i < riinfo->nkeys; i++)
+		{
+			for (k = 0; k < nrows; k++)
+				elems[k] = pending->values[(start + k) * pending->nkeys + i];
+			vals[i] = PointerGetDatum(construct_array(elems, nrows,
+													  pending->key_types[i],
+													  pending->key_typlens[i],
+													  pending->key_typbyvals[i],
+													  pending->key_typaligns[i]));
+			nulls[i] = ' ';
+		}
+
+		/* Switch to proper UID to perform the lookup as */
+		GetUserIdAndSecContext(&save_userid, &save_sec_context);
+		SetUserIdAndSecContext(RelationGetForm(pk_rel)->relowner,
+							   save_sec_context | SECURITY_LOCAL_USERID_CHANGE |
+							   SECURITY_NOFORCE_RLS);
+
+		spi_result = SPI_execute_snapshot(qplan, vals, nulls,
+										  InvalidSnapshot, InvalidSnapshot,
+										  false, false, 0);
+
+		/* Restore UID and security context */
+		SetUserIdAndSecContext(save_userid, save_sec_context);
+
+		if (spi_result != SPI_OK_SELECT)
+			elog(ERROR, "SPI_execute_snapshot returned %s", SPI_result_code_string(spi_result));
+
+		for (j = 0; j < SPI_processed; j++)
+		{
+			char	   *tuple_id = NULL;
+			int64_t		tuple_id_size = 0;
+
+			BuildPgTupleId(
+				pk_rel /* Primary table */,
+				ref_table_id == pk_rel->rd_id ? pk_rel : idx_rel /* Reference index */,
+				riinfo, SPI_tuptable->tupdesc, result_attnums,
+				SPI_tuptable->vals[j], (void **)&tuple_id, &tuple_id_size);
+			if (tuple_id != NULL)
+			{
+				PgGate_CacheForeignKeyReference(ref_table_id, tuple_id, tuple_id_size);
+				++ncached;
+			}
+		}
+
+		SPI_freetuptable(SPI_tuptable);
+		for (i = 0; i < riinfo->nkeys; i++)
+			pfree(DatumGetPointer(vals[i]));
+	}
+	pfree(elems);
+
+	if (SPI_finish() != SPI_OK_FINISH)
+		elog(ERROR, "SPI_finish failed");
+
+	elog(DEBUG1, "Cached " UINT64_FORMAT " foreign key references of %d rows: table ID %u",
+		 ncached, pending->nrows, ref_table_id);
+
+	RelationClose(idx_rel);
+	heap_close(pk_rel, RowShareLock);
+}
@@ -3087,6 +3087,52 @@ static struct config_int ConfigureNamesInt[] =
 		NULL, NULL, NULL
 	},
 
+	{
+		{"k2pg_copy_rows_per_transaction", PGC_USERSET, CLIENT_CONN_STATEMENT,
+			gettext_noop("Sets the number of rows COPY FROM writes to a K2 table before it commits them."),
+			gettext_noop("Only applies to a COPY FROM which is not run in a transaction block. "
+						 "Rows committed before an error stay in the table. "
+						 "Zero loads the whole file in a single transaction."),
+		},
+		&k2pg_copy_rows_per_transaction,
+		0, 0, INT_MAX,
+		NULL, NULL, NULL
+	},
+
+	{
+		{"k2pg_sequence_max_cache_size", PGC_USERSET, CLIENT_CONN_STATEMENT,
+			gettext_noop("Sets the maximum number of values a session reserves at once for a busy sequence."),
+			gettext_noop("A session reserves the CACHE of the sequence at first, and twice as many "
+						 "values each time the previous ones were used up within a second. "
+						 "Unused reserved values are lost when the session ends."),
+		},
+		&k2pg_sequence_max_cache_size,
+		100, 1, INT_MAX,
+		NULL, NULL, NULL
+	},
+
+	{
+		{"k2pg_nestloop_batch_size", PGC_USERSET, QUERY_TUNING_OTHER,
+			gettext_noop("Sets the number of outer rows a nested loop join looks up at once in the inner K2 index."),
+			gettext_noop("Applies to joins whose inner side is an index scan with equality conditions "
+						 "on the join keys. One looks up every outer row on its own."),
+		},
+		&k2pg_nestloop_batch_size,
+		64, 1, 1024,
+		NULL, NULL, NULL
+	},
+
+	{
+		{"k2pg_fk_check_batch_size", PGC_USERSET, CLIENT_CONN_STATEMENT,
+			gettext_noop("Sets the number of rows whose foreign keys are looked up at once in the referenced K2 table."),
+			gettext_noop("The referenced rows found are cached until the end of the transaction, "
+						 "so the checks of the rows skip their own lookups. One checks every row on its own."),
+		},
+		&k2pg_fk_check_batch_size,
+		1024, 1, 1024,
+		NULL, NULL, NULL
+	},
+
 	/* End-of-list marker */
 	{
 		{NULL, 0, 0, NULL, NULL}, NULL, 0, 0, 0, NULL, NULL, NULL
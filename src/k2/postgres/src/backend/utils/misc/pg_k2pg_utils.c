@@ -53,6 +53,7 @@
 #include "access/htup_details.h"
 #include "access/tupdesc.h"
 
+#include "tcop/tcopprot.h"
 #include "tcop/utility.h"
 
 uint64_t k2pg_catalog_cache_version = K2PG_CATCACHE_VERSION_UNINITIALIZED;
@@ -312,6 +313,16 @@ FetchUniqueConstraintName(Oid relation_id, char* dest, size_t max_size)
 	RelationClose(rel);
 }
 
+/*
+ * Returns the text of the statement being executed, used to report the statement which issued a buffered
+ * write when the write fails after the statement has finished.
+ */
+static const char*
+GetDebugQueryString()
+{
+	return debug_query_string;
+}
+
 void
 K2PgInitPostgresBackend(
 	const char *program_name,
@@ -335,6 +346,7 @@ K2PgInitPostgresBackend(
 		K2PgCallbacks callbacks;
 		callbacks.FetchUniqueConstraintName = &FetchUniqueConstraintName;
 		callbacks.GetCurrentYbMemctx = &GetCurrentYbMemctx;
+		callbacks.GetDebugQueryString = &GetDebugQueryString;
 		PgGate_InitPgGate(type_table, count, callbacks);
 		K2PgInstallTxnDdlHook();
 
@@ -655,6 +667,17 @@ K2PgRaiseNotSupportedSignal(const char *msg, int issue_no, int signal_level)
 	}
 }
 
+//------------------------------------------------------------------------------
+// Bulk load and sequences.
+
+int k2pg_copy_rows_per_transaction = 0;
+
+int k2pg_sequence_max_cache_size = 100;
+
+int k2pg_nestloop_batch_size = 64;
+
+int k2pg_fk_check_batch_size = 1024;
+
 //------------------------------------------------------------------------------
 // Debug utils.
 
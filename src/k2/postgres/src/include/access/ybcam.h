@@ -135,7 +135,12 @@ IndexTuple cam_getnext_indextuple(CamScanDesc camScan, bool is_forward_scan, boo
 
 void camEndScan(CamScanDesc camScan);
 
-/* Number of rows assumed for a K2PG table if no size estimates exist */
+/*
+ * Number of rows assumed for a K2PG table if no size estimates exist, i.e.
+ * the table has not been analyzed yet. The selectivities below are only used
+ * in that case as well; once ANALYZE has filled in pg_class.reltuples and
+ * pg_statistic, the regular clause selectivity estimation is used instead.
+ */
 #define K2PG_DEFAULT_NUM_ROWS  1000
 
 #define K2PG_SINGLE_ROW_SELECTIVITY	(1.0 / K2PG_DEFAULT_NUM_ROWS)
@@ -145,7 +150,7 @@ void camEndScan(CamScanDesc camScan);
 
 /*
  * For a partial index the index predicate will filter away some rows.
- * TODO: Evaluate this based on the predicate itself and table stats.
+ * Only used if the table has no stats.
  */
 #define K2PG_PARTIAL_IDX_PRED_SELECTIVITY 0.8
 
@@ -167,9 +172,16 @@ void camEndScan(CamScanDesc camScan);
 extern void camCostEstimate(RelOptInfo *baserel, Selectivity selectivity,
                             bool is_backwards_scan, bool is_uncovered_idx_scan,
 							Cost *startup_cost, Cost *total_cost);
-extern void camIndexCostEstimate(IndexPath *path, Selectivity *selectivity,
+extern void camIndexCostEstimate(PlannerInfo *root, IndexPath *path,
+								 Selectivity *selectivity,
 								 Cost *startup_cost, Cost *total_cost);
 
+/*
+ * Whether the given K2PG table has been analyzed, i.e. whether its reltuples
+ * and column statistics can be used for planning.
+ */
+extern bool camRelHasStats(Relation relation);
+
 /*
  * Fetch a single tuple by the k2pgctid.
  */
@@ -271,4 +271,9 @@ extern bool RI_Initial_Check(Trigger *trigger,
 
 extern int	RI_FKey_trigger_type(Oid tgfoid);
 
+extern void K2PgRIQueueReferenceCheck(Trigger *trigger, Relation fk_rel,
+							  HeapTuple new_row);
+extern void K2PgRIPrefetchReferences(void);
+extern void K2PgRIResetPendingChecks(void);
+
 #endif							/* TRIGGER_H */
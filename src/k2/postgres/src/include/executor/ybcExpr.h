@@ -40,4 +40,11 @@ extern K2PgExpr K2PgNewConstant(K2PgStatement k2pg_stmt, Oid type_id, Datum datu
 // Construct a generic eval_expr call for given a PG Expr and its expected type and attno.
 extern K2PgExpr K2PgNewEvalExprCall(K2PgStatement k2pg_stmt, Expr *expr, int32_t attno, int32_t type_id, int32_t type_mod);
 
+// Name of the K2 operator which evaluates the given PG function in an UPDATE assignment, or NULL if there is none.
+extern const char *K2PgAssignOperatorName(Oid funcid);
+
+// Construct the expression tree of a pushed down UPDATE assignment, e.g. "col = col + 1".
+// Only valid for expressions whose functions are all accepted by K2PgAssignOperatorName.
+extern K2PgExpr K2PgNewAssignExpr(K2PgStatement k2pg_stmt, Expr *expr);
+
 #endif							/* YBCEXPR_H */
@@ -47,13 +47,23 @@ extern Oid K2PgExecuteInsert(Relation rel,
                             HeapTuple tuple);
 
 /*
- * Execute the insert outside of a transaction.
+ * Execute the insert of a single row statement in autocommit mode, in a K2
+ * transaction of its own rather than the session transaction.
  * Assumes the caller checked that it is safe to do so.
  */
 extern Oid K2PgExecuteNonTxnInsert(Relation rel,
 								  TupleDesc tupleDesc,
 								  HeapTuple tuple);
 
+/*
+ * Insert a tuple of a bulk load, e.g. COPY, without creating an INSERT
+ * statement for it. The write is buffered, so a failure may be reported by a
+ * later write of the transaction or by its commit.
+ */
+extern Oid K2PgExecuteBulkInsert(Relation rel,
+								TupleDesc tupleDesc,
+								HeapTuple tuple);
+
 /*
  * Insert a tuple into the an index's backing K2PG index table.
  */
@@ -1733,6 +1733,25 @@ typedef struct NestLoopState
 	bool		nl_NeedNewOuter;
 	bool		nl_MatchedOuter;
 	TupleTableSlot *nl_NullInnerTupleSlot;
+
+	/*
+	 * K2PG specific attributes, for joining batches of outer tuples with the
+	 * results of one scan of the inner K2 index.  k2pg_batch_size is zero if
+	 * the join is not batched.
+	 */
+	int			k2pg_batch_size;
+	Bitmapset  *k2pg_batch_keys;	/* inner runtime keys bound to IN lists */
+	TupleTableSlot **k2pg_batch_outer;	/* outer tuples of the batch */
+	int			k2pg_batch_outer_count;
+	int			k2pg_batch_outer_pos;	/* next outer tuple to join */
+	bool		k2pg_batch_outer_done;	/* the outer plan is exhausted */
+	HeapTuple  *k2pg_batch_inner;	/* inner tuples read for the batch */
+	int			k2pg_batch_inner_count;
+	int			k2pg_batch_inner_pos;	/* next inner tuple to match */
+	bool		k2pg_batch_rescan;	/* inner tuples didn't fit in work_mem,
+									 * rescan the inner plan per outer tuple */
+	MemoryContext k2pg_batch_context;	/* reset for every batch */
+	K2PgExecParameters k2pg_batch_exec_params;	/* for the inner scan */
 } NestLoopState;
 
 /* ----------------
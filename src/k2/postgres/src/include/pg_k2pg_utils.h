@@ -270,6 +270,33 @@ Oid K2PgGetDatabaseOid(Relation rel);
 void K2PgRaiseNotSupported(const char *msg, int issue_no);
 void K2PgRaiseNotSupportedSignal(const char *msg, int issue_no, int signal_level);
 
+//------------------------------------------------------------------------------
+// K2PG bulk load and sequences.
+
+/**
+ * Number of rows a COPY FROM outside of a transaction block writes to a K2 table before it commits them and
+ * continues in a new transaction, e.g. 'SET k2pg_copy_rows_per_transaction=20000'. Zero disables it.
+ */
+extern int k2pg_copy_rows_per_transaction;
+
+/**
+ * Max number of values of a busy sequence a backend reserves at once, when it is more than the CACHE of the
+ * sequence, e.g. 'SET k2pg_sequence_max_cache_size=1000'. One only reserves CACHE values.
+ */
+extern int k2pg_sequence_max_cache_size;
+
+/**
+ * Max number of outer tuples a nested loop join reads before it looks up their join keys in the inner K2 index
+ * with one scan, e.g. 'SET k2pg_nestloop_batch_size=128'. One joins every outer tuple on its own.
+ */
+extern int k2pg_nestloop_batch_size;
+
+/**
+ * Max number of rows whose foreign keys a statement on a K2 table looks up in the referenced table with one read,
+ * e.g. 'SET k2pg_fk_check_batch_size=256'. One checks every row on its own.
+ */
+extern int k2pg_fk_check_batch_size;
+
 //------------------------------------------------------------------------------
 // K2PG Debug utils.
 
@@ -55,6 +55,15 @@ class TestAggregation(unittest.TestCase):
         record = selectOneRecord(self.sharedConn, "SELECT SUM(dataA) FROM aggregate;")
         self.assertEqual(record[0], 10)
 
+    def test_sumBeyondInt32(self):
+        commitSQL(self.sharedConn, "CREATE TABLE aggregatebig (id integer PRIMARY KEY, dataA integer, dataB smallint);")
+        commitSQL(self.sharedConn, "INSERT INTO aggregatebig SELECT i, 2000000000, 30000 FROM generate_series(1, 5) i;")
+        record = selectOneRecord(self.sharedConn, "SELECT SUM(dataA), SUM(dataB), COUNT(*) FROM aggregatebig;")
+        self.assertEqual(record[0], 10000000000)
+        self.assertEqual(record[1], 150000)
+        self.assertEqual(record[2], 5)
+        commitSQL(self.sharedConn, "DROP TABLE aggregatebig;")
+
     def test_min(self):
         record = selectOneRecord(self.sharedConn, "SELECT MIN(dataA) FROM aggregate;")
         self.assertEqual(record[0], 0)
@@ -67,3 +76,25 @@ class TestAggregation(unittest.TestCase):
         record = selectOneRecord(self.sharedConn, "SELECT COUNT(id) FROM aggregate WHERE dataA=0;")
         self.assertEqual(record[0], 10)
 
+
+    def test_countStar(self):
+        record = selectOneRecord(self.sharedConn, "SELECT COUNT(*) FROM aggregate;")
+        self.assertEqual(record[0], 20)
+
+    def test_avg(self):
+        record = selectOneRecord(self.sharedConn, "SELECT AVG(id) FROM aggregate;")
+        self.assertEqual(float(record[0]), 10.5)
+
+    def test_multipleAggregates(self):
+        record = selectOneRecord(self.sharedConn, "SELECT COUNT(*), SUM(dataB), MIN(id), MAX(id), AVG(dataA) FROM aggregate;")
+        self.assertEqual(record[0], 20)
+        self.assertEqual(record[1], 20)
+        self.assertEqual(record[2], 1)
+        self.assertEqual(record[3], 20)
+        self.assertEqual(float(record[4]), 0.5)
+
+    def test_emptyRange(self):
+        record = selectOneRecord(self.sharedConn, "SELECT COUNT(*), SUM(dataA), MAX(dataA) FROM aggregate WHERE id > 100;")
+        self.assertEqual(record[0], 0)
+        self.assertIsNone(record[1])
+        self.assertIsNone(record[2])
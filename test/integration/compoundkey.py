@@ -36,6 +36,8 @@ class TestCompoundKey(unittest.TestCase):
         commitSQL(cls.sharedConn, "CREATE TABLE compoundkeyintint (id integer, id2 integer, dataA integer, PRIMARY KEY(id, id2));")
         commitSQL(cls.sharedConn, "CREATE TABLE compoundkeytxttxt (id text, id2 text, dataA integer, PRIMARY KEY(id, id2));")
         commitSQL(cls.sharedConn, "CREATE TABLE compoundkeyboolint (id bool, id2 integer, dataA integer, PRIMARY KEY(id, id2));")
+        commitSQL(cls.sharedConn, "CREATE TABLE compoundkeytxtrange (id text, id2 integer, dataA integer, PRIMARY KEY(id, id2));")
+        commitSQL(cls.sharedConn, "CREATE TABLE compoundkeyinlist (id integer, id2 integer, dataA integer, PRIMARY KEY(id, id2));")
 
     @classmethod
     def tearDownClass(cls):
@@ -84,6 +86,28 @@ class TestCompoundKey(unittest.TestCase):
         self.assertEqual(record[2], 5)
         self.assertEqual(record[3], 1)
 
+    def test_rangeScanTxt(self):
+        # Populate some records for the tests
+        with self.sharedConn: # commits at end of context if no errors
+            with self.sharedConn.cursor() as cur:
+                for key in ["a", "ab", "abc", "b", "ba", "c"]:
+                    for i in range(1, 4):
+                        cur.execute("INSERT INTO compoundkeytxtrange VALUES (%s, %s, 1);", (key, i))
+
+        def countRange(cond):
+            return selectOneRecord(self.sharedConn, "SELECT COUNT(*) FROM compoundkeytxtrange WHERE " + cond + ";")[0]
+
+        # Inclusive and exclusive bounds on a text key
+        self.assertEqual(countRange("id >= 'ab'"), 15)
+        self.assertEqual(countRange("id > 'ab'"), 12)
+        self.assertEqual(countRange("id <= 'ab'"), 6)
+        self.assertEqual(countRange("id < 'ab'"), 3)
+        self.assertEqual(countRange("id > 'ab' AND id <= 'b'"), 6)
+        self.assertEqual(countRange("id BETWEEN 'abc' AND 'ba'"), 9)
+        # Range on the second key after an equality on the first one
+        self.assertEqual(countRange("id = 'b' AND id2 > 1"), 2)
+        self.assertEqual(countRange("id = 'b' AND id2 <= 1"), 1)
+
     def test_prefixScanIntInt(self):
         # Populate some records for the tests
         with self.sharedConn: # commits at end of context if no errors
@@ -152,3 +176,29 @@ class TestCompoundKey(unittest.TestCase):
                     self.assertEqual(record[0], False)
                     self.assertEqual(record[1], i)
                     self.assertEqual(record[2], 2)
+
+    def test_inListOnKeys(self):
+        # Populate some records for the tests
+        with self.sharedConn: # commits at end of context if no errors
+            with self.sharedConn.cursor() as cur:
+                for i in range(1, 6):
+                    for j in range(1, 6):
+                        cur.execute("INSERT INTO compoundkeyinlist VALUES (%s, %s, %s);", (i, j, i * 10 + j))
+
+        def selectKeys(query):
+            with self.sharedConn: # commits at end of context if no errors
+                with self.sharedConn.cursor() as cur:
+                    cur.execute(query)
+                    return [(record[0], record[1]) for record in cur.fetchall()]
+
+        # Point reads on the full key, duplicates and missing keys included
+        self.assertEqual(selectKeys("SELECT * FROM compoundkeyinlist WHERE id IN (4, 2, 2, 9) AND id2 IN (3, 1) ORDER BY id, id2;"),
+                         [(2, 1), (2, 3), (4, 1), (4, 3)])
+        self.assertEqual(selectKeys("SELECT * FROM compoundkeyinlist WHERE id = ANY(ARRAY[5, 1]) AND id2 = 2 ORDER BY id DESC;"),
+                         [(5, 2), (1, 2)])
+        # Prefix scans on the leading key, with a range on the second key
+        self.assertEqual(selectKeys("SELECT * FROM compoundkeyinlist WHERE id IN (3, 1) AND id2 > 3 ORDER BY id, id2;"),
+                         [(1, 4), (1, 5), (3, 4), (3, 5)])
+        # An IN list together with a filter on a non-key column
+        record = selectOneRecord(self.sharedConn, "SELECT COUNT(*) FROM compoundkeyinlist WHERE id IN (1, 5) AND dataA > 13;")
+        self.assertEqual(record[0], 7)
@@ -60,4 +60,30 @@ class TestDDL(unittest.TestCase):
         self.assertEqual(exists, False)
         commitSQL(self.sharedConn, "CREATE TABLE ddltest5 (id integer, dataA text, dataB text);")
 
+    def test_truncateTable(self):
+        commitSQL(self.sharedConn, "CREATE TABLE ddltest6 (id integer PRIMARY KEY, dataA integer);")
+        commitSQL(self.sharedConn, "CREATE INDEX ddltest6_idx ON ddltest6 (dataA);")
+        with self.sharedConn:
+            with self.sharedConn.cursor() as cur:
+                for i in range(1, 301):
+                    cur.execute("INSERT INTO ddltest6 VALUES (%s, %s);", (i, i % 10))
+
+        # a rolled back truncate keeps the rows
+        with self.assertRaises(psycopg2.errors.DivisionByZero):
+            with self.sharedConn:
+                with self.sharedConn.cursor() as cur:
+                    cur.execute("TRUNCATE ddltest6;")
+                    cur.execute("SELECT 1/0;")
+        record = selectOneRecord(self.sharedConn, "SELECT COUNT(*) FROM ddltest6;")
+        self.assertEqual(record[0], 300)
+
+        commitSQL(self.sharedConn, "TRUNCATE ddltest6;")
+        record = selectOneRecord(self.sharedConn, "SELECT COUNT(*) FROM ddltest6;")
+        self.assertEqual(record[0], 0)
+        record = selectOneRecord(self.sharedConn, "SELECT COUNT(*) FROM ddltest6 WHERE dataA = 3;")
+        self.assertEqual(record[0], 0)
+        commitSQL(self.sharedConn, "INSERT INTO ddltest6 VALUES (1, 3);")
+        record = selectOneRecord(self.sharedConn, "SELECT id FROM ddltest6 WHERE dataA = 3;")
+        self.assertEqual(record[0], 1)
+
 # TODO add table already exists error case after #216 is fixed
@@ -26,6 +26,7 @@ SOFTWARE.
 This file has tests for basic dml statements (not joins, aggregates, or isolation tests)
 '''
 
+import io
 import unittest
 import psycopg2
 from helper import commitSQL, selectOneRecord, getConn
@@ -78,6 +79,39 @@ class TestDMLBasic(unittest.TestCase):
             commitSQL(self.sharedConn, "INSERT INTO dmlbasic VALUES (4, 1, 1);")
             commitSQL(self.sharedConn, "INSERT INTO dmlbasic VALUES (4, 2, 2);")
 
+    def test_bufferedWritesInTransaction(self):
+        with self.sharedConn:
+            with self.sharedConn.cursor() as cur:
+                for i in range(21, 36):
+                    cur.execute("INSERT INTO dmlbasic VALUES (%s, 1, %s);", (i, i))
+                cur.execute("UPDATE dmlbasic SET dataA=2 WHERE id=21;")
+                cur.execute("DELETE FROM dmlbasic WHERE id=35;")
+                # reads must see the writes of the transaction
+                cur.execute("SELECT * FROM dmlbasic WHERE id >= 21 AND id <= 35;")
+                records = cur.fetchall()
+                self.assertEqual(14, len(records))
+        record = selectOneRecord(self.sharedConn, "SELECT * FROM dmlbasic WHERE id=21;")
+        self.assertEqual(record[1], 2)
+
+    def test_bufferedDuplicateKeyInTransaction(self):
+        commitSQL(self.sharedConn, "INSERT INTO dmlbasic VALUES (38, 1, 1);")
+        for duplicate in ["INSERT INTO dmlbasic VALUES (36, 2, 2);", "INSERT INTO dmlbasic VALUES (38, 2, 2);"]:
+            cur = self.sharedConn.cursor()
+            cur.execute("INSERT INTO dmlbasic VALUES (36, 1, 1);")
+            cur.execute("INSERT INTO dmlbasic VALUES (37, 1, 1);")
+            cur.execute(duplicate)
+            # the write is buffered past its statement, the error names the statement that wrote the duplicate
+            with self.assertRaises(psycopg2.errors.UniqueViolation) as context:
+                cur.execute("INSERT INTO dmlbasic VALUES (39, 1, 1);")
+                self.sharedConn.commit()
+            self.assertIn(duplicate, str(context.exception))
+            cur.close()
+            self.sharedConn.rollback()
+        with self.sharedConn:
+            with self.sharedConn.cursor() as cur:
+                cur.execute("SELECT * FROM dmlbasic WHERE id >= 36 AND id <= 37 OR id = 39;")
+                self.assertEqual(0, len(cur.fetchall()))
+
     def test_insertOverExistingDoNothing(self):
         commitSQL(self.sharedConn, "INSERT INTO dmlbasic VALUES (5, 1, 1);")
         commitSQL(self.sharedConn, "INSERT INTO dmlbasic VALUES (5, 2, 2) ON CONFLICT DO NOTHING;")
@@ -145,6 +179,38 @@ class TestDMLBasic(unittest.TestCase):
         self.assertEqual(record[1], 43)
         self.assertEqual(record[2], 10)
 
+    def test_updateWithAssignExpression(self):
+        commitSQL(self.sharedConn, "INSERT INTO dmlbasic VALUES (38, 2147483640, NULL);")
+        commitSQL(self.sharedConn, "UPDATE dmlbasic SET dataA=dataA+5, dataB=dataB*2 WHERE id=38;")
+        record = selectOneRecord(self.sharedConn, "SELECT * FROM dmlbasic WHERE id=38;")
+        self.assertEqual(record[1], 2147483645)
+        self.assertEqual(record[2], None)
+        with self.assertRaises(psycopg2.errors.NumericValueOutOfRange):
+            commitSQL(self.sharedConn, "UPDATE dmlbasic SET dataA=dataA+5 WHERE id=38;")
+        record = selectOneRecord(self.sharedConn, "SELECT * FROM dmlbasic WHERE id=38;")
+        self.assertEqual(record[1], 2147483645)
+        # no row to update
+        with self.sharedConn:
+            with self.sharedConn.cursor() as cur:
+                cur.execute("UPDATE dmlbasic SET dataA=dataA+1 WHERE id=39;")
+                self.assertEqual(0, cur.rowcount)
+
+    def test_updateWithFloatAssignExpression(self):
+        commitSQL(self.sharedConn, "CREATE TABLE dmlfloat (id integer PRIMARY KEY, f4 real, f8 double precision);")
+        commitSQL(self.sharedConn, "INSERT INTO dmlfloat VALUES (1, 3e38, 1e-300);")
+        # the float4 product is computed in float4 precision, like PG does
+        commitSQL(self.sharedConn, "UPDATE dmlfloat SET f4=f4*1.1::real, f8=f8*1e10 WHERE id=1;")
+        record = selectOneRecord(self.sharedConn, "SELECT f4 = 3e38::real*1.1::real, f8 FROM dmlfloat WHERE id=1;")
+        self.assertTrue(record[0])
+        self.assertAlmostEqual(record[1] / 1e-290, 1.0)
+        with self.assertRaises(psycopg2.errors.NumericValueOutOfRange):
+            commitSQL(self.sharedConn, "UPDATE dmlfloat SET f4=f4*2::real WHERE id=1;")
+        with self.assertRaises(psycopg2.errors.NumericValueOutOfRange):
+            commitSQL(self.sharedConn, "UPDATE dmlfloat SET f4=f4*1e-30::real*1e-30::real*1e-30::real WHERE id=1;")
+        with self.assertRaises(psycopg2.errors.NumericValueOutOfRange):
+            commitSQL(self.sharedConn, "UPDATE dmlfloat SET f8=f8*1e-300 WHERE id=1;")
+        commitSQL(self.sharedConn, "DROP TABLE dmlfloat;")
+
     def test_selectWithFieldReference(self):
         commitSQL(self.sharedConn, "INSERT INTO dmlbasic VALUES (10, 33, 33);")
         commitSQL(self.sharedConn, "INSERT INTO dmlbasic VALUES (11, 4, 33);")
@@ -203,3 +269,125 @@ class TestDMLBasic(unittest.TestCase):
                 for record in records:
                     self.assertEqual(record[0], 111)
 
+
+    def test_serialColumn(self):
+        commitSQL(self.sharedConn, "CREATE TABLE dmlserial (id serial PRIMARY KEY, data integer);")
+        # two sessions taking ids from the same sequence, each reserving ranges of them
+        otherConn = getConn()
+        for i in range(1, 201):
+            commitSQL(self.sharedConn, "INSERT INTO dmlserial (data) VALUES ({});".format(i))
+            commitSQL(otherConn, "INSERT INTO dmlserial (data) VALUES ({});".format(i))
+        otherConn.close()
+
+        record = selectOneRecord(self.sharedConn, "SELECT COUNT(DISTINCT id), COUNT(*), MIN(id) FROM dmlserial;")
+        self.assertEqual(record[0], 400)
+        self.assertEqual(record[1], 400)
+        self.assertEqual(record[2], 1)
+
+        record = selectOneRecord(self.sharedConn, "SELECT setval('dmlserial_id_seq', 5000);")
+        commitSQL(self.sharedConn, "INSERT INTO dmlserial (data) VALUES (0);")
+        record = selectOneRecord(self.sharedConn, "SELECT id FROM dmlserial WHERE data = 0;")
+        self.assertEqual(record[0], 5001)
+        commitSQL(self.sharedConn, "DROP TABLE dmlserial;")
+
+    def test_scanWithFilters(self):
+        commitSQL(self.sharedConn, "CREATE TABLE dmlfilter (id integer PRIMARY KEY, dataA integer, dataB integer, name text);")
+        with self.sharedConn:
+            with self.sharedConn.cursor() as cur:
+                cur.execute("INSERT INTO dmlfilter VALUES (1, 1, 2, 'abc');")
+                cur.execute("INSERT INTO dmlfilter VALUES (2, 2, 2, 'abd');")
+                cur.execute("INSERT INTO dmlfilter VALUES (3, 3, 2, 'bcd');")
+                cur.execute("INSERT INTO dmlfilter VALUES (4, NULL, 2, 'a%c');")
+                cur.execute("INSERT INTO dmlfilter VALUES (5, 5, NULL, NULL);")
+
+        def selectIds(where, params=None):
+            with self.sharedConn:
+                with self.sharedConn.cursor() as cur:
+                    cur.execute("SELECT id FROM dmlfilter WHERE " + where + " ORDER BY id;", params)
+                    return [record[0] for record in cur.fetchall()]
+
+        self.assertEqual(selectIds("dataA = 1 OR dataA = 3"), [1, 3])
+        self.assertEqual(selectIds("dataA IN (2, 3, NULL)"), [2, 3])
+        self.assertEqual(selectIds("dataA = ANY(%s)", ([1, 5],)), [1, 5])
+        self.assertEqual(selectIds("dataA NOT IN (1, 2)"), [3, 5])
+        self.assertEqual(selectIds("dataA <> 1"), [2, 3, 5])
+        self.assertEqual(selectIds("dataA IS NULL"), [4])
+        self.assertEqual(selectIds("dataB IS NOT NULL AND name IS NOT NULL"), [1, 2, 3, 4])
+        self.assertEqual(selectIds("dataA < dataB"), [1])
+        self.assertEqual(selectIds("dataA = dataB OR dataB IS NULL"), [2, 5])
+        self.assertEqual(selectIds("NOT (dataA = 1 OR dataA = 2)"), [3, 5])
+        self.assertEqual(selectIds("name LIKE 'ab%'"), [1, 2])
+        self.assertEqual(selectIds("name LIKE 'a_c'"), [1])
+        self.assertEqual(selectIds("name LIKE 'a\\%c'"), [4])
+        self.assertEqual(selectIds("name NOT LIKE 'ab%'"), [3, 4])
+        # a condition that can't be pushed down doesn't stop the others
+        self.assertEqual(selectIds("dataA IN (1, 2, 3) AND dataA + 1 = dataB"), [1])
+        commitSQL(self.sharedConn, "DROP TABLE dmlfilter;")
+
+    def test_foreignKeyCheck(self):
+        commitSQL(self.sharedConn, "CREATE TABLE dmlfkparent (id integer PRIMARY KEY, name text);")
+        commitSQL(self.sharedConn, "CREATE TABLE dmlfkchild (id integer PRIMARY KEY, parent integer REFERENCES dmlfkparent(id));")
+        commitSQL(self.sharedConn, "INSERT INTO dmlfkparent SELECT i, 'p' || i FROM generate_series(1, 100) i;")
+
+        # the parent keys of a statement's rows are looked up in batches, including duplicates and nulls
+        commitSQL(self.sharedConn, "INSERT INTO dmlfkchild SELECT i, CASE WHEN i % 50 = 0 THEN NULL ELSE i % 100 + 1 END FROM generate_series(1, 2500) i;")
+        record = selectOneRecord(self.sharedConn, "SELECT COUNT(*), COUNT(parent) FROM dmlfkchild;")
+        self.assertEqual(record[0], 2500)
+        self.assertEqual(record[1], 2450)
+
+        # a missing parent among found ones still fails the statement
+        with self.assertRaises(psycopg2.errors.ForeignKeyViolation):
+            commitSQL(self.sharedConn, "INSERT INTO dmlfkchild SELECT i, i - 2500 FROM generate_series(2501, 2601) i;")
+        with self.assertRaises(psycopg2.errors.ForeignKeyViolation):
+            commitSQL(self.sharedConn, "UPDATE dmlfkchild SET parent = parent + 1 WHERE id <= 100;")
+        record = selectOneRecord(self.sharedConn, "SELECT COUNT(*), SUM(parent) FROM dmlfkchild WHERE id <= 100;")
+        self.assertEqual(record[0], 100)
+        self.assertEqual(record[1], 5050 - 51 - 1)
+
+        # a parent deleted in the transaction isn't taken from the cache of found keys
+        with self.assertRaises(psycopg2.errors.ForeignKeyViolation):
+            with self.sharedConn:
+                with self.sharedConn.cursor() as cur:
+                    cur.execute("INSERT INTO dmlfkchild SELECT i, 7 FROM generate_series(3001, 3010) i;")
+                    cur.execute("DELETE FROM dmlfkchild WHERE parent = 7;")
+                    cur.execute("DELETE FROM dmlfkparent WHERE id = 7;")
+                    cur.execute("INSERT INTO dmlfkchild VALUES (3011, 7);")
+        commitSQL(self.sharedConn, "DROP TABLE dmlfkchild;")
+        commitSQL(self.sharedConn, "DROP TABLE dmlfkparent;")
+
+    def test_singleRowWriteTransactions(self):
+        commitSQL(self.sharedConn, "CREATE TABLE dmlsinglerow (id integer PRIMARY KEY, dataA integer);")
+        commitSQL(self.sharedConn, "CREATE TABLE dmlsinglerowidx (id integer PRIMARY KEY, dataA integer);")
+        commitSQL(self.sharedConn, "CREATE INDEX dmlsinglerowidx_idx1 ON dmlsinglerowidx (dataA);")
+
+        # single row statements in autocommit mode run in a transaction of their own
+        conn = getConn()
+        conn.autocommit = True
+        with conn.cursor() as cur:
+            cur.execute("INSERT INTO dmlsinglerow VALUES (1, 10);")
+            with self.assertRaises(psycopg2.errors.UniqueViolation):
+                cur.execute("INSERT INTO dmlsinglerow VALUES (1, 11);")
+            cur.execute("INSERT INTO dmlsinglerow VALUES (2, 20);")
+            cur.execute("UPDATE dmlsinglerow SET dataA = 21 WHERE id = 2;")
+            cur.execute("DELETE FROM dmlsinglerow WHERE id = 1;")
+            cur.execute("INSERT INTO dmlsinglerowidx VALUES (1, 10);")
+        record = selectOneRecord(self.sharedConn, "SELECT COUNT(*), SUM(dataA) FROM dmlsinglerow;")
+        self.assertEqual(record[0], 1)
+        self.assertEqual(record[1], 21)
+        self.assertEqual(selectOneRecord(self.sharedConn, "SELECT id FROM dmlsinglerowidx WHERE dataA = 10;")[0], 1)
+
+        # but not within a transaction block, nor for the rows of a COPY, which are all rolled back
+        with self.sharedConn.cursor() as cur:
+            cur.execute("INSERT INTO dmlsinglerow VALUES (3, 30);")
+            cur.execute("UPDATE dmlsinglerow SET dataA = 22 WHERE id = 2;")
+            cur.copy_from(io.StringIO("4\t40\n5\t50\n"), "dmlsinglerow", columns=("id", "dataA"))
+            cur.copy_from(io.StringIO("2\t20\n3\t30\n"), "dmlsinglerowidx", columns=("id", "dataA"))
+        self.sharedConn.rollback()
+        record = selectOneRecord(self.sharedConn, "SELECT COUNT(*), SUM(dataA) FROM dmlsinglerow;")
+        self.assertEqual(record[0], 1)
+        self.assertEqual(record[1], 21)
+        self.assertEqual(selectOneRecord(self.sharedConn, "SELECT COUNT(*) FROM dmlsinglerowidx WHERE dataA >= 20;")[0], 0)
+
+        conn.close()
+        commitSQL(self.sharedConn, "DROP TABLE dmlsinglerowidx;")
+        commitSQL(self.sharedConn, "DROP TABLE dmlsinglerow;")
@@ -22,6 +22,7 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 SOFTWARE.
 '''
 
+import io
 import unittest
 import psycopg2
 from helper import commitSQL, selectOneRecord, getConn, secIndexExists
@@ -61,3 +62,112 @@ class TestIndex(unittest.TestCase):
                 cur.execute("SELECT * FROM table1 where dataA = '100';")
                 records = cur.fetchall()
                 self.assertEqual(len(records), 1)
+
+    def test_copyIntoIndexedTable(self):
+        commitSQL(self.sharedConn, "CREATE TABLE table2 (id integer PRIMARY KEY, dataA text, dataB integer);")
+        commitSQL(self.sharedConn, "CREATE INDEX table2_idx1 ON table2 (dataA);")
+
+        # COPY outside of a transaction block, committing every 300 rows
+        conn = getConn()
+        conn.autocommit = True
+        with conn.cursor() as cur:
+            cur.execute("SET k2pg_copy_rows_per_transaction=300;")
+            data = io.StringIO("".join("{}\t{}\t{}\n".format(i, i, i * 2) for i in range(1, 2001)))
+            cur.copy_from(data, "table2", columns=("id", "dataA", "dataB"))
+        conn.close()
+
+        with self.sharedConn:
+            with self.sharedConn.cursor() as cur:
+                cur.execute("SELECT COUNT(*) FROM table2;")
+                self.assertEqual(cur.fetchone()[0], 2000)
+                cur.execute("SELECT id, dataB FROM table2 WHERE dataA = '1500';")
+                records = cur.fetchall()
+                self.assertEqual(len(records), 1)
+                self.assertEqual(records[0][0], 1500)
+                self.assertEqual(records[0][1], 3000)
+
+        commitSQL(self.sharedConn, "DROP TABLE table2;")
+
+    def test_createIndexOnPopulatedTable(self):
+        commitSQL(self.sharedConn, "CREATE TABLE table3 (id integer PRIMARY KEY, dataA text, dataB integer);")
+        with self.sharedConn:
+            with self.sharedConn.cursor() as cur:
+                for i in range(1, 501):
+                    cur.execute("INSERT INTO table3 VALUES (%s, %s, %s);", (i, str(i % 100) if i % 50 else None, i))
+
+        commitSQL(self.sharedConn, "CREATE INDEX table3_idx1 ON table3 (dataA);")
+        commitSQL(self.sharedConn, "CREATE UNIQUE INDEX table3_idx2 ON table3 (dataB, dataA);")
+        with self.sharedConn:
+            with self.sharedConn.cursor() as cur:
+                cur.execute("SELECT id FROM table3 WHERE dataA = '7' ORDER BY id;")
+                self.assertEqual([r[0] for r in cur.fetchall()], [7, 107, 207, 307, 407])
+                cur.execute("SELECT id FROM table3 WHERE dataB = 250;")
+                self.assertEqual(cur.fetchall(), [(250,)])
+
+        # the rows with the same dataA can't be indexed by a unique index
+        with self.assertRaises(psycopg2.errors.UniqueViolation):
+            commitSQL(self.sharedConn, "CREATE UNIQUE INDEX table3_idx3 ON table3 (dataA);")
+
+        commitSQL(self.sharedConn, "DROP TABLE table3;")
+
+    def test_createIndexByKeyRanges(self):
+        # wide enough for the backfill to be split into several ranges of id
+        commitSQL(self.sharedConn, "CREATE TABLE table4 (id integer PRIMARY KEY, dataA integer, dataB integer);")
+        with self.sharedConn:
+            with self.sharedConn.cursor() as cur:
+                cur.execute("INSERT INTO table4 SELECT i, i % 1000, i FROM generate_series(1, 10000) i;")
+
+        commitSQL(self.sharedConn, "CREATE INDEX table4_idx1 ON table4 (dataA);")
+        commitSQL(self.sharedConn, "CREATE UNIQUE INDEX table4_idx2 ON table4 (dataB);")
+        with self.sharedConn:
+            with self.sharedConn.cursor() as cur:
+                cur.execute("SELECT id FROM table4 WHERE dataA = 7 ORDER BY id;")
+                self.assertEqual([r[0] for r in cur.fetchall()], list(range(7, 10001, 1000)))
+                cur.execute("SELECT id FROM table4 WHERE dataB = 9999;")
+                self.assertEqual(cur.fetchall(), [(9999,)])
+
+        # the duplicates of dataA are in different ranges
+        with self.assertRaises(psycopg2.errors.UniqueViolation):
+            commitSQL(self.sharedConn, "CREATE UNIQUE INDEX table4_idx3 ON table4 (dataA);")
+
+        # rows written by the same transaction are indexed too
+        with self.sharedConn:
+            with self.sharedConn.cursor() as cur:
+                cur.execute("INSERT INTO table4 VALUES (20000, 5000, 20000);")
+                cur.execute("CREATE INDEX table4_idx4 ON table4 (dataA, dataB);")
+        self.assertEqual(selectOneRecord(self.sharedConn, "SELECT id FROM table4 WHERE dataA = 5000 AND dataB = 20000;")[0], 20000)
+
+        commitSQL(self.sharedConn, "DROP TABLE table4;")
+
+    def test_createIndexOnDescendingKey(self):
+        commitSQL(self.sharedConn, "CREATE TABLE table5 (id integer, dataA integer, PRIMARY KEY (id DESC));")
+        with self.sharedConn:
+            with self.sharedConn.cursor() as cur:
+                cur.execute("INSERT INTO table5 SELECT i, i % 100 FROM generate_series(1, 5000) i;")
+
+        commitSQL(self.sharedConn, "CREATE INDEX table5_idx1 ON table5 (dataA);")
+        with self.sharedConn:
+            with self.sharedConn.cursor() as cur:
+                cur.execute("SET enable_seqscan = off;")
+                cur.execute("SELECT COUNT(*) FROM table5 WHERE dataA = 42;")
+                self.assertEqual(cur.fetchone()[0], 50)
+                cur.execute("RESET enable_seqscan;")
+
+        commitSQL(self.sharedConn, "DROP TABLE table5;")
+
+    def test_createIndexRolledBack(self):
+        commitSQL(self.sharedConn, "CREATE TABLE table6 (id integer PRIMARY KEY, dataA integer);")
+        with self.sharedConn:
+            with self.sharedConn.cursor() as cur:
+                cur.execute("INSERT INTO table6 SELECT i, i FROM generate_series(1, 5000) i;")
+
+        # the rows backfilled for the index are purged when its transaction is rolled back
+        with self.sharedConn.cursor() as cur:
+            cur.execute("CREATE UNIQUE INDEX table6_idx1 ON table6 (dataA);")
+        self.sharedConn.rollback()
+        self.assertFalse(secIndexExists(self.sharedConn, "table6", "table6_idx1"))
+
+        commitSQL(self.sharedConn, "CREATE UNIQUE INDEX table6_idx1 ON table6 (dataA);")
+        self.assertEqual(selectOneRecord(self.sharedConn, "SELECT id FROM table6 WHERE dataA = 4321;")[0], 4321)
+
+        commitSQL(self.sharedConn, "DROP TABLE table6;")
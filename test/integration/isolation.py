@@ -105,3 +105,56 @@ class TestIsolation(unittest.TestCase):
                 cur.execute("SELECT * FROM isolation WHERE id=7;")
                 records = cur.fetchall()
                 self.assertEqual(len(records), 0)
+
+    def test_commitReadOnlyWithoutBegin(self):
+        conn = getConn()
+        conn.set_session(readonly=True)
+        # the K2 transaction is only begun by the first read, so this one never begins
+        with conn.cursor() as cur:
+            cur.execute("SELECT 1;")
+            self.assertEqual(cur.fetchone()[0], 1)
+        conn.commit()
+        # nor does an empty one
+        conn.commit()
+
+        # a read-only transaction which did begin is ended locally
+        with conn.cursor() as cur:
+            cur.execute("SELECT * FROM isolation WHERE id=8;")
+            self.assertEqual(len(cur.fetchall()), 0)
+        conn.commit()
+
+        # the next transaction begins as usual
+        conn.set_session(readonly=False)
+        with conn.cursor() as cur:
+            cur.execute("INSERT INTO isolation VALUES (8, 8, 8);")
+        conn.commit()
+        conn.close()
+        self.assertEqual(selectOneRecord(self.sharedConn, "SELECT dataA FROM isolation WHERE id=8;")[0], 8)
+
+    def test_failureDuringBegin(self):
+        commitSQL(self.sharedConn, "INSERT INTO isolation VALUES (9, 9, 9);")
+
+        # the first write of the transaction fails while its begin is still in flight
+        conn = getConn()
+        with self.assertRaises(psycopg2.errors.UniqueViolation):
+            with conn.cursor() as cur:
+                cur.execute("INSERT INTO isolation VALUES (9, 10, 10);")
+        conn.rollback()
+
+        # the first read of the transaction succeeds, then the statement fails on its row
+        with self.assertRaises(psycopg2.errors.DivisionByZero):
+            with conn.cursor() as cur:
+                cur.execute("SELECT 1 / (dataA - 9) FROM isolation WHERE id=9;")
+        conn.rollback()
+
+        # neither transaction is left behind: both connections can write the row
+        with conn.cursor() as cur:
+            cur.execute("UPDATE isolation SET dataA = 11 WHERE id=9;")
+            cur.execute("INSERT INTO isolation VALUES (10, 10, 10);")
+        conn.commit()
+        conn.close()
+        commitSQL(self.sharedConn, "UPDATE isolation SET dataB = 12 WHERE id=9;")
+        record = selectOneRecord(self.sharedConn, "SELECT dataA, dataB FROM isolation WHERE id=9;")
+        self.assertEqual(record[0], 11)
+        self.assertEqual(record[1], 12)
+        self.assertEqual(selectOneRecord(self.sharedConn, "SELECT dataA FROM isolation WHERE id=10;")[0], 10)
@@ -63,3 +63,70 @@ class TestJoin(unittest.TestCase):
                 result = cur.fetchall()
                 self.assertEqual(len(result), 1000)
 
+
+    def test_mergeJoinOnPrimaryKeys(self):
+        with self.sharedConn:
+            with self.sharedConn.cursor() as cur:
+                cur.execute("SET LOCAL enable_hashjoin = off;")
+                cur.execute("SET LOCAL enable_nestloop = off;")
+                cur.execute("EXPLAIN SELECT join1.id FROM join1 INNER JOIN join2 ON join1.id=join2.id;")
+                plan = " ".join(row[0] for row in cur.fetchall())
+                self.assertIn("Merge Join", plan)
+                cur.execute("SELECT join1.id FROM join1 INNER JOIN join2 ON join1.id=join2.id;")
+                result = cur.fetchall()
+                self.assertEqual(len(result), 1000)
+
+    def test_orderByPrimaryKeyWithLimit(self):
+        with self.sharedConn:
+            with self.sharedConn.cursor() as cur:
+                cur.execute("EXPLAIN SELECT id FROM join1 ORDER BY id DESC LIMIT 3;")
+                plan = " ".join(row[0] for row in cur.fetchall())
+                self.assertNotIn("Sort", plan)
+                cur.execute("SELECT id FROM join1 ORDER BY id DESC LIMIT 3;")
+                self.assertEqual([row[0] for row in cur.fetchall()], [1000, 999, 998])
+
+    def test_batchedNestedLoop(self):
+        def runJoin(batchSize, query, workMem="4MB"):
+            with self.sharedConn:
+                with self.sharedConn.cursor() as cur:
+                    cur.execute("SET LOCAL enable_hashjoin = off;")
+                    cur.execute("SET LOCAL enable_mergejoin = off;")
+                    cur.execute("SET LOCAL k2pg_nestloop_batch_size = %s;", (batchSize,))
+                    cur.execute("SET LOCAL work_mem = %s;", (workMem,))
+                    cur.execute("EXPLAIN " + query)
+                    plan = " ".join(row[0] for row in cur.fetchall())
+                    self.assertIn("Nested Loop", plan)
+                    cur.execute(query)
+                    return cur.fetchall()
+
+        # Outer rows without a match and an inner filter, with a batch size which doesn't
+        # divide the number of outer rows
+        query = """SELECT join1.id, join2.id, join2.dataC FROM join1 LEFT JOIN join2
+                   ON join2.id = join1.dataA + 990 AND join2.dataC % 2 = 0
+                   WHERE join1.id <= 20 ORDER BY join1.id;"""
+        result = runJoin(7, query)
+        self.assertEqual(result, runJoin(1, query))
+        self.assertEqual(len(result), 20)
+        self.assertEqual(result[1], (2, 992, 992))
+        self.assertEqual(result[2], (3, None, None))
+        self.assertEqual(result[10], (11, None, None))
+
+        query = "SELECT COUNT(*) FROM join1 WHERE EXISTS (SELECT 1 FROM join2 WHERE join2.id = join1.id + 500);"
+        self.assertEqual(runJoin(64, query)[0][0], 500)
+        query = "SELECT COUNT(*) FROM join1 WHERE NOT EXISTS (SELECT 1 FROM join2 WHERE join2.id = join1.id + 500);"
+        self.assertEqual(runJoin(64, query)[0][0], 500)
+
+        # inner rows of a batch which don't fit in work_mem are read again for every outer row
+        query = "SELECT COUNT(*), SUM(join2.dataC) FROM join1 JOIN join2 ON join2.id = join1.id;"
+        self.assertEqual(runJoin(1000, query, "64kB"), runJoin(1, query))
+
+        # the inner index scan is accounted for in EXPLAIN ANALYZE
+        with self.sharedConn:
+            with self.sharedConn.cursor() as cur:
+                cur.execute("SET LOCAL enable_hashjoin = off;")
+                cur.execute("SET LOCAL enable_mergejoin = off;")
+                cur.execute("SET LOCAL k2pg_nestloop_batch_size = 64;")
+                cur.execute("EXPLAIN ANALYZE SELECT join1.id, join2.id FROM join1 JOIN join2 ON join2.id = join1.id WHERE join1.id <= 100;")
+                plan = " ".join(row[0] for row in cur.fetchall())
+                self.assertIn("Nested Loop", plan)
+                self.assertNotIn("never executed", plan)